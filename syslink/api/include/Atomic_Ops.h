@@ -48,7 +48,6 @@
 
 /* Standard libc headers */
 #include <stdio.h>
-#include <pthread.h>
 
 
 /* =============================================================================
@@ -59,17 +58,14 @@
 typedef UInt32 Atomic;
 
 
-/* =============================================================================
- * Global
- * =============================================================================
- */
-/* Lock used by atomic operations to create psuedo atomicity */
-static pthread_mutex_t Atomic_lock = PTHREAD_MUTEX_INITIALIZER;
-
-
 /* =============================================================================
  * APIs & Macros
  * =============================================================================
+ *  The operations map onto the GCC __sync builtins (GCC 4.1 and later, so
+ *  the arm-2008q3 toolchain is covered), so concurrent callers operating on
+ *  different variables no longer serialize on a common lock.  Reads are
+ *  followed and writes preceded by a full barrier, so a refCount update
+ *  also publishes the module state written before it.
  */
 /*!
  *   @brief Function to read an variable atomically
@@ -78,14 +74,12 @@ static pthread_mutex_t Atomic_lock = PTHREAD_MUTEX_INITIALIZER;
  */
 static inline UInt32 Atomic_read (Atomic * var)
 {
-    UInt32 ret;
+    UInt32 val = *(volatile Atomic *) var;
 
-    pthread_mutex_lock (&Atomic_lock);
-    ret = *var;
-    pthread_mutex_unlock (&Atomic_lock);
+    __sync_synchronize ();
 
     /*! @retval value   Current value of the atomic variable */
-    return ret;
+    return val;
 }
 
 
@@ -97,9 +91,8 @@ static inline UInt32 Atomic_read (Atomic * var)
  */
 static inline void Atomic_set (Atomic * var, UInt32 val)
 {
-    pthread_mutex_lock (&Atomic_lock);
-    *var = val;
-    pthread_mutex_unlock (&Atomic_lock);
+    __sync_synchronize ();
+    *(volatile Atomic *) var = val;
 }
 
 
@@ -111,15 +104,8 @@ static inline void Atomic_set (Atomic * var, UInt32 val)
  */
 static inline UInt32 Atomic_inc_return (Atomic * var)
 {
-    UInt32 ret;
-
-    pthread_mutex_lock (&Atomic_lock);
-    *var = *var + 1u;
-    ret = *var;
-    pthread_mutex_unlock (&Atomic_lock);
-
     /*! @retval value   Current value of the atomic variable */
-    return ret;
+    return __sync_add_and_fetch (var, 1u);
 }
 
 
@@ -131,15 +117,8 @@ static inline UInt32 Atomic_inc_return (Atomic * var)
  */
 static inline UInt32 Atomic_dec_return (Atomic * var)
 {
-    UInt32 ret;
-
-    pthread_mutex_lock (&Atomic_lock);
-    *var = *var - 1u;
-    ret = *var;
-    pthread_mutex_unlock (&Atomic_lock);
-
     /*! @retval value   Current value of the atomic variable */
-    return ret;
+    return __sync_sub_and_fetch (var, 1u);
 }
 
 
@@ -152,14 +131,17 @@ static inline UInt32 Atomic_dec_return (Atomic * var)
  */
 static inline void Atomic_cmpmask_and_set(Atomic * var, UInt32 mask, UInt32 val)
 {
-    UInt32  ret;
-
-    pthread_mutex_lock (&Atomic_lock);
-    ret = *var;
-    if ((ret & mask) != mask) {
-        *var = val;
+    UInt32  cur = Atomic_read (var);
+    UInt32  prev;
+
+    /* On failure cur is the value found, so the mask is checked again. */
+    while ((cur & mask) != mask) {
+        prev = __sync_val_compare_and_swap (var, cur, val);
+        if (prev == cur) {
+            break;
+        }
+        cur = prev;
     }
-    pthread_mutex_unlock (&Atomic_lock);
 }
 
 /*!
@@ -173,16 +155,13 @@ static inline void Atomic_cmpmask_and_set(Atomic * var, UInt32 mask, UInt32 val)
 static inline Bool Atomic_cmpmask_and_lt(Atomic * var, UInt32 mask, UInt32 val)
 {
     Bool   ret = TRUE;
-    UInt32 cur = 0;
+    UInt32 cur = Atomic_read (var);
 
-    pthread_mutex_lock (&Atomic_lock);
-    cur = *var;
     if ((cur & mask) == mask) {
         if (cur >= val) {
             ret = FALSE;
         }
     }
-    pthread_mutex_unlock (&Atomic_lock);
 
     /*! @retval TRUE  if mask matches and current value is less than given
      *  value */
@@ -202,16 +181,13 @@ static inline Bool Atomic_cmpmask_and_lt(Atomic * var, UInt32 mask, UInt32 val)
 static inline Bool Atomic_cmpmask_and_gt(Atomic * var, UInt32 mask, UInt32 val)
 {
     Bool   ret = TRUE;
-    UInt32 cur = 0;
+    UInt32 cur = Atomic_read (var);
 
-    pthread_mutex_lock (&Atomic_lock);
-    cur = *var;
     if ((cur & mask) == mask) {
         if (cur < val) {
             ret = FALSE;
         }
     }
-    pthread_mutex_unlock (&Atomic_lock);
 
     /*! @retval TRUE  if mask matches and current value is less than given
      *  value */
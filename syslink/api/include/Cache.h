@@ -0,0 +1,122 @@
+/*
+ *  Syslink-IPC for TI OMAP Processors
+ *
+ *  Copyright (c) 2008-2010, Texas Instruments Incorporated
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  *  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  *  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  *  Neither the name of Texas Instruments Incorporated nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/** ============================================================================
+ *  @file   Cache.h
+ *
+ *  @brief      Cache maintenance for cached shared memory mappings.
+ *
+ *  The MPU cannot clean or invalidate data cache lines from user space, so
+ *  the operations are carried out by the driver that owns the remote
+ *  processor's MMU. ProcMgr registers its flush and invalidate functions
+ *  while a handle to a remote processor is open; without a registered
+ *  processor the Cache APIs do nothing.
+ *
+ *  ============================================================================
+ */
+
+
+#ifndef CACHE_H_0x3A7E
+#define CACHE_H_0x3A7E
+
+#if defined (__cplusplus)
+extern "C" {
+#endif
+
+/* =============================================================================
+ *  Macros and types
+ * =============================================================================
+ */
+/*!
+ *  @brief  Cache types, kept for compatibility with the SYS/BIOS Cache API.
+ *          The MPU always operates on all levels.
+ */
+#define Cache_Type_L1D          0x2
+#define Cache_Type_L2D          0x8
+#define Cache_Type_ALLD         0xA
+#define Cache_Type_ALL          0x7FFF
+
+/*!
+ *  @brief  Operation successful
+ */
+#define Cache_S_SUCCESS         0
+
+/*!
+ *  @brief  The MMU driver failed the operation
+ */
+#define Cache_E_FAIL            -1
+
+/*!
+ *  @brief  No processor has registered cache operations
+ */
+#define Cache_E_INVALIDSTATE    -2
+
+/*!
+ *  @brief  Maximum number of processors that can register cache operations
+ */
+#define Cache_MAXPROCS          16u
+
+/*!
+ *  @brief  Function performing one cache operation through the MMU driver
+ *          of processor procId.
+ */
+typedef Int (*Cache_OpFxn) (Ptr addr, UInt32 size, UInt16 procId);
+
+
+/* =============================================================================
+ *  APIs
+ * =============================================================================
+ */
+/* Function to invalidate a range of memory */
+Int Cache_inv (Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait);
+
+/* Function to write back a range of memory */
+Int Cache_wb (Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait);
+
+/* Function to write back and invalidate a range of memory */
+Int Cache_wbInv (Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait);
+
+/* Function to register the cache operations of a remote processor */
+Void Cache_register (UInt16 procId, Cache_OpFxn wbInvFxn, Cache_OpFxn invFxn);
+
+/* Function to drop one registration made with Cache_register */
+Void Cache_unregister (UInt16 procId);
+
+/* Function to tell whether cache operations are carried out */
+Bool Cache_isEnabled (Void);
+
+#if defined (__cplusplus)
+}
+#endif /* defined (__cplusplus) */
+
+#endif /* CACHE_H_0x3A7E */
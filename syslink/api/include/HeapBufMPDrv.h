@@ -68,7 +68,8 @@ Int HeapBufMPDrv_open (Void);
 /* Function to close the HeapBufMP driver. */
 Int HeapBufMPDrv_close (Void);
 
-/* Function to invoke the APIs through ioctl. */
+/* Function to invoke the APIs through ioctl. errno is preserved when the
+ * ioctl itself fails. */
 Int HeapBufMPDrv_ioctl (UInt32 cmd, Ptr args);
 
 
@@ -78,7 +78,9 @@ enum CMD_HEAPBUF {
     HEAPBUFMP_FREE,
     HEAPBUFMP_SHAREDMEMREQ,
     HEAPBUFMP_GETSTATS,
-    HEAPBUFMP_GETEXTENDEDSTATS
+    HEAPBUFMP_GETEXTENDEDSTATS,
+    HEAPBUFMP_ALLOCMANY,
+    HEAPBUFMP_FREEMANY
 };
 
 /*!
@@ -179,6 +181,25 @@ enum CMD_HEAPBUF {
                                         HEAPBUFMP_OPENBYADDR,                  \
                                         HeapBufMPDrv_CmdArgs)
 
+/*!
+ *  @brief  Command for refilling a HeapBufMP magazine
+ */
+#define CMD_HEAPBUFMP_ALLOCMANY         _IOWR(HEAPBUFMP_IOC_MAGIC,             \
+                                        HEAPBUFMP_ALLOCMANY,                   \
+                                        HeapBufMPDrv_CmdArgs)
+
+/*!
+ *  @brief  Command for draining a HeapBufMP magazine
+ */
+#define CMD_HEAPBUFMP_FREEMANY          _IOWR(HEAPBUFMP_IOC_MAGIC,             \
+                                        HEAPBUFMP_FREEMANY,                    \
+                                        HeapBufMPDrv_CmdArgs)
+
+/*!
+ *  @brief  Maximum number of blocks moved by one ALLOCMANY/FREEMANY command
+ */
+#define HEAPBUFMP_MAXBATCH              64u
+
 
 /*  ----------------------------------------------------------------------------
  *  Command arguments for HeapBufMP
@@ -241,6 +262,23 @@ typedef struct HeapBufMPDrv_CmdArgs {
             UInt32                      size;
         } free;
 
+        struct {
+            Ptr                         handle;
+            UInt32                      size;
+            UInt32                      align;
+            SharedRegion_SRPtr        * blockSrPtrs;
+            UInt32                      numBlocks;
+            UInt32                      numAlloced;
+        } allocMany;
+
+        struct {
+            Ptr                         handle;
+            UInt32                      size;
+            SharedRegion_SRPtr        * blockSrPtrs;
+            UInt32                      numBlocks;
+            UInt32                      numFreed;
+        } freeMany;
+
         struct {
             Ptr                         handle;
             Memory_Stats              * stats;
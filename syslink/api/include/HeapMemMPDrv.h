@@ -68,7 +68,8 @@ Int HeapMemMPDrv_open (Void);
 /* Function to close the HeapMemMP driver. */
 Int HeapMemMPDrv_close (Void);
 
-/* Function to invoke the APIs through ioctl. */
+/* Function to invoke the APIs through ioctl. errno is preserved when the
+ * ioctl itself fails. */
 Int HeapMemMPDrv_ioctl (UInt32 cmd, Ptr args);
 
 
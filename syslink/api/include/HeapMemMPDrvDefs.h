@@ -78,7 +78,8 @@ enum CMD_HEAPMEMMP {
     HEAPMEMMP_SHAREDMEMREQ,
     HEAPMEMMP_GETSTATS,
     HEAPMEMMP_GETEXTENDEDSTATS,
-    HEAPMEMMP_RESTORE
+    HEAPMEMMP_RESTORE,
+    HEAPMEMMP_ALLOCMANY
 };
 
 /*!
@@ -186,6 +187,18 @@ enum CMD_HEAPMEMMP {
                                         HEAPMEMMP_OPENBYADDR,                  \
                                         HeapMemMPDrv_CmdArgs)
 
+/*!
+ *  @brief  Command for HeapMemMP_allocMany
+ */
+#define CMD_HEAPMEMMP_ALLOCMANY         _IOWR(HEAPMEMMP_IOC_MAGIC,             \
+                                        HEAPMEMMP_ALLOCMANY,                   \
+                                        HeapMemMPDrv_CmdArgs)
+
+/*!
+ *  @brief  Maximum number of blocks allocated by one ALLOCMANY command
+ */
+#define HEAPMEMMP_MAXBATCH              64u
+
 
 /*  ----------------------------------------------------------------------------
  *  Command arguments for HeapMemMP
@@ -249,6 +262,15 @@ typedef struct HeapMemMPDrv_CmdArgs {
             UInt32                      size;
         } free;
 
+        struct {
+            Ptr                         handle;
+            UInt32                      size;
+            UInt32                      align;
+            SharedRegion_SRPtr        * blockSrPtrs;
+            UInt32                      numBlocks;
+            UInt32                      numAlloced;
+        } allocMany;
+
         struct {
             Ptr                         handle;
             Memory_Stats              * stats;
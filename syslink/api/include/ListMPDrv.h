@@ -68,7 +68,8 @@ Int ListMPDrv_open (Void);
 /* Function to close the ListMP driver. */
 Int ListMPDrv_close (Void);
 
-/* Function to invoke the APIs through ioctl. */
+/* Function to invoke the APIs through ioctl. errno is preserved when the
+ * ioctl itself fails. */
 Int ListMPDrv_ioctl (UInt32 cmd, Ptr args);
 
 
@@ -83,7 +83,8 @@ enum CMD_LISTMP {
     LISTMP_NEXT,
     LISTMP_PREV,
     LISTMP_SHAREDMEMREQ,
-    LISTMP_OPENBYADDR
+    LISTMP_OPENBYADDR,
+    LISTMP_GETSHAREDADDR
 };
 /*  ----------------------------------------------------------------------------
  *  IOCTL command IDs for ListMP
@@ -206,6 +207,13 @@ enum CMD_LISTMP {
                                         LISTMP_OPENBYADDR,                     \
                                         ListMPDrv_CmdArgs)
 
+/*!
+ *  @brief  Command to get the shared attributes address of an instance
+ */
+#define CMD_LISTMP_GETSHAREDADDR        _IOWR(LISTMP_IOC_MAGIC,                \
+                                        LISTMP_GETSHAREDADDR,                  \
+                                        ListMPDrv_CmdArgs)
+
 /*  ----------------------------------------------------------------------------
  *  Command arguments for ListMP
  *  ----------------------------------------------------------------------------
@@ -310,6 +318,11 @@ typedef struct ListMPDrv_CmdArgs {
             UInt32                      nameLen;
             Ptr                         handle;
         } sharedMemReq;
+
+        struct {
+            Ptr                         handle;
+            SharedRegion_SRPtr          sharedAddrSrPtr;
+        } getSharedAddr;
     } args;
 
     Int32 apiStatus;
@@ -69,7 +69,8 @@ Int MessageQDrv_open (Void);
 /* Function to close the MessageQ driver. */
 Int MessageQDrv_close (Void);
 
-/* Function to invoke the APIs through ioctl. */
+/* Function to invoke the APIs through ioctl. errno is preserved when the
+ * ioctl itself fails. */
 Int MessageQDrv_ioctl (UInt32 cmd, Ptr args);
 
 
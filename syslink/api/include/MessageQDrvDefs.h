@@ -85,7 +85,9 @@ enum messageq_drv_cmd {
     MESSAGEQ_DETACH,
     MESSAGEQ_GET,
     MESSAGEQ_SHAREDMEMREQ,
-    MESSAGEQ_UNBLOCK
+    MESSAGEQ_UNBLOCK,
+    MESSAGEQ_PUTMANY,
+    MESSAGEQ_GETMANY
 };
 
 /*  ----------------------------------------------------------------------------
@@ -225,6 +227,25 @@ enum messageq_drv_cmd {
                                         MESSAGEQ_UNBLOCK,                      \
                                         MessageQDrv_CmdArgs)
 
+/*!
+ *  @brief  Command for MessageQ_putMany
+ */
+#define CMD_MESSAGEQ_PUTMANY            _IOWR(MESSAGEQ_IOC_MAGIC,              \
+                                        MESSAGEQ_PUTMANY,                      \
+                                        MessageQDrv_CmdArgs)
+
+/*!
+ *  @brief  Command for MessageQ_getMany
+ */
+#define CMD_MESSAGEQ_GETMANY            _IOWR(MESSAGEQ_IOC_MAGIC,              \
+                                        MESSAGEQ_GETMANY,                      \
+                                        MessageQDrv_CmdArgs)
+
+/*!
+ *  @brief  Maximum number of messages moved by one PUTMANY/GETMANY command
+ */
+#define MESSAGEQ_MAXBATCH               64u
+
 /*  ----------------------------------------------------------------------------
  *  Command arguments for MessageQ
  *  ----------------------------------------------------------------------------
@@ -321,6 +342,21 @@ typedef struct MessageQDrv_CmdArgs_Tag {
         struct {
             Ptr                   handle;
         } unblock;
+
+        struct {
+            MessageQ_QueueId      queueId;
+            SharedRegion_SRPtr  * msgSrPtrs;
+            UInt32                numMsgs;
+            UInt32                numPut;
+        } putMany;
+
+        struct {
+            Ptr                   handle;
+            UInt                  timeout;
+            SharedRegion_SRPtr  * msgSrPtrs;
+            UInt32                maxMsgs;
+            UInt32                numMsgs;
+        } getMany;
     } args;
 
     Int32 apiStatus;
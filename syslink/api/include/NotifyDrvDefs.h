@@ -89,7 +89,8 @@ enum CMD_NOTIFY {
     NOTIFY_ISREGISTERED,
     NOTIFY_SHAREDMEMREQ,
     NOTIFY_REGISTEREVENTSINGLE,
-    NOTIFY_UNREGISTEREVENTSINGLE
+    NOTIFY_UNREGISTEREVENTSINGLE,
+    NOTIFY_SENDEVENTS
 };
 
 /*!
@@ -217,6 +218,25 @@ enum CMD_NOTIFY {
                                                  NOTIFY_UNREGISTEREVENTSINGLE,\
                                                  Notify_CmdArgsUnregisterEvent)
 
+/*!
+ *  @brief  Command for Notify_sendEvents
+ */
+#define CMD_NOTIFY_SENDEVENTS                    _IOWR(NOTIFY_IOC_MAGIC,\
+                                                 NOTIFY_SENDEVENTS,\
+                                                 Notify_CmdArgsSendEvents)
+
+/*!
+ *  @brief  Maximum number of event packets taken by one read() on the
+ *          Notify driver.
+ *
+ *          The event worker reads into an array of packets, with the pid
+ *          set in the first one. The driver copies as many pending events
+ *          as fit and returns the number of bytes filled, a multiple of
+ *          sizeof (NotifyDrv_EventPacket). A driver that only knows single
+ *          packet reads fills the first packet and keeps working.
+ */
+#define NOTIFYDRV_MAX_EVENT_PACKETS             16
+
 /*!
  *  @brief  Structure of Event Packet read from notify kernel-side.
  */
@@ -241,6 +261,38 @@ typedef struct NotifyDrv_EventPacket_tag {
     /*!< Indicates whether this is an exit packet */
 } NotifyDrv_EventPacket ;
 
+/*!
+ *  @brief  Event delivery statistics of the user-side event worker.
+ */
+typedef struct NotifyDrv_EventStats_tag {
+    UInt32             wakeups;
+    /*!< Number of reads that returned events */
+    UInt32             events;
+    /*!< Number of events dispatched to callbacks */
+    UInt32             maxBatch;
+    /*!< Largest number of events returned by one read */
+} NotifyDrv_EventStats;
+
+/*!
+ *  @brief  Number of buckets in a callback execution time histogram.
+ */
+#define NOTIFYDRV_CBHIST_BUCKETS                16
+
+/*!
+ *  @brief  Execution time statistics of one Notify callback function.
+ */
+typedef struct NotifyDrv_CallbackStats_tag {
+    Notify_FnNotifyCbck func;
+    /*!< Callback function the statistics belong to */
+    UInt32             count;
+    /*!< Number of times the callback was run */
+    UInt32             maxUs;
+    /*!< Longest run, in microseconds */
+    UInt32             hist [NOTIFYDRV_CBHIST_BUCKETS];
+    /*!< hist[i] counts runs shorter than 2^i microseconds and not counted
+     *   in a lower bucket; the last bucket also holds all longer runs */
+} NotifyDrv_CallbackStats;
+
 /*  ----------------------------------------------------------------------------
  *  Command arguments for Notify
  *  ----------------------------------------------------------------------------
@@ -352,6 +404,26 @@ typedef struct Notify_CmdArgsSendEvent_tag {
     Bool                  waitClear;
 } Notify_CmdArgsSendEvent;
 
+/*!
+ *  @brief  Command arguments for Notify_sendEvents
+ *
+ *          The driver sends the payloads in order within one call. With
+ *          coalesce set, a payload whose predecessor has not yet been
+ *          cleared by the remote processor overwrites it instead of raising
+ *          another interrupt. numSent returns the number of interrupts
+ *          actually raised.
+ */
+typedef struct Notify_CmdArgsSendEvents_tag {
+    Notify_CmdArgs        commonArgs;
+    UInt16                procId;
+    UInt16                lineId;
+    UInt32                eventId;
+    UInt32 *              payloads;
+    UInt32                numPayloads;
+    Bool                  coalesce;
+    UInt32                numSent;
+} Notify_CmdArgsSendEvents;
+
 /*!
  *  @brief  Command arguments for Notify_disable
  */
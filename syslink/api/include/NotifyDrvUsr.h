@@ -45,6 +45,9 @@
 #ifndef NotifyDrvUsr_H_0x5f84
 #define NotifyDrvUsr_H_0x5f84
 
+/* Module headers */
+#include <NotifyDrvDefs.h>
+
 
 #if defined (__cplusplus)
 extern "C" {
@@ -68,9 +71,20 @@ Int NotifyDrvUsr_open (Bool createThread);
 /* Function to close the Notify driver. */
 Int NotifyDrvUsr_close (Bool deleteThread);
 
-/* Function to invoke the APIs through ioctl. */
+/* Function to invoke the APIs through ioctl. errno is preserved when the
+ * ioctl itself fails. */
 Int NotifyDrvUsr_ioctl (UInt32 cmd, Ptr args);
 
+/* Function to get the event delivery statistics of the event worker. */
+Int NotifyDrvUsr_getEventStats (NotifyDrv_EventStats * stats);
+
+/* Function to set the number of callback dispatch threads. */
+Int NotifyDrvUsr_setDispatchThreads (UInt32 numThreads);
+
+/* Function to get the execution time statistics of a callback. */
+Int NotifyDrvUsr_getCallbackStats (UInt32                    index,
+                                   NotifyDrv_CallbackStats * stats);
+
 
 #if defined (__cplusplus)
 }
@@ -120,7 +120,7 @@ Int OsalDrv_open (Void);
 Int OsalDrv_close (Void);
 
 /* Function to map a memory region specific to the driver. */
-UInt32 OsalDrv_map (UInt32 addr, UInt32 size);
+UInt32 OsalDrv_map (UInt32 addr, UInt32 size, Bool isCached);
 
 /* Function to unmap a memory region specific to the driver. */
 Void OsalDrv_unmap (UInt32 addr, UInt32 size);
@@ -317,8 +317,21 @@ typedef struct RcmClient_Config_tag {
 typedef struct RcmClient_Params_tag {
     UInt16 heapId;                /*!< heap ID for msg alloc */
     Bool   callbackNotification;  /*!< enable/ disable asynchronous exec */
+    UInt   cacheLength;           /*!< # of messages kept for reuse, 0 to
+                                       disable the message cache */
+    UInt32 cacheDataSize;         /*!< payload size (in chars) of cached
+                                       messages */
 } RcmClient_Params;
 
+/*
+ *  @brief  Message cache statistics, see RcmClient_getCacheStats().
+ */
+typedef struct RcmClient_CacheStats_tag {
+    UInt32 hits;                  /*!< allocs served from the cache */
+    UInt32 misses;                /*!< allocs that went to MessageQ_alloc */
+    UInt   count;                 /*!< messages currently in the cache */
+} RcmClient_CacheStats;
+
 /*
  *  @brief RCM message structure.
  */
@@ -524,6 +537,21 @@ Int RcmClient_execCmd (RcmClient_Handle handle, RcmClient_Message *cmdMsg);
  */
 Int RcmClient_free (RcmClient_Handle handle, RcmClient_Message *msg);
 
+/*!
+ *  @brief  Function returns the message cache statistics
+ *
+ *          Messages with a payload of up to cacheDataSize chars are taken
+ *          from the instance cache by RcmClient_alloc and returned to it
+ *          by RcmClient_free. The counters help size cacheLength.
+ *
+ *  @param  handle      RcmClient Handle
+ *  @param  stats       Pointer to return the statistics
+ *
+ *  @return Status of the call
+ */
+Int RcmClient_getCacheStats (RcmClient_Handle       handle,
+                             RcmClient_CacheStats * stats);
+
 /*!
  *  @brief  Function gets symbol index
  *
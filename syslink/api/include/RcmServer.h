@@ -302,6 +302,28 @@ typedef struct {
     /*!<
      *   The worker thread stack placement.
      */
+
+    UInt    maxCount;
+    /*!<
+     *   The maximum number of worker threads in the pool.
+     *
+     *  When greater than count, the pool grows by one thread whenever a
+     *  message has been waiting longer than growLatency behind a busy
+     *  worker, and shrinks back towards count as workers stay idle.
+     *  Zero (or any value not above count) gives a fixed size pool.
+     */
+
+    UInt    growLatency;
+    /*!<
+     *   Time in milliseconds a queued message may wait before the pool
+     *   adds a worker thread.
+     */
+
+    UInt    idleTimeout;
+    /*!<
+     *   Time in milliseconds a worker thread above count may stay idle
+     *   before it is retired. Zero keeps the extra threads.
+     */
 } RcmServer_ThreadPoolDesc;
 
 /*!
@@ -320,6 +342,18 @@ typedef struct {
 } RcmServer_ThreadPoolDescAry;
 
 
+/*!
+ *  @brief  Worker pool statistics, see RcmServer_getPoolStats()
+ */
+typedef struct {
+    UInt    numWorkers; /*!< Number of active worker threads in the pool */
+    UInt    queueDepth; /*!< Messages waiting on the worker ready queues */
+    UInt32  processed;  /*!< Messages executed by the pool's workers     */
+    UInt32  steals;     /*!< Messages taken from a sibling's queue       */
+    UInt32  idleTime;   /*!< Total time workers spent idle, in ms        */
+} RcmServer_PoolStats;
+
+
 /*!
  *  @brief  RcmServer instance object handle
  */
@@ -491,6 +525,64 @@ Void RcmServer_exit (Void);
  */
 Void RcmServer_init (Void);
 
+/*!
+ *  @brief  Create a worker pool at runtime
+ *
+ *          The pool starts with desc->count threads and scales up to
+ *          desc->maxCount as described in #RcmServer_ThreadPoolDesc.
+ *          The returned id is used in RcmClient_Message.poolId; it stays
+ *          unique across deletePool/createPool cycles for a while, so a
+ *          stale id is rejected instead of reaching a new pool.
+ *
+ *  @param  handle  Handle to an instance object.
+ *  @param  desc    Description of the pool.
+ *  @param  poolId  Location to receive the pool id.
+ *
+ *  @return Status of the call
+ *          -#RcmServer_S_SUCCESS
+ *          -#RcmServer_E_INVALIDARG
+ *          -#RcmServer_E_NOMEMORY
+ *          -#RcmServer_E_FAIL
+ */
+Int RcmServer_createPool (RcmServer_Handle              handle,
+                          RcmServer_ThreadPoolDesc    * desc,
+                          UInt16                      * poolId);
+
+/*!
+ *  @brief  Delete a worker pool created with RcmServer_createPool()
+ *
+ *          Messages still queued on the pool are returned to the client
+ *          with status #RcmServer_Status_Unprocessed.
+ *
+ *  @param  handle  Handle to an instance object.
+ *  @param  poolId  Id returned by RcmServer_createPool().
+ *
+ *  @return Status of the call
+ *          -#RcmServer_S_SUCCESS
+ *          -#RcmServer_E_INVALIDARG
+ */
+Int RcmServer_deletePool (RcmServer_Handle handle, UInt16 poolId);
+
+/*!
+ *  @brief  Get the statistics of a worker pool
+ *
+ *          Each worker thread keeps its own ready queue and steals from its
+ *          siblings when idle. This returns the sum of the per-worker
+ *          counters; the values are a snapshot taken without stopping the
+ *          workers.
+ *
+ *  @param  handle  Handle to an instance object.
+ *  @param  poolId  Id of the pool, e.g. #RcmClient_DEFAULTPOOLID.
+ *  @param  stats   Location to receive the statistics.
+ *
+ *  @return Status of the call
+ *          -#RcmClient_S_SUCCESS
+ *          -#RcmServer_E_INVALIDARG
+ */
+Int RcmServer_getPoolStats (RcmServer_Handle        handle,
+                            UInt16                  poolId,
+                            RcmServer_PoolStats   * stats);
+
 /*!
  *  @brief  Initialize the instance create params structure.
  *
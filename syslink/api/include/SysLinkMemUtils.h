@@ -102,6 +102,11 @@ SysLinkMemUtils_virtToPhys (UInt32          remoteAddr,
                             UInt32 *        physAddr,
                             ProcMgr_ProcId  procId);
 
+/* Internal: closes the ProcMgr handles cached by this module. Called by
+ * ProcMgr_destroy. */
+Void
+_SysLinkMemUtils_closeHandles (Void);
+
 #if defined (__cplusplus)
 }
 #endif /* defined (__cplusplus) */
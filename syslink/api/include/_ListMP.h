@@ -96,6 +96,13 @@ typedef struct ListMP_Config_tag {
          added to the NameServer. */
     UInt maxNameLen;
     /*!< Maximum length of name */
+    Bool directAccess;
+    /*!< Whether handles read the list straight from the SharedRegion mapping
+         instead of going through the driver. This covers ListMP_empty,
+         ListMP_next and ListMP_prev. Calls that modify the list still use the
+         driver, because taking the GateMP from user space costs more ioctls
+         than the one call it would replace. Default is FALSE.
+         ListMP_setDirectAccess overrides the setting for a single handle. */
 } ListMP_Config;
 
 
@@ -125,6 +132,25 @@ Int ListMP_setup (ListMP_Config * config) ;
 /* Function to destroy the ListMP module. */
 Int ListMP_destroy (void);
 
+/*!
+ *  @brief      Enables or disables direct access for one handle.
+ *
+ *              Direct access needs the address of the shared list
+ *              attributes. The address is known for instances created with
+ *              ListMP_Params#sharedAddr or opened with ListMP_openByAddr.
+ *              For other instances it is queried from the driver.
+ *
+ *  @param      handle  Handle to a created or opened instance.
+ *  @param      enable  TRUE to read the list in user space.
+ *
+ *  @retval     ListMP_S_SUCCESS    Operation successful
+ *  @retval     ListMP_E_FAIL       The shared list attributes are not known
+ *                                  for this handle
+ *
+ *  @sa         ListMP_Config#directAccess
+ */
+Int ListMP_setDirectAccess (ListMP_Handle handle, Bool enable);
+
 
 
 #if defined (__cplusplus)
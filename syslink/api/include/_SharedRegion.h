@@ -102,6 +102,24 @@ typedef struct SharedRegion_Config {
      *   for all processors. If 'true', it results in a fast
      *   getPtr and getSRPtr.
      */
+
+    UInt32     cachedRegionMask;
+    /*!< Regions this process maps cached, one bit per region id
+     *
+     *   Bit n set maps region n through the MPU cache instead of uncached.
+     *   MessageQ, ListMP, HeapBufMP and HeapMemMP then write back and
+     *   invalidate the memory they pass to or receive from other processors
+     *   through that region; payloads exchanged by other means need explicit
+     *   Cache_wb/Cache_inv calls. Cache maintenance needs a ProcMgr handle
+     *   open in the process: a region mapped while none is open is mapped
+     *   uncached instead, and maintenance of a cached region fails once the
+     *   last handle is closed. Regions valid at SharedRegion_setup are
+     *   mapped before any handle can be open, so only regions mapped by the
+     *   Ipc_CONTROLCMD_STARTCALLBACK of Ipc_control end up cached. For a
+     *   region added with SharedRegion_setEntry, the bit states how the
+     *   caller mapped it. Only regions 0 to 31 can be cached. The default
+     *   is 0 (all regions uncached).
+     */
 } SharedRegion_Config;
 
 /*!
@@ -242,6 +260,60 @@ _SharedRegion_setRegions (Void);
 Int
 _SharedRegion_clearRegions (Void);
 
+/*!
+ *  @brief      Writes back and invalidates a block in a region that is mapped
+ *              cached, before it is handed over to another processor.
+ *              Does nothing for uncached regions. On failure the block must
+ *              not be handed over, since its data may still be in the cache.
+ *
+ *  @param      addr    Local address of the block
+ *  @param      size    Size of the block
+ *
+ *  @retval     SharedRegion_S_SUCCESS  Block written back, or not cached
+ *  @retval     SharedRegion_E_FAIL     Cache maintenance failed
+ */
+Int
+_SharedRegion_cacheWbInv (Ptr addr, SizeT size);
+
+/*!
+ *  @brief      Invalidates a block in a region that is mapped cached, after
+ *              it is received from another processor. Does nothing for
+ *              uncached regions. On failure the block contents must not be
+ *              used.
+ *
+ *  @param      addr    Local address of the block
+ *  @param      size    Size of the block
+ *
+ *  @retval     SharedRegion_S_SUCCESS  Block invalidated, or not cached
+ *  @retval     SharedRegion_E_FAIL     Cache maintenance failed
+ */
+Int
+_SharedRegion_cacheInv (Ptr addr, SizeT size);
+
+/*!
+ *  @brief      Tells whether a region is currently mapped cached, i.e. its
+ *              blocks get cache maintenance.
+ *
+ *  @param      id      Shared region id
+ *
+ *  @retval     TRUE    Region is mapped cached
+ *  @retval     FALSE   Region is not mapped cached
+ */
+Bool
+_SharedRegion_isCached (UInt16 id);
+
+/*!
+ *  @brief      Enables or disables the lock-free address translation in
+ *              SharedRegion_getId, SharedRegion_getPtr and
+ *              SharedRegion_getSRPtr. When disabled, lookups scan the region
+ *              table under the module gate. Enabled by default; meant for
+ *              comparing both paths.
+ *
+ *  @param      enable  TRUE to use the translation snapshot
+ */
+Void
+_SharedRegion_setLockFree (Bool enable);
+
 
 #if defined (__cplusplus)
 }
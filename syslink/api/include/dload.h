@@ -90,6 +90,8 @@ typedef struct
    Elf32_Word           gsymnum;         /* # global symbols                */
    char                *gstrtab;         /* Module's global symbol names    */
    Elf32_Word           gstrsz;          /* Size of global string table     */
+   Elf32_Word          *gsymhash;        /* gsymtab hash buckets + chains   */
+   Elf32_Word           gsymhash_nbucket;/* # buckets in gsymhash           */
    Array_List           loaded_segments; /* List of DLIMP_Loaded_Segment(s) */
    Array_List           dependencies;    /* List of dependent file handles  */
    BOOL                 direct_dependent_only;
@@ -146,6 +148,7 @@ typedef struct
                                        /* record.                            */
    struct Elf32_Sym    *symtab;        /* Elf Dynamic Symbol Table           */
    Elf32_Word           symnum;        /* # symbols in dynamic symbol table  */
+   Elf32_Word          *hashtab;       /* Elf symbol hash table (DT_HASH)    */
    Elf32_Word           gsymtab_offset;/* Offset into symbol table where     */
                                        /* global symbols start.              */
    Elf32_Word           gstrtab_offset;/* Offset into string table where     */
@@ -230,6 +233,13 @@ typedef struct
     /* Client token, passed in via DLOAD_create()                            */
     /*-----------------------------------------------------------------------*/
     void *                   client_handle;
+
+    /*-----------------------------------------------------------------------*/
+    /* Symbol resolution caches of the modules relocated by the load in      */
+    /* progress (see DLSYM_get_symbol_cache()).  Flushed when the load       */
+    /* completes and whenever a module is unloaded.                          */
+    /*-----------------------------------------------------------------------*/
+    struct DLSYM_Cache *     DLSYM_symbol_caches;
 } LOADER_OBJECT;
 
 
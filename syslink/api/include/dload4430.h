@@ -157,6 +157,18 @@
  */
 #define DLOAD_S_ALREADYEXISTS    DLOAD_MAKE_SUCCESS(4)
 
+/*!
+ *  @brief  Host mapping of a physical window of target memory
+ */
+typedef struct DLoad4430_MapWindow_tag {
+    UInt32                 physAddr;
+    /*!< Physical start address of the window */
+    UInt32                 size;
+    /*!< Size of the window in bytes */
+    UInt32                 virtAddr;
+    /*!< Host virtual address the window is mapped at */
+} DLoad4430_MapWindow;
+
 /*!
  *  @brief  DLoad instance object
  */
@@ -187,6 +199,17 @@ typedef struct DLoad4430_Object_tag {
 
     DLOAD_HANDLE     loaderHandle;
     /*!< Handle to loader-instance specific info used by dyn loader lib. */
+
+    DLoad4430_MapWindow *  mapWindows;
+    /*!< Cache of host mappings of target memory, kept until delete. */
+    UInt32                 numMapWindows;
+    /*!< Number of valid entries in mapWindows. */
+    UInt32                 maxMapWindows;
+    /*!< Number of entries allocated for mapWindows. */
+    UInt32                 mapRefCount;
+    /*!< Nesting count of DLIF_mapTable calls. */
+    Bool                   mapDrvOpen;
+    /*!< Indicates whether UsrUtilsDrv is held open for the mappings. */
 } DLoad4430_Object;
 
 
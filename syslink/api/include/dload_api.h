@@ -238,6 +238,18 @@ int32_t  DLIF_ftell(LOADER_FILE_DESC *stream);
 size_t   DLIF_fread(void *ptr, size_t size, size_t nmemb,
                     LOADER_FILE_DESC *stream);
 
+/*---------------------------------------------------------------------------*/
+/* DLIF_fview()                                                              */
+/*                                                                           */
+/*    Return a read-only host pointer to 'size' bytes of the file identified */
+/*    in the LOADER_FILE_DESC pointed to by 'stream', starting at 'offset'.  */
+/*    The pointer stays valid until the file is closed.  Returns NULL if the */
+/*    client cannot provide direct access, in which case the data must be    */
+/*    read with DLIF_fseek() and DLIF_fread().                               */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+const void *DLIF_fview(LOADER_FILE_DESC *stream, int32_t offset, size_t size);
+
 /*---------------------------------------------------------------------------*/
 /* DLIF_fclose()                                                             */
 /*                                                                           */
@@ -332,7 +344,6 @@ struct DLOAD_MEMORY_REQUEST
    uint32_t                     align;        /* align of trg memory block   */
 };
 
-#if 0
 /*---------------------------------------------------------------------------*/
 /* DLIF_mapTable()                                                           */
 /*                                                                           */
@@ -349,7 +360,15 @@ void     DLIF_mapTable(void* client_handle);
 /*                                                                           */
 /*---------------------------------------------------------------------------*/
 void     DLIF_unMapTable(void* client_handle);
-#endif
+
+/*---------------------------------------------------------------------------*/
+/* DLIF_flushMapTable()                                                      */
+/*                                                                           */
+/*    Release all cached memory region mappings of the specified client      */
+/*    handle.  This should be called before the client handle is deleted.    */
+/*                                                                           */
+/*---------------------------------------------------------------------------*/
+void     DLIF_flushMapTable(void* client_handle);
 
 /*---------------------------------------------------------------------------*/
 /* DLIF_initMem()                                                            */
@@ -56,6 +56,20 @@ extern time_t DLREL_total_reloc_time;
 #endif
 
 
+/*---------------------------------------------------------------------------*/
+/* Relocations are partitioned by target segment and the partitions are run  */
+/* on up to DLREL_max_threads threads (at most DLREL_MAX_THREADS).  Passes   */
+/* with fewer than DLREL_MIN_PARALLEL_RELOCS relocations are run serially.   */
+/*---------------------------------------------------------------------------*/
+#define DLREL_MAX_THREADS           4
+#define DLREL_MIN_PARALLEL_RELOCS   256
+
+extern int32_t DLREL_max_threads;
+extern int32_t DLREL_forced_threads;
+
+void DLREL_run_tasks(int32_t num_tasks, uint32_t num_relocs,
+                     void (*task_fxn)(void *arg, int32_t task), void *arg);
+
 /*---------------------------------------------------------------------------*/
 /* Landing point for core loader's relocation processor.                     */
 /*---------------------------------------------------------------------------*/
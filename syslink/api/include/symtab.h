@@ -40,6 +40,7 @@
 #ifndef SYMTAB_H
 #define SYMTAB_H
 
+#include <pthread.h>
 #include "ArrayList.h"
 #include "dload.h"
 
@@ -72,4 +73,46 @@ void DLSYM_copy_globals(DLIMP_Dynamic_Module *dyn_module);
 BOOL DLSYM_lookup_global_symtab(const char *sym_name, struct Elf32_Sym *symtab,
                                 Elf32_Word symnum, Elf32_Addr *sym_value);
 
+BOOL DLSYM_lookup_loaded_module(const char          *sym_name,
+                                DLIMP_Loaded_Module *module,
+                                Elf32_Addr          *sym_value);
+
+/*---------------------------------------------------------------------------*/
+/* Symbol resolution cache.  Remembers the result of DLSYM_canonical_lookup  */
+/* for each symbol index of a module, so that all relocations referencing a  */
+/* symbol share one lookup.  Lookups through the cache may be made from      */
+/* several threads at once; misses are resolved under the cache lock.        */
+/*                                                                           */
+/* The loader object keeps one cache per module (keyed by file handle) for   */
+/* the duration of a load, see DLSYM_get_symbol_cache().                     */
+/*---------------------------------------------------------------------------*/
+typedef struct DLSYM_Cache
+{
+   pthread_mutex_t       lock;
+   DLIMP_Dynamic_Module *dyn_module;
+   int32_t               file_handle;
+   uint8_t              *state;      /* DLSYM_CACHE_* per symbol index      */
+   Elf32_Addr           *value;      /* Resolved value per symbol index     */
+   Elf32_Word            symnum;
+   uint32_t              lookups;    /* Statistics, kept under LOADER_DEBUG */
+   uint32_t              misses;
+   struct DLSYM_Cache   *next;
+} DLSYM_Cache;
+
+#define DLSYM_CACHE_EMPTY     0
+#define DLSYM_CACHE_RESOLVED  1
+#define DLSYM_CACHE_FAILED    2
+
+BOOL DLSYM_cache_init(DLSYM_Cache *cache, DLIMP_Dynamic_Module *dyn_module);
+
+void DLSYM_cache_destroy(DLSYM_Cache *cache);
+
+BOOL DLSYM_cached_lookup(DLOAD_HANDLE handle, DLSYM_Cache *cache,
+                         int32_t sym_index, Elf32_Addr *sym_value);
+
+DLSYM_Cache *DLSYM_get_symbol_cache(DLOAD_HANDLE handle,
+                                    DLIMP_Dynamic_Module *dyn_module);
+
+void DLSYM_flush_symbol_caches(DLOAD_HANDLE handle);
+
 #endif
@@ -50,6 +50,9 @@ extern int unit_arm_rel_overflow(ARM_RELOC_TYPE r_type, int32_t reloc_value);
 
 extern void unit_arm_rel_mask_for_group(ARM_RELOC_TYPE r_type,
                                         int32_t* reloc_val);
+
+extern int unit_arm_relocate_parallel_matches_serial(int32_t num_segs,
+                                                     int32_t relocs_per_seg);
 }
 
 
@@ -128,4 +131,21 @@ class ARM_TestGroupRelocations : public CxxTest::TestSuite
   public:
     void test_RelMaskForGroup();
 };
+
+class ARM_TestParallelRelocate : public CxxTest::TestSuite
+{
+  public:
+    void test_ParallelMatchesSerial()
+    {
+        TS_ASSERT(unit_arm_relocate_parallel_matches_serial(8, 1024));
+    }
+    void test_SmallPass()
+    {
+        TS_ASSERT(unit_arm_relocate_parallel_matches_serial(6, 16));
+    }
+    void test_SingleSegment()
+    {
+        TS_ASSERT(unit_arm_relocate_parallel_matches_serial(1, 512));
+    }
+};
 #endif /* _TEST_ARM_RELOC_H_ */
@@ -246,6 +246,23 @@ typedef struct HeapBufMP_Params {
      *  system gate for context protection.
      */
 
+    UInt magazineSize;
+    /*!< Number of blocks cached by each thread of the creating process
+     *
+     *  When non-zero, every thread that allocates or frees through the
+     *  created handle keeps a magazine of up to this many free blocks.
+     *  Allocations and frees are served from the magazine, which is refilled
+     *  from and drained to the heap half a magazine at a time, one kernel
+     *  call per batch.  Blocks held in magazines count as allocated in the
+     *  heap statistics and cannot be allocated by other threads or
+     *  processors, so the heap needs up to magazineSize spare blocks per
+     *  thread.  Only requests that fit within blockSize and align (and match
+     *  blockSize exactly for an #HeapBufMP_Params::exact heap) use the
+     *  magazine.
+     *
+     *  The default is 0 (no magazines).
+     */
+
 } HeapBufMP_Params;
 
 /*!
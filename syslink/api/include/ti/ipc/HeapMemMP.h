@@ -222,8 +222,67 @@ typedef struct HeapMemMP_Params {
      *  system gate for context protection.
      */
 
+    SizeT slabSize;
+    /*!< Size of the slabs backing the size-class front end
+     *
+     *  When non-zero, the creating process serves requests of up to
+     *  #HeapMemMP_MAXCLASSSIZE bytes from per-size-class free lists, without
+     *  a kernel call.  The lists are refilled by carving slabs of slabSize
+     *  bytes out of the heap, one class per slab.  Slabs stay with the
+     *  instance until it is deleted, so memory freed into a size class can
+     *  only be reused for that class.  Values below #HeapMemMP_MAXCLASSSIZE
+     *  disable the front end.
+     *
+     *  Blocks served by the size classes are only known to the creating
+     *  handle, so they must be freed through that handle in the creating
+     *  process.  Freeing them through an opened handle, from another process
+     *  or from a remote processor would corrupt the heap; an opened handle
+     *  in the creating process rejects them.
+     *
+     *  The default is 0 (no size classes).
+     */
+
 } HeapMemMP_Params;
 
+/*!
+ *  @brief  Number of size classes of the HeapMemMP front end
+ */
+#define HeapMemMP_NUMSIZECLASSES        5u
+
+/*!
+ *  @brief  Block size of the smallest size class; each class doubles it
+ */
+#define HeapMemMP_MINCLASSSIZE          16u
+
+/*!
+ *  @brief  Block size of the largest size class
+ */
+#define HeapMemMP_MAXCLASSSIZE          (HeapMemMP_MINCLASSSIZE <<            \
+                                         (HeapMemMP_NUMSIZECLASSES - 1u))
+
+/*!
+ *  @brief  Statistics of one size class of the HeapMemMP front end
+ */
+typedef struct HeapMemMP_SizeClassStats {
+    SizeT blockSize;
+    /*!< Size of the blocks of this class */
+
+    UInt  numAllocs;
+    /*!< Allocations served by this class */
+
+    UInt  numHits;
+    /*!< Allocations served from the free list without carving a new slab */
+
+    UInt  numBlocks;
+    /*!< Blocks carved for this class */
+
+    UInt  numFree;
+    /*!< Blocks of this class currently free */
+
+    SizeT wastedBytes;
+    /*!< Bytes lost to rounding up the blocks currently allocated */
+} HeapMemMP_SizeClassStats;
+
 /*!
  *  @brief  Stats structure for the HeapMemMP_getExtendedStats API.
  */
@@ -233,6 +292,17 @@ typedef struct HeapMemMP_ExtendedStats {
 
     SizeT size;
     /*!< Size of the shared buffer */
+
+    SizeT slabBytes;
+    /*!< Bytes of the heap held by size-class slabs (0 for a handle without
+     *   the size-class front end) */
+
+    SizeT fragmentedBytes;
+    /*!< Bytes of the slabs not available to other requests: free blocks
+     *   held in the size classes plus rounding waste */
+
+    HeapMemMP_SizeClassStats sizeClasses [HeapMemMP_NUMSIZECLASSES];
+    /*!< Per-size-class statistics */
 } HeapMemMP_ExtendedStats;
 
 /* =============================================================================
@@ -359,6 +429,10 @@ Void *HeapMemMP_alloc(HeapMemMP_Handle handle, SizeT size,
  *  #HeapMemMP_free will lock the heap using the HeapMemMP gate if one is
  *  specified or the system GateMP if not.
  *
+ *  Blocks of up to #HeapMemMP_MAXCLASSSIZE bytes allocated from an instance
+ *  created with a #HeapMemMP_Params::slabSize must be freed through the
+ *  creating handle, in the creating process.
+ *
  *  @param[in]  handle    Handle to previously created/opened instance.
  *  @param[in]  block     Block of memory to be freed.
  *  @param[in]  size      Size to be freed (in bytes)
@@ -367,6 +441,30 @@ Void *HeapMemMP_alloc(HeapMemMP_Handle handle, SizeT size,
  */
 Void HeapMemMP_free(HeapMemMP_Handle handle, Ptr block, SizeT size);
 
+/*!
+ *  @brief      Allocate several blocks of the same size and alignment
+ *
+ *  Blocks are requested from the heap in batches, one kernel call per batch,
+ *  or taken from the size-class front end when the
+ *  instance has one and the size fits.  Each block is freed individually
+ *  with #HeapMemMP_free.
+ *
+ *  @param[in]  handle     Handle to previously created/opened instance.
+ *  @param[in]  size       Size of each block (in bytes)
+ *  @param[in]  align      Alignment of each block (power of 2)
+ *  @param[out] blocks     Array receiving the allocated blocks
+ *  @param[in]  numBlocks  Number of blocks to allocate
+ *  @param[out] numAlloced Number of blocks actually allocated
+ *
+ *  @retval     HeapMemMP_S_SUCCESS   All blocks were allocated
+ *  @retval     HeapMemMP_E_MEMORY    The heap ran out of memory; the blocks
+ *                                    allocated so far are in @c blocks
+ *
+ *  @sa         HeapMemMP_alloc, HeapMemMP_free
+ */
+Int HeapMemMP_allocMany(HeapMemMP_Handle handle, SizeT size, SizeT align,
+                        Ptr blocks[], UInt numBlocks, UInt *numAlloced);
+
 /*!
  *  @brief      Get extended memory statistics
  *
@@ -625,6 +625,60 @@ Int MessageQ_get(MessageQ_Handle handle, MessageQ_Msg *msg, UInt timeout);
  */
 Int MessageQ_put(MessageQ_QueueId queueId, MessageQ_Msg msg);
 
+/*!
+ *  @brief      Place several messages onto a message queue
+ *
+ *  This call places @c numMsgs messages onto the specified message queue,
+ *  in array order, using one driver call per batch instead of one per
+ *  message. The ownership rules are the same as for #MessageQ_put.
+ *
+ *  If the call fails part-way, the messages that were placed onto the
+ *  queue are owned by the queue; the caller still owns the remaining
+ *  messages, starting at @c msgs[*numPut].
+ *
+ *  @param[in]  queueId     Destination MessageQ
+ *  @param[in]  msgs        Array of messages to be sent.
+ *  @param[in]  numMsgs     Number of entries in @c msgs
+ *  @param[out] numPut      Optional. Number of messages actually placed.
+ *
+ *  @return     Status of the call.
+ *              - #MessageQ_S_SUCCESS denotes success.
+ *              - #MessageQ_E_FAIL denotes failure. Not all messages were put.
+ *
+ *  @sa         MessageQ_put, MessageQ_getMany
+ */
+Int MessageQ_putMany(MessageQ_QueueId queueId, MessageQ_Msg *msgs,
+                     UInt numMsgs, UInt *numPut);
+
+/*!
+ *  @brief      Gets several messages from a message queue
+ *
+ *  Waits up to @c timeout for the first message, exactly like
+ *  #MessageQ_get, and then returns every message that is already on the
+ *  queue, up to @c maxMsgs, without blocking again. All messages are
+ *  fetched with one driver call per batch.
+ *
+ *  @param[in]  handle      MessageQ handle
+ *  @param[out] msgs        Array filled in with the received messages
+ *  @param[in]  maxMsgs     Number of entries in @c msgs
+ *  @param[out] numMsgs     Number of messages returned in @c msgs
+ *  @param[in]  timeout     Maximum duration to wait for the first message
+ *                          in microseconds.
+ *
+ *  @return     Status of the call.
+ *              - #MessageQ_S_SUCCESS denotes at least one message was
+ *                received.
+ *              - #MessageQ_E_TIMEOUT denotes no message arrived in time.
+ *              - #MessageQ_E_UNBLOCKED denotes the queue was unblocked.
+ *              - #MessageQ_E_FAIL denotes a received message could not be
+ *                cache invalidated and was freed. The @c *numMsgs messages
+ *                in @c msgs are still valid and owned by the caller.
+ *
+ *  @sa         MessageQ_get, MessageQ_putMany
+ */
+Int MessageQ_getMany(MessageQ_Handle handle, MessageQ_Msg *msgs,
+                     UInt maxMsgs, UInt *numMsgs, UInt timeout);
+
 /*!
  *  @brief      Register a heap with MessageQ
  *
@@ -470,6 +470,49 @@ Int Notify_sendEvent(UInt16 procId,
                      UInt32 payload,
                      Bool waitClear);
 
+/*!
+ *  @brief      Send a sequence of payloads to a remote processor's event
+ *
+ *  Equivalent to calling #Notify_sendEvent with waitClear TRUE for each
+ *  payload in turn, but done in a single call into the driver.
+ *
+ *  With 'coalesce' TRUE, a payload that would otherwise have to wait for
+ *  the remote processor to clear the previous one replaces the pending
+ *  payload instead, so back-to-back payloads are merged into one
+ *  interrupt and the remote processor only sees the latest value. This
+ *  suits streaming control traffic where intermediate values may be
+ *  dropped.
+ *
+ *  @param[in]  procId      Remote processor id
+ *  @param[in]  lineId      Line id
+ *  @param[in]  eventId     Event id
+ *  @param[in]  payloads    Payloads to send, in order
+ *  @param[in]  numPayloads Number of entries in payloads
+ *  @param[in]  coalesce    Merge payloads the remote has not yet cleared
+ *  @param[out] numSent     Number of interrupts raised, also when an error
+ *                          is returned. Without coalesce this is the number
+ *                          of leading payloads that were sent. May be NULL.
+ *
+ *  @return     Notify status:
+ *              - #Notify_E_INVALIDARG: invalid payloads or numPayloads
+ *              - #Notify_E_EVTNOTREGISTERED: event has no registered callback
+ *                functions
+ *              - #Notify_E_NOTINITIALIZED: remote driver has not yet been
+ *                initialized
+ *              - #Notify_E_EVTDISABLED: remote event is disabled
+ *              - #Notify_E_TIMEOUT: timeout occured
+ *              - #Notify_S_SUCCESS: all payloads successfully sent
+ *
+ *  @sa         Notify_sendEvent
+ */
+Int Notify_sendEvents(UInt16 procId,
+                      UInt16 lineId,
+                      UInt32 eventId,
+                      UInt32 payloads[],
+                      UInt32 numPayloads,
+                      Bool coalesce,
+                      UInt32 *numSent);
+
 /*!
  *  @brief      Creates notify drivers and registers them with Notify
  *
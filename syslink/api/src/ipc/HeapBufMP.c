@@ -81,8 +81,13 @@
 #include <HeapBufMPDrvDefs.h>
 #include <ti/ipc/ListMP.h>
 #include <ti/ipc/SharedRegion.h>
+#include <_SharedRegion.h>
 #include <_GateMP.h>
 
+/* OS-specific headers */
+#include <pthread.h>
+#include <errno.h>
+
 
 #if defined (__cplusplus)
 extern "C" {
@@ -108,8 +113,36 @@ extern "C" {
 typedef struct HeapBufMP_Obj_tag {
     Ptr         knlObject;
     /*!< Pointer to the kernel-side HeapBufMP object. */
+    UInt        magazineSize;
+    /*!< Blocks per thread magazine, 0 if magazines are not used. */
+    UInt32      blockSize;
+    /*!< Block size the heap was created with. */
+    UInt32      align;
+    /*!< Alignment the heap was created with. */
+    Bool        exact;
+    /*!< Whether the heap only serves requests of exactly blockSize. */
+    pthread_key_t magazineKey;
+    /*!< Key of the calling thread's magazine. */
+    pthread_mutex_t magazineLock;
+    /*!< Protects the list of magazines. */
+    struct HeapBufMP_Magazine_tag * magazines;
+    /*!< Magazines of all threads, so that they can be drained on delete. */
 } HeapBufMP_Obj;
 
+/*!
+ *  @brief  Per-thread cache of free blocks of a HeapBufMP instance
+ */
+typedef struct HeapBufMP_Magazine_tag {
+    HeapBufMP_Obj *                 obj;
+    /*!< Instance the blocks belong to. */
+    struct HeapBufMP_Magazine_tag * next;
+    /*!< Next magazine of the instance. */
+    UInt                            count;
+    /*!< Number of blocks currently in the magazine. */
+    Ptr                             blocks [1];
+    /*!< magazineSize block pointers. */
+} HeapBufMP_Magazine;
+
 /*!
  *  @brief  Structure for HeapBufMP module state
  */
@@ -118,6 +151,12 @@ typedef struct HeapBufMP_ModuleObject_tag {
     /*!< Reference count for number of times setup/destroy were called in this
      *   process.
      */
+    Bool                batchSupported;
+    /*!< Whether the driver accepts the ALLOCMANY/FREEMANY commands. Cleared
+     *   the first time the driver rejects a batched command as unknown
+     *   (ENOTTY), after which magazines are refilled and drained one block
+     *   per command.
+     */
 } HeapBufMP_ModuleObject;
 
 
@@ -135,7 +174,8 @@ static
 #endif /* if !defined(SYSLINK_BUILD_DEBUG) */
 HeapBufMP_ModuleObject HeapBufMP_state =
 {
-    .setupRefCount = 0
+    .setupRefCount  = 0,
+    .batchSupported = TRUE
 };
 
 
@@ -157,6 +197,24 @@ _HeapBufMP_create (HeapBufMP_Handle       * heapHandle,
                    HeapBufMPDrv_CmdArgs     cmdArgs,
                    Bool                     createFlag);
 
+static Void _HeapBufMP_initMagazines (HeapBufMP_Obj          * obj,
+                                      const HeapBufMP_Params * params);
+
+static Void _HeapBufMP_destroyMagazines (HeapBufMP_Obj * obj);
+
+static HeapBufMP_Magazine * _HeapBufMP_getMagazine (HeapBufMP_Obj * obj,
+                                                    UInt32          size,
+                                                    UInt32          align);
+
+static Ptr _HeapBufMP_magazineAlloc (HeapBufMP_Magazine * magazine);
+
+static Void _HeapBufMP_releaseBlock (HeapBufMP_Obj * obj,
+                                     Ptr             block,
+                                     UInt32          size);
+
+static Void _HeapBufMP_magazineFree (HeapBufMP_Magazine * magazine,
+                                     Ptr                  block);
+
 
 
 /* =============================================================================
@@ -395,6 +453,9 @@ HeapBufMP_Params_init (HeapBufMP_Params       * params)
         status =
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_PARAMS_INIT, &cmdArgs);
+
+        /* Magazines are a user-side feature, unknown to the driver. */
+        params->magazineSize = 0;
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         if (status < 0) {
             GT_setFailureReason (curTrace,
@@ -500,6 +561,15 @@ HeapBufMP_create (const HeapBufMP_Params * params)
                                      status,
                                      "Heap creation failed on user-side!");
             }
+            else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+                if (params->magazineSize > 0) {
+                    _HeapBufMP_initMagazines ((HeapBufMP_Obj *)
+                                      ((HeapBufMP_Object *) handle)->obj,
+                                      params);
+                }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
         }
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
@@ -553,6 +623,7 @@ HeapBufMP_delete (HeapBufMP_Handle * hpHandle)
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (HeapBufMP_Obj *) (((HeapBufMP_Object *) (*hpHandle))->obj);
+        _HeapBufMP_destroyMagazines (obj);
         cmdArgs.args.deleteInstance.handle = obj->knlObject;
         status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_DELETE, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -790,6 +861,7 @@ HeapBufMP_close (HeapBufMP_Handle * hpHandle)
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (HeapBufMP_Obj *) (((HeapBufMP_Object *) (*hpHandle))->obj);
+        _HeapBufMP_destroyMagazines (obj);
         cmdArgs.args.close.handle = obj->knlObject;
         status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_CLOSE, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -829,6 +901,8 @@ HeapBufMP_alloc (HeapBufMP_Handle   hpHandle,
     Char           *    block      = NULL;
     SharedRegion_SRPtr  blockSrPtr = SharedRegion_INVALIDSRPTR;
     HeapBufMPDrv_CmdArgs  cmdArgs;
+    HeapBufMP_Obj *       obj;
+    HeapBufMP_Magazine *  magazine;
 
     GT_3trace (curTrace, GT_ENTER, "HeapBufMP_alloc", hpHandle, size, align);
 
@@ -852,28 +926,40 @@ HeapBufMP_alloc (HeapBufMP_Handle   hpHandle,
     }
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        cmdArgs.args.alloc.handle =
-            ((HeapBufMP_Obj *) ((HeapBufMP_Object *) hpHandle)->obj)->knlObject;
-        cmdArgs.args.alloc.size   = size;
-        cmdArgs.args.alloc.align  = align;
+        obj = (HeapBufMP_Obj *) ((HeapBufMP_Object *) hpHandle)->obj;
+        magazine = _HeapBufMP_getMagazine (obj, size, align);
+        if (magazine != NULL) {
+            block = _HeapBufMP_magazineAlloc (magazine);
+        }
+        else {
+            cmdArgs.args.alloc.handle = obj->knlObject;
+            cmdArgs.args.alloc.size   = size;
+            cmdArgs.args.alloc.align  = align;
 
-        status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_ALLOC, &cmdArgs);
+            status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_ALLOC, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
                                  GT_4CLASS,
                                  "HeapBufMP_alloc",
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
-        }
-        else {
-#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            blockSrPtr = cmdArgs.args.alloc.blockSrPtr;
-            if (blockSrPtr != SharedRegion_INVALIDSRPTR) {
-                block = SharedRegion_getPtr (blockSrPtr);
             }
+            else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+                blockSrPtr = cmdArgs.args.alloc.blockSrPtr;
+                if (blockSrPtr != SharedRegion_INVALIDSRPTR) {
+                    block = SharedRegion_getPtr (blockSrPtr);
+                    if (_SharedRegion_cacheInv (block, size) < 0) {
+                        _HeapBufMP_releaseBlock (obj, block, size);
+                        block = NULL;
+                    }
+                }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -894,6 +980,8 @@ HeapBufMP_free (HeapBufMP_Handle   hpHandle,
     Int                   status = HeapBufMP_S_SUCCESS;
     HeapBufMPDrv_CmdArgs  cmdArgs;
     UInt16                index;
+    HeapBufMP_Obj *       obj;
+    HeapBufMP_Magazine *  magazine;
 
     GT_3trace (curTrace, GT_ENTER, "HeapBufMP_free", hpHandle, block, size);
 
@@ -927,23 +1015,36 @@ HeapBufMP_free (HeapBufMP_Handle   hpHandle,
     }
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        cmdArgs.args.free.handle =
-            ((HeapBufMP_Obj *) ((HeapBufMP_Object *) hpHandle)->obj)->knlObject;
-        cmdArgs.args.free.size   = size;
+        obj = (HeapBufMP_Obj *) ((HeapBufMP_Object *) hpHandle)->obj;
+        magazine = _HeapBufMP_getMagazine (obj, size, 0);
+        if (magazine != NULL) {
+            _HeapBufMP_magazineFree (magazine, block);
+        }
+        else if (_SharedRegion_cacheWbInv (block, size) < 0) {
+            /* Its data may still be in the cache, so the block is kept. */
+            status = HeapBufMP_E_FAIL;
+        }
+        else {
+            cmdArgs.args.free.handle = obj->knlObject;
+            cmdArgs.args.free.size   = size;
 
-        /* Translate to SrPtr. */
-        index = SharedRegion_getId (block);
-        cmdArgs.args.free.blockSrPtr = SharedRegion_getSRPtr (block, index);
+            /* Translate to SrPtr. */
+            index = SharedRegion_getId (block);
+            cmdArgs.args.free.blockSrPtr = SharedRegion_getSRPtr (block,
+                                                                  index);
 
-        status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_FREE, &cmdArgs);
+            status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_FREE, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
                                  GT_4CLASS,
                                  "HeapBufMP_free",
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1299,6 +1400,378 @@ _HeapBufMP_create (HeapBufMP_Handle     * heapHandle,
 }
 
 
+/*
+ *  Allocates up to numBlocks blocks of the heap's block size, one command per
+ *  batch. Returns the number of blocks allocated, which is less than
+ *  numBlocks when the heap runs out of blocks.
+ */
+static UInt
+_HeapBufMP_allocBlocks (HeapBufMP_Obj * obj, Ptr * blocks, UInt numBlocks)
+{
+    Int32                 status;
+    UInt                  done = 0;
+    UInt                  i;
+    UInt                  n;
+    SharedRegion_SRPtr    blockSrPtrs [HEAPBUFMP_MAXBATCH];
+    HeapBufMPDrv_CmdArgs  cmdArgs;
+
+    GT_assert (curTrace, (numBlocks <= HEAPBUFMP_MAXBATCH));
+
+    if (HeapBufMP_module->batchSupported == TRUE) {
+        cmdArgs.args.allocMany.handle      = obj->knlObject;
+        cmdArgs.args.allocMany.size        = obj->blockSize;
+        cmdArgs.args.allocMany.align       = obj->align;
+        cmdArgs.args.allocMany.blockSrPtrs = blockSrPtrs;
+        cmdArgs.args.allocMany.numBlocks   = numBlocks;
+        cmdArgs.args.allocMany.numAlloced  = 0;
+
+        status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_ALLOCMANY, &cmdArgs);
+        if ((status == HeapBufMP_E_OSFAILURE) && (errno == ENOTTY)) {
+            /* Driver predates the batched commands; nothing was allocated. */
+            HeapBufMP_module->batchSupported = FALSE;
+        }
+        else {
+            /* numAlloced is only copied back when the command succeeded. */
+            if (status >= 0) {
+                done = cmdArgs.args.allocMany.numAlloced;
+            }
+            /* Blocks that cannot be invalidated go straight back. */
+            for (i = 0, n = 0; i < done; i++) {
+                blocks [n] = SharedRegion_getPtr (blockSrPtrs [i]);
+                if (_SharedRegion_cacheInv (blocks [n], obj->blockSize) < 0) {
+                    _HeapBufMP_releaseBlock (obj, blocks [n], obj->blockSize);
+                }
+                else {
+                    n++;
+                }
+            }
+            return n;
+        }
+    }
+
+    while (done < numBlocks) {
+        cmdArgs.args.alloc.handle = obj->knlObject;
+        cmdArgs.args.alloc.size   = obj->blockSize;
+        cmdArgs.args.alloc.align  = obj->align;
+
+        status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_ALLOC, &cmdArgs);
+        if (    (status < 0)
+            ||  (cmdArgs.args.alloc.blockSrPtr == SharedRegion_INVALIDSRPTR)) {
+            break;
+        }
+        blocks [done] = SharedRegion_getPtr (cmdArgs.args.alloc.blockSrPtr);
+        if (_SharedRegion_cacheInv (blocks [done], obj->blockSize) < 0) {
+            _HeapBufMP_releaseBlock (obj, blocks [done], obj->blockSize);
+            break;
+        }
+        done++;
+    }
+
+    return done;
+}
+
+
+/*
+ *  Gives a block that was just allocated back to the heap when it cannot be
+ *  invalidated. The block was not written to, so it needs no write back.
+ */
+static Void
+_HeapBufMP_releaseBlock (HeapBufMP_Obj * obj, Ptr block, UInt32 size)
+{
+    HeapBufMPDrv_CmdArgs  cmdArgs;
+    UInt16                index;
+
+    index = SharedRegion_getId (block);
+    cmdArgs.args.free.handle     = obj->knlObject;
+    cmdArgs.args.free.size       = size;
+    cmdArgs.args.free.blockSrPtr = SharedRegion_getSRPtr (block, index);
+
+    HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_FREE, &cmdArgs);
+}
+
+
+/*
+ *  Returns numBlocks blocks to the heap, one command per batch. Returns the
+ *  number of blocks freed. Blocks the driver did not take back are not
+ *  resent, since the driver may have freed them without reporting it.
+ *  Blocks that cannot be written back are kept out of the heap, since their
+ *  data may still be in the cache.
+ */
+static UInt
+_HeapBufMP_freeBlocks (HeapBufMP_Obj * obj, Ptr * blocks, UInt numBlocks)
+{
+    Int32                 status;
+    UInt                  done = 0;
+    UInt                  i;
+    UInt                  n    = 0;
+    UInt16                index;
+    SharedRegion_SRPtr    blockSrPtrs [HEAPBUFMP_MAXBATCH];
+    HeapBufMPDrv_CmdArgs  cmdArgs;
+
+    GT_assert (curTrace, (numBlocks <= HEAPBUFMP_MAXBATCH));
+
+    for (i = 0; i < numBlocks; i++) {
+        if (_SharedRegion_cacheWbInv (blocks [i], obj->blockSize) >= 0) {
+            index = SharedRegion_getId (blocks [i]);
+            blockSrPtrs [n++] = SharedRegion_getSRPtr (blocks [i], index);
+        }
+    }
+
+    if (HeapBufMP_module->batchSupported == TRUE) {
+        cmdArgs.args.freeMany.handle      = obj->knlObject;
+        cmdArgs.args.freeMany.size        = obj->blockSize;
+        cmdArgs.args.freeMany.blockSrPtrs = blockSrPtrs;
+        cmdArgs.args.freeMany.numBlocks   = n;
+        cmdArgs.args.freeMany.numFreed    = 0;
+
+        status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_FREEMANY, &cmdArgs);
+        if ((status != HeapBufMP_E_OSFAILURE) || (errno != ENOTTY)) {
+            /* numFreed is only copied back when the command succeeded. */
+            if (status >= 0) {
+                done = cmdArgs.args.freeMany.numFreed;
+            }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+            else {
+                GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_HeapBufMP_freeBlocks",
+                                 status,
+                                 "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+            return done;
+        }
+
+        /* Driver predates the batched commands; nothing was freed. */
+        HeapBufMP_module->batchSupported = FALSE;
+    }
+
+    for (i = 0; i < n; i++) {
+        cmdArgs.args.free.handle     = obj->knlObject;
+        cmdArgs.args.free.size       = obj->blockSize;
+        cmdArgs.args.free.blockSrPtr = blockSrPtrs [i];
+
+        status = HeapBufMPDrv_ioctl (CMD_HEAPBUFMP_FREE, &cmdArgs);
+        if (status >= 0) {
+            done++;
+        }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+        else {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_HeapBufMP_freeBlocks",
+                                 status,
+                                 "API (through IOCTL) failed on kernel-side!");
+        }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+    }
+
+    return done;
+}
+
+
+/*
+ *  Number of blocks moved between a magazine and the heap at a time.
+ */
+static inline UInt
+_HeapBufMP_magazineBatch (HeapBufMP_Obj * obj)
+{
+    UInt batch = (obj->magazineSize + 1u) / 2u;
+
+    return (batch > HEAPBUFMP_MAXBATCH) ? HEAPBUFMP_MAXBATCH : batch;
+}
+
+
+/*
+ *  Returns all blocks of a magazine to the heap. The magazine must not be in
+ *  use by its thread.
+ */
+static Void
+_HeapBufMP_drainMagazine (HeapBufMP_Magazine * magazine)
+{
+    UInt batch;
+
+    while (magazine->count > 0) {
+        batch = magazine->count;
+        if (batch > HEAPBUFMP_MAXBATCH) {
+            batch = HEAPBUFMP_MAXBATCH;
+        }
+        magazine->count -= batch;
+        _HeapBufMP_freeBlocks (magazine->obj,
+                               &magazine->blocks [magazine->count],
+                               batch);
+    }
+}
+
+
+/*
+ *  Thread-exit destructor of a magazine: returns its blocks to the heap.
+ */
+static Void
+_HeapBufMP_releaseMagazine (Ptr arg)
+{
+    HeapBufMP_Magazine *  magazine = (HeapBufMP_Magazine *) arg;
+    HeapBufMP_Obj *       obj      = magazine->obj;
+    HeapBufMP_Magazine ** prev;
+
+    pthread_mutex_lock (&obj->magazineLock);
+    for (prev = &obj->magazines; *prev != NULL; prev = &(*prev)->next) {
+        if (*prev == magazine) {
+            *prev = magazine->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock (&obj->magazineLock);
+
+    _HeapBufMP_drainMagazine (magazine);
+    Memory_free (NULL,
+                 magazine,
+                 sizeof (HeapBufMP_Magazine)
+                 + (obj->magazineSize - 1u) * sizeof (Ptr));
+}
+
+
+/*
+ *  Enables per-thread magazines for a newly created instance. Magazines are
+ *  an optimization only, so a failure leaves the instance without them.
+ */
+static Void
+_HeapBufMP_initMagazines (HeapBufMP_Obj          * obj,
+                          const HeapBufMP_Params * params)
+{
+    if (pthread_key_create (&obj->magazineKey, _HeapBufMP_releaseMagazine)
+        != 0) {
+        GT_0trace (curTrace,
+                   GT_4CLASS,
+                   "_HeapBufMP_initMagazines: pthread_key_create failed, "
+                   "magazines disabled");
+        return;
+    }
+
+    pthread_mutex_init (&obj->magazineLock, NULL);
+    obj->magazines    = NULL;
+    obj->blockSize    = params->blockSize;
+    obj->align        = params->align;
+    obj->exact        = params->exact;
+    obj->magazineSize = params->magazineSize;
+}
+
+
+/*
+ *  Returns the blocks in all magazines of an instance to the heap and frees
+ *  the magazines. Called before the instance is deleted or closed.
+ */
+static Void
+_HeapBufMP_destroyMagazines (HeapBufMP_Obj * obj)
+{
+    HeapBufMP_Magazine * magazine;
+
+    if (obj->magazineSize == 0) {
+        return;
+    }
+
+    /* Deleting the key keeps exiting threads from running the destructor. */
+    pthread_key_delete (obj->magazineKey);
+
+    pthread_mutex_lock (&obj->magazineLock);
+    while (obj->magazines != NULL) {
+        magazine = obj->magazines;
+        obj->magazines = magazine->next;
+        _HeapBufMP_drainMagazine (magazine);
+        Memory_free (NULL,
+                     magazine,
+                     sizeof (HeapBufMP_Magazine)
+                     + (obj->magazineSize - 1u) * sizeof (Ptr));
+    }
+    pthread_mutex_unlock (&obj->magazineLock);
+
+    pthread_mutex_destroy (&obj->magazineLock);
+    obj->magazineSize = 0;
+}
+
+
+/*
+ *  Returns the calling thread's magazine if the request can be served from
+ *  it, creating the magazine on first use. Returns NULL when the request has
+ *  to go to the heap directly.
+ */
+static HeapBufMP_Magazine *
+_HeapBufMP_getMagazine (HeapBufMP_Obj * obj, UInt32 size, UInt32 align)
+{
+    HeapBufMP_Magazine * magazine;
+
+    if (    (obj->magazineSize == 0)
+        ||  (size > obj->blockSize)
+        ||  (align > obj->align)
+        ||  ((obj->exact == TRUE) && (size != obj->blockSize))) {
+        return NULL;
+    }
+
+    magazine = (HeapBufMP_Magazine *) pthread_getspecific (obj->magazineKey);
+    if (magazine == NULL) {
+        magazine = (HeapBufMP_Magazine *) Memory_alloc (NULL,
+                                      sizeof (HeapBufMP_Magazine)
+                                      + (obj->magazineSize - 1u) * sizeof (Ptr),
+                                      0);
+        if (magazine == NULL) {
+            return NULL;
+        }
+        magazine->obj   = obj;
+        magazine->count = 0;
+
+        pthread_mutex_lock (&obj->magazineLock);
+        magazine->next = obj->magazines;
+        obj->magazines = magazine;
+        pthread_mutex_unlock (&obj->magazineLock);
+
+        pthread_setspecific (obj->magazineKey, magazine);
+    }
+
+    return magazine;
+}
+
+
+/*
+ *  Takes a block from a magazine, refilling it from the heap when empty.
+ *  Returns NULL if the heap has no free blocks left.
+ */
+static Ptr
+_HeapBufMP_magazineAlloc (HeapBufMP_Magazine * magazine)
+{
+    if (magazine->count == 0) {
+        magazine->count = _HeapBufMP_allocBlocks (magazine->obj,
+                              magazine->blocks,
+                              _HeapBufMP_magazineBatch (magazine->obj));
+        if (magazine->count == 0) {
+            return NULL;
+        }
+    }
+
+    return magazine->blocks [--magazine->count];
+}
+
+
+/*
+ *  Puts a block into a magazine, returning a batch of blocks to the heap
+ *  first when the magazine is full.
+ */
+static Void
+_HeapBufMP_magazineFree (HeapBufMP_Magazine * magazine, Ptr block)
+{
+    UInt batch;
+
+    if (magazine->count == magazine->obj->magazineSize) {
+        batch = _HeapBufMP_magazineBatch (magazine->obj);
+        magazine->count -= batch;
+        _HeapBufMP_freeBlocks (magazine->obj,
+                               &magazine->blocks [magazine->count],
+                               batch);
+    }
+
+    magazine->blocks [magazine->count++] = block;
+}
+
+
 #if defined (__cplusplus)
 }
 #endif /* defined (__cplusplus) */
@@ -208,6 +208,7 @@ HeapBufMPDrv_ioctl (UInt32 cmd, Ptr args)
 {
     Int status      = HeapBufMP_S_SUCCESS;
     int osStatus    = 0;
+    int osErrno     = 0;
 
     GT_2trace (curTrace, GT_ENTER, "HeapBufMPDrv_ioctl", cmd, args);
 
@@ -218,6 +219,7 @@ HeapBufMPDrv_ioctl (UInt32 cmd, Ptr args)
     } while( (osStatus < 0) && (errno == EINTR) );
 
     if (osStatus < 0) {
+        osErrno = errno;
         /*! @retval HeapBufMP_E_OSFAILURE Driver ioctl failed */
         status = HeapBufMP_E_OSFAILURE;
         GT_setFailureReason (curTrace,
@@ -233,6 +235,11 @@ HeapBufMPDrv_ioctl (UInt32 cmd, Ptr args)
 
     GT_1trace (curTrace, GT_LEAVE, "HeapBufMPDrv_ioctl", status);
 
+    if (osStatus < 0) {
+        /* Left in errno so that callers can tell an unknown command apart. */
+        errno = osErrno;
+    }
+
     /*! @retval HeapBufMP_S_SUCCESS Operation successfully completed. */
     return status;
 }
@@ -81,6 +81,11 @@
 #include <HeapMemMPDrvDefs.h>
 #include <ti/ipc/ListMP.h>
 #include <ti/ipc/SharedRegion.h>
+#include <_SharedRegion.h>
+
+/* OS-specific headers */
+#include <pthread.h>
+#include <errno.h>
 
 
 #if defined (__cplusplus)
@@ -98,12 +103,54 @@ extern "C" {
 #define HEAPMEMMP_CACHESIZE              128u
 
 
+/*!
+ *  @brief  Free list and counters of one size class
+ */
+typedef struct HeapMemMP_SizeClass_tag {
+    Ptr         freeList;
+    /*!< Free blocks, linked through their first word. */
+    UInt        numAllocs;
+    /*!< Allocations served by the class. */
+    UInt        numHits;
+    /*!< Allocations served without carving a new slab. */
+    UInt        numBlocks;
+    /*!< Blocks carved for the class. */
+    UInt        numFree;
+    /*!< Blocks on the free list. */
+    SizeT       requestedBytes;
+    /*!< Bytes requested for the blocks currently allocated. */
+} HeapMemMP_SizeClass;
+
+/*!
+ *  @brief  Slab carved into blocks of one size class
+ */
+typedef struct HeapMemMP_Slab_tag {
+    Char *      base;
+    /*!< Local address of the slab. */
+    UInt        sizeClass;
+    /*!< Size class the slab is carved for. */
+} HeapMemMP_Slab;
+
 /*!
  *  @brief  Structure defining object for the HeapMemMP
  */
 typedef struct HeapMemMP_Obj_tag {
     Ptr         knlObject;
     /*!< Pointer to the kernel-side HeapMemMP object. */
+    SizeT       slabSize;
+    /*!< Size of a size-class slab, 0 if size classes are not used. */
+    pthread_mutex_t sizeClassLock;
+    /*!< Protects the size classes and the slab table. */
+    HeapMemMP_SizeClass sizeClasses [HeapMemMP_NUMSIZECLASSES];
+    /*!< Size classes, smallest first. */
+    HeapMemMP_Slab * slabs;
+    /*!< Slabs of all size classes, sorted by base address. */
+    UInt        numSlabs;
+    /*!< Number of entries used in slabs. */
+    UInt        maxSlabs;
+    /*!< Number of entries allocated in slabs. */
+    struct HeapMemMP_Obj_tag * nextOwner;
+    /*!< Next instance of this process that owns slabs. */
 } HeapMemMP_Obj;
 
 /*!
@@ -114,6 +161,15 @@ typedef struct HeapMemMP_ModuleObject_tag {
     /*!< Reference count for number of times setup/destroy were called in this
      *   process.
      */
+    Bool                batchSupported;
+    /*!< Whether the driver accepts the ALLOCMANY command. Cleared the first
+     *   time the driver rejects it as unknown (ENOTTY), after which
+     *   HeapMemMP_allocMany allocates one block per command.
+     */
+    pthread_mutex_t     ownersLock;
+    /*!< Protects slabOwners. */
+    HeapMemMP_Obj *     slabOwners;
+    /*!< Instances of this process that have size classes enabled. */
 } HeapMemMP_ModuleObject;
 
 
@@ -131,7 +187,10 @@ static
 #endif /* if !defined(SYSLINK_BUILD_DEBUG) */
 HeapMemMP_ModuleObject HeapMemMP_state =
 {
-    .setupRefCount = 0
+    .setupRefCount  = 0,
+    .batchSupported = TRUE,
+    .ownersLock     = PTHREAD_MUTEX_INITIALIZER,
+    .slabOwners     = NULL
 };
 
 
@@ -144,6 +203,43 @@ _HeapMemMP_create (HeapMemMP_Handle       * heapHandle,
                    HeapMemMPDrv_CmdArgs     cmdArgs,
                    Bool                     createFlag);
 
+static Void _HeapMemMP_initSizeClasses (HeapMemMP_Obj          * obj,
+                                        const HeapMemMP_Params * params);
+
+static Void _HeapMemMP_destroySizeClasses (HeapMemMP_Obj * obj);
+
+static Void _HeapMemMP_resetSizeClasses (HeapMemMP_Obj * obj,
+                                         Bool            freeSlabs);
+
+static Int _HeapMemMP_getSizeClass (HeapMemMP_Obj * obj,
+                                    UInt32          size,
+                                    UInt32          align);
+
+static UInt _HeapMemMP_sizeClassAlloc (HeapMemMP_Obj * obj,
+                                       Int             sizeClass,
+                                       UInt32          size,
+                                       Ptr           * blocks,
+                                       UInt            numBlocks);
+
+static Bool _HeapMemMP_sizeClassFree (HeapMemMP_Obj * obj,
+                                      Ptr             block,
+                                      UInt32          size);
+
+static Bool _HeapMemMP_isOwnerSlabBlock (HeapMemMP_Obj * obj, Ptr block);
+
+static Void _HeapMemMP_releaseBlock (HeapMemMP_Obj * obj,
+                                     Ptr             block,
+                                     UInt32          size);
+
+static UInt _HeapMemMP_allocBlocks (HeapMemMP_Obj * obj,
+                                    UInt32          size,
+                                    UInt32          align,
+                                    Ptr           * blocks,
+                                    UInt            numBlocks);
+
+static Void _HeapMemMP_getSizeClassStats (HeapMemMP_Obj           * obj,
+                                          HeapMemMP_ExtendedStats * stats);
+
 
 
 /* =============================================================================
@@ -397,6 +493,9 @@ HeapMemMP_Params_init (HeapMemMP_Params       * params)
         status =
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_PARAMS_INIT, &cmdArgs);
+
+        /* Size classes are a user-side feature, unknown to the driver. */
+        params->slabSize = 0;
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         if (status < 0) {
             GT_setFailureReason (curTrace,
@@ -515,6 +614,13 @@ HeapMemMP_create (const HeapMemMP_Params * params)
                                      status,
                                      "Heap creation failed on user-side!");
             }
+            else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+                _HeapMemMP_initSizeClasses ((HeapMemMP_Obj *)
+                                      ((HeapMemMP_Object *) handle)->obj,
+                                      params);
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
         }
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
@@ -573,6 +679,7 @@ HeapMemMP_delete (HeapMemMP_Handle * hpHandle)
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (HeapMemMP_Obj *) (((HeapMemMP_Object *) (*hpHandle))->obj);
+        _HeapMemMP_destroySizeClasses (obj);
         cmdArgs.args.deleteInstance.handle = obj->knlObject;
         status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_DELETE, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -823,6 +930,7 @@ HeapMemMP_close (HeapMemMP_Handle * hpHandle)
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (HeapMemMP_Obj *) (((HeapMemMP_Object *) (*hpHandle))->obj);
+        _HeapMemMP_destroySizeClasses (obj);
         cmdArgs.args.close.handle = obj->knlObject;
         status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_CLOSE, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -867,6 +975,8 @@ HeapMemMP_alloc (HeapMemMP_Handle   hpHandle,
     Char                * block      = NULL;
     SharedRegion_SRPtr    blockSrPtr = SharedRegion_INVALIDSRPTR;
     HeapMemMPDrv_CmdArgs  cmdArgs;
+    HeapMemMP_Obj *       obj;
+    Int                   sizeClass;
 
     GT_3trace (curTrace, GT_ENTER, "HeapMemMP_alloc", hpHandle, size, align);
 
@@ -890,28 +1000,42 @@ HeapMemMP_alloc (HeapMemMP_Handle   hpHandle,
     }
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        cmdArgs.args.alloc.handle =
-            ((HeapMemMP_Obj *) ((HeapMemMP_Object *) hpHandle)->obj)->knlObject;
-        cmdArgs.args.alloc.size   = size;
-        cmdArgs.args.alloc.align  = align;
+        obj = (HeapMemMP_Obj *) ((HeapMemMP_Object *) hpHandle)->obj;
+        sizeClass = _HeapMemMP_getSizeClass (obj, size, align);
+        if (sizeClass >= 0) {
+            _HeapMemMP_sizeClassAlloc (obj, sizeClass, size, (Ptr *) &block, 1);
+        }
 
-        status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_ALLOC, &cmdArgs);
+        /* Larger requests, and small ones the slabs cannot serve. */
+        if (block == NULL) {
+            cmdArgs.args.alloc.handle = obj->knlObject;
+            cmdArgs.args.alloc.size   = size;
+            cmdArgs.args.alloc.align  = align;
+
+            status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_ALLOC, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
                                  GT_4CLASS,
                                  "HeapMemMP_alloc",
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
-        }
-        else {
-#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            blockSrPtr = cmdArgs.args.alloc.blockSrPtr;
-            if (blockSrPtr != SharedRegion_INVALIDSRPTR) {
-                block = SharedRegion_getPtr (blockSrPtr);
             }
+            else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+                blockSrPtr = cmdArgs.args.alloc.blockSrPtr;
+                if (blockSrPtr != SharedRegion_INVALIDSRPTR) {
+                    block = SharedRegion_getPtr (blockSrPtr);
+                    if (_SharedRegion_cacheInv (block, size) < 0) {
+                        _HeapMemMP_releaseBlock (obj, block, size);
+                        block = NULL;
+                    }
+                }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -938,6 +1062,7 @@ HeapMemMP_free (HeapMemMP_Handle   hpHandle,
     Int                   status = HeapMemMP_S_SUCCESS;
     HeapMemMPDrv_CmdArgs  cmdArgs;
     UInt16                index;
+    HeapMemMP_Obj *       obj;
 
     GT_3trace (curTrace, GT_ENTER, "HeapMemMP_free", hpHandle, block, size);
 
@@ -971,23 +1096,47 @@ HeapMemMP_free (HeapMemMP_Handle   hpHandle,
     }
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        cmdArgs.args.free.handle =
-            ((HeapMemMP_Obj *) ((HeapMemMP_Object *) hpHandle)->obj)->knlObject;
-        cmdArgs.args.free.size   = size;
+        obj = (HeapMemMP_Obj *) ((HeapMemMP_Object *) hpHandle)->obj;
+        if (_HeapMemMP_sizeClassFree (obj, block, size) == TRUE) {
+            /* Returned to its size class. */
+        }
+        else if (_HeapMemMP_isOwnerSlabBlock (obj, block) == TRUE) {
+            /* Slab blocks can only go back through the creating handle. */
+            status = HeapMemMP_E_INVALIDARG;
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "HeapMemMP_free",
+                                 status,
+                                 "Block belongs to a size-class slab of the "
+                                 "creating handle!");
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        }
+        else if (_SharedRegion_cacheWbInv (block, size) < 0) {
+            /* Its data may still be in the cache, so the block is kept. */
+            status = HeapMemMP_E_FAIL;
+        }
+        else {
+            cmdArgs.args.free.handle = obj->knlObject;
+            cmdArgs.args.free.size   = size;
 
-        /* Translate to SrPtr. */
-        index = SharedRegion_getId (block);
-        cmdArgs.args.free.blockSrPtr = SharedRegion_getSRPtr (block, index);
+            /* Translate to SrPtr. */
+            index = SharedRegion_getId (block);
+            cmdArgs.args.free.blockSrPtr = SharedRegion_getSRPtr (block,
+                                                                  index);
 
-        status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_FREE, &cmdArgs);
+            status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_FREE, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
                                  GT_4CLASS,
                                  "HeapMemMP_free",
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -997,6 +1146,109 @@ HeapMemMP_free (HeapMemMP_Handle   hpHandle,
 }
 
 
+/*!
+ *  @brief      Allocates several blocks of the same size and alignment
+ *
+ *  @param      hpHandle   Handle to previously created/opened instance.
+ *  @param      size       Size of each block (in bytes)
+ *  @param      align      Alignment of each block (power of 2)
+ *  @param      blocks     Array receiving the allocated blocks
+ *  @param      numBlocks  Number of blocks to allocate
+ *  @param      numAlloced Return value: number of blocks allocated
+ *
+ *  @sa         HeapMemMP_alloc, HeapMemMP_free
+ */
+Int
+HeapMemMP_allocMany (HeapMemMP_Handle   hpHandle,
+                     SizeT              size,
+                     SizeT              align,
+                     Ptr                blocks [],
+                     UInt               numBlocks,
+                     UInt             * numAlloced)
+{
+    Int                   status = HeapMemMP_S_SUCCESS;
+    HeapMemMP_Obj *       obj;
+    Int                   sizeClass;
+    UInt                  done   = 0;
+    UInt                  batch;
+    UInt                  count;
+
+    GT_5trace (curTrace, GT_ENTER, "HeapMemMP_allocMany",
+               hpHandle, size, align, blocks, numBlocks);
+
+    GT_assert (curTrace, (hpHandle != NULL));
+    GT_assert (curTrace, (blocks != NULL));
+    GT_assert (curTrace, (numAlloced != NULL));
+
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    if (HeapMemMP_state.setupRefCount == 0) {
+        status = HeapMemMP_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "HeapMemMP_allocMany",
+                             status,
+                             "Module is not initialized!");
+    }
+    else if (hpHandle == NULL) {
+        status = HeapMemMP_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "HeapMemMP_allocMany",
+                             status,
+                             "Invalid NULL hpHandle pointer specified!");
+    }
+    else if ((blocks == NULL) || (numAlloced == NULL)) {
+        status = HeapMemMP_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "HeapMemMP_allocMany",
+                             status,
+                             "Invalid NULL blocks or numAlloced pointer "
+                             "specified!");
+    }
+    else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        obj = (HeapMemMP_Obj *) ((HeapMemMP_Object *) hpHandle)->obj;
+        sizeClass = _HeapMemMP_getSizeClass (obj, size, align);
+        if (sizeClass >= 0) {
+            done = _HeapMemMP_sizeClassAlloc (obj, sizeClass, size, blocks,
+                                              numBlocks);
+        }
+
+        while (done < numBlocks) {
+            batch = numBlocks - done;
+            if (batch > HEAPMEMMP_MAXBATCH) {
+                batch = HEAPMEMMP_MAXBATCH;
+            }
+            count = _HeapMemMP_allocBlocks (obj, size, align, &blocks [done],
+                                            batch);
+            done += count;
+            if (count < batch) {
+                break;
+            }
+        }
+
+        *numAlloced = done;
+        if (done < numBlocks) {
+            status = HeapMemMP_E_MEMORY;
+            GT_3trace (curTrace,
+                       GT_2CLASS,
+                       "    HeapMemMP_allocMany: heap exhausted after %d of "
+                       "%d blocks of size %d\n",
+                       done,
+                       numBlocks,
+                       size);
+        }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+
+    GT_1trace (curTrace, GT_LEAVE, "HeapMemMP_allocMany", status);
+
+    return status;
+}
+
+
 /*!
  *  @brief      Get memory statistics
  *
@@ -1124,6 +1376,12 @@ HeapMemMP_getExtendedStats (HeapMemMP_Handle          hpHandle,
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
         }
+        else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+            _HeapMemMP_getSizeClassStats ((HeapMemMP_Obj *)
+                                  ((HeapMemMP_Object *) hpHandle)->obj, stats);
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+        }
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1390,6 +1648,487 @@ _HeapMemMP_create (HeapMemMP_Handle     * heapHandle,
 }
 
 
+/*
+ *  Enables the size classes when the instance is created with a slabSize
+ *  large enough to hold a block of the largest class.
+ */
+static Void
+_HeapMemMP_initSizeClasses (HeapMemMP_Obj          * obj,
+                            const HeapMemMP_Params * params)
+{
+    if (params->slabSize >= HeapMemMP_MAXCLASSSIZE) {
+        pthread_mutex_init (&obj->sizeClassLock, NULL);
+        obj->slabSize = params->slabSize;
+
+        pthread_mutex_lock (&HeapMemMP_state.ownersLock);
+        obj->nextOwner = HeapMemMP_state.slabOwners;
+        HeapMemMP_state.slabOwners = obj;
+        pthread_mutex_unlock (&HeapMemMP_state.ownersLock);
+    }
+}
+
+
+/*
+ *  Returns the slabs to the heap and disables the size classes.
+ */
+static Void
+_HeapMemMP_destroySizeClasses (HeapMemMP_Obj * obj)
+{
+    HeapMemMP_Obj ** prev;
+
+    if (obj->slabSize != 0) {
+        pthread_mutex_lock (&HeapMemMP_state.ownersLock);
+        for (prev = &HeapMemMP_state.slabOwners;
+             *prev != NULL;
+             prev = &(*prev)->nextOwner) {
+            if (*prev == obj) {
+                *prev = obj->nextOwner;
+                break;
+            }
+        }
+        pthread_mutex_unlock (&HeapMemMP_state.ownersLock);
+
+        _HeapMemMP_resetSizeClasses (obj, TRUE);
+        pthread_mutex_destroy (&obj->sizeClassLock);
+        obj->slabSize = 0;
+    }
+}
+
+
+/*
+ *  Forgets all slabs and empties the size classes. The slabs are returned to
+ *  the heap only if freeSlabs is TRUE; after HeapMemMP_restore they are
+ *  already part of the restored free list.
+ */
+static Void
+_HeapMemMP_resetSizeClasses (HeapMemMP_Obj * obj, Bool freeSlabs)
+{
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    Int32                 status;
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+    UInt                  i;
+    UInt16                index;
+    HeapMemMPDrv_CmdArgs  cmdArgs;
+
+    if (obj->slabSize == 0) {
+        return;
+    }
+
+    pthread_mutex_lock (&obj->sizeClassLock);
+
+    for (i = 0; (freeSlabs == TRUE) && (i < obj->numSlabs); i++) {
+        if (_SharedRegion_cacheWbInv (obj->slabs [i].base, obj->slabSize) < 0) {
+            /* Its data may still be in the cache, so the slab is kept. */
+            continue;
+        }
+        index = SharedRegion_getId (obj->slabs [i].base);
+        cmdArgs.args.free.handle     = obj->knlObject;
+        cmdArgs.args.free.size       = obj->slabSize;
+        cmdArgs.args.free.blockSrPtr = SharedRegion_getSRPtr (
+                                                        obj->slabs [i].base,
+                                                        index);
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+        status =
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_FREE, &cmdArgs);
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_HeapMemMP_resetSizeClasses",
+                                 status,
+                                 "API (through IOCTL) failed on kernel-side!");
+        }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+    }
+
+    if (obj->slabs != NULL) {
+        Memory_free (NULL, obj->slabs, obj->maxSlabs * sizeof (HeapMemMP_Slab));
+    }
+    obj->slabs    = NULL;
+    obj->numSlabs = 0;
+    obj->maxSlabs = 0;
+    Memory_set (obj->sizeClasses, 0, sizeof (obj->sizeClasses));
+
+    pthread_mutex_unlock (&obj->sizeClassLock);
+}
+
+
+/*
+ *  Returns the smallest size class whose blocks fit size bytes at the given
+ *  alignment, or -1 if the request is not served by the size classes.
+ */
+static Int
+_HeapMemMP_getSizeClass (HeapMemMP_Obj * obj, UInt32 size, UInt32 align)
+{
+    UInt32  need = (size > align) ? size : align;
+    UInt32  blockSize = HeapMemMP_MINCLASSSIZE;
+    Int     sizeClass = 0;
+
+    if ((obj->slabSize == 0) || (size == 0) || (need > HeapMemMP_MAXCLASSSIZE)) {
+        return -1;
+    }
+
+    while (blockSize < need) {
+        blockSize <<= 1u;
+        sizeClass++;
+    }
+
+    return sizeClass;
+}
+
+
+/*
+ *  Returns the index of the slab containing block, or -1 if the block was
+ *  not carved from a slab of this instance. Called with sizeClassLock held.
+ */
+static Int
+_HeapMemMP_findSlab (HeapMemMP_Obj * obj, Ptr block)
+{
+    UInt    lo = 0;
+    UInt    hi = obj->numSlabs;
+    UInt    mid;
+
+    /* Find the last slab starting at or below block. */
+    while (lo < hi) {
+        mid = (lo + hi) / 2u;
+        if (obj->slabs [mid].base <= (Char *) block) {
+            lo = mid + 1u;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    if (    (lo > 0)
+        &&  ((Char *) block < obj->slabs [lo - 1u].base + obj->slabSize)) {
+        return (Int) (lo - 1u);
+    }
+
+    return -1;
+}
+
+
+/*
+ *  Allocates a slab from the heap and carves it into free blocks of the
+ *  given size class. Called with sizeClassLock held.
+ */
+static Bool
+_HeapMemMP_addSlab (HeapMemMP_Obj * obj, Int sizeClass)
+{
+    Int32                 status;
+    HeapMemMPDrv_CmdArgs  cmdArgs;
+    HeapMemMP_SizeClass * sc = &obj->sizeClasses [sizeClass];
+    UInt32                blockSize = HeapMemMP_MINCLASSSIZE << sizeClass;
+    HeapMemMP_Slab *      slabs;
+    Char *                base;
+    UInt                  numBlocks;
+    UInt                  i;
+
+    /* Make room in the table first, so a slab is never left untracked. */
+    if (obj->numSlabs == obj->maxSlabs) {
+        slabs = Memory_alloc (NULL,
+                              (obj->maxSlabs ? obj->maxSlabs * 2u : 8u)
+                              * sizeof (HeapMemMP_Slab),
+                              0);
+        if (slabs == NULL) {
+            return FALSE;
+        }
+        if (obj->slabs != NULL) {
+            Memory_copy (slabs,
+                         obj->slabs,
+                         obj->numSlabs * sizeof (HeapMemMP_Slab));
+            Memory_free (NULL,
+                         obj->slabs,
+                         obj->maxSlabs * sizeof (HeapMemMP_Slab));
+        }
+        obj->slabs    = slabs;
+        obj->maxSlabs = obj->maxSlabs ? obj->maxSlabs * 2u : 8u;
+    }
+
+    cmdArgs.args.alloc.handle = obj->knlObject;
+    cmdArgs.args.alloc.size   = obj->slabSize;
+    cmdArgs.args.alloc.align  = HeapMemMP_MAXCLASSSIZE;
+
+    status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_ALLOC, &cmdArgs);
+    if (    (status < 0)
+        ||  (cmdArgs.args.alloc.blockSrPtr == SharedRegion_INVALIDSRPTR)) {
+        return FALSE;
+    }
+    base = SharedRegion_getPtr (cmdArgs.args.alloc.blockSrPtr);
+    if (_SharedRegion_cacheInv (base, obj->slabSize) < 0) {
+        _HeapMemMP_releaseBlock (obj, base, obj->slabSize);
+        return FALSE;
+    }
+
+    /* Keep the table sorted by base address. */
+    for (i = obj->numSlabs; (i > 0) && (obj->slabs [i - 1u].base > base); i--) {
+        obj->slabs [i] = obj->slabs [i - 1u];
+    }
+    obj->slabs [i].base      = base;
+    obj->slabs [i].sizeClass = sizeClass;
+    obj->numSlabs++;
+
+    /* Push from the top, so that blocks are handed out in address order. */
+    numBlocks = obj->slabSize / blockSize;
+    for (i = numBlocks; i > 0; i--) {
+        *(Ptr *) (base + (i - 1u) * blockSize) = sc->freeList;
+        sc->freeList = base + (i - 1u) * blockSize;
+    }
+    sc->numBlocks += numBlocks;
+    sc->numFree   += numBlocks;
+
+    GT_3trace (curTrace,
+               GT_2CLASS,
+               "    _HeapMemMP_addSlab: slab [0x%x] carved into %d blocks of "
+               "size %d\n",
+               base,
+               numBlocks,
+               blockSize);
+
+    return TRUE;
+}
+
+
+/*
+ *  Takes up to numBlocks blocks from a size class, carving new slabs as
+ *  needed. Returns the number of blocks taken, which is less than numBlocks
+ *  only when no slab could be allocated from the heap.
+ */
+static UInt
+_HeapMemMP_sizeClassAlloc (HeapMemMP_Obj * obj,
+                           Int             sizeClass,
+                           UInt32          size,
+                           Ptr           * blocks,
+                           UInt            numBlocks)
+{
+    HeapMemMP_SizeClass * sc = &obj->sizeClasses [sizeClass];
+    UInt                  done;
+
+    pthread_mutex_lock (&obj->sizeClassLock);
+
+    for (done = 0; done < numBlocks; done++) {
+        if (sc->freeList != NULL) {
+            sc->numHits++;
+        }
+        else if (_HeapMemMP_addSlab (obj, sizeClass) == FALSE) {
+            break;
+        }
+        blocks [done] = sc->freeList;
+        sc->freeList  = *(Ptr *) sc->freeList;
+        sc->numFree--;
+        sc->numAllocs++;
+        sc->requestedBytes += size;
+    }
+
+    pthread_mutex_unlock (&obj->sizeClassLock);
+
+    return done;
+}
+
+
+/*
+ *  Returns a block to its size class. Returns FALSE, leaving the block to
+ *  the caller, if it does not belong to a slab of this instance.
+ */
+static Bool
+_HeapMemMP_sizeClassFree (HeapMemMP_Obj * obj, Ptr block, UInt32 size)
+{
+    HeapMemMP_SizeClass * sc;
+    Int                   slab;
+
+    if (obj->slabSize == 0) {
+        return FALSE;
+    }
+
+    pthread_mutex_lock (&obj->sizeClassLock);
+
+    slab = _HeapMemMP_findSlab (obj, block);
+    if (slab >= 0) {
+        sc = &obj->sizeClasses [obj->slabs [slab].sizeClass];
+        *(Ptr *) block = sc->freeList;
+        sc->freeList   = block;
+        sc->numFree++;
+        sc->requestedBytes -= (size < sc->requestedBytes) ? size
+                                                          : sc->requestedBytes;
+    }
+
+    pthread_mutex_unlock (&obj->sizeClassLock);
+
+    return (slab >= 0);
+}
+
+
+/*
+ *  Returns TRUE if block was carved from a slab of another handle of this
+ *  process to the same heap, typically when a handle opened in the creating
+ *  process frees a small block allocated through the creating handle.
+ */
+static Bool
+_HeapMemMP_isOwnerSlabBlock (HeapMemMP_Obj * obj, Ptr block)
+{
+    HeapMemMP_Obj * owner;
+    Bool            found = FALSE;
+
+    pthread_mutex_lock (&HeapMemMP_state.ownersLock);
+    for (owner = HeapMemMP_state.slabOwners;
+         (owner != NULL) && (found == FALSE);
+         owner = owner->nextOwner) {
+        if ((owner != obj) && (owner->knlObject == obj->knlObject)) {
+            pthread_mutex_lock (&owner->sizeClassLock);
+            found = (_HeapMemMP_findSlab (owner, block) >= 0);
+            pthread_mutex_unlock (&owner->sizeClassLock);
+        }
+    }
+    pthread_mutex_unlock (&HeapMemMP_state.ownersLock);
+
+    return found;
+}
+
+
+/*
+ *  Allocates up to numBlocks blocks from the heap, one command per batch.
+ *  Returns the number of blocks allocated, which is less than numBlocks when
+ *  the heap runs out of memory.
+ */
+static UInt
+_HeapMemMP_allocBlocks (HeapMemMP_Obj * obj,
+                        UInt32          size,
+                        UInt32          align,
+                        Ptr           * blocks,
+                        UInt            numBlocks)
+{
+    Int32                 status;
+    UInt                  done = 0;
+    UInt                  i;
+    UInt                  n;
+    SharedRegion_SRPtr    blockSrPtrs [HEAPMEMMP_MAXBATCH];
+    HeapMemMPDrv_CmdArgs  cmdArgs;
+
+    GT_assert (curTrace, (numBlocks <= HEAPMEMMP_MAXBATCH));
+
+    if (HeapMemMP_state.batchSupported == TRUE) {
+        cmdArgs.args.allocMany.handle      = obj->knlObject;
+        cmdArgs.args.allocMany.size        = size;
+        cmdArgs.args.allocMany.align       = align;
+        cmdArgs.args.allocMany.blockSrPtrs = blockSrPtrs;
+        cmdArgs.args.allocMany.numBlocks   = numBlocks;
+        cmdArgs.args.allocMany.numAlloced  = 0;
+
+        status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_ALLOCMANY, &cmdArgs);
+        if ((status == HeapMemMP_E_OSFAILURE) && (errno == ENOTTY)) {
+            /* Driver predates the batched command; nothing was allocated. */
+            HeapMemMP_state.batchSupported = FALSE;
+        }
+        else {
+            /* numAlloced is only copied back when the command succeeded. */
+            if (status >= 0) {
+                done = cmdArgs.args.allocMany.numAlloced;
+            }
+            /* Blocks that cannot be invalidated go straight back. */
+            for (i = 0, n = 0; i < done; i++) {
+                blocks [n] = SharedRegion_getPtr (blockSrPtrs [i]);
+                if (_SharedRegion_cacheInv (blocks [n], size) < 0) {
+                    _HeapMemMP_releaseBlock (obj, blocks [n], size);
+                }
+                else {
+                    n++;
+                }
+            }
+            return n;
+        }
+    }
+
+    while (done < numBlocks) {
+        cmdArgs.args.alloc.handle = obj->knlObject;
+        cmdArgs.args.alloc.size   = size;
+        cmdArgs.args.alloc.align  = align;
+
+        status = HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_ALLOC, &cmdArgs);
+        if (    (status < 0)
+            ||  (cmdArgs.args.alloc.blockSrPtr == SharedRegion_INVALIDSRPTR)) {
+            break;
+        }
+        blocks [done] = SharedRegion_getPtr (cmdArgs.args.alloc.blockSrPtr);
+        if (_SharedRegion_cacheInv (blocks [done], size) < 0) {
+            _HeapMemMP_releaseBlock (obj, blocks [done], size);
+            break;
+        }
+        done++;
+    }
+
+    return done;
+}
+
+
+/*
+ *  Gives a block that was just allocated back to the heap when it cannot be
+ *  invalidated. The block was not written to, so it needs no write back.
+ */
+static Void
+_HeapMemMP_releaseBlock (HeapMemMP_Obj * obj, Ptr block, UInt32 size)
+{
+    HeapMemMPDrv_CmdArgs  cmdArgs;
+    UInt16                index;
+
+    index = SharedRegion_getId (block);
+    cmdArgs.args.free.handle     = obj->knlObject;
+    cmdArgs.args.free.size       = size;
+    cmdArgs.args.free.blockSrPtr = SharedRegion_getSRPtr (block, index);
+
+    HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_FREE, &cmdArgs);
+}
+
+
+/*
+ *  Fills the size-class part of the extended statistics. Fragmentation is
+ *  the part of the slabs not holding live data: free blocks, the unused tail
+ *  of each slab, and the rounding of requests up to their class size.
+ */
+static Void
+_HeapMemMP_getSizeClassStats (HeapMemMP_Obj           * obj,
+                              HeapMemMP_ExtendedStats * stats)
+{
+    HeapMemMP_SizeClass *      sc;
+    HeapMemMP_SizeClassStats * out;
+    SizeT                      usedBytes = 0;
+    SizeT                      liveBytes;
+    UInt                       i;
+
+    Memory_set (stats->sizeClasses, 0, sizeof (stats->sizeClasses));
+    stats->slabBytes       = 0;
+    stats->fragmentedBytes = 0;
+
+    for (i = 0; i < HeapMemMP_NUMSIZECLASSES; i++) {
+        stats->sizeClasses [i].blockSize = HeapMemMP_MINCLASSSIZE << i;
+    }
+
+    if (obj->slabSize == 0) {
+        return;
+    }
+
+    pthread_mutex_lock (&obj->sizeClassLock);
+
+    for (i = 0; i < HeapMemMP_NUMSIZECLASSES; i++) {
+        sc  = &obj->sizeClasses [i];
+        out = &stats->sizeClasses [i];
+        out->numAllocs = sc->numAllocs;
+        out->numHits   = sc->numHits;
+        out->numBlocks = sc->numBlocks;
+        out->numFree   = sc->numFree;
+
+        liveBytes = (sc->numBlocks - sc->numFree) * out->blockSize;
+        out->wastedBytes = (liveBytes > sc->requestedBytes) ?
+                                (liveBytes - sc->requestedBytes) : 0;
+        usedBytes += liveBytes - out->wastedBytes;
+    }
+    stats->slabBytes       = obj->numSlabs * obj->slabSize;
+    stats->fragmentedBytes = stats->slabBytes - usedBytes;
+
+    pthread_mutex_unlock (&obj->sizeClassLock);
+}
+
+
 /*!
  *  @brief      Restore an instance to it's original created state.
  *
@@ -1422,6 +2161,11 @@ HeapMemMP_restore (HeapMemMP_Handle handle)
         status =
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         HeapMemMPDrv_ioctl (CMD_HEAPMEMMP_RESTORE, &cmdArgs);
+
+        /* The slabs went back to the heap with everything else. */
+        _HeapMemMP_resetSizeClasses ((HeapMemMP_Obj *)
+                                     ((HeapMemMP_Object *) handle)->obj,
+                                     FALSE);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         if (status < 0) {
             GT_setFailureReason (curTrace,
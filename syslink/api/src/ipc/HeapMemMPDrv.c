@@ -208,6 +208,7 @@ HeapMemMPDrv_ioctl (UInt32 cmd, Ptr args)
 {
     Int status      = HeapMemMP_S_SUCCESS;
     int osStatus    = 0;
+    int osErrno     = 0;
 
     GT_2trace (curTrace, GT_ENTER, "HeapMemMPDrv_ioctl", cmd, args);
 
@@ -215,6 +216,7 @@ HeapMemMPDrv_ioctl (UInt32 cmd, Ptr args)
 
     osStatus = ioctl (HeapMemMPDrv_handle, cmd, args);
     if (osStatus < 0) {
+        osErrno = errno;
         /*! @retval HeapMemMP_E_OSFAILURE Driver ioctl failed */
         status = HeapMemMP_E_OSFAILURE;
         GT_setFailureReason (curTrace,
@@ -230,6 +232,11 @@ HeapMemMPDrv_ioctl (UInt32 cmd, Ptr args)
 
     GT_1trace (curTrace, GT_LEAVE, "HeapMemMPDrv_ioctl", status);
 
+    if (osStatus < 0) {
+        /* Left in errno so that callers can tell an unknown command apart. */
+        errno = osErrno;
+    }
+
     /*! @retval HeapMemMP_S_SUCCESS Operation successfully completed. */
     return status;
 }
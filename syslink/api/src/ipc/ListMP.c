@@ -99,6 +99,8 @@
 #include <ListMPDrv.h>
 #include <ListMPDrvDefs.h>
 
+/* Linux specific header files */
+#include <errno.h>
 
 #if defined (__cplusplus)
 extern "C" {
@@ -119,8 +121,15 @@ extern "C" {
 
 /* Structure defining object for the Gate */
 typedef struct ListMP_Object_tag {
-    Ptr         knlObject;
+    Ptr                 knlObject;
     /*!< Pointer to the kernel-side ListMP object. */
+    ListMP_Attrs *      attrs;
+    /*!< Shared attributes of the instance, NULL when not known. */
+    SharedRegion_SRPtr  headSrPtr;
+    /*!< SrPtr of attrs->head, which terminates the list in both
+         directions. */
+    Bool                direct;
+    /*!< Whether empty/next/prev read the list directly. */
 } ListMP_Object;
 
 /*!
@@ -130,6 +139,11 @@ typedef struct ListMP_ModuleObject_tag {
     UInt32                    setupRefCount;
     /*!< Reference count for number of times setup/destroy were called in this
          process. */
+    Bool                      directAccess;
+    /*!< Default direct access setting for new handles. */
+    Bool                      getSharedAddrSupported;
+    /*!< Whether the driver accepts the GETSHAREDADDR command. Cleared the
+         first time the command fails at OS level. */
 } ListMP_ModuleObject;
 
 
@@ -147,7 +161,9 @@ static
 #endif /* if !defined(SYSLINK_BUILD_DEBUG) */
 ListMP_ModuleObject ListMP_state =
 {
-    .setupRefCount = 0
+    .setupRefCount          = 0,
+    .directAccess           = FALSE,
+    .getSharedAddrSupported = TRUE
 };
 
 /*!
@@ -168,7 +184,18 @@ ListMP_ModuleObject * ListMP_module = &ListMP_state;
 Int32
  _ListMP_create(ListMP_Handle       * listMPHandle,
                 ListMPDrv_CmdArgs     cmdArgs,
-                UInt16                createFlag);
+                UInt16                createFlag,
+                Ptr                   sharedAddr);
+
+static Void _ListMP_initDirect (ListMP_Object * obj, Ptr sharedAddr);
+
+static Ptr _ListMP_directLink (ListMP_Object * obj,
+                               ListMP_Elem   * elem,
+                               Bool            forward);
+
+static Void _ListMP_putBack (ListMP_Object * obj,
+                             ListMP_Elem   * elem,
+                             Bool            head);
 
 
 /* =============================================================================
@@ -233,6 +260,8 @@ ListMP_getConfig (ListMP_Config * cfgParams)
             }
         }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        /* User-side only setting, unknown to the driver. */
+        cfgParams->directAccess = FALSE;
         /* Close the driver handle. */
         ListMPDrv_close ();
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -266,6 +295,9 @@ ListMP_setup (ListMP_Config * config)
                    ListMP_module->setupRefCount);
     }
     else {
+        ListMP_module->directAccess = (   (config != NULL)
+                                       && (config->directAccess == TRUE));
+
         /* Open the driver handle. */
         status = ListMPDrv_open ();
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -502,7 +534,7 @@ ListMP_create (const ListMP_Params * params)
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
             status =
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            _ListMP_create (&handle, cmdArgs, TRUE);
+            _ListMP_create (&handle, cmdArgs, TRUE, params->sharedAddr);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
             if (status < 0) {
                 GT_setFailureReason (curTrace,
@@ -727,7 +759,7 @@ Int ListMP_open (String            name,
         }
         else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-           status = _ListMP_create (handlePtr, cmdArgs, FALSE);
+           status = _ListMP_create (handlePtr, cmdArgs, FALSE, NULL);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         }
     }
@@ -796,7 +828,7 @@ Int ListMP_openByAddr (Ptr               sharedAddr,
         }
         else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-           status = _ListMP_create (handlePtr, cmdArgs, FALSE);
+           status = _ListMP_create (handlePtr, cmdArgs, FALSE, sharedAddr);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         }
     }
@@ -913,24 +945,32 @@ ListMP_empty (ListMP_Handle  listMPHandle)
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (ListMP_Object *) listMPHandle;
-        cmdArgs.args.isEmpty.handle = obj->knlObject;
+        if (obj->direct == TRUE) {
+            /* A single SrPtr read, so no gate is needed. */
+            isEmpty = (_ListMP_directLink (obj, NULL, TRUE) == NULL);
+        }
+        else {
+            cmdArgs.args.isEmpty.handle = obj->knlObject;
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        status =
+            status =
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        ListMPDrv_ioctl (CMD_LISTMP_ISEMPTY, &cmdArgs);
+            ListMPDrv_ioctl (CMD_LISTMP_ISEMPTY, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
                                  GT_4CLASS,
                                  "ListMP_empty",
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
-        }
-        else {
+            }
+            else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            isEmpty = cmdArgs.args.isEmpty.isEmpty ;
+                isEmpty = cmdArgs.args.isEmpty.isEmpty ;
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -992,6 +1032,11 @@ Ptr ListMP_getHead (ListMP_Handle listMPHandle)
             if (cmdArgs.args.getHead.elemSrPtr != SharedRegion_INVALIDSRPTR) {
                 elem = (ListMP_Elem *) SharedRegion_getPtr(
                                                 cmdArgs.args.getHead.elemSrPtr);
+                if (_SharedRegion_cacheInv (elem, sizeof (ListMP_Elem)) < 0) {
+                    /* Its links may be stale; leave it on the list. */
+                    _ListMP_putBack (obj, elem, TRUE);
+                    elem = NULL;
+                }
             }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         }
@@ -1057,6 +1102,11 @@ Ptr ListMP_getTail (ListMP_Handle listMPHandle)
             if (cmdArgs.args.getTail.elemSrPtr != SharedRegion_INVALIDSRPTR) {
                 elem = (ListMP_Elem *) SharedRegion_getPtr(
                                                 cmdArgs.args.getTail.elemSrPtr);
+                if (_SharedRegion_cacheInv (elem, sizeof (ListMP_Elem)) < 0) {
+                    /* Its links may be stale; leave it on the list. */
+                    _ListMP_putBack (obj, elem, FALSE);
+                    elem = NULL;
+                }
             }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         }
@@ -1116,18 +1166,26 @@ Int ListMP_putHead (ListMP_Handle  listMPHandle,
         obj = (ListMP_Object *) listMPHandle;
         cmdArgs.args.putHead.handle = obj->knlObject;
 
-        index = SharedRegion_getId (elem);
-        cmdArgs.args.putHead.elemSrPtr =  SharedRegion_getSRPtr (elem,index);
-        status = ListMPDrv_ioctl (CMD_LISTMP_PUTHEAD, &cmdArgs);
+        if (_SharedRegion_cacheWbInv (elem, sizeof (ListMP_Elem)) < 0) {
+            status = ListMP_E_FAIL;
+        }
+        else {
+            index = SharedRegion_getId (elem);
+            cmdArgs.args.putHead.elemSrPtr = SharedRegion_getSRPtr (elem,
+                                                                    index);
+            status = ListMPDrv_ioctl (CMD_LISTMP_PUTHEAD, &cmdArgs);
 
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "ListMP_putHead",
-                                 status,
-                                 "API (through IOCTL) failed on kernel-side!");
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "ListMP_putHead",
+                                     status,
+                                     "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1182,19 +1240,27 @@ Int ListMP_putTail (ListMP_Handle    listMPHandle,
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (ListMP_Object *) listMPHandle;
         cmdArgs.args.putTail.handle = obj->knlObject;
-        index = SharedRegion_getId (elem);
-        cmdArgs.args.putTail.elemSrPtr =  SharedRegion_getSRPtr (elem,index);
+        if (_SharedRegion_cacheWbInv (elem, sizeof (ListMP_Elem)) < 0) {
+            status = ListMP_E_FAIL;
+        }
+        else {
+            index = SharedRegion_getId (elem);
+            cmdArgs.args.putTail.elemSrPtr = SharedRegion_getSRPtr (elem,
+                                                                    index);
 
-        status = ListMPDrv_ioctl (CMD_LISTMP_PUTTAIL, &cmdArgs);
+            status = ListMPDrv_ioctl (CMD_LISTMP_PUTTAIL, &cmdArgs);
 
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "ListMP_putTail",
-                                 status,
-                                 "API (through IOCTL) failed on kernel-side!");
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "ListMP_putTail",
+                                     status,
+                                     "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1260,21 +1326,30 @@ Int ListMP_insert (ListMP_Handle  listMPHandle,
         obj = (ListMP_Object *) listMPHandle;
         cmdArgs.args.insert.handle = obj->knlObject;
 
-        index = SharedRegion_getId (newElem);
-        cmdArgs.args.insert.newElemSrPtr =SharedRegion_getSRPtr (newElem,index);
-        index = SharedRegion_getId (curElem);
-        cmdArgs.args.insert.curElemSrPtr =SharedRegion_getSRPtr (curElem,index);
-        status = ListMPDrv_ioctl (CMD_LISTMP_INSERT,
-                                              &cmdArgs);
+        if (   (_SharedRegion_cacheWbInv (newElem, sizeof (ListMP_Elem)) < 0)
+            || (_SharedRegion_cacheWbInv (curElem, sizeof (ListMP_Elem)) < 0)) {
+            status = ListMP_E_FAIL;
+        }
+        else {
+            index = SharedRegion_getId (newElem);
+            cmdArgs.args.insert.newElemSrPtr = SharedRegion_getSRPtr (newElem,
+                                                                      index);
+            index = SharedRegion_getId (curElem);
+            cmdArgs.args.insert.curElemSrPtr = SharedRegion_getSRPtr (curElem,
+                                                                      index);
+            status = ListMPDrv_ioctl (CMD_LISTMP_INSERT, &cmdArgs);
 
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "ListMP_insert",
-                                 status,
-                                 "API (through IOCTL) failed on kernel-side!");
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "ListMP_insert",
+                                     status,
+                                     "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1328,19 +1403,27 @@ Int ListMP_remove (ListMP_Handle   listMPHandle,
         obj = (ListMP_Object *) listMPHandle;
         cmdArgs.args.remove.handle = obj->knlObject;
 
-        index = SharedRegion_getId (elem);
-        cmdArgs.args.remove.elemSrPtr = SharedRegion_getSRPtr (elem,index);
+        if (_SharedRegion_cacheWbInv (elem, sizeof (ListMP_Elem)) < 0) {
+            status = ListMP_E_FAIL;
+        }
+        else {
+            index = SharedRegion_getId (elem);
+            cmdArgs.args.remove.elemSrPtr = SharedRegion_getSRPtr (elem,
+                                                                   index);
 
-        status = ListMPDrv_ioctl (CMD_LISTMP_REMOVE, &cmdArgs);
+            status = ListMPDrv_ioctl (CMD_LISTMP_REMOVE, &cmdArgs);
 
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "ListMP_remove",
-                                 status,
-                                 "API (through IOCTL) failed on kernel-side!");
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "ListMP_remove",
+                                     status,
+                                     "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1387,35 +1470,48 @@ Ptr ListMP_next (ListMP_Handle   listMPHandle,
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (ListMP_Object *) listMPHandle;
-        cmdArgs.args.next.handle = obj->knlObject;
-
-        if (elem != NULL){
-            index = SharedRegion_getId (elem);
-            cmdArgs.args.next.elemSrPtr = SharedRegion_getSRPtr (elem,index);
-        }
-        else{
-            cmdArgs.args.next.elemSrPtr = SharedRegion_INVALIDSRPTR;
+        if (obj->direct == TRUE) {
+            /* Traversal does not take the gate, as on the kernel side. */
+            next = _ListMP_directLink (obj, elem, TRUE);
         }
+        else {
+            cmdArgs.args.next.handle = obj->knlObject;
 
-        status = ListMPDrv_ioctl (CMD_LISTMP_NEXT,
-                                  &cmdArgs);
+            if (elem != NULL){
+                index = SharedRegion_getId (elem);
+                cmdArgs.args.next.elemSrPtr = SharedRegion_getSRPtr (elem,
+                                                                     index);
+            }
+            else{
+                cmdArgs.args.next.elemSrPtr = SharedRegion_INVALIDSRPTR;
+            }
+
+            status = ListMPDrv_ioctl (CMD_LISTMP_NEXT,
+                                      &cmdArgs);
 
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
                                  GT_4CLASS,
                                  "ListMP_next",
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
-        }
-        else {
+            }
+            else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            if (cmdArgs.args.next.nextElemSrPtr != SharedRegion_INVALIDSRPTR) {
-                next = (ListMP_Elem *)SharedRegion_getPtr(
+                if (   cmdArgs.args.next.nextElemSrPtr
+                    != SharedRegion_INVALIDSRPTR) {
+                    next = (ListMP_Elem *)SharedRegion_getPtr(
                                                cmdArgs.args.next.nextElemSrPtr);
-            }
+                    if (_SharedRegion_cacheInv (next, sizeof (ListMP_Elem)) < 0) {
+                        next = NULL;
+                    }
+                }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1462,34 +1558,46 @@ Ptr ListMP_prev (ListMP_Handle    listMPHandle,
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         obj = (ListMP_Object *) listMPHandle;
-
-        cmdArgs.args.prev.handle = obj->knlObject;
-        if(elem != NULL){
-            index = SharedRegion_getId (elem);
-            cmdArgs.args.prev.elemSrPtr = SharedRegion_getSRPtr (elem,index);
-        }
-        else{
-            cmdArgs.args.prev.elemSrPtr = SharedRegion_INVALIDSRPTR;
+        if (obj->direct == TRUE) {
+            /* Traversal does not take the gate, as on the kernel side. */
+            prev = _ListMP_directLink (obj, elem, FALSE);
         }
+        else {
+            cmdArgs.args.prev.handle = obj->knlObject;
+            if(elem != NULL){
+                index = SharedRegion_getId (elem);
+                cmdArgs.args.prev.elemSrPtr = SharedRegion_getSRPtr (elem,
+                                                                     index);
+            }
+            else{
+                cmdArgs.args.prev.elemSrPtr = SharedRegion_INVALIDSRPTR;
+            }
 
-        status = ListMPDrv_ioctl (CMD_LISTMP_PREV, &cmdArgs);
+            status = ListMPDrv_ioctl (CMD_LISTMP_PREV, &cmdArgs);
 
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
                                  GT_4CLASS,
                                  "ListMP_prev",
                                  status,
                                  "API (through IOCTL) failed on kernel-side!");
-        }
-        else {
+            }
+            else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            if (cmdArgs.args.prev.prevElemSrPtr != SharedRegion_INVALIDSRPTR) {
-                prev = (ListMP_Elem *)SharedRegion_getPtr(
+                if (   cmdArgs.args.prev.prevElemSrPtr
+                    != SharedRegion_INVALIDSRPTR) {
+                    prev = (ListMP_Elem *)SharedRegion_getPtr(
                                                cmdArgs.args.prev.prevElemSrPtr);
-            }
+                    if (_SharedRegion_cacheInv (prev, sizeof (ListMP_Elem)) < 0) {
+                        prev = NULL;
+                    }
+                }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -1509,7 +1617,8 @@ Ptr ListMP_prev (ListMP_Handle    listMPHandle,
 Int32
 _ListMP_create(ListMP_Handle     * handlePtr,
                ListMPDrv_CmdArgs   cmdArgs,
-               UInt16              createFlag)
+               UInt16              createFlag,
+               Ptr                 sharedAddr)
 {
     Int32 status = ListMP_S_SUCCESS;
 
@@ -1540,6 +1649,8 @@ _ListMP_create(ListMP_Handle     * handlePtr,
                                                      cmdArgs.args.open.handle;
         }
 
+        _ListMP_initDirect ((ListMP_Object *) *handlePtr, sharedAddr);
+
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
@@ -1547,6 +1658,153 @@ _ListMP_create(ListMP_Handle     * handlePtr,
     return(status);
 }
 
+/*
+ * Finds the shared attributes of a new handle so that it can use direct
+ * access. sharedAddr is NULL when the caller does not know where they are.
+ */
+static Void
+_ListMP_initDirect (ListMP_Object * obj, Ptr sharedAddr)
+{
+    Int32             status;
+    ListMPDrv_CmdArgs cmdArgs;
+    ListMP_Attrs    * attrs;
+    UInt16            index;
+
+    if (    (sharedAddr == NULL)
+        &&  (ListMP_module->getSharedAddrSupported == TRUE)) {
+        cmdArgs.args.getSharedAddr.handle = obj->knlObject;
+        status = ListMPDrv_ioctl (CMD_LISTMP_GETSHAREDADDR, &cmdArgs);
+        if ((status == ListMP_E_OSFAILURE) && (errno == ENOTTY)) {
+            /* Driver predates the command. Any other failure only costs
+             * this handle its direct access.
+             */
+            ListMP_module->getSharedAddrSupported = FALSE;
+        }
+        else if (    (status >= 0)
+                 &&  (   cmdArgs.args.getSharedAddr.sharedAddrSrPtr
+                      != SharedRegion_INVALIDSRPTR)) {
+            sharedAddr = SharedRegion_getPtr (
+                                cmdArgs.args.getSharedAddr.sharedAddrSrPtr);
+        }
+    }
+
+    if (sharedAddr == NULL) {
+        return;
+    }
+
+    attrs = (ListMP_Attrs *) sharedAddr;
+    if (_SharedRegion_cacheInv (attrs, sizeof (ListMP_Attrs)) < 0) {
+        /* Stay on the ioctl path. */
+        return;
+    }
+    if (attrs->status != ListMP_CREATED) {
+        GT_1trace (curTrace,
+                   GT_2CLASS,
+                   "    _ListMP_initDirect: No ListMP at [0x%x], direct access"
+                   " disabled\n",
+                   sharedAddr);
+        return;
+    }
+
+    index          = SharedRegion_getId (&attrs->head);
+    obj->attrs     = attrs;
+    obj->headSrPtr = SharedRegion_getSRPtr (&attrs->head, index);
+    obj->direct    = ListMP_module->directAccess;
+}
+
+/*
+ * Follows one link of elem, or of the list head when elem is NULL, in shared
+ * memory. Returns NULL at the end of the list.
+ */
+static Ptr
+_ListMP_directLink (ListMP_Object * obj, ListMP_Elem * elem, Bool forward)
+{
+    SharedRegion_SRPtr link;
+    ListMP_Elem      * linked;
+
+    if (elem == NULL) {
+        elem = &obj->attrs->head;
+    }
+
+    if (_SharedRegion_cacheInv (elem, sizeof (ListMP_Elem)) < 0) {
+        return NULL;
+    }
+    link = (forward == TRUE) ? elem->next : elem->prev;
+    if (link == obj->headSrPtr) {
+        return NULL;
+    }
+
+    linked = (ListMP_Elem *) SharedRegion_getPtr (link);
+    if (_SharedRegion_cacheInv (linked, sizeof (ListMP_Elem)) < 0) {
+        return NULL;
+    }
+
+    return linked;
+}
+
+/*
+ * Puts an element taken off the list back at the same end. No cache
+ * maintenance is done; this process has not written to the element.
+ */
+static Void
+_ListMP_putBack (ListMP_Object * obj, ListMP_Elem * elem, Bool head)
+{
+    ListMPDrv_CmdArgs cmdArgs;
+    UInt16            index;
+
+    index = SharedRegion_getId (elem);
+    if (head == TRUE) {
+        cmdArgs.args.putHead.handle    = obj->knlObject;
+        cmdArgs.args.putHead.elemSrPtr = SharedRegion_getSRPtr (elem, index);
+        ListMPDrv_ioctl (CMD_LISTMP_PUTHEAD, &cmdArgs);
+    }
+    else {
+        cmdArgs.args.putTail.handle    = obj->knlObject;
+        cmdArgs.args.putTail.elemSrPtr = SharedRegion_getSRPtr (elem, index);
+        ListMPDrv_ioctl (CMD_LISTMP_PUTTAIL, &cmdArgs);
+    }
+}
+
+/*
+ *  Enables or disables direct access for one handle.
+ */
+Int
+ListMP_setDirectAccess (ListMP_Handle handle, Bool enable)
+{
+    Int             status = ListMP_S_SUCCESS;
+    ListMP_Object * obj    = (ListMP_Object *) handle;
+
+    GT_2trace (curTrace, GT_ENTER, "ListMP_setDirectAccess", handle, enable);
+
+    GT_assert (curTrace, (handle != NULL));
+
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    if (handle == NULL) {
+        status = ListMP_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "ListMP_setDirectAccess",
+                             status,
+                             "Invalid NULL handle specified!");
+    }
+    else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        if ((enable == TRUE) && (obj->attrs == NULL)) {
+            /* Expected when the driver cannot report the address. */
+            status = ListMP_E_FAIL;
+        }
+        else {
+            obj->direct = enable;
+        }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+
+    GT_1trace (curTrace, GT_LEAVE, "ListMP_setDirectAccess", status);
+
+    return status;
+}
+
 /*
  *  Retrieves the GateMP handle associated with the ListMP instance.
  */
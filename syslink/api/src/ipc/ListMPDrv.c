@@ -211,6 +211,7 @@ ListMPDrv_ioctl (UInt32 cmd, Ptr args)
 {
     Int status      = ListMP_S_SUCCESS;
     int osStatus    = 0;
+    int osErrno     = 0;
 
     GT_2trace (curTrace, GT_ENTER, "ListMPDrv_ioctl", cmd, args);
 
@@ -218,6 +219,7 @@ ListMPDrv_ioctl (UInt32 cmd, Ptr args)
 
     osStatus = ioctl (ListMPDrv_handle, cmd, args);
     if (osStatus < 0) {
+        osErrno = errno;
     /*! @retval ListMP_E_OSFAILURE Driver ioctl failed */
         status = ListMP_E_OSFAILURE;
         GT_setFailureReason (curTrace,
@@ -233,6 +235,11 @@ ListMPDrv_ioctl (UInt32 cmd, Ptr args)
 
     GT_1trace (curTrace, GT_LEAVE, "ListMPDrv_ioctl", status);
 
+    if (osStatus < 0) {
+        /* Left in errno so that callers can tell an unknown command apart. */
+        errno = osErrno;
+    }
+
     /*! @retval ListMP_S_SUCCESS Operation successfully completed. */
     return status;
 }
@@ -134,6 +134,10 @@
 #include <MessageQDrvDefs.h>
 #include <MessageQDrv.h>
 #include <ti/ipc/SharedRegion.h>
+#include <_SharedRegion.h>
+
+/* Linux specific header files */
+#include <errno.h>
 
 
 #if defined (__cplusplus)
@@ -161,6 +165,11 @@ typedef struct MessageQ_ModuleObject_tag {
     UInt32          setupRefCount;
     /*!< Reference count for number of times setup/destroy were called in this
          process. */
+    Bool            batchSupported;
+    /*!< Whether the driver accepts the PUTMANY/GETMANY commands. Cleared the
+         first time the driver rejects a batched command as unknown
+         (ENOTTY), after which the batched APIs fall back to one PUT/GET per
+         message. */
 } MessageQ_ModuleObject;
 
 
@@ -178,7 +187,8 @@ static
 #endif /* if !defined(SYSLINK_BUILD_DEBUG) */
 MessageQ_ModuleObject MessageQ_state =
 {
-    .setupRefCount = 0
+    .setupRefCount  = 0,
+    .batchSupported = TRUE
 };
 
 /*!
@@ -192,6 +202,44 @@ static
 MessageQ_ModuleObject * MessageQ_module = &MessageQ_state;
 
 
+/* =============================================================================
+ *  Internal functions
+ * =============================================================================
+ */
+/* Invalidates a message received from the kernel or a remote processor. The
+ * header is invalidated first so that msgSize is read from memory.
+ */
+static
+Int
+_MessageQ_cacheInvMsg (MessageQ_Msg msg)
+{
+    Int status;
+
+    status = _SharedRegion_cacheInv (msg, sizeof (MessageQ_MsgHeader));
+    if ((status >= 0) && (msg->msgSize > sizeof (MessageQ_MsgHeader))) {
+        status = _SharedRegion_cacheInv (msg, msg->msgSize);
+    }
+
+    return ((status < 0) ? MessageQ_E_FAIL : MessageQ_S_SUCCESS);
+}
+
+
+/* Returns a message that could not be invalidated to its heap. No cache
+ * maintenance is done; this process has not written to the message.
+ */
+static
+Void
+_MessageQ_releaseMsg (MessageQ_Msg msg)
+{
+    MessageQDrv_CmdArgs cmdArgs;
+    UInt16              index;
+
+    index = SharedRegion_getId (msg);
+    cmdArgs.args.free.msgSrPtr = SharedRegion_getSRPtr (msg, index);
+    MessageQDrv_ioctl (CMD_MESSAGEQ_FREE, &cmdArgs);
+}
+
+
 /* =============================================================================
  * APIS
  * =============================================================================
@@ -728,19 +776,29 @@ MessageQ_put (MessageQ_QueueId queueId,
     }
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        cmdArgs.args.put.queueId  = queueId;
-        index = SharedRegion_getId (msg);
-        cmdArgs.args.put.msgSrPtr = SharedRegion_getSRPtr (msg, index);
+        /* A message whose data may still sit in the cache must not be
+         * handed over; it stays owned by the caller.
+         */
+        if (_SharedRegion_cacheWbInv (msg, msg->msgSize) < 0) {
+            status = MessageQ_E_FAIL;
+        }
+        else {
+            cmdArgs.args.put.queueId  = queueId;
+            index = SharedRegion_getId (msg);
+            cmdArgs.args.put.msgSrPtr = SharedRegion_getSRPtr (msg, index);
 
-        status = MessageQDrv_ioctl (CMD_MESSAGEQ_PUT, &cmdArgs);
+            status = MessageQDrv_ioctl (CMD_MESSAGEQ_PUT, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "MessageQ_put",
-                                 status,
-                                 "API (through IOCTL) failed on kernel-side!");
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "MessageQ_put",
+                                     status,
+                                     "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -818,6 +876,12 @@ MessageQ_get (MessageQ_Handle handle, MessageQ_Msg * msg ,UInt timeout)
             msgSrPtr = cmdArgs.args.get.msgSrPtr;
             if (msgSrPtr != SharedRegion_INVALIDSRPTR) {
                 *msg = (MessageQ_Msg) SharedRegion_getPtr (msgSrPtr);
+                if (_MessageQ_cacheInvMsg (*msg) < 0) {
+                    /* Its contents may be stale; drop it. */
+                    _MessageQ_releaseMsg (*msg);
+                    *msg = NULL;
+                    status = MessageQ_E_FAIL;
+                }
             }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         }
@@ -830,6 +894,271 @@ MessageQ_get (MessageQ_Handle handle, MessageQ_Msg * msg ,UInt timeout)
 }
 
 
+/* Place several messages onto a message queue, one ioctl per batch. */
+Int
+MessageQ_putMany (MessageQ_QueueId   queueId,
+                  MessageQ_Msg     * msgs,
+                  UInt               numMsgs,
+                  UInt             * numPut)
+{
+    Int                 status = MessageQ_S_SUCCESS;
+    UInt                done   = 0;
+    UInt                batch;
+    UInt                i;
+    UInt16              index;
+    SharedRegion_SRPtr  msgSrPtrs [MESSAGEQ_MAXBATCH];
+    MessageQDrv_CmdArgs cmdArgs;
+
+    GT_3trace (curTrace, GT_ENTER, "MessageQ_putMany", queueId, msgs, numMsgs);
+
+    GT_assert (curTrace, (queueId != MessageQ_INVALIDMESSAGEQ));
+    GT_assert (curTrace, ((msgs != NULL) || (numMsgs == 0)));
+
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    if (MessageQ_module->setupRefCount == 0) {
+        status = MessageQ_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "MessageQ_putMany",
+                             status,
+                             "Module is not initialized!");
+    }
+    else if (queueId == MessageQ_INVALIDMESSAGEQ) {
+        status = MessageQ_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "MessageQ_putMany",
+                             status,
+                             "queueId is MessageQ_INVALIDMESSAGEQ!");
+    }
+    else if ((msgs == NULL) && (numMsgs != 0)) {
+        status = MessageQ_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "MessageQ_putMany",
+                             status,
+                             "msgs is null!");
+    }
+    else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        while ((done < numMsgs) && (status >= 0)) {
+            if (MessageQ_module->batchSupported == FALSE) {
+                status = MessageQ_put (queueId, msgs [done]);
+                if (status >= 0) {
+                    done++;
+                }
+                continue;
+            }
+
+            batch = numMsgs - done;
+            if (batch > MESSAGEQ_MAXBATCH) {
+                batch = MESSAGEQ_MAXBATCH;
+            }
+            for (i = 0; i < batch; i++) {
+                if (_SharedRegion_cacheWbInv (msgs [done + i],
+                                              msgs [done + i]->msgSize) < 0) {
+                    break;
+                }
+                index = SharedRegion_getId (msgs [done + i]);
+                msgSrPtrs [i] = SharedRegion_getSRPtr (msgs [done + i], index);
+            }
+            if (i == 0) {
+                /* msgs [done] could not be written back; it and the rest
+                 * stay with the caller.
+                 */
+                status = MessageQ_E_FAIL;
+                continue;
+            }
+            /* Put the messages before a failed write-back; the next pass
+             * stops on it.
+             */
+            batch = i;
+
+            cmdArgs.args.putMany.queueId   = queueId;
+            cmdArgs.args.putMany.msgSrPtrs = msgSrPtrs;
+            cmdArgs.args.putMany.numMsgs   = batch;
+            cmdArgs.args.putMany.numPut    = 0;
+
+            status = MessageQDrv_ioctl (CMD_MESSAGEQ_PUTMANY, &cmdArgs);
+            if ((status == MessageQ_E_OSFAILURE) && (errno == ENOTTY)) {
+                /* Driver predates the batched commands; nothing was put.
+                 * Any other failure may follow partial progress, so it ends
+                 * the call with the count the kernel reported.
+                 */
+                MessageQ_module->batchSupported = FALSE;
+                status = MessageQ_S_SUCCESS;
+                continue;
+            }
+
+            if (status >= 0) {
+                done += batch;
+            }
+            else {
+                done += cmdArgs.args.putMany.numPut;
+            }
+        }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "MessageQ_putMany",
+                                 status,
+                                 "API (through IOCTL) failed on kernel-side!");
+        }
+    }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+
+    if (numPut != NULL) {
+        *numPut = done;
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "MessageQ_putMany", status);
+
+    return (status);
+}
+
+
+/* Gets several messages from a message queue, one ioctl per batch. Blocks
+ * only for the first message; the rest are whatever is already queued.
+ */
+Int
+MessageQ_getMany (MessageQ_Handle   handle,
+                  MessageQ_Msg    * msgs,
+                  UInt              maxMsgs,
+                  UInt            * numMsgs,
+                  UInt              timeout)
+{
+    Int                 status = MessageQ_S_SUCCESS;
+    UInt                done   = 0;
+    UInt                batch;
+    UInt                i;
+    UInt                n;
+    SharedRegion_SRPtr  msgSrPtrs [MESSAGEQ_MAXBATCH];
+    MessageQDrv_CmdArgs cmdArgs;
+
+    GT_4trace (curTrace, GT_ENTER, "MessageQ_getMany",
+               handle, msgs, maxMsgs, timeout);
+
+    GT_assert (curTrace, (handle != NULL));
+    GT_assert (curTrace, (msgs != NULL));
+    GT_assert (curTrace, (numMsgs != NULL));
+
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    if (MessageQ_module->setupRefCount == 0) {
+        status = MessageQ_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "MessageQ_getMany",
+                             status,
+                             "Module is not initialized!");
+    }
+    else if (handle == NULL) {
+        status = MessageQ_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "MessageQ_getMany",
+                             status,
+                             "handle pointer passed is null!");
+    }
+    else if ((msgs == NULL) || (numMsgs == NULL) || (maxMsgs == 0)) {
+        status = MessageQ_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "MessageQ_getMany",
+                             status,
+                             "Invalid msgs/numMsgs/maxMsgs specified!");
+    }
+    else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        GT_assert (curTrace,
+                   (((MessageQ_Object *)(handle))->knlObject != NULL));
+
+        while ((done < maxMsgs) && (status >= 0)) {
+            if (MessageQ_module->batchSupported == FALSE) {
+                /* Only the first get may block. */
+                status = MessageQ_get (handle, &msgs [done],
+                                       (done == 0) ? timeout : 0);
+                if ((status < 0) || (msgs [done] == NULL)) {
+                    break;
+                }
+                done++;
+                continue;
+            }
+
+            batch = maxMsgs - done;
+            if (batch > MESSAGEQ_MAXBATCH) {
+                batch = MESSAGEQ_MAXBATCH;
+            }
+
+            cmdArgs.args.getMany.handle    =
+                                    ((MessageQ_Object *)(handle))->knlObject;
+            cmdArgs.args.getMany.timeout   = (done == 0) ? timeout : 0;
+            cmdArgs.args.getMany.msgSrPtrs = msgSrPtrs;
+            cmdArgs.args.getMany.maxMsgs   = batch;
+            cmdArgs.args.getMany.numMsgs   = 0;
+
+            status = MessageQDrv_ioctl (CMD_MESSAGEQ_GETMANY, &cmdArgs);
+            if ((status == MessageQ_E_OSFAILURE) && (errno == ENOTTY)) {
+                /* Driver predates the batched commands; nothing was taken. */
+                MessageQ_module->batchSupported = FALSE;
+                status = MessageQ_S_SUCCESS;
+                continue;
+            }
+
+            if (status >= 0) {
+                n = 0;
+                for (i = 0; i < cmdArgs.args.getMany.numMsgs; i++) {
+                    msgs [done + n] = (MessageQ_Msg)
+                                        SharedRegion_getPtr (msgSrPtrs [i]);
+                    if (_MessageQ_cacheInvMsg (msgs [done + n]) < 0) {
+                        /* Its contents may be stale; drop it. */
+                        _MessageQ_releaseMsg (msgs [done + n]);
+                        status = MessageQ_E_FAIL;
+                    }
+                    else {
+                        n++;
+                    }
+                }
+                done += n;
+                if (cmdArgs.args.getMany.numMsgs < batch) {
+                    /* Queue drained. */
+                    break;
+                }
+            }
+        }
+
+        /* Messages already handed out are owned by the caller, so a timeout
+         * or unblock after the first batch is not an error. A dropped
+         * message still is.
+         */
+        if ((done > 0) && (status != MessageQ_E_FAIL)) {
+            status = MessageQ_S_SUCCESS;
+        }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+        if (    (status < 0)
+            &&  (status != MessageQ_E_FAIL)
+            &&  (status != MessageQ_E_TIMEOUT)
+            &&  (status != MessageQ_E_UNBLOCKED)) {
+            /* Timeout and unblock are valid runtime errors. */
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "MessageQ_getMany",
+                                 status,
+                                 "API (through IOCTL) failed on kernel-side!");
+        }
+    }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+
+    if (numMsgs != NULL) {
+        *numMsgs = done;
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "MessageQ_getMany", status);
+
+    return (status);
+}
+
+
 /* Return a count of the number of messages in the queue */
 Int
 MessageQ_count (MessageQ_Handle handle)
@@ -982,6 +1311,10 @@ MessageQ_alloc (UInt16 heapId, UInt32 size)
             msgSrPtr = cmdArgs.args.alloc.msgSrPtr;
             if (msgSrPtr != SharedRegion_INVALIDSRPTR) {
                 msg = SharedRegion_getPtr (msgSrPtr);
+                if (_SharedRegion_cacheInv (msg, size) < 0) {
+                    _MessageQ_releaseMsg (msg);
+                    msg = NULL;
+                }
             }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         }
@@ -1032,17 +1365,27 @@ MessageQ_free (MessageQ_Msg msg)
     }
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        index = SharedRegion_getId (msg);
-        cmdArgs.args.free.msgSrPtr = SharedRegion_getSRPtr (msg, index);
-        status = MessageQDrv_ioctl (CMD_MESSAGEQ_FREE, &cmdArgs);
+        /* Freeing with dirty lines still cached would let a later write-back
+         * land on the next owner's data; keep the message instead.
+         */
+        if (_SharedRegion_cacheWbInv (msg, msg->msgSize) < 0) {
+            status = MessageQ_E_FAIL;
+        }
+        else {
+            index = SharedRegion_getId (msg);
+            cmdArgs.args.free.msgSrPtr = SharedRegion_getSRPtr (msg, index);
+            status = MessageQDrv_ioctl (CMD_MESSAGEQ_FREE, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "MessageQ_free",
-                                 status,
-                                 "API (through IOCTL) failed on kernel-side!");
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "MessageQ_free",
+                                     status,
+                                     "API (through IOCTL) failed on kernel-side!");
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -204,6 +204,7 @@ MessageQDrv_ioctl (UInt32 cmd, Ptr args)
 {
     Int status      = MessageQ_S_SUCCESS;
     int osStatus    = 0;
+    int osErrno     = 0;
 
     GT_2trace (curTrace, GT_ENTER, "MessageQDrv_ioctl", cmd, args);
 
@@ -214,6 +215,7 @@ MessageQDrv_ioctl (UInt32 cmd, Ptr args)
     } while( (osStatus < 0) && (errno == EINTR) );
 
     if (osStatus < 0) {
+        osErrno = errno;
         /*! @retval MessageQ_E_OSFAILURE Driver ioctl failed */
         status = MessageQ_E_OSFAILURE;
         GT_setFailureReason (curTrace,
@@ -229,6 +231,11 @@ MessageQDrv_ioctl (UInt32 cmd, Ptr args)
 
     GT_1trace (curTrace, GT_LEAVE, "MessageQDrv_ioctl", status);
 
+    if (osStatus < 0) {
+        /* Left in errno so that callers can tell an unknown command apart. */
+        errno = osErrno;
+    }
+
     /*! @retval MessageQ_S_SUCCESS Operation successfully completed. */
     return status;
 }
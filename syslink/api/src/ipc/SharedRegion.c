@@ -79,6 +79,9 @@
 /* Standard headers */
 #include <Std.h>
 
+/* Linux specific header files */
+#include <sched.h>
+
 /* OSAL & Utils headers */
 #include <Memory.h>
 #include <String.h>
@@ -86,6 +89,7 @@
 #include <GateMutex.h>
 #include <Gate.h>
 #include <Bitops.h>
+#include <Cache.h>
 
 /* Module level headers */
 #include <ti/ipc/MultiProc.h>
@@ -128,6 +132,21 @@ UInt32 SharedRegion_getNumOffsetBits();
  */
 Int SharedRegion_checkOverlap (Ptr    base, UInt32 len);
 
+/*!
+ *  @brief      Rebuilds and publishes the address translation snapshot.
+ *              Must be called with the localLock held.
+ *
+ *  @sa         None
+ */
+static Void _SharedRegion_publishXlt (Void);
+
+/*!
+ *  @brief      Frees the current translation snapshot.
+ *
+ *  @sa         None
+ */
+static Void _SharedRegion_freeXlt (Void);
+
 
 /* =============================================================================
  * Macros and types
@@ -140,11 +159,48 @@ Int SharedRegion_checkOverlap (Ptr    base, UInt32 len);
  */
 #define IS_RANGE_VALID(x,min,max) (((x) < (max)) && ((x) >= (min)))
 
+/*!
+ *  @def    IS_CACHED_REGION
+ *  @brief  Checks if region id is mapped cached according to the given
+ *          cachedRegionMask.
+ */
+#define IS_CACHED_REGION(mask,id) (((id) < 32u) && (((mask) >> (id)) & 1u))
+
 
 /* =============================================================================
  * Structure & Enums
  * =============================================================================
  */
+/*!
+ *  @brief  Address range of one region in a translation snapshot
+ */
+typedef struct SharedRegion_XltRange_tag {
+    UInt32 base;
+    /*!< Local virtual base address of the region */
+    UInt32 end;
+    /*!< One past the last address of the region */
+    UInt16 id;
+    /*!< Region id */
+} SharedRegion_XltRange;
+
+/*!
+ *  @brief  Read-only snapshot of the region table used by getId, getPtr and
+ *          getSRPtr without taking the localLock.
+ *
+ *          A new snapshot is built and published with a single pointer store
+ *          whenever an entry is set or cleared. Readers count themselves in
+ *          xltReaders while they use a snapshot, and a superseded snapshot is
+ *          freed as soon as those counts have drained.
+ */
+typedef struct SharedRegion_Xlt_tag {
+    UInt16                        numRanges;
+    /*!< Number of valid regions in 'ranges' */
+    SharedRegion_XltRange       * ranges;
+    /*!< Valid regions sorted by base address, for getId */
+    SharedRegion_XltRange       * byId;
+    /*!< Every region indexed by id, for getPtr/getSRPtr */
+} SharedRegion_Xlt;
+
 /*!
  *  @brief  SharedRegion Module state object
  */
@@ -162,9 +218,50 @@ typedef struct SharedRegion_ModuleObject_tag {
                                                * in knl space
                                                */
     SharedRegion_Config   cfg;        /*!< Current config values */
+    SharedRegion_Xlt    * volatile xlt;
+    /*!< Current translation snapshot. NULL if it could not be allocated, in
+     *   which case lookups fall back to scanning regions under localLock.
+     */
+    volatile UInt32       xltReaders [2];
+    /*!< Lock-free lookups in progress, counted by epoch parity */
+    volatile UInt32       xltEpoch;
+    /*!< Selects the xltReaders counter new lookups use */
+    volatile Bool         xltEnabled;
+    /*!< Whether lookups use the snapshot, see _SharedRegion_setLockFree */
+    volatile UInt32       cachedRegions;
+    /*!< Regions actually mapped cached, one bit per region id. A region of
+     *   cfg.cachedRegionMask is mapped uncached when no cache maintenance is
+     *   available at the time it is mapped.
+     */
 } SharedRegion_ModuleObject;
 
 
+/* =============================================================================
+ * Forward declarations of internal functions
+ * =============================================================================
+ */
+/*!
+ *  @brief      Counts the caller as a lock-free reader and returns the current
+ *              translation snapshot. If there is none, the count is dropped
+ *              again and NULL is returned; otherwise the caller must release
+ *              it with _SharedRegion_leaveXlt once done with the snapshot.
+ *
+ *  @param      reader    Location to receive the readers counter to release
+ *
+ *  @sa         _SharedRegion_leaveXlt
+ */
+static SharedRegion_Xlt * _SharedRegion_enterXlt (UInt32 * reader);
+
+/*!
+ *  @brief      Releases a reader counted by _SharedRegion_enterXlt.
+ *
+ *  @param      reader    Readers counter returned by _SharedRegion_enterXlt
+ *
+ *  @sa         _SharedRegion_enterXlt
+ */
+static Void _SharedRegion_leaveXlt (UInt32 reader);
+
+
 /* =============================================================================
  * Globals
  * =============================================================================
@@ -184,6 +281,11 @@ SharedRegion_ModuleObject SharedRegion_state =
     .regions              = NULL,
     .localLock            = NULL,
     .offsetMask           = 0,
+    .xlt                  = NULL,
+    .xltReaders           = {0, 0},
+    .xltEpoch             = 0,
+    .xltEnabled           = TRUE,
+    .cachedRegions        = 0,
 };
 
 /*!
@@ -244,6 +346,9 @@ SharedRegion_getConfig (SharedRegion_Config * config)
             status =
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
             SharedRegionDrv_ioctl (CMD_SHAREDREGION_GETCONFIG, &cmdArgs);
+
+            /* Cached mappings are a user-side choice, unknown to the driver. */
+            config->cachedRegionMask = 0;
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
             if (status < 0) {
                 GT_setFailureReason (curTrace,
@@ -362,8 +467,28 @@ SharedRegion_setup (SharedRegion_Config * cfg)
                     }
                     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+                        /* The driver maps the regions that are valid now
+                         * with this mask; see _SharedRegion_setRegions.
+                         */
+                        SharedRegion_module->cachedRegions =
+                                     SharedRegion_module->cfg.cachedRegionMask;
+                        if (    (SharedRegion_module->cachedRegions != 0)
+                            &&  (Cache_isEnabled () == FALSE)) {
+                            GT_0trace (curTrace,
+                                       GT_4CLASS,
+                                       "SharedRegion_setup: no cache "
+                                       "maintenance available, mapping "
+                                       "regions uncached");
+                            SharedRegion_module->cachedRegions = 0;
+                        }
+                        Memory_copy ((Ptr) &tCfg,
+                                     (Ptr) &(SharedRegion_module->cfg),
+                                     sizeof (SharedRegion_Config));
+                        tCfg.cachedRegionMask =
+                                     SharedRegion_module->cachedRegions;
+
                         cmdArgs.args.setup.regions  = SharedRegion_module->regions;
-                        cmdArgs.args.setup.config   = (SharedRegion_Config *) ptCfg;
+                        cmdArgs.args.setup.config   = &tCfg;
                         for (i = 0; i < SharedRegion_module->cfg.numEntries; i++) {
                             SharedRegion_module->regions[i].entry.base = NULL;
                             SharedRegion_module->regions[i].entry.len = 0;
@@ -400,6 +525,14 @@ SharedRegion_setup (SharedRegion_Config * cfg)
             }
 
             if (status >= 0) {
+                /* Only the regions mapped above are cached so far. */
+                for (i = 0; (i < SharedRegion_module->cfg.numEntries) && (i < 32u);
+                     i++) {
+                    if (SharedRegion_module->regions[i].entry.isValid != TRUE) {
+                        SharedRegion_module->cachedRegions &= ~(1u << i);
+                    }
+                }
+
                 SharedRegion_module->numOffsetBits =
                                             SharedRegion_getNumOffsetBits ();
                 SharedRegion_module->offsetMask =
@@ -417,6 +550,11 @@ SharedRegion_setup (SharedRegion_Config * cfg)
                                          SharedRegion_E_MEMORY,
                                          "Failed to create the localLock!");
                 }
+                else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+                    _SharedRegion_publishXlt ();
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+                }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
             }
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -475,6 +613,9 @@ SharedRegion_destroy (Void)
                          (  sizeof (UInt32) *
                          SharedRegion_module->cfg.numEntries));
         }
+        /* No translation can be in flight once the module is torn down. */
+        _SharedRegion_freeXlt ();
+
         if (SharedRegion_module->regions != NULL) {
             Memory_free (NULL,
                          SharedRegion_module->regions,
@@ -489,6 +630,7 @@ SharedRegion_destroy (Void)
 
         SharedRegion_module->numOffsetBits = 0;
         SharedRegion_module->offsetMask    = 0;
+        SharedRegion_module->cachedRegions = 0;
 
         if (SharedRegion_module->localLock != NULL) {
             /* Leave the gate */
@@ -746,6 +888,19 @@ SharedRegion_setEntry (UInt16               id,
                          (Ptr) entry,
                          sizeof (SharedRegion_Entry));
 
+            /* The caller mapped the region; cfg.cachedRegionMask states
+             * whether that mapping is cached.
+             */
+            if (IS_CACHED_REGION (SharedRegion_module->cfg.cachedRegionMask,
+                                  id)) {
+                SharedRegion_module->cachedRegions |= (1u << id);
+            }
+            else if (id < 32u) {
+                SharedRegion_module->cachedRegions &= ~(1u << id);
+            }
+
+            _SharedRegion_publishXlt ();
+
             /* Leave the gate */
             IGateProvider_leave (SharedRegion_module->localLock, key);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -768,8 +923,13 @@ UInt16
 SharedRegion_getId (Ptr addr)
 {
     SharedRegion_Region  * region = NULL;
+    SharedRegion_Xlt     * xlt;
+    UInt32                 reader;
     UInt16                 id = SharedRegion_INVALIDREGIONID;
     UInt32                 i;
+    UInt32                 lo;
+    UInt32                 hi;
+    UInt32                 mid;
     IArg                   key;
 
     GT_1trace (curTrace, GT_ENTER, "SharedRegion_getId", addr);
@@ -788,6 +948,30 @@ SharedRegion_getId (Ptr addr)
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
     /* Return invalid for NULL addr */
     if (addr != NULL) {
+        xlt = _SharedRegion_enterXlt (&reader);
+        if (xlt != NULL) {
+            /* Binary search for the last range starting at or below addr. */
+            lo = 0;
+            hi = xlt->numRanges;
+            while (lo < hi) {
+                mid = (lo + hi) >> 1;
+                if ((UInt32) addr < xlt->ranges [mid].base) {
+                    hi = mid;
+                }
+                else {
+                    lo = mid + 1;
+                }
+            }
+            if ((lo > 0) && ((UInt32) addr < xlt->ranges [lo - 1].end)) {
+                id = xlt->ranges [lo - 1].id;
+            }
+            _SharedRegion_leaveXlt (reader);
+
+            GT_1trace (curTrace, GT_LEAVE, "SharedRegion_getId", id);
+
+            return id;
+        }
+
         /* Enter the gate */
         key = IGateProvider_enter (SharedRegion_module->localLock);
 
@@ -820,6 +1004,8 @@ SharedRegion_getPtr (SharedRegion_SRPtr srPtr)
 {
 
     SharedRegion_Region * region    = NULL;
+    SharedRegion_Xlt    * xlt;
+    UInt32                reader;
     Ptr                   returnPtr = NULL;
     IArg                  key    = 0;
     UInt16                regionId;
@@ -843,6 +1029,26 @@ SharedRegion_getPtr (SharedRegion_SRPtr srPtr)
         if (SharedRegion_module->cfg.translate == FALSE) {
             returnPtr = (Ptr) srPtr;
         }
+        else if ((xlt = _SharedRegion_enterXlt (&reader)) != NULL) {
+            regionId = (UInt32) (srPtr >> SharedRegion_module->numOffsetBits);
+
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+            if (regionId >= SharedRegion_module->cfg.numEntries) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "SharedRegion_getPtr",
+                                     SharedRegion_E_INVALIDARG,
+                                     "Id cannot be larger than numEntries!");
+            }
+            else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+                returnPtr = (Ptr)(  (srPtr & SharedRegion_module->offsetMask)
+                                  + xlt->byId [regionId].base);
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+            }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+            _SharedRegion_leaveXlt (reader);
+        }
         else {
             /* Enter the gate */
             key = IGateProvider_enter (SharedRegion_module->localLock);
@@ -883,6 +1089,8 @@ SharedRegion_SRPtr
 SharedRegion_getSRPtr (Ptr addr, UInt16 id)
 {
     SharedRegion_Region * region  = NULL;
+    SharedRegion_Xlt    * xlt;
+    UInt32                reader;
     SharedRegion_SRPtr    retPtr = SharedRegion_INVALIDSRPTR ;
     IArg                  key    = 0;
 
@@ -928,6 +1136,23 @@ SharedRegion_getSRPtr (Ptr addr, UInt16 id)
             if (SharedRegion_module->cfg.translate == FALSE) {
                 retPtr = (SharedRegion_SRPtr) addr;
             }
+            else if ((xlt = _SharedRegion_enterXlt (&reader)) != NULL) {
+                if (    ((UInt32) addr >= xlt->byId [id].base)
+                    &&  ((UInt32) addr <  xlt->byId [id].end)) {
+                    retPtr = (SharedRegion_SRPtr)
+                              (  (id << SharedRegion_module->numOffsetBits)
+                               | ((UInt32) addr - xlt->byId [id].base));
+                }
+                else {
+                    GT_setFailureReason (curTrace,
+                                         GT_4CLASS,
+                                         "SharedRegion_getSRPtr",
+                                         SharedRegion_E_INVALIDARG,
+                                         "Provided addr is not in correct range"
+                                         " for the specified id!");
+                }
+                _SharedRegion_leaveXlt (reader);
+            }
             else {
                 /* Enter the gate */
                 key = IGateProvider_enter (SharedRegion_module->localLock);
@@ -1046,6 +1271,8 @@ SharedRegion_clearEntry (UInt16 id)
             region->reservedSize        = 0u;
             region->heap                = NULL;
 
+            _SharedRegion_publishXlt ();
+
             /* Leave the gate */
             IGateProvider_leave (SharedRegion_module->localLock, key);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -1771,6 +1998,8 @@ _SharedRegion_setRegions (Void)
     SharedRegion_Region *   regions = NULL;
     SharedRegionDrv_CmdArgs cmdArgs;
     Memory_MapInfo          mapInfo;
+    IArg                    key;
+    Bool                    cached;
 
     cmdArgs.args.getRegionInfo.regions = (SharedRegion_Region *)
                                       Memory_alloc (NULL,
@@ -1810,9 +2039,24 @@ _SharedRegion_setRegions (Void)
                 regions = &(cmdArgs.args.getRegionInfo.regions [i]);
                 if (regions->entry.isValid == TRUE) {
                     if (SharedRegion_module->regions[i].entry.isValid != TRUE) {
+                        cached = IS_CACHED_REGION (
+                                    SharedRegion_module->cfg.cachedRegionMask,
+                                    i);
+                        if ((cached == TRUE) && (Cache_isEnabled () == FALSE)) {
+                            /* Without maintenance the mapping would not stay
+                             * coherent with the other processors.
+                             */
+                            GT_1trace (curTrace,
+                                       GT_4CLASS,
+                                       "_SharedRegion_setRegions: no cache "
+                                       "maintenance available, mapping region "
+                                       "%d uncached",
+                                       i);
+                            cached = FALSE;
+                        }
                         mapInfo.src  = (UInt32) regions->entry.base;
                         mapInfo.size = regions->entry.len;
-                        mapInfo.isCached = FALSE;
+                        mapInfo.isCached = cached;
                         status = Memory_map (&mapInfo);
                         if (status < 0) {
                             GT_setFailureReason (curTrace,
@@ -1829,6 +2073,13 @@ _SharedRegion_setRegions (Void)
                                        (Ptr) mapInfo.dst;
                             SharedRegion_module->regions[i].entry.isValid = TRUE;
                             SharedRegion_module->bCreatedInKnlSpace[i] = TRUE;
+                            if (cached == TRUE) {
+                                SharedRegion_module->cachedRegions |= (1u << i);
+                            }
+                            else if (i < 32u) {
+                                SharedRegion_module->cachedRegions &=
+                                                                ~(1u << i);
+                            }
 
                             /* Not Opening heapMem  instances for the regions
                              * that  have createHeap flag set to TRUE.
@@ -1844,6 +2095,10 @@ _SharedRegion_setRegions (Void)
                     }
                 }
             }
+
+            key = IGateProvider_enter (SharedRegion_module->localLock);
+            _SharedRegion_publishXlt ();
+            IGateProvider_leave (SharedRegion_module->localLock, key);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
@@ -1871,6 +2126,7 @@ _SharedRegion_clearRegions ()
     UInt32              i;
     Memory_UnmapInfo    unmapInfo;
     SharedRegion_Region *regions;
+    IArg                key;
 
     for (i = 0;
         (   (i < SharedRegion_module->cfg.numEntries) && (status >= 0));
@@ -1884,9 +2140,16 @@ _SharedRegion_clearRegions ()
 
 //            Gate_leaveSystem();
 
+            /* Stop translating into the region before it is unmapped. */
+            key = IGateProvider_enter (SharedRegion_module->localLock);
+            _SharedRegion_publishXlt ();
+            IGateProvider_leave (SharedRegion_module->localLock, key);
+
             unmapInfo.addr  = (UInt32) regions->entry.base;
             unmapInfo.size = regions->entry.len;
-            unmapInfo.isCached = FALSE;
+            unmapInfo.isCached = IS_CACHED_REGION (
+                                    SharedRegion_module->cachedRegions,
+                                    i);
             status = Memory_unmap (&unmapInfo);
             if (status < 0) {
                 status = SharedRegion_E_FAIL;
@@ -1898,6 +2161,9 @@ _SharedRegion_clearRegions ()
             }
             else {
                     regions->entry.base = NULL;
+                    if (i < 32u) {
+                        SharedRegion_module->cachedRegions &= ~(1u << i);
+                    }
             }
         }
 
@@ -1907,6 +2173,204 @@ _SharedRegion_clearRegions ()
     return status;
 }
 
+/* Writes back and invalidates a block of a cached region before it is
+ * handed over to another processor.
+ */
+Int
+_SharedRegion_cacheWbInv (Ptr addr, SizeT size)
+{
+    Int    status = SharedRegion_S_SUCCESS;
+    UInt32 mask   = SharedRegion_module->cachedRegions;
+    UInt16 id;
+
+    if (mask != 0) {
+        id = SharedRegion_getId (addr);
+        if (    IS_CACHED_REGION (mask, id)
+            &&  (Cache_wbInv (addr, size, Cache_Type_ALL, TRUE) < 0)) {
+            status = SharedRegion_E_FAIL;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_SharedRegion_cacheWbInv",
+                                 status,
+                                 "Cache write back failed!");
+        }
+    }
+
+    return status;
+}
+
+/* Invalidates a block of a cached region after it is received from another
+ * processor.
+ */
+Int
+_SharedRegion_cacheInv (Ptr addr, SizeT size)
+{
+    Int    status = SharedRegion_S_SUCCESS;
+    UInt32 mask   = SharedRegion_module->cachedRegions;
+    UInt16 id;
+
+    if (mask != 0) {
+        id = SharedRegion_getId (addr);
+        if (    IS_CACHED_REGION (mask, id)
+            &&  (Cache_inv (addr, size, Cache_Type_ALL, TRUE) < 0)) {
+            status = SharedRegion_E_FAIL;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_SharedRegion_cacheInv",
+                                 status,
+                                 "Cache invalidate failed!");
+        }
+    }
+
+    return status;
+}
+
+/* Tells whether a region is currently mapped cached. */
+Bool
+_SharedRegion_isCached (UInt16 id)
+{
+    return (IS_CACHED_REGION (SharedRegion_module->cachedRegions, id)
+            ? TRUE : FALSE);
+}
+
+/* Enables or disables the lock-free address translation. */
+Void
+_SharedRegion_setLockFree (Bool enable)
+{
+    GT_1trace (curTrace, GT_ENTER, "_SharedRegion_setLockFree", enable);
+
+    SharedRegion_module->xltEnabled = enable;
+
+    GT_0trace (curTrace, GT_LEAVE, "_SharedRegion_setLockFree");
+}
+
+
+/* Rebuilds the translation snapshot from the region table and publishes it.
+ * Called with the localLock held, so writers are serialized; readers only
+ * ever see a fully built snapshot.
+ *
+ * Any reader that can see the old snapshot was counted before the new one
+ * was published, so once the epoch has been flipped twice and each readers
+ * counter has drained, the old snapshot is unreachable and is freed. Readers
+ * never hold a count while waiting for the localLock, so the wait cannot
+ * deadlock against this caller.
+ */
+static Void
+_SharedRegion_publishXlt (Void)
+{
+    SharedRegion_Xlt      * xlt;
+    SharedRegion_Xlt      * old        = SharedRegion_module->xlt;
+    SharedRegion_Region   * region;
+    SharedRegion_XltRange   range;
+    UInt16                  numEntries = SharedRegion_module->cfg.numEntries;
+    SizeT                   size;
+    UInt16                  i;
+    Int                     j;
+    UInt32                  idx;
+    UInt32                  round;
+
+    size =   sizeof (SharedRegion_Xlt)
+           + (2 * numEntries * sizeof (SharedRegion_XltRange));
+    xlt = (SharedRegion_Xlt *) Memory_alloc (NULL, size, 0);
+    if (xlt == NULL) {
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_SharedRegion_publishXlt",
+                             SharedRegion_E_MEMORY,
+                             "Failed to allocate translation snapshot, "
+                             "falling back to locked lookups!");
+    }
+    else {
+        xlt->ranges    = (SharedRegion_XltRange *) (xlt + 1);
+        xlt->byId      = xlt->ranges + numEntries;
+        xlt->numRanges = 0;
+
+        for (i = 0; i < numEntries; i++) {
+            region = &(SharedRegion_module->regions [i]);
+            range.base = (UInt32) region->entry.base;
+            range.end  = (UInt32) region->entry.base + region->entry.len;
+            range.id   = i;
+            xlt->byId [i] = range;
+
+            if (region->entry.isValid) {
+                /* Insertion sort; numEntries is small. */
+                for (j = xlt->numRanges;
+                     (j > 0) && (xlt->ranges [j - 1].base > range.base);
+                     j--) {
+                    xlt->ranges [j] = xlt->ranges [j - 1];
+                }
+                xlt->ranges [j] = range;
+                xlt->numRanges++;
+            }
+        }
+    }
+
+    /* Make the snapshot contents visible before the pointer. */
+    __sync_synchronize ();
+    SharedRegion_module->xlt = xlt;
+    __sync_synchronize ();
+
+    if (old != NULL) {
+        for (round = 0; round < 2; round++) {
+            idx = SharedRegion_module->xltEpoch & 1u;
+            __sync_fetch_and_add (&SharedRegion_module->xltEpoch, 1);
+            while (SharedRegion_module->xltReaders [idx] != 0) {
+                sched_yield ();
+            }
+        }
+        Memory_free (NULL, old, size);
+    }
+}
+
+
+/* Frees the current translation snapshot. */
+static Void
+_SharedRegion_freeXlt (Void)
+{
+    SizeT              size;
+
+    size =   sizeof (SharedRegion_Xlt)
+           + (  2 * SharedRegion_module->cfg.numEntries
+              * sizeof (SharedRegion_XltRange));
+
+    if (SharedRegion_module->xlt != NULL) {
+        Memory_free (NULL, SharedRegion_module->xlt, size);
+        SharedRegion_module->xlt = NULL;
+    }
+}
+
+
+/* Counts a lock-free reader in the current epoch and loads the snapshot. */
+static SharedRegion_Xlt *
+_SharedRegion_enterXlt (UInt32 * reader)
+{
+    SharedRegion_Xlt * xlt;
+
+    if (SharedRegion_module->xltEnabled == FALSE) {
+        return NULL;
+    }
+
+    *reader = SharedRegion_module->xltEpoch & 1u;
+    __sync_fetch_and_add (&SharedRegion_module->xltReaders [*reader], 1);
+    xlt = SharedRegion_module->xlt;
+    if (xlt == NULL) {
+        /* Callers fall back to the localLock, which must not be taken while
+         * counted as a reader.
+         */
+        __sync_fetch_and_sub (&SharedRegion_module->xltReaders [*reader], 1);
+    }
+
+    return xlt;
+}
+
+
+/* Releases a reader counted by _SharedRegion_enterXlt. */
+static Void
+_SharedRegion_leaveXlt (UInt32 reader)
+{
+    __sync_fetch_and_sub (&SharedRegion_module->xltReaders [reader], 1);
+}
+
 #if defined (__cplusplus)
 }
 #endif /* defined (__cplusplus) */
@@ -236,6 +236,9 @@ SharedRegionDrv_ioctl (UInt32 cmd, Ptr args)
                 if (regions->entry.isValid == TRUE) {
                     mapInfo.src  = (UInt32) regions->entry.base;
                     mapInfo.size = regions->entry.len;
+                    mapInfo.isCached = (   (i < 32u)
+                                        && ((config->cachedRegionMask >> i)
+                                            & 1u));
                     status = Memory_map (&mapInfo);
                     if (status < 0) {
                         GT_setFailureReason (curTrace,
@@ -46,6 +46,9 @@
 /* TBD: this should be removed as getpid should made as osal */
 #include <unistd.h>
 
+/* Linux specific header files */
+#include <errno.h>
+
 /* Osal headers*/
 #include <Trace.h>
 #include <MemoryDefs.h>
@@ -78,6 +81,8 @@ typedef struct Notify_ModuleObject_tag {
          process. */
     Notify_Config      cfg;
     /*!< Notify configuration structure */
+    Bool               noSendEvents;
+    /*!< Kernel driver does not support CMD_NOTIFY_SENDEVENTS */
 } Notify_ModuleObject;
 
 
@@ -95,7 +100,8 @@ static
 #endif /* if !defined(SYSLINK_BUILD_DEBUG) */
 Notify_ModuleObject Notify_state =
 {
-    .setupRefCount = 0
+    .setupRefCount = 0,
+    .noSendEvents  = FALSE
 };
 
 
@@ -1034,6 +1040,171 @@ Notify_sendEvent (UInt16              procId,
 }
 
 
+/*!
+ *  @brief      Send a sequence of payloads to an event on the remote
+ *              processor with one call into the driver.
+ *
+ *              Drivers that predate CMD_NOTIFY_SENDEVENTS fail the ioctl;
+ *              the payloads are then sent one at a time. In that case a
+ *              coalesced batch is collapsed to its last payload, which is
+ *              all the remote processor would have been guaranteed to see.
+ *
+ *  @param      procId       Remote processor Id
+ *  @param      lineId       Line Id
+ *  @param      eventId      Event Id
+ *  @param      payloads     Payloads to send, in order
+ *  @param      numPayloads  Number of payloads
+ *  @param      coalesce     Merge payloads the remote has not yet cleared
+ *
+ *  @sa         Notify_sendEvent
+ */
+Int
+Notify_sendEvents (UInt16              procId,
+                   UInt16              lineId,
+                   UInt32              eventId,
+                   UInt32              payloads [],
+                   UInt32              numPayloads,
+                   Bool                coalesce,
+                   UInt32            * numSent)
+{
+    Int32                    status          = Notify_S_SUCCESS;
+    UInt32                   strippedEventId = (eventId & Notify_EVENT_MASK);
+    Notify_CmdArgsSendEvents cmdArgs;
+    UInt32                   i;
+    UInt32                   sent            = 0;
+
+    GT_5trace (curTrace, GT_ENTER, "Notify_sendEvents",
+               procId, lineId, eventId, payloads, numPayloads);
+
+    GT_assert (curTrace, (Notify_state.setupRefCount > 0));
+    GT_assert (curTrace, (procId < MultiProc_getNumProcessors ()));
+    GT_assert (curTrace, (lineId < Notify_MAX_INTLINES));
+    GT_assert (curTrace, (strippedEventId < (Notify_state.cfg.numEvents)));
+    GT_assert (curTrace, \
+                        (ISRESERVED(eventId, Notify_state.cfg.reservedEvents)));
+    GT_assert (curTrace, (payloads != NULL));
+    GT_assert (curTrace, (numPayloads > 0));
+
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    if (procId >= MultiProc_getNumProcessors ()) {
+        /*! @retval  Notify_E_INVALIDARG Invalid procId argument
+                                         provided. */
+        status = Notify_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Notify_sendEvents",
+                             status,
+                             "Invalid procId argument provided");
+    }
+    else if (lineId >= Notify_MAX_INTLINES) {
+        /*! @retval  Notify_E_INVALIDARG Invalid lineId argument
+                                         provided. */
+        status = Notify_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Notify_sendEvents",
+                             status,
+                             "Invalid lineId argument provided");
+    }
+    else if ((payloads == NULL) || (numPayloads == 0)) {
+        /*! @retval  Notify_E_INVALIDARG Invalid payloads argument
+                                         provided. */
+        status = Notify_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Notify_sendEvents",
+                             status,
+                             "Invalid payloads argument provided");
+    }
+    else if (strippedEventId >= (Notify_state.cfg.numEvents)) {
+        /*! @retval  Notify_E_EVTNOTREGISTERED Invalid eventId specified. */
+        status = Notify_E_EVTNOTREGISTERED;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Notify_sendEvents",
+                             status,
+                             "Invalid eventId specified.");
+    }
+    else if (!ISRESERVED(eventId, Notify_state.cfg.reservedEvents)) {
+        /*! @retval  Notify_E_EVTRESERVED Invalid usage of reserved event
+                                            number. */
+        status = Notify_E_EVTRESERVED;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Notify_sendEvents",
+                             status,
+                             "Invalid usage of reserved event number");
+    }
+    else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        if (numPayloads == 1) {
+            /* Nothing to coalesce */
+            status = Notify_sendEvent (procId, lineId, eventId,
+                                       payloads [0], TRUE);
+            sent = (status >= 0) ? 1 : 0;
+        }
+        else if (Notify_state.noSendEvents == FALSE) {
+            cmdArgs.procId      = procId;
+            cmdArgs.lineId      = lineId;
+            cmdArgs.eventId     = eventId;
+            cmdArgs.payloads    = payloads;
+            cmdArgs.numPayloads = numPayloads;
+            cmdArgs.coalesce    = coalesce;
+            cmdArgs.numSent     = 0;
+            status = NotifyDrvUsr_ioctl (CMD_NOTIFY_SENDEVENTS, &cmdArgs);
+            if (    (status == Notify_E_OSFAILURE)
+                &&  ((errno == ENOTTY) || (errno == EINVAL))) {
+                /* Older driver, fall back to one ioctl per payload. Nothing
+                 * was sent, so the whole sequence goes through the loop.
+                 */
+                Notify_state.noSendEvents = TRUE;
+            }
+            else {
+                /* Any other failure is returned as is; resending would
+                 * deliver the payloads the driver already raised twice.
+                 */
+                sent = cmdArgs.numSent;
+            }
+        }
+
+        if ((numPayloads > 1) && (Notify_state.noSendEvents == TRUE)) {
+            i = (coalesce == TRUE) ? (numPayloads - 1) : 0;
+            for (status = Notify_S_SUCCESS;
+                 (i < numPayloads) && (status >= 0);
+                 i++) {
+                status = Notify_sendEvent (procId, lineId, eventId,
+                                           payloads [i], TRUE);
+                if (status >= 0) {
+                    sent++;
+                }
+            }
+        }
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+        /* Notify_E_NOTINITIALIZED and Notify_E_EVTNOTREGISTERED are run-time
+         * failures.
+         */
+        if (   (status < 0)
+            && (status != Notify_E_EVTNOTREGISTERED)) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "Notify_sendEvents",
+                                 status,
+                                 "API (through IOCTL) failed on kernel-side!");
+        }
+    }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+
+    if (numSent != NULL) {
+        *numSent = sent;
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "Notify_sendEvents", status);
+
+    /*! @retval Notify_S_SUCCESS Operation successful */
+    return (status);
+}
+
+
 /*!
  *  @brief      Disable all events for specified procId.
  *              This is equivalent to global interrupt disable for specified
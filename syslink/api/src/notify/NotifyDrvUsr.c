@@ -50,12 +50,14 @@
 #include <errno.h>
 #include <pthread.h>
 #include <string.h>
+#include <time.h>
 
 /* Standard headers */
 #include <Std.h>
 
 /* OSAL & Utils headers */
 #include <Trace.h>
+#include <Memory.h>
 #include <NotifyDrvUsr.h>
 
 /* Module headers */
@@ -76,6 +78,45 @@ extern "C" {
  */
 #define NOTIFY_DRIVER_NAME         "/dev/syslinkipc/Notify"
 
+/*!
+ *  @brief  Maximum number of callback dispatch threads.
+ */
+#define NOTIFYDRVUSR_MAX_DISPATCHERS    8
+
+/*!
+ *  @brief  Packets queued per dispatch thread, power of 2.
+ */
+#define NOTIFYDRVUSR_DISPATCH_QLEN      64
+
+/*!
+ *  @brief  Number of distinct callbacks with execution time statistics.
+ */
+#define NOTIFYDRVUSR_MAX_CALLBACKS      32
+
+/*!
+ *  @brief  Callback dispatch thread. Events are assigned to a dispatcher
+ *          by (procId, lineId, eventId), so each event is still delivered
+ *          in order while unrelated events run in parallel.
+ */
+typedef struct NotifyDrvUsr_Dispatcher_tag {
+    pthread_t             thread;
+    /*!< Dispatch thread */
+    pthread_mutex_t       lock;
+    /*!< Protects the queue indexes and exit flag */
+    pthread_cond_t        notEmpty;
+    /*!< Signalled when a packet is queued */
+    pthread_cond_t        notFull;
+    /*!< Signalled when a packet is taken */
+    UInt32                head;
+    /*!< Next packet to run */
+    UInt32                tail;
+    /*!< Next free queue entry */
+    Bool                  exit;
+    /*!< Exit once the queue is empty */
+    NotifyDrv_EventPacket queue [NOTIFYDRVUSR_DISPATCH_QLEN];
+    /*!< Packets waiting to run */
+} NotifyDrvUsr_Dispatcher;
+
 
 /** ============================================================================
  *  Globals
@@ -96,6 +137,30 @@ static UInt32 NotifyDrvUsr_refCount = 0;
  */
 static pthread_t  NotifyDrv_workerThread;
 
+/*!
+ *  @brief  Event delivery statistics, only written by the worker thread.
+ */
+static NotifyDrv_EventStats NotifyDrvUsr_eventStats;
+
+/*!
+ *  @brief  Number of callback dispatch threads, zero runs the callbacks on
+ *          the event worker thread.
+ */
+static UInt32 NotifyDrvUsr_numDispatchers = 0;
+
+/*!
+ *  @brief  Callback dispatch threads.
+ */
+static NotifyDrvUsr_Dispatcher * NotifyDrvUsr_dispatchers = NULL;
+
+/*!
+ *  @brief  Callback execution time statistics. Entries are only added,
+ *          under NotifyDrvUsr_cbStatsLock.
+ */
+static NotifyDrv_CallbackStats NotifyDrvUsr_cbStats [NOTIFYDRVUSR_MAX_CALLBACKS];
+static UInt32 NotifyDrvUsr_numCbStats = 0;
+static pthread_mutex_t NotifyDrvUsr_cbStatsLock = PTHREAD_MUTEX_INITIALIZER;
+
 
 /** ============================================================================
  *  Forward declaration of internal functions
@@ -110,6 +175,38 @@ static pthread_t  NotifyDrv_workerThread;
  */
 Void _NotifyDrvUsr_eventWorker (Void * arg);
 
+/*!
+ *  @brief      Callback dispatch thread.
+ *
+ *  @param      arg Dispatcher object
+ *
+ *  @sa
+ */
+Void _NotifyDrvUsr_dispatchWorker (Void * arg);
+
+/*!
+ *  @brief      Create the callback dispatch threads.
+ *
+ *  @sa         _NotifyDrvUsr_stopDispatchers
+ */
+static Int _NotifyDrvUsr_startDispatchers (Void);
+
+/*!
+ *  @brief      Let the dispatch threads drain their queues and exit.
+ *
+ *  @sa         _NotifyDrvUsr_startDispatchers
+ */
+static Void _NotifyDrvUsr_stopDispatchers (Void);
+
+/*!
+ *  @brief      Run a callback and record its execution time.
+ *
+ *  @param      packet Event packet
+ *
+ *  @sa
+ */
+static Void _NotifyDrvUsr_runCallback (NotifyDrv_EventPacket * packet);
+
 
 /** ============================================================================
  *  Functions
@@ -172,6 +269,13 @@ NotifyDrvUsr_open (Bool createThread)
                                              "side!");
                     }
                     else {
+                        /* Without dispatch threads the callbacks run on
+                         * the event worker thread.
+                         */
+                        if (_NotifyDrvUsr_startDispatchers () < 0) {
+                            NotifyDrvUsr_numDispatchers = 0;
+                        }
+
                         /* Create the pthread */
                         pthread_create (&NotifyDrv_workerThread,
                                         NULL,
@@ -278,6 +382,7 @@ NotifyDrvUsr_ioctl (UInt32 cmd, Ptr args)
 {
     Int status      = Notify_S_SUCCESS;
     int osStatus    = 0;
+    int osErrno     = 0;
 
     GT_2trace (curTrace, GT_ENTER, "NotifyDrvUsr_ioctl", cmd, args);
 
@@ -285,6 +390,7 @@ NotifyDrvUsr_ioctl (UInt32 cmd, Ptr args)
 
     osStatus = ioctl (NotifyDrvUsr_handle, cmd, args);
     if (osStatus < 0) {
+        osErrno = errno;
         /*! @retval Notify_E_OSFAILURE Driver ioctl failed */
         status = Notify_E_OSFAILURE;
         GT_setFailureReason (curTrace,
@@ -299,6 +405,145 @@ NotifyDrvUsr_ioctl (UInt32 cmd, Ptr args)
     }
     GT_1trace (curTrace, GT_LEAVE, "NotifyDrvUsr_ioctl", status);
 
+    if (osStatus < 0) {
+        /* Left in errno so that callers can tell an unknown command apart. */
+        errno = osErrno;
+    }
+
+    /*! @retval Notify_S_SUCCESS Operation successfully completed. */
+    return status;
+}
+
+
+/*!
+ *  @brief  Function to get the event delivery statistics of the event
+ *          worker thread.
+ *
+ *          The counters are updated by the worker without a lock, so the
+ *          values are a snapshot that may be one batch behind.
+ *
+ *  @param  stats   Location to receive the statistics
+ *
+ *  @sa
+ */
+Int
+NotifyDrvUsr_getEventStats (NotifyDrv_EventStats * stats)
+{
+    Int status = Notify_S_SUCCESS;
+
+    GT_1trace (curTrace, GT_ENTER, "NotifyDrvUsr_getEventStats", stats);
+
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    if (stats == NULL) {
+        /*! @retval Notify_E_INVALIDARG Invalid stats pointer */
+        status = Notify_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "NotifyDrvUsr_getEventStats",
+                             status,
+                             "stats pointer is NULL!");
+    }
+    else {
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+        *stats = NotifyDrvUsr_eventStats;
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+    }
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+
+    GT_1trace (curTrace, GT_LEAVE, "NotifyDrvUsr_getEventStats", status);
+
+    /*! @retval Notify_S_SUCCESS Operation successfully completed. */
+    return status;
+}
+
+
+/*!
+ *  @brief  Function to set the number of threads that run the Notify
+ *          callbacks of this process.
+ *
+ *          Must be called before the driver is opened by Notify_setup. With
+ *          zero threads (the default) callbacks run on the event worker
+ *          thread, one at a time.
+ *
+ *  @param  numThreads  Number of dispatch threads
+ *
+ *  @sa     NotifyDrvUsr_open
+ */
+Int
+NotifyDrvUsr_setDispatchThreads (UInt32 numThreads)
+{
+    Int status = Notify_S_SUCCESS;
+
+    GT_1trace (curTrace, GT_ENTER, "NotifyDrvUsr_setDispatchThreads",
+               numThreads);
+
+    if (NotifyDrvUsr_refCount > 0) {
+        /*! @retval Notify_E_INVALIDSTATE Driver is already open */
+        status = Notify_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "NotifyDrvUsr_setDispatchThreads",
+                             status,
+                             "Driver is already open!");
+    }
+    else if (numThreads > NOTIFYDRVUSR_MAX_DISPATCHERS) {
+        /*! @retval Notify_E_INVALIDARG Too many dispatch threads */
+        status = Notify_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "NotifyDrvUsr_setDispatchThreads",
+                             status,
+                             "numThreads exceeds the maximum!");
+    }
+    else {
+        NotifyDrvUsr_numDispatchers = numThreads;
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "NotifyDrvUsr_setDispatchThreads", status);
+
+    /*! @retval Notify_S_SUCCESS Operation successfully completed. */
+    return status;
+}
+
+
+/*!
+ *  @brief  Function to get the execution time statistics of a callback.
+ *
+ *          Callbacks are numbered from zero in the order they first ran.
+ *
+ *  @param  index   Callback number
+ *  @param  stats   Location to receive the statistics
+ *
+ *  @sa
+ */
+Int
+NotifyDrvUsr_getCallbackStats (UInt32                    index,
+                               NotifyDrv_CallbackStats * stats)
+{
+    Int status = Notify_S_SUCCESS;
+
+    GT_2trace (curTrace, GT_ENTER, "NotifyDrvUsr_getCallbackStats", index,
+               stats);
+
+    if (stats == NULL) {
+        /*! @retval Notify_E_INVALIDARG Invalid stats pointer */
+        status = Notify_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "NotifyDrvUsr_getCallbackStats",
+                             status,
+                             "stats pointer is NULL!");
+    }
+    else if (index >= NotifyDrvUsr_numCbStats) {
+        /*! @retval Notify_E_NOTFOUND No callback with this number */
+        status = Notify_E_NOTFOUND;
+    }
+    else {
+        *stats = NotifyDrvUsr_cbStats [index];
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "NotifyDrvUsr_getCallbackStats", status);
+
     /*! @retval Notify_S_SUCCESS Operation successfully completed. */
     return status;
 }
@@ -319,8 +564,14 @@ Void
 _NotifyDrvUsr_eventWorker (Void * arg)
 {
     Int32                 status = Notify_S_SUCCESS;
-    UInt32                nRead  = 0;
-    NotifyDrv_EventPacket packet;
+    Int32                 nRead  = 0;
+    UInt32                count;
+    UInt32                i;
+    UInt32                pid;
+    UInt32                hash;
+    NotifyDrvUsr_Dispatcher * dsp;
+    NotifyDrv_EventPacket packets [NOTIFYDRV_MAX_EVENT_PACKETS];
+    NotifyDrv_EventPacket * packet;
     sigset_t              blockSet;
 
     GT_1trace (curTrace, GT_ENTER, "_NotifyDrvUsr_eventWorker", arg);
@@ -338,32 +589,293 @@ _NotifyDrvUsr_eventWorker (Void * arg)
     }
 #endif /* #ifndef HAVE_ANDROID_OS */
 
+    memset (packets, 0, sizeof (packets));
+    pid = getpid ();
+
     while (status >= 0) {
-        memset (&packet, 0, sizeof (NotifyDrv_EventPacket));
-        packet.pid = getpid ();
-        nRead = read (NotifyDrvUsr_handle,
-                      &packet,
-                      sizeof (NotifyDrv_EventPacket));
-        if (0 == nRead || nRead == sizeof (NotifyDrv_EventPacket)) {
+        /* The driver finds this process from the first packet, which is
+         * also the only one it may leave unfilled
+         */
+        packets [0].pid = pid;
+        packets [0].func = NULL;
+        packets [0].isExit = FALSE;
+        nRead = read (NotifyDrvUsr_handle, packets, sizeof (packets));
+        if (nRead < 0) {
+            continue;
+        }
+
+        /* Older drivers fill one packet and may return zero */
+        count = nRead / sizeof (NotifyDrv_EventPacket);
+        if (count == 0) {
+            count = 1;
+        }
+
+        for (i = 0; i < count; i++) {
+            packet = &packets [i];
+
             /* check for termination packet */
-            if (packet.isExit  == TRUE) {
+            if (packet->isExit == TRUE) {
+                _NotifyDrvUsr_stopDispatchers ();
                 return;
             }
 
-            if (packet.func != NULL) {
-                packet.func (packet.procId,
-                             packet.lineId,
-                             packet.eventId,
-                             packet.param,
-                             packet.data);
+            if (packet->func == NULL) {
+                continue;
+            }
+
+            if (NotifyDrvUsr_numDispatchers == 0) {
+                _NotifyDrvUsr_runCallback (packet);
+            }
+            else {
+                /* Same event, same dispatcher: keeps per-event order */
+                hash = ((packet->procId * 31u) + packet->lineId) * 31u
+                       + packet->eventId;
+                hash ^= hash >> 16;
+                dsp = &NotifyDrvUsr_dispatchers [hash
+                                            % NotifyDrvUsr_numDispatchers];
+
+                pthread_mutex_lock (&dsp->lock);
+                while (dsp->tail - dsp->head == NOTIFYDRVUSR_DISPATCH_QLEN) {
+                    pthread_cond_wait (&dsp->notFull, &dsp->lock);
+                }
+                dsp->queue [dsp->tail & (NOTIFYDRVUSR_DISPATCH_QLEN - 1)] =
+                                                                    *packet;
+                dsp->tail++;
+                pthread_cond_signal (&dsp->notEmpty);
+                pthread_mutex_unlock (&dsp->lock);
             }
         }
+
+        NotifyDrvUsr_eventStats.wakeups++;
+        NotifyDrvUsr_eventStats.events += count;
+        if (count > NotifyDrvUsr_eventStats.maxBatch) {
+            NotifyDrvUsr_eventStats.maxBatch = count;
+        }
     }
 
     GT_0trace (curTrace, GT_LEAVE, "_NotifyDrvUsr_eventWorker");
 }
 
 
+/*!
+ *  @brief      Callback dispatch thread, runs the packets of its queue in
+ *              order.
+ *
+ *  @param      arg Dispatcher object
+ *
+ *  @sa
+ */
+Void
+_NotifyDrvUsr_dispatchWorker (Void * arg)
+{
+    NotifyDrvUsr_Dispatcher * dsp = (NotifyDrvUsr_Dispatcher *) arg;
+    NotifyDrv_EventPacket     packet;
+    sigset_t                  blockSet;
+
+    GT_1trace (curTrace, GT_ENTER, "_NotifyDrvUsr_dispatchWorker", arg);
+
+#ifndef HAVE_ANDROID_OS
+    if (sigfillset (&blockSet) == 0) {
+        pthread_sigmask (SIG_BLOCK, &blockSet, NULL);
+    }
+#endif /* #ifndef HAVE_ANDROID_OS */
+
+    pthread_mutex_lock (&dsp->lock);
+    while (TRUE) {
+        while (dsp->head == dsp->tail && !dsp->exit) {
+            pthread_cond_wait (&dsp->notEmpty, &dsp->lock);
+        }
+        if (dsp->head == dsp->tail) {
+            break;
+        }
+        packet = dsp->queue [dsp->head & (NOTIFYDRVUSR_DISPATCH_QLEN - 1)];
+        dsp->head++;
+        pthread_cond_signal (&dsp->notFull);
+        pthread_mutex_unlock (&dsp->lock);
+
+        _NotifyDrvUsr_runCallback (&packet);
+
+        pthread_mutex_lock (&dsp->lock);
+    }
+    pthread_mutex_unlock (&dsp->lock);
+
+    GT_0trace (curTrace, GT_LEAVE, "_NotifyDrvUsr_dispatchWorker");
+}
+
+
+/*!
+ *  @brief      Create the callback dispatch threads.
+ *
+ *  @sa         _NotifyDrvUsr_stopDispatchers
+ */
+static Int
+_NotifyDrvUsr_startDispatchers (Void)
+{
+    Int                       status = Notify_S_SUCCESS;
+    NotifyDrvUsr_Dispatcher * dsp;
+    UInt32                    i;
+
+    GT_0trace (curTrace, GT_ENTER, "_NotifyDrvUsr_startDispatchers");
+
+    if (NotifyDrvUsr_numDispatchers == 0) {
+        goto leave;
+    }
+
+    NotifyDrvUsr_dispatchers = Memory_calloc (NULL,
+                        NotifyDrvUsr_numDispatchers *
+                        sizeof (NotifyDrvUsr_Dispatcher), 0);
+    if (NotifyDrvUsr_dispatchers == NULL) {
+        /*! @retval Notify_E_MEMORY Failed to allocate dispatchers */
+        status = Notify_E_MEMORY;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_NotifyDrvUsr_startDispatchers",
+                             status,
+                             "Failed to allocate dispatchers!");
+        goto leave;
+    }
+
+    for (i = 0; i < NotifyDrvUsr_numDispatchers; i++) {
+        dsp = &NotifyDrvUsr_dispatchers [i];
+        pthread_mutex_init (&dsp->lock, NULL);
+        pthread_cond_init (&dsp->notEmpty, NULL);
+        pthread_cond_init (&dsp->notFull, NULL);
+        if (pthread_create (&dsp->thread, NULL,
+                            (Ptr) _NotifyDrvUsr_dispatchWorker, dsp) != 0) {
+            /*! @retval Notify_E_OSFAILURE Failed to create dispatch
+                                           thread */
+            status = Notify_E_OSFAILURE;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_NotifyDrvUsr_startDispatchers",
+                                 status,
+                                 "Failed to create dispatch thread!");
+            pthread_cond_destroy (&dsp->notFull);
+            pthread_cond_destroy (&dsp->notEmpty);
+            pthread_mutex_destroy (&dsp->lock);
+
+            /* Stop the threads already created */
+            NotifyDrvUsr_numDispatchers = i;
+            _NotifyDrvUsr_stopDispatchers ();
+            break;
+        }
+    }
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "_NotifyDrvUsr_startDispatchers", status);
+
+    return status;
+}
+
+
+/*!
+ *  @brief      Let the dispatch threads drain their queues and exit.
+ *
+ *  @sa         _NotifyDrvUsr_startDispatchers
+ */
+static Void
+_NotifyDrvUsr_stopDispatchers (Void)
+{
+    NotifyDrvUsr_Dispatcher * dsp;
+    UInt32                    i;
+
+    GT_0trace (curTrace, GT_ENTER, "_NotifyDrvUsr_stopDispatchers");
+
+    if (NotifyDrvUsr_dispatchers != NULL) {
+        for (i = 0; i < NotifyDrvUsr_numDispatchers; i++) {
+            dsp = &NotifyDrvUsr_dispatchers [i];
+            pthread_mutex_lock (&dsp->lock);
+            dsp->exit = TRUE;
+            pthread_cond_signal (&dsp->notEmpty);
+            pthread_mutex_unlock (&dsp->lock);
+        }
+
+        for (i = 0; i < NotifyDrvUsr_numDispatchers; i++) {
+            dsp = &NotifyDrvUsr_dispatchers [i];
+            pthread_join (dsp->thread, NULL);
+            pthread_cond_destroy (&dsp->notFull);
+            pthread_cond_destroy (&dsp->notEmpty);
+            pthread_mutex_destroy (&dsp->lock);
+        }
+
+        Memory_free (NULL, NotifyDrvUsr_dispatchers,
+                     NotifyDrvUsr_numDispatchers *
+                     sizeof (NotifyDrvUsr_Dispatcher));
+        NotifyDrvUsr_dispatchers = NULL;
+    }
+
+    GT_0trace (curTrace, GT_LEAVE, "_NotifyDrvUsr_stopDispatchers");
+}
+
+
+/*!
+ *  @brief      Run a callback and record its execution time.
+ *
+ *  @param      packet Event packet
+ *
+ *  @sa         NotifyDrvUsr_getCallbackStats
+ */
+static Void
+_NotifyDrvUsr_runCallback (NotifyDrv_EventPacket * packet)
+{
+    struct timespec           start;
+    struct timespec           end;
+    NotifyDrv_CallbackStats * cbStats = NULL;
+    UInt32                    usecs;
+    UInt32                    bucket;
+    UInt32                    i;
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    packet->func (packet->procId,
+                  packet->lineId,
+                  packet->eventId,
+                  packet->param,
+                  packet->data);
+    clock_gettime (CLOCK_MONOTONIC, &end);
+
+    usecs = (end.tv_sec - start.tv_sec) * 1000000
+            + (end.tv_nsec - start.tv_nsec) / 1000;
+    for (bucket = 0;
+         (bucket < NOTIFYDRV_CBHIST_BUCKETS - 1) && (usecs >= (1u << bucket));
+         bucket++);
+
+    /* Entries are published after they are filled in, so the lookup
+     * only needs the lock to add a new callback.
+     */
+    for (i = 0; i < NotifyDrvUsr_numCbStats; i++) {
+        if (NotifyDrvUsr_cbStats [i].func == packet->func) {
+            cbStats = &NotifyDrvUsr_cbStats [i];
+            break;
+        }
+    }
+    if (cbStats == NULL) {
+        pthread_mutex_lock (&NotifyDrvUsr_cbStatsLock);
+        for (i = 0; i < NotifyDrvUsr_numCbStats; i++) {
+            if (NotifyDrvUsr_cbStats [i].func == packet->func) {
+                cbStats = &NotifyDrvUsr_cbStats [i];
+                break;
+            }
+        }
+        if (   (cbStats == NULL)
+            && (NotifyDrvUsr_numCbStats < NOTIFYDRVUSR_MAX_CALLBACKS)) {
+            cbStats = &NotifyDrvUsr_cbStats [NotifyDrvUsr_numCbStats];
+            cbStats->func = packet->func;
+            __sync_synchronize ();
+            NotifyDrvUsr_numCbStats++;
+        }
+        pthread_mutex_unlock (&NotifyDrvUsr_cbStatsLock);
+    }
+
+    if (cbStats != NULL) {
+        __sync_fetch_and_add (&cbStats->count, 1);
+        __sync_fetch_and_add (&cbStats->hist [bucket], 1);
+        if (usecs > cbStats->maxUs) {
+            cbStats->maxUs = usecs;
+        }
+    }
+}
+
+
 #if defined (__cplusplus)
 }
 #endif /* defined (__cplusplus) */
@@ -109,6 +109,7 @@
 /* OSAL & Utils headers */
 #include <Memory.h>
 #include <Trace.h>
+#include <Cache.h>
 
 /* Module level headers */
 #include <ti/ipc/MultiProc.h>
@@ -125,6 +126,7 @@
 #include <ProcMMU.h>
 #include <ProcMgr.h>
 #include <ProcDEH.h>
+#include <SysLinkMemUtils.h>
 
 #if defined (__cplusplus)
 extern "C" {
@@ -182,6 +184,9 @@ typedef struct ProcMgr_Object_tag {
     ProcMgr_AddrInfo memEntries [PROCMGR_MAX_MEMORY_REGIONS];
     /*!< Configuration of memory regions */
     DLoad4430_Handle loaderHandle;
+    Bool             cacheRegistered;
+    /*!< Whether this object holds a Cache_register reference, dropped when
+         its last handle is closed. */
 } ProcMgr_Object;
 
 
@@ -202,6 +207,27 @@ ProcMgr_ModuleObject ProcMgr_state =
     .setupRefCount = 0
 };
 
+
+/* =============================================================================
+ *  Internal functions
+ * =============================================================================
+ */
+/*
+ *  Cache operations registered with the Cache module while a handle is open,
+ *  since only the MMU driver can clean and invalidate user mappings.
+ */
+static Int
+_ProcMgr_cacheWbInv (Ptr addr, UInt32 size, UInt16 procId)
+{
+    return ProcMgr_flushMemory (addr, size, (ProcMgr_ProcId) procId);
+}
+
+static Int
+_ProcMgr_cacheInv (Ptr addr, UInt32 size, UInt16 procId)
+{
+    return ProcMgr_invalidateMemory (addr, size, (ProcMgr_ProcId) procId);
+}
+
 /* =============================================================================
  *  APIs
  * =============================================================================
@@ -424,6 +450,11 @@ ProcMgr_destroy (Void)
                    (ProcMgr_state.setupRefCount + 1));
     }
     else {
+        /* Handles cached for remote memory requests go before the
+         * instances they refer to.
+         */
+        _SysLinkMemUtils_closeHandles ();
+
         status = ProcMgrDrvUsr_ioctl (CMD_PROCMGR_DESTROY, &cmdArgs);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         if (status < 0) {
@@ -999,6 +1030,10 @@ ProcMgr_open (ProcMgr_Handle * handlePtr, UInt16 procId)
                                  status,
                                  "ProcMMU_open failed!");
         }
+        else if ((handle != NULL) && (handle->cacheRegistered == FALSE)) {
+            Cache_register (procId, _ProcMgr_cacheWbInv, _ProcMgr_cacheInv);
+            handle->cacheRegistered = TRUE;
+        }
 
         /* Open handle to DEH */
         status = ProcDEH_open (procId);
@@ -1126,6 +1161,11 @@ ProcMgr_close (ProcMgr_Handle * handlePtr)
             status = DLoad4430_delete (&procMgrHandle->loaderHandle);
             status = DLoad4430_destroy ();
 
+            if (procMgrHandle->cacheRegistered == TRUE) {
+                Cache_unregister (procId);
+                procMgrHandle->cacheRegistered = FALSE;
+            }
+
             if (procMgrHandle->created == FALSE) {
                 /* Clear the ProcMgr handle in the local array. */
                 GT_assert (curTrace,
@@ -1754,6 +1794,7 @@ ProcMgr_start (ProcMgr_Handle        handle,
                 /* Get the user virtual address of the PRM base */
                 sysCtrlMapInfo.src  = 0x4A002000;
                 sysCtrlMapInfo.size = 0x1000;
+                sysCtrlMapInfo.isCached = FALSE;
 
                 status = Memory_map (&sysCtrlMapInfo);
                 if (status < 0) {
@@ -49,13 +49,13 @@
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <pthread.h>
 /* Standard headers */
 #include <Std.h>
 
 /* OSAL & Utils headers */
 #include <Memory.h>
 #include <Trace.h>
-#include <List.h>
 #include <OsalSemaphore.h>
 
 /* Module level headers */
@@ -125,27 +125,41 @@ typedef struct {
 } FreeArgs;
 
 /*!
- *  @brief  Structure element used to store a mapped buffer
+ *  @brief  Structure element used to store a mapped buffer. The nodes form
+ *          an AVL tree ordered by da over [da, da + size); non-linear
+ *          blocks only cover their start address.
  */
-typedef struct {
-    List_Elem   elem;
-    /*!< List element */
-    Ptr         da;
+typedef struct AddrNode_tag {
+    struct AddrNode_tag * left;
+    /*!< Blocks below da */
+    struct AddrNode_tag * right;
+    /*!< Blocks above da + size */
+    Int                   height;
+    /*!< Height of the subtree rooted here */
+    Ptr                   da;
     /*!< Device address */
-    Ptr         ua;
+    Ptr                   ua;
     /*!< User address */
-    UInt32      size;
-    /*!< Size of the mapping */
+    UInt32                size;
+    /*!< Size of the mapping; 1 for non-linear blocks, which are keyed by
+     *   their exact start address */
+    Bool                  linear;
+    /*!< Offsets from da and ua match, i.e. not a 2D TILER block */
 } AddrNode;
 
 /*!
  *  @brief  SysLinkMemUtils Module state object
  */
 typedef struct SysLinkMemUtils_ModuleObject_tag {
-    List_Handle          addrTable;
+    AddrNode *           addrTable;
     /*!< Table where the device address and A9 address will be stored. */
-    OsalSemaphore_Handle semList;
-    /*!< Semaphore to protect the table */
+    pthread_rwlock_t     addrLock;
+    /*!< Lock protecting the table, lookups only take it shared */
+    ProcMgr_Handle       procHandles [PROC_END];
+    /*!< ProcMgr handles, opened on first use and kept open until
+     *   _SysLinkMemUtils_closeHandles */
+    OsalSemaphore_Handle semHandles;
+    /*!< Semaphore to protect procHandles */
 } SysLinkMemUtils_ModuleObject;
 
 
@@ -164,7 +178,8 @@ static
 SysLinkMemUtils_ModuleObject SysLinkMemUtils_state =
 {
     .addrTable              = NULL,
-    .semList                = NULL,
+    .addrLock               = PTHREAD_RWLOCK_INITIALIZER,
+    .semHandles             = NULL,
 };
 
 /*!
@@ -192,31 +207,17 @@ static Void _SysLinkMemUtils_init (Void) __attribute__((constructor));
 static Void
 _SysLinkMemUtils_init (Void)
 {
-    List_Params             listParams;
-
     GT_0trace (curTrace, GT_ENTER, "_SysLinkMemUtils_init");
 
-    List_Params_init (&listParams);
-    SysLinkMemUtils_module->addrTable = List_create (&listParams);
-#if !defined(SYSLINK_BUILD_OPTIMIZE)
-    if (!SysLinkMemUtils_module->addrTable) {
-        GT_setFailureReason (curTrace,
-                             GT_4CLASS,
-                             (Char *)__func__,
-                             PROCMGR_E_MEMORY,
-                             "Translation list could not be created!");
-    }
-#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-
-    SysLinkMemUtils_module->semList = OsalSemaphore_create (
+    SysLinkMemUtils_module->semHandles = OsalSemaphore_create (
                                                 OsalSemaphore_Type_Counting, 1);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-    if (!SysLinkMemUtils_module->semList) {
+    if (!SysLinkMemUtils_module->semHandles) {
         GT_setFailureReason (curTrace,
                              GT_4CLASS,
                              (Char *)__func__,
                              PROCMGR_E_MEMORY,
-                             "List semaphore could not be created!");
+                             "Handle semaphore could not be created!");
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
 
@@ -224,6 +225,8 @@ _SysLinkMemUtils_init (Void)
 }
 
 
+static Void _SysLinkMemUtils_deleteTree (AddrNode * root);
+
 static Void _SysLinkMemUtils_exit (Void) __attribute__((destructor));
 /*!
  *  @brief      Free resources allocated in setup part
@@ -235,15 +238,287 @@ _SysLinkMemUtils_exit (Void)
 {
     GT_0trace (curTrace, GT_ENTER, "_SysLinkMemUtils_exit");
 
-    List_delete (&SysLinkMemUtils_module->addrTable);
-    OsalSemaphore_delete (&SysLinkMemUtils_module->semList);
+    _SysLinkMemUtils_deleteTree (SysLinkMemUtils_module->addrTable);
+    SysLinkMemUtils_module->addrTable = NULL;
+    OsalSemaphore_delete (&SysLinkMemUtils_module->semHandles);
 
     GT_0trace (curTrace, GT_LEAVE, "_SysLinkMemUtils_exit");
 }
 
 
 /*!
- *  @brief  Find a node inside the Translation Table which da matches
+ *  @brief      Get the cached ProcMgr handle of a remote processor, opening
+ *              it on first use.
+ *
+ *              The handle stays open until _SysLinkMemUtils_closeHandles, so
+ *              ProcMgr_open/ProcMgr_close are not paid per call.
+ *
+ *  @param      procId      Remote processor Id
+ *  @param      handlePtr   Location to receive the handle
+ *
+ *  @sa         _SysLinkMemUtils_closeHandles
+ */
+static Int32
+_SysLinkMemUtils_getHandle (ProcMgr_ProcId   procId,
+                            ProcMgr_Handle * handlePtr)
+{
+    ProcMgr_Handle  * entry;
+    Int32             status = PROCMGR_SUCCESS;
+
+    GT_2trace (curTrace, GT_ENTER, "_SysLinkMemUtils_getHandle", procId,
+                handlePtr);
+
+    if ((UInt32) procId >= PROC_END) {
+        status = PROCMGR_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             (Char *)__func__,
+                             status,
+                             "Invalid procId specified!");
+    }
+    else {
+        entry = &SysLinkMemUtils_module->procHandles [procId];
+        OsalSemaphore_pend (SysLinkMemUtils_module->semHandles,
+                            OSALSEMAPHORE_WAIT_FOREVER);
+        if (*entry == NULL) {
+            status = ProcMgr_open (entry, procId);
+            if (status < 0) {
+                Osal_printf ("Error in ProcMgr_open [0x%x]\n", status);
+                *entry = NULL;
+            }
+        }
+        *handlePtr = *entry;
+        OsalSemaphore_post (SysLinkMemUtils_module->semHandles);
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "_SysLinkMemUtils_getHandle", status);
+
+    return status;
+}
+
+
+/*!
+ *  @brief      Close the ProcMgr handles opened by this module. Called by
+ *              ProcMgr_destroy before the ProcMgr instances are deleted.
+ *
+ *  @sa         _SysLinkMemUtils_getHandle
+ */
+Void
+_SysLinkMemUtils_closeHandles (Void)
+{
+    ProcMgr_Handle  * entry;
+    Int32             status;
+    UInt32            i;
+
+    GT_0trace (curTrace, GT_ENTER, "_SysLinkMemUtils_closeHandles");
+
+    if (SysLinkMemUtils_module->semHandles != NULL) {
+        OsalSemaphore_pend (SysLinkMemUtils_module->semHandles,
+                            OSALSEMAPHORE_WAIT_FOREVER);
+        for (i = 0; i < PROC_END; i++) {
+            entry = &SysLinkMemUtils_module->procHandles [i];
+            if (*entry != NULL) {
+                status = ProcMgr_close (entry);
+                if (status < 0) {
+                    Osal_printf ("Error in ProcMgr_close [0x%x]\n", status);
+                }
+                *entry = NULL;
+            }
+        }
+        OsalSemaphore_post (SysLinkMemUtils_module->semHandles);
+    }
+
+    GT_0trace (curTrace, GT_LEAVE, "_SysLinkMemUtils_closeHandles");
+}
+
+
+/*!
+ *  @brief  Height of a Translation Table subtree
+ *
+ *  @params node    Subtree root, may be NULL
+ */
+static inline Int
+_SysLinkMemUtils_height (AddrNode * node)
+{
+    return node ? node->height : 0;
+}
+
+
+/*!
+ *  @brief  Recompute the height of a node from its children
+ *
+ *  @params node    Node to update
+ */
+static inline Void
+_SysLinkMemUtils_updateHeight (AddrNode * node)
+{
+    Int lh = _SysLinkMemUtils_height (node->left);
+    Int rh = _SysLinkMemUtils_height (node->right);
+
+    node->height = (lh > rh ? lh : rh) + 1;
+}
+
+
+/*!
+ *  @brief  Rotate a subtree so that the given child becomes its root
+ *
+ *  @params node    Subtree root
+ *  @params toLeft  Rotate left (right child rises) or right (left child rises)
+ *
+ *  @sa     _SysLinkMemUtils_balance
+ */
+static AddrNode *
+_SysLinkMemUtils_rotate (AddrNode * node, Bool toLeft)
+{
+    AddrNode * child;
+
+    if (toLeft) {
+        child = node->right;
+        node->right = child->left;
+        child->left = node;
+    }
+    else {
+        child = node->left;
+        node->left = child->right;
+        child->right = node;
+    }
+    _SysLinkMemUtils_updateHeight (node);
+    _SysLinkMemUtils_updateHeight (child);
+
+    return child;
+}
+
+
+/*!
+ *  @brief  Restore the AVL balance of a subtree after an insert or remove
+ *
+ *  @params node    Subtree root
+ *
+ *  @sa     _SysLinkMemUtils_insertNode, _SysLinkMemUtils_removeNode
+ */
+static AddrNode *
+_SysLinkMemUtils_balance (AddrNode * node)
+{
+    Int diff;
+
+    _SysLinkMemUtils_updateHeight (node);
+    diff = _SysLinkMemUtils_height (node->left)
+           - _SysLinkMemUtils_height (node->right);
+
+    if (diff > 1) {
+        if (_SysLinkMemUtils_height (node->left->left)
+            < _SysLinkMemUtils_height (node->left->right)) {
+            node->left = _SysLinkMemUtils_rotate (node->left, TRUE);
+        }
+        node = _SysLinkMemUtils_rotate (node, FALSE);
+    }
+    else if (diff < -1) {
+        if (_SysLinkMemUtils_height (node->right->right)
+            < _SysLinkMemUtils_height (node->right->left)) {
+            node->right = _SysLinkMemUtils_rotate (node->right, FALSE);
+        }
+        node = _SysLinkMemUtils_rotate (node, TRUE);
+    }
+
+    return node;
+}
+
+
+/*!
+ *  @brief  Insert a node into a Translation Table subtree
+ *
+ *  @params root    Subtree root
+ *  @params node    Node to insert
+ *  @params status  Set to PROCMGR_E_INVALIDARG if the block overlaps one
+ *                  already in the table
+ *
+ *  @sa     _SysLinkMemUtils_insertMapElement
+ */
+static AddrNode *
+_SysLinkMemUtils_insertNode (AddrNode * root, AddrNode * node, Int32 * status)
+{
+    if (root == NULL) {
+        return node;
+    }
+
+    if ((UInt32)node->da + node->size <= (UInt32)root->da) {
+        root->left = _SysLinkMemUtils_insertNode (root->left, node, status);
+    }
+    else if ((UInt32)node->da >= (UInt32)root->da + root->size) {
+        root->right = _SysLinkMemUtils_insertNode (root->right, node, status);
+    }
+    else {
+        *status = PROCMGR_E_INVALIDARG;
+        return root;
+    }
+
+    return _SysLinkMemUtils_balance (root);
+}
+
+
+/*!
+ *  @brief  Unlink the node with the given da from a Translation Table
+ *          subtree
+ *
+ *  @params root    Subtree root
+ *  @params da      Device address of the block
+ *  @params found   Receives the unlinked node, untouched if there is none
+ *
+ *  @sa     _SysLinkMemUtils_removeMapElement
+ */
+static AddrNode *
+_SysLinkMemUtils_removeNode (AddrNode * root, Ptr da, AddrNode ** found)
+{
+    AddrNode * min;
+
+    if (root == NULL) {
+        return NULL;
+    }
+
+    if ((UInt32)da < (UInt32)root->da) {
+        root->left = _SysLinkMemUtils_removeNode (root->left, da, found);
+    }
+    else if ((UInt32)da > (UInt32)root->da) {
+        root->right = _SysLinkMemUtils_removeNode (root->right, da, found);
+    }
+    else {
+        *found = root;
+        if (root->left == NULL || root->right == NULL) {
+            return root->left ? root->left : root->right;
+        }
+        /* Replace by the lowest block of the right subtree */
+        for (min = root->right; min->left != NULL; min = min->left);
+        root->right = _SysLinkMemUtils_removeNode (root->right, min->da, &min);
+        min->left = root->left;
+        min->right = root->right;
+        root = min;
+    }
+
+    return _SysLinkMemUtils_balance (root);
+}
+
+
+/*!
+ *  @brief  Free a Translation Table subtree
+ *
+ *  @params root    Subtree root
+ *
+ *  @sa     _SysLinkMemUtils_exit
+ */
+static Void
+_SysLinkMemUtils_deleteTree (AddrNode * root)
+{
+    if (root != NULL) {
+        _SysLinkMemUtils_deleteTree (root->left);
+        _SysLinkMemUtils_deleteTree (root->right);
+        Memory_free (NULL, root, sizeof (AddrNode));
+    }
+}
+
+
+/*!
+ *  @brief  Find the node of the Translation Table whose block contains da.
+ *          The caller holds addrLock, shared is enough.
  *
  *  @params da      Device address
  *
@@ -256,10 +531,15 @@ _SysLinkMemUtils_findNode (Ptr da)
 
     GT_1trace (curTrace, GT_ENTER, "_SysLinkMemUtils_findNode", da);
 
-    for (node = List_next (SysLinkMemUtils_module->addrTable, NULL);
-        node != NULL; node = List_next (SysLinkMemUtils_module->addrTable,
-            &node->elem)) {
-        if (da == node->da) {
+    node = SysLinkMemUtils_module->addrTable;
+    while (node != NULL) {
+        if ((UInt32)da < (UInt32)node->da) {
+            node = node->left;
+        }
+        else if ((UInt32)da - (UInt32)node->da >= node->size) {
+            node = node->right;
+        }
+        else {
             break;
         }
     }
@@ -276,19 +556,24 @@ _SysLinkMemUtils_findNode (Ptr da)
  *  @param      da      Device address
  *  @param      ua      User address
  *  @param      size    Buffer size
+ *  @param      linear  Addresses inside the block translate by offset.
+ *                      Otherwise only da itself is entered: the rows of a
+ *                      2D TILER block are spread over height * stride bytes
+ *                      of device address space, which neighbouring blocks
+ *                      may share.
  *
  *  @sa         _SysLinkMemUtils_removeMapElement
  */
 static Int32
-_SysLinkMemUtils_insertMapElement (Ptr da, Ptr ua, UInt32 size)
+_SysLinkMemUtils_insertMapElement (Ptr da, Ptr ua, UInt32 size, Bool linear)
 {
     AddrNode      * node;
     Int32           status = PROCMGR_SUCCESS;
 
-    GT_3trace (curTrace, GT_ENTER, "_SysLinkMemUtils_insertMapElement", da, ua,
-                size);
+    GT_4trace (curTrace, GT_ENTER, "_SysLinkMemUtils_insertMapElement", da, ua,
+                size, linear);
 
-    node = Memory_alloc (NULL, sizeof (AddrNode), 0);
+    node = Memory_calloc (NULL, sizeof (AddrNode), 0);
     if (!node) {
         status = PROCMGR_E_MEMORY;
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -302,11 +587,24 @@ _SysLinkMemUtils_insertMapElement (Ptr da, Ptr ua, UInt32 size)
     else {
         node->ua = ua;
         node->da = da;
-        node->size = size;
-        OsalSemaphore_pend (SysLinkMemUtils_module->semList,
-                            OSALSEMAPHORE_WAIT_FOREVER);
-        List_put (SysLinkMemUtils_module->addrTable, &node->elem);
-        OsalSemaphore_post (SysLinkMemUtils_module->semList);
+        node->size = (linear && size) ? size : 1;
+        node->linear = linear;
+        node->height = 1;
+        pthread_rwlock_wrlock (&SysLinkMemUtils_module->addrLock);
+        SysLinkMemUtils_module->addrTable = _SysLinkMemUtils_insertNode (
+                                SysLinkMemUtils_module->addrTable, node,
+                                &status);
+        pthread_rwlock_unlock (&SysLinkMemUtils_module->addrLock);
+        if (status < 0) {
+#if !defined(SYSLINK_BUILD_OPTIMIZE)
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 (Char *)__func__,
+                                 status,
+                                 "Block overlaps an existing entry!");
+#endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
+            Memory_free (NULL, node, sizeof (AddrNode));
+        }
     }
 
     GT_1trace (curTrace, GT_LEAVE, "_SysLinkMemUtils_insertMapElement", status);
@@ -325,15 +623,16 @@ _SysLinkMemUtils_insertMapElement (Ptr da, Ptr ua, UInt32 size)
 static Ptr
 _SysLinkMemUtils_removeMapElement (Ptr da)
 {
-    AddrNode  * node;
+    AddrNode  * node = NULL;
     Ptr         addr = NULL;
 
     GT_1trace (curTrace, GT_ENTER, "_SysLinkMemUtils_removeMapElement", da);
 
-    OsalSemaphore_pend (SysLinkMemUtils_module->semList,
-                        OSALSEMAPHORE_WAIT_FOREVER);
-    node = _SysLinkMemUtils_findNode (da);
-    if (!node || node->da != da) {
+    pthread_rwlock_wrlock (&SysLinkMemUtils_module->addrLock);
+    SysLinkMemUtils_module->addrTable = _SysLinkMemUtils_removeNode (
+                                SysLinkMemUtils_module->addrTable, da, &node);
+    pthread_rwlock_unlock (&SysLinkMemUtils_module->addrLock);
+    if (!node) {
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         GT_setFailureReason (curTrace,
                              GT_4CLASS,
@@ -344,10 +643,8 @@ _SysLinkMemUtils_removeMapElement (Ptr da)
     }
     else {
         addr = node->ua;
-        List_remove (SysLinkMemUtils_module->addrTable, &node->elem);
         Memory_free (NULL, node, sizeof (AddrNode));
     }
-    OsalSemaphore_post (SysLinkMemUtils_module->semList);
 
     GT_1trace (curTrace, GT_LEAVE, "_SysLinkMemUtils_removeMapElement", addr);
 
@@ -392,6 +689,10 @@ _SysLinkMemUtils_bufferSize (MemAllocBlock * memBlock, UInt numBlocks)
  *
  *              This function  can be called by an app running
  *              in A9 to access a buffer allocated from remote processor.
+ *              Any address inside a block allocated with
+ *              SysLinkMemUtils_alloc is translated; for 2D TILER blocks only
+ *              the start address is, since their rows are not contiguous
+ *              in the device address space.
  *
  *  @param      da      Device address
  *
@@ -405,27 +706,12 @@ SysLinkMemUtils_DAtoVA (Ptr da)
 
     GT_1trace (curTrace, GT_ENTER, "SysLinkMemUtils_DAtoVA", da);
 
-#if 1
-    /* SysLinkMemUtils_DAtoVA() is now a stub that always      */
-    /* returns NULL.  It is necessary to disable this function */
-    /* due to the changes to the block lookup that breaks its  */
-    /* functionality.                                          */
-    (Void)node;
-    (Void)da;
-    GT_setFailureReason (curTrace,
-                         GT_4CLASS,
-                         (Char *)__func__,
-                         -1,
-                         "SysLinkMemUtils_DAtoVA() is unavailable.");
-#else
-    OsalSemaphore_pend (SysLinkMemUtils_module->semList,
-                        OSALSEMAPHORE_WAIT_FOREVER);
+    pthread_rwlock_rdlock (&SysLinkMemUtils_module->addrLock);
     node = _SysLinkMemUtils_findNode (da);
-    OsalSemaphore_post (SysLinkMemUtils_module->semList);
-    if (node) {
+    if (node && (node->linear || node->da == da)) {
         addr = node->ua + (da - node->da);
     }
-#endif
+    pthread_rwlock_unlock (&SysLinkMemUtils_module->addrLock);
 
     GT_1trace (curTrace, GT_LEAVE, "SysLinkMemUtils_DAtoVA", addr);
 
@@ -455,6 +741,7 @@ SysLinkMemUtils_alloc (UInt32 dataSize, UInt32 * data)
     UInt32                          retAddr         = 0;
     UInt32                          size            = 0;
     Int32                           status          = PROCMGR_SUCCESS;
+    Bool                            linear          = FALSE;
     SyslinkMemUtils_MpuAddrToMap    mpuAddrList [1];
 
     GT_2trace (curTrace, GT_ENTER, "SysLinkMemUtils_alloc", dataSize, data);
@@ -472,11 +759,18 @@ SysLinkMemUtils_alloc (UInt32 dataSize, UInt32 * data)
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
     }
     else {
+        /* Only a single 1D block is contiguous in device address space;
+         * every TILER block gets its own address.
+         */
+        linear = (args->numBuffers == 1);
         for (i = 0; i < args->numBuffers; i++) {
             memBlock [i].pixelFormat = args->params [i].pixelFormat;
             memBlock [i].dim.area.width = args->params [i].width;
             memBlock [i].dim.area.height = args->params [i].height;
             memBlock [i].dim.len = args->params [i].length;
+            if (memBlock [i].pixelFormat != PIXEL_FMT_PAGE) {
+                linear = FALSE;
+            }
         }
     }
 
@@ -518,7 +812,8 @@ SysLinkMemUtils_alloc (UInt32 dataSize, UInt32 * data)
 
     if (status == PROCMGR_SUCCESS) {
         status = _SysLinkMemUtils_insertMapElement ((Ptr)retAddr,
-                                                        allocedPtr, size);
+                                                        allocedPtr, size,
+                                                        linear);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         if (status != PROCMGR_SUCCESS) {
             GT_setFailureReason (curTrace,
@@ -604,9 +899,17 @@ SysLinkMemUtils_free (UInt32 dataSize, UInt32 * data)
  *              module
  *
  *              This function can be called by the application to map their
- *              address space to remote slave's address space.
+ *              address space to remote slave's address space. Each of the
+ *              numOfBuffers entries of mpuAddrList is mapped separately and
+ *              its device address returned in the matching entry of
+ *              mappedAddr, which must have room for numOfBuffers addresses.
+ *              Either all buffers are mapped or none is.
  *
- *  @param      MpuAddr
+ *  @param      mpuAddrList     Host buffers to map
+ *  @param      numOfBuffers    Number of entries in mpuAddrList
+ *  @param      mappedAddr      Location to receive the device addresses
+ *  @param      memType         Type of mapping
+ *  @param      procId          Remote processor Id
  *
  *  @sa         SysLinkMemUtils_unmap
  */
@@ -619,9 +922,11 @@ SysLinkMemUtils_map (SyslinkMemUtils_MpuAddrToMap   mpuAddrList [],
 {
     ProcMgr_Handle  procMgrHandle;
     UInt32          mappedSize;
+    UInt32          i;
+    UInt32          numMapped = 0;
     Int32           status = PROCMGR_SUCCESS;
 
-    if (numOfBuffers > 1) {
+    if (numOfBuffers == 0 || mpuAddrList == NULL || mappedAddr == NULL) {
         status = PROCMGR_E_INVALIDARG;
         Osal_printf ("SysLinkMemUtils_map numBufError [0x%x]\n", status);
         return status;
@@ -633,26 +938,34 @@ SysLinkMemUtils_map (SyslinkMemUtils_MpuAddrToMap   mpuAddrList [],
 
     if (memType == ProcMgr_MapType_Tiler) {
         /* TILER addresses are pre-mapped, so just return the TILER ssPtr */
-        *mappedAddr = TilerMem_VirtToPhys ((Void *)mpuAddrList [0].mpuAddr);
+        for (i = 0; i < numOfBuffers; i++) {
+            mappedAddr [i] = TilerMem_VirtToPhys (
+                                            (Void *)mpuAddrList [i].mpuAddr);
+        }
         return status;
     }
 
-    /* Open a handle to the ProcMgr instance. */
-    status = ProcMgr_open (&procMgrHandle, procId);
-    if (status < 0) {
-        Osal_printf ("Error in ProcMgr_open [0x%x]\n", status);
-    }
-    else {
+    status = _SysLinkMemUtils_getHandle (procId, &procMgrHandle);
+    if (status >= 0) {
         /* FIX ME: Add Proc reserve call */
-        status = ProcMgr_map (procMgrHandle, (UInt32)mpuAddrList [0].mpuAddr,
-                        (UInt32)mpuAddrList [0].size, mappedAddr, &mappedSize,
-                        memType, procId);
-         /* FIX ME: Add the table that keeps the C-D translations */
-        if (status < 0) {
-            Osal_printf ("Error in ProcMgr_map [0x%x]\n", status);
+        for (i = 0; i < numOfBuffers; i++) {
+            status = ProcMgr_map (procMgrHandle,
+                                  (UInt32)mpuAddrList [i].mpuAddr,
+                                  (UInt32)mpuAddrList [i].size,
+                                  &mappedAddr [i], &mappedSize,
+                                  memType, procId);
+            if (status < 0) {
+                Osal_printf ("Error in ProcMgr_map [0x%x]\n", status);
+                break;
+            }
+            numMapped++;
         }
-        else {
-            status = ProcMgr_close (&procMgrHandle);
+
+        if (status < 0) {
+            /* Undo the part of the list already mapped */
+            for (i = 0; i < numMapped; i++) {
+                ProcMgr_unmap (procMgrHandle, mappedAddr [i], procId);
+            }
         }
     }
 
@@ -675,25 +988,17 @@ SysLinkMemUtils_unmap (UInt32 mappedAddr, ProcMgr_ProcId procId)
     ProcMgr_Handle procMgrHandle;
     Int32          status = PROCMGR_SUCCESS;
 
-    /* Open a handle to the ProcMgr instance. */
     if (procId == PROC_APPM3) {
         procId = PROC_SYSM3;
     }
 
-    /* Open a handle to the ProcMgr instance. */
-    status = ProcMgr_open (&procMgrHandle, procId);
-    if (status < 0) {
-        Osal_printf ("Error in ProcMgr_open [0x%x]\n", status);
-    }
-    else {
+    status = _SysLinkMemUtils_getHandle (procId, &procMgrHandle);
+    if (status >= 0) {
         status = ProcMgr_unmap (procMgrHandle, mappedAddr, procId);
         /* FIX ME: Add Proc unreserve call */
         if (status < 0) {
             Osal_printf ("Error in ProcMgr_unmap [0x%x]\n", status);
         }
-        else {
-            status = ProcMgr_close (&procMgrHandle);
-        }
     }
 
     return status;
@@ -740,10 +1045,8 @@ SysLinkMemUtils_virtToPhysPages (UInt32         remoteAddr,
 
     Osal_printf ("testing with ProcMgr_virtToPhysPages\n");
 
-    /* Open a handle to the ProcMgr instance. */
-    status = ProcMgr_open (&procMgrHandle, procId);
+    status = _SysLinkMemUtils_getHandle (procId, &procMgrHandle);
     if (status < 0) {
-        Osal_printf ("Error in ProcMgr_open [0x%x]\n", status);
         return PROCMGR_E_FAIL;
     }
     /* TODO: Hack for tiler */
@@ -767,8 +1070,6 @@ SysLinkMemUtils_virtToPhysPages (UInt32         remoteAddr,
         }
     }
 
-    status = ProcMgr_close (&procMgrHandle);
-
     return status;
 }
 
@@ -39,6 +39,7 @@
 
 #include <limits.h>
 #include <stdlib.h>
+#include <string.h>
 #include "relocate.h"
 #include "dload_api.h"
 #include "util.h"
@@ -1567,14 +1568,32 @@ static void rel_unpack_addend(ARM_RELOC_TYPE r_type,
 }
 
 /*****************************************************************************/
-/* PROCESS_REL_TABLE() - Process REL type relocation table.                  */
+/* LOOKUP_SYMBOL() - Resolve a relocation's symbol, through the symbol       */
+/*      resolution cache of the current relocation pass if there is one.    */
 /*****************************************************************************/
-static BOOL process_rel_table(DLOAD_HANDLE handle,
-                              DLIMP_Loaded_Segment* seg,
-                              struct Elf32_Rel* rel_table,
-                              uint32_t relnum,
-                              int32_t *start_rid,
-                              DLIMP_Dynamic_Module* dyn_module)
+static BOOL lookup_symbol(DLOAD_HANDLE handle, DLSYM_Cache* symcache,
+                          int32_t r_symid, DLIMP_Dynamic_Module* dyn_module,
+                          Elf32_Addr* r_symval)
+{
+    if (symcache)
+        return DLSYM_cached_lookup(handle, symcache, r_symid, r_symval);
+
+    return DLSYM_canonical_lookup(handle, r_symid, dyn_module, r_symval);
+}
+
+/*****************************************************************************/
+/* FIND_RELOC_RANGE() - Find the entries of a REL or RELA table that apply  */
+/*      to the given segment.  The table is scanned from *start_rid (or from */
+/*      the start if that is past the end) up to the end of the first run    */
+/*      of entries that fall within the segment; that run is returned in     */
+/*      [*first, *last).  *start_rid is left where the scan stopped, so the  */
+/*      next segment continues from there.  Returns TRUE if a run was found. */
+/*****************************************************************************/
+static BOOL find_reloc_range(DLIMP_Loaded_Segment* seg,
+                             void* reloc_table, size_t entsize,
+                             uint32_t relnum,
+                             int32_t* start_rid,
+                             int32_t* first, int32_t* last)
 {
     Elf32_Addr seg_start_addr = seg->input_vaddr;
     Elf32_Addr seg_end_addr   = seg_start_addr + seg->phdr.p_memsz;
@@ -1583,191 +1602,250 @@ static BOOL process_rel_table(DLOAD_HANDLE handle,
 
     if (rid >= relnum) rid = 0;
 
+    *first = rid;
     for ( ; rid < relnum; rid++)
     {
-        /*---------------------------------------------------------------*/
-        /* If the relocation offset falls within the segment, process it */
-        /*---------------------------------------------------------------*/
-        if (rel_table[rid].r_offset >= seg_start_addr &&
-            rel_table[rid].r_offset < seg_end_addr)
-        {
-            Elf32_Addr r_symval;
-            ARM_RELOC_TYPE r_type = ELF32_R_TYPE(rel_table[rid].r_info);
-            int32_t r_symid = ELF32_R_SYM(rel_table[rid].r_info);
-            uint8_t* reloc_address;
-            uint32_t pc;
-            uint32_t addend;
-            BOOL change_endian;
+        /*-------------------------------------------------------------------*/
+        /* Both Elf32_Rel and Elf32_Rela start with r_offset.                */
+        /*-------------------------------------------------------------------*/
+        Elf32_Addr r_offset = ((struct Elf32_Rel*)
+                               ((uint8_t*)reloc_table + rid * entsize))->r_offset;
 
+        if (r_offset >= seg_start_addr && r_offset < seg_end_addr)
+        {
+            if (!found) *first = rid;
             found = TRUE;
-
-            /*---------------------------------------------------------*/
-            /* If symbol definition is not found don't do the          */
-            /* relocation. An error is generated by the lookup         */
-            /* function.                                               */
-            /*---------------------------------------------------------*/
-            if (!DLSYM_canonical_lookup(handle, r_symid, dyn_module, &r_symval))
-                continue;
-
-            reloc_address =
-                (((uint8_t*)(seg->phdr.p_vaddr) + seg->reloc_offset) +
-                 rel_table[rid].r_offset - seg->input_vaddr);
-            pc = (uint32_t) reloc_address;
-            change_endian = rel_swap_endian(dyn_module, r_type);
-            if (change_endian)
-                rel_change_endian(r_type, reloc_address);
-
-            rel_unpack_addend(ELF32_R_TYPE(rel_table[rid].r_info),
-                              reloc_address,
-                              &addend);
-
-#if LOADER_DEBUG || LOADER_PROFILE
-            if (debugging_on)
-            {
-                char *r_symname = (char*) dyn_module->symtab[r_symid].st_name;
-                DLIF_trace("r_type=%d, "
-                           "pc=0x%x, "
-                           "addend=0x%x, "
-                           "symnm=%s, "
-                           "symval=0x%x\n",
-                           r_type,
-                           pc,
-                           addend,
-                           r_symname,
-                           r_symval);
-            }
-#endif
-            /*----------------------------------------------------------*/
-            /* Perform actual relocation.  This is a really wide        */
-            /* function interface and could do with some encapsulation. */
-            /*----------------------------------------------------------*/
-            reloc_do(r_type,
-                     reloc_address,
-                     addend,
-                     r_symval,
-                     pc,
-                     0 /* static base, not yet supported */);
-
-
-            if (change_endian)
-                rel_change_endian(r_type, reloc_address);
-
         }
         else if (found)
             break;
     }
 
+    if (!found) *first = rid;
+    *last = rid;
     *start_rid = rid;
     return found;
 }
 
-static BOOL process_rela_table(DLOAD_HANDLE handle,
+/*****************************************************************************/
+/* RELOCATE_REL_RANGE() - Process entries [first, last) of a REL type        */
+/*      relocation table, all of which apply to the given segment.           */
+/*****************************************************************************/
+static void relocate_rel_range(DLOAD_HANDLE handle,
                                DLIMP_Loaded_Segment* seg,
-                               struct Elf32_Rela* rela_table,
-                               uint32_t relanum,
-                               int32_t* start_rid,
+                               struct Elf32_Rel* rel_table,
+                               int32_t first, int32_t last,
+                               DLSYM_Cache* symcache,
                                DLIMP_Dynamic_Module* dyn_module)
 {
-    Elf32_Addr seg_start_addr = seg->input_vaddr;
-    Elf32_Addr seg_end_addr   = seg_start_addr + seg->phdr.p_memsz;
-    BOOL found = FALSE;
-    int32_t rid = *start_rid;
+    int32_t rid;
 
-    if (rid >= relanum) rid = 0;
-
-    for ( ; rid < relanum; rid++)
+    for (rid = first; rid < last; rid++)
     {
-        /*---------------------------------------------------------------*/
-        /* If the relocation offset falls within the segment, process it */
-        /*---------------------------------------------------------------*/
-        if (rela_table[rid].r_offset >= seg_start_addr &&
-            rela_table[rid].r_offset < seg_end_addr)
+        Elf32_Addr r_symval;
+        ARM_RELOC_TYPE r_type = ELF32_R_TYPE(rel_table[rid].r_info);
+        int32_t r_symid = ELF32_R_SYM(rel_table[rid].r_info);
+        uint8_t* reloc_address;
+        uint32_t pc;
+        uint32_t addend;
+        BOOL change_endian;
+
+        /*-------------------------------------------------------------------*/
+        /* If symbol definition is not found don't do the relocation. An     */
+        /* error is generated by the lookup function.                        */
+        /*-------------------------------------------------------------------*/
+        if (!lookup_symbol(handle, symcache, r_symid, dyn_module, &r_symval))
+            continue;
+
+        reloc_address =
+            (((uint8_t*)(seg->phdr.p_vaddr) + seg->reloc_offset) +
+             rel_table[rid].r_offset - seg->input_vaddr);
+        pc = (uint32_t) reloc_address;
+        change_endian = rel_swap_endian(dyn_module, r_type);
+        if (change_endian)
+            rel_change_endian(r_type, reloc_address);
+
+        rel_unpack_addend(ELF32_R_TYPE(rel_table[rid].r_info),
+                          reloc_address,
+                          &addend);
+
+#if LOADER_DEBUG || LOADER_PROFILE
+        if (debugging_on)
         {
-            Elf32_Addr r_symval;
-            ARM_RELOC_TYPE r_type = ELF32_R_TYPE(rela_table[rid].r_info);
-            int32_t r_symid = ELF32_R_SYM(rela_table[rid].r_info);
-            uint8_t* reloc_address;
-            uint32_t pc;
-            uint32_t addend;
-            BOOL change_endian;
+            char *r_symname = (char*) dyn_module->symtab[r_symid].st_name;
+            DLIF_trace("r_type=%d, "
+                       "pc=0x%x, "
+                       "addend=0x%x, "
+                       "symnm=%s, "
+                       "symval=0x%x\n",
+                       r_type,
+                       pc,
+                       addend,
+                       r_symname,
+                       r_symval);
+        }
+#endif
+        /*-------------------------------------------------------------------*/
+        /* Perform actual relocation.  This is a really wide function        */
+        /* interface and could do with some encapsulation.                   */
+        /*-------------------------------------------------------------------*/
+        reloc_do(r_type,
+                 reloc_address,
+                 addend,
+                 r_symval,
+                 pc,
+                 0 /* static base, not yet supported */);
 
-            found = TRUE;
 
-            /*---------------------------------------------------------*/
-            /* If symbol definition is not found don't do the          */
-            /* relocation. An error is generated by the lookup         */
-            /* function.                                               */
-            /*---------------------------------------------------------*/
-            if (!DLSYM_canonical_lookup(handle, r_symid, dyn_module, &r_symval))
-                continue;
+        if (change_endian)
+            rel_change_endian(r_type, reloc_address);
+    }
+}
+
+/*****************************************************************************/
+/* RELOCATE_RELA_RANGE() - Process entries [first, last) of a RELA type      */
+/*      relocation table, all of which apply to the given segment.           */
+/*****************************************************************************/
+static void relocate_rela_range(DLOAD_HANDLE handle,
+                                DLIMP_Loaded_Segment* seg,
+                                struct Elf32_Rela* rela_table,
+                                int32_t first, int32_t last,
+                                DLSYM_Cache* symcache,
+                                DLIMP_Dynamic_Module* dyn_module)
+{
+    int32_t rid;
+
+    for (rid = first; rid < last; rid++)
+    {
+        Elf32_Addr r_symval;
+        ARM_RELOC_TYPE r_type = ELF32_R_TYPE(rela_table[rid].r_info);
+        int32_t r_symid = ELF32_R_SYM(rela_table[rid].r_info);
+        uint8_t* reloc_address;
+        uint32_t pc;
+        uint32_t addend;
+        BOOL change_endian;
+
+        /*-------------------------------------------------------------------*/
+        /* If symbol definition is not found don't do the relocation. An     */
+        /* error is generated by the lookup function.                        */
+        /*-------------------------------------------------------------------*/
+        if (!lookup_symbol(handle, symcache, r_symid, dyn_module, &r_symval))
+            continue;
 
-            reloc_address = (((uint8_t*)(seg->phdr.p_vaddr) + seg->reloc_offset) +
-                             rela_table[rid].r_offset - seg->input_vaddr);
-            pc = (uint32_t) reloc_address;
-            addend = rela_table[rid].r_addend;
+        reloc_address = (((uint8_t*)(seg->phdr.p_vaddr) + seg->reloc_offset) +
+                         rela_table[rid].r_offset - seg->input_vaddr);
+        pc = (uint32_t) reloc_address;
+        addend = rela_table[rid].r_addend;
 
-            change_endian = rel_swap_endian(dyn_module, r_type);
-            if (change_endian)
-                rel_change_endian(r_type, reloc_address);
+        change_endian = rel_swap_endian(dyn_module, r_type);
+        if (change_endian)
+            rel_change_endian(r_type, reloc_address);
 
 #if LOADER_DEBUG || LOADER_PROFILE
-            if (debugging_on)
-            {
-                char *r_symname = (char*) dyn_module->symtab[r_symid].st_name;
-                DLIF_trace("r_type=%d, "
-                           "pc=0x%x, "
-                           "addend=0x%x, "
-                           "symnm=%s, "
-                           "symval=0x%x\n",
-                           r_type,
-                           pc,
-                           addend,
-                           r_symname,
-                           r_symval);
-            }
+        if (debugging_on)
+        {
+            char *r_symname = (char*) dyn_module->symtab[r_symid].st_name;
+            DLIF_trace("r_type=%d, "
+                       "pc=0x%x, "
+                       "addend=0x%x, "
+                       "symnm=%s, "
+                       "symval=0x%x\n",
+                       r_type,
+                       pc,
+                       addend,
+                       r_symname,
+                       r_symval);
+        }
 #endif
 
-            /*----------------------------------------------------------*/
-            /* Perform actual relocation.  This is a really wide        */
-            /* function interface and could do with some encapsulation. */
-            /*----------------------------------------------------------*/
+        /*-------------------------------------------------------------------*/
+        /* Perform actual relocation.  This is a really wide function        */
+        /* interface and could do with some encapsulation.                   */
+        /*-------------------------------------------------------------------*/
 
-            reloc_do(ELF32_R_TYPE(rela_table[rid].r_info),
-                     reloc_address,
-                     addend,
-                     r_symval,
-                     pc,
-                     0);
+        reloc_do(ELF32_R_TYPE(rela_table[rid].r_info),
+                 reloc_address,
+                 addend,
+                 r_symval,
+                 pc,
+                 0);
 
 
-            if (change_endian)
-                rel_change_endian(r_type, reloc_address);
-        }
-        else if (found)
-            break;
+        if (change_endian)
+            rel_change_endian(r_type, reloc_address);
     }
+}
 
-    *start_rid = rid;
-    return found;
+/*****************************************************************************/
+/* PROCESS_REL_TABLE() - Process REL type relocation table.                  */
+/*****************************************************************************/
+static BOOL process_rel_table(DLOAD_HANDLE handle,
+                              DLIMP_Loaded_Segment* seg,
+                              struct Elf32_Rel* rel_table,
+                              uint32_t relnum,
+                              int32_t *start_rid,
+                              DLSYM_Cache* symcache,
+                              DLIMP_Dynamic_Module* dyn_module)
+{
+    int32_t first, last;
+
+    if (!find_reloc_range(seg, rel_table, sizeof(struct Elf32_Rel), relnum,
+                          start_rid, &first, &last))
+        return FALSE;
+
+    relocate_rel_range(handle, seg, rel_table, first, last, symcache,
+                       dyn_module);
+    return TRUE;
+}
+
+/*****************************************************************************/
+/* PROCESS_RELA_TABLE() - Process RELA type relocation table.                */
+/*****************************************************************************/
+static BOOL process_rela_table(DLOAD_HANDLE handle,
+                               DLIMP_Loaded_Segment* seg,
+                               struct Elf32_Rela* rela_table,
+                               uint32_t relanum,
+                               int32_t* start_rid,
+                               DLSYM_Cache* symcache,
+                               DLIMP_Dynamic_Module* dyn_module)
+{
+    int32_t first, last;
+
+    if (!find_reloc_range(seg, rela_table, sizeof(struct Elf32_Rela), relanum,
+                          start_rid, &first, &last))
+        return FALSE;
+
+    relocate_rela_range(handle, seg, rela_table, first, last, symcache,
+                        dyn_module);
+    return TRUE;
 }
 
 /*****************************************************************************/
 /* READ_REL_TABLE() -                                                        */
 /*                                                                           */
-/*   Read in a REL type relocation table.  This function allocates host      */
-/*   memory for the table.                                                   */
+/*   Read in a REL type relocation table.  If the file is mapped and no      */
+/*   endian conversion is needed, the table is used in place; otherwise this */
+/*   function allocates host memory for the table.  Returns TRUE if the      */
+/*   table must be freed by the caller.                                      */
 /*****************************************************************************/
-static void read_rel_table(struct Elf32_Rel** rel_table,
+static BOOL read_rel_table(struct Elf32_Rel** rel_table,
                            int32_t table_offset,
                            uint32_t relnum, uint32_t relent,
                            LOADER_FILE_DESC* elf_file,
                            BOOL wrong_endian)
 {
     int i;
+
+    if (!wrong_endian && (table_offset & 3) == 0)
+    {
+        *rel_table = (struct Elf32_Rel*) DLIF_fview(elf_file, table_offset,
+                                                    relnum*relent);
+        if (*rel_table) return FALSE;
+    }
+
     *rel_table = (struct Elf32_Rel*) DLIF_malloc(relnum*relent);
     if (NULL == *rel_table) {
         DLIF_error(DLET_MEMORY,"Failed to Allocate read_rel_table\n");
-        return;
+        return FALSE;
     }
     DLIF_fseek(elf_file, table_offset, LOADER_SEEK_SET);
     DLIF_fread(*rel_table, relnum, relent, elf_file);
@@ -1775,25 +1853,37 @@ static void read_rel_table(struct Elf32_Rel** rel_table,
     if (wrong_endian)
         for (i=0; i<relnum; i++)
             DLIMP_change_rel_endian(*rel_table + i);
+
+    return TRUE;
 }
 
 /*****************************************************************************/
 /* READ_RELA_TABLE() -                                                       */
 /*                                                                           */
-/*   Read in a RELA type relocation table.  This function allocates host     */
-/*   memory for the table.                                                   */
+/*   Read in a RELA type relocation table.  If the file is mapped and no     */
+/*   endian conversion is needed, the table is used in place; otherwise this */
+/*   function allocates host memory for the table.  Returns TRUE if the      */
+/*   table must be freed by the caller.                                      */
 /*****************************************************************************/
-static void read_rela_table(struct Elf32_Rela** rela_table,
+static BOOL read_rela_table(struct Elf32_Rela** rela_table,
                             int32_t table_offset,
                             uint32_t relanum, uint32_t relaent,
                             LOADER_FILE_DESC* elf_file,
                             BOOL wrong_endian)
 {
     int i;
+
+    if (!wrong_endian && (table_offset & 3) == 0)
+    {
+        *rela_table = (struct Elf32_Rela*) DLIF_fview(elf_file, table_offset,
+                                                      relanum*relaent);
+        if (*rela_table) return FALSE;
+    }
+
     *rela_table = DLIF_malloc(relanum*relaent);
     if (NULL == *rela_table) {
         DLIF_error(DLET_MEMORY,"Failed to Allocate read_rela_table\n");
-        return;
+        return FALSE;
     }
     DLIF_fseek(elf_file, table_offset, LOADER_SEEK_SET);
     DLIF_fread(*rela_table, relanum, relaent, elf_file);
@@ -1801,17 +1891,60 @@ static void read_rela_table(struct Elf32_Rela** rela_table,
     if (wrong_endian)
         for (i=0; i<relanum; i++)
             DLIMP_change_rela_endian(*rela_table + i);
+
+    return TRUE;
+}
+
+/*****************************************************************************/
+/* GOT relocations of one segment, processed as a unit by a relocation       */
+/* thread.  Segments occupy disjoint host memory, so different segments can */
+/* be relocated concurrently; within a segment the serial order (RELA       */
+/* entries, then REL entries) is preserved.                                  */
+/*****************************************************************************/
+typedef struct
+{
+    DLIMP_Loaded_Segment* seg;
+    int32_t               rela_first;
+    int32_t               rela_last;
+    int32_t               rel_first;
+    int32_t               rel_last;
+} Reloc_Task;
+
+typedef struct
+{
+    DLOAD_HANDLE          handle;
+    DLIMP_Dynamic_Module* dyn_module;
+    DLSYM_Cache*          symcache;
+    struct Elf32_Rel*     rel_table;
+    struct Elf32_Rela*    rela_table;
+    Reloc_Task*           tasks;
+} Reloc_Pass;
+
+static void run_reloc_task(void* arg, int32_t t)
+{
+    Reloc_Pass* pass = (Reloc_Pass*)arg;
+    Reloc_Task* task = &pass->tasks[t];
+
+    relocate_rela_range(pass->handle, task->seg, pass->rela_table,
+                        task->rela_first, task->rela_last, pass->symcache,
+                        pass->dyn_module);
+    relocate_rel_range(pass->handle, task->seg, pass->rel_table,
+                       task->rel_first, task->rel_last, pass->symcache,
+                       pass->dyn_module);
 }
 
 /*****************************************************************************/
 /* PROCESS_GOT_RELOCS() -                                                    */
 /*                                                                           */
 /*   Process all GOT relocations. It is possible to have both REL and RELA   */
-/*   relocations in the same file, so we handle them both.                   */
+/*   relocations in the same file, so we handle them both.  The tables are   */
+/*   first split into per-segment ranges exactly as a serial walk would      */
+/*   visit them, then the segments are relocated by DLREL_run_tasks().       */
 /*****************************************************************************/
 static void process_got_relocs(DLOAD_HANDLE handle,
                                struct Elf32_Rel* rel_table, uint32_t relnum,
                                struct Elf32_Rela* rela_table, uint32_t relanum,
+                               DLSYM_Cache* symcache,
                                DLIMP_Dynamic_Module* dyn_module)
 {
     DLIMP_Loaded_Segment* seg =
@@ -1819,10 +1952,22 @@ static void process_got_relocs(DLOAD_HANDLE handle,
     int seg_size = dyn_module->loaded_module->loaded_segments.size;
     int32_t rel_rid = 0;
     int32_t rela_rid = 0;
+    Reloc_Pass pass;
+    int32_t num_tasks = 0;
+    uint32_t num_relocs = 0;
     int s;
 
+    pass.handle     = handle;
+    pass.dyn_module = dyn_module;
+    pass.symcache   = symcache;
+    pass.rel_table  = rel_table;
+    pass.rela_table = rela_table;
+    pass.tasks      = DLIF_malloc(seg_size * sizeof(Reloc_Task));
+
     for (s=0; s<seg_size; s++)
     {
+        Reloc_Task task;
+
         /*-------------------------------------------------------------------*/
         /* Relocations into the BSS should not occur.                        */
         /*-------------------------------------------------------------------*/
@@ -1840,13 +1985,44 @@ static void process_got_relocs(DLOAD_HANDLE handle,
         }
 #endif
 
+        task.seg = seg + s;
+        task.rela_first = task.rela_last = 0;
+        task.rel_first = task.rel_last = 0;
+
         if (rela_table)
-            process_rela_table(handle, (seg + s), rela_table, relanum,
-                               &rela_rid, dyn_module);
+            find_reloc_range(seg + s, rela_table, sizeof(struct Elf32_Rela),
+                             relanum, &rela_rid,
+                             &task.rela_first, &task.rela_last);
 
         if (rel_table)
-            process_rel_table(handle, (seg + s), rel_table, relnum, &rel_rid,
-                              dyn_module);
+            find_reloc_range(seg + s, rel_table, sizeof(struct Elf32_Rel),
+                             relnum, &rel_rid,
+                             &task.rel_first, &task.rel_last);
+
+        if (task.rela_first == task.rela_last &&
+            task.rel_first == task.rel_last)
+            continue;
+
+        /*-------------------------------------------------------------------*/
+        /* Without memory for the task list, relocate the segment right away.*/
+        /*-------------------------------------------------------------------*/
+        if (pass.tasks == NULL)
+        {
+            pass.tasks = &task;
+            run_reloc_task(&pass, 0);
+            pass.tasks = NULL;
+            continue;
+        }
+
+        pass.tasks[num_tasks++] = task;
+        num_relocs += (task.rela_last - task.rela_first) +
+                      (task.rel_last - task.rel_first);
+    }
+
+    if (pass.tasks)
+    {
+        DLREL_run_tasks(num_tasks, num_relocs, run_reloc_task, &pass);
+        DLIF_free(pass.tasks);
     }
 }
 
@@ -1860,6 +2036,7 @@ static void process_got_relocs(DLOAD_HANDLE handle,
 static void process_pltgot_relocs(DLOAD_HANDLE handle,
                                   void* plt_reloc_table, int reltype,
                                   uint32_t pltnum,
+                                  DLSYM_Cache* symcache,
                                   DLIMP_Dynamic_Module* dyn_module)
 {
     Elf32_Addr r_offset = (reltype == DT_REL) ?
@@ -1893,12 +2070,12 @@ static void process_pltgot_relocs(DLOAD_HANDLE handle,
             if (reltype == DT_REL)
                 process_rel_table(handle, (seg + s),
                                   (struct Elf32_Rel*) plt_reloc_table,
-                                  pltnum, &plt_rid,
+                                  pltnum, &plt_rid, symcache,
                                   dyn_module);
             else
                 process_rela_table(handle, (seg + s),
                                    (struct Elf32_Rela*) plt_reloc_table,
-                                   pltnum, &plt_rid,
+                                   pltnum, &plt_rid, symcache,
                                    dyn_module);
 
             break;
@@ -1919,6 +2096,10 @@ void DLREL_relocate(DLOAD_HANDLE handle,
     struct Elf32_Rela* rela_table = NULL;
     struct Elf32_Rel*  rel_table = NULL;
     void*              plt_table = NULL;
+    BOOL               free_rela = FALSE;
+    BOOL               free_rel = FALSE;
+    BOOL               free_plt = FALSE;
+    DLSYM_Cache*       psymcache = NULL;
 
     /*-----------------------------------------------------------------------*/
     /* Read the size of the relocation table (DT_RELASZ) and the size per    */
@@ -1957,19 +2138,19 @@ void DLREL_relocate(DLOAD_HANDLE handle,
         {
             pltnum = pltrelsz/relent;
             relsz -= pltrelsz;
-            read_rel_table(((struct Elf32_Rel**) &plt_table),
-                           DLIMP_get_first_dyntag(DT_JMPREL, dyn_nugget),
-                           pltnum, relent, elf_file,
-                           dyn_module->wrong_endian);
+            free_plt = read_rel_table(((struct Elf32_Rel**) &plt_table),
+                                DLIMP_get_first_dyntag(DT_JMPREL, dyn_nugget),
+                                pltnum, relent, elf_file,
+                                dyn_module->wrong_endian);
         }
         else if (pltreltype == DT_RELA)
         {
             pltnum = pltrelsz/relaent;
             relasz -= pltrelsz;
-            read_rela_table(((struct Elf32_Rela**) &plt_table),
-                            DLIMP_get_first_dyntag(DT_JMPREL, dyn_nugget),
-                            pltnum, relaent, elf_file,
-                            dyn_module->wrong_endian);
+            free_plt = read_rela_table(((struct Elf32_Rela**) &plt_table),
+                                DLIMP_get_first_dyntag(DT_JMPREL, dyn_nugget),
+                                pltnum, relaent, elf_file,
+                                dyn_module->wrong_endian);
         }
         else
         {
@@ -1985,9 +2166,10 @@ void DLREL_relocate(DLOAD_HANDLE handle,
     if (relasz != INT_MAX)
     {
         relanum = relasz/relaent;
-        read_rela_table(&rela_table,
-                        DLIMP_get_first_dyntag(DT_RELA, dyn_nugget),
-                        relanum, relaent, elf_file, dyn_module->wrong_endian);
+        free_rela = read_rela_table(&rela_table,
+                                DLIMP_get_first_dyntag(DT_RELA, dyn_nugget),
+                                relanum, relaent, elf_file,
+                                dyn_module->wrong_endian);
     }
 
     /*-----------------------------------------------------------------------*/
@@ -1996,29 +2178,39 @@ void DLREL_relocate(DLOAD_HANDLE handle,
     if (relsz != INT_MAX)
     {
         relnum = relsz/relent;
-        read_rel_table(&rel_table, DLIMP_get_first_dyntag(DT_REL, dyn_nugget),
-                       relnum, relent, elf_file, dyn_module->wrong_endian);
+        free_rel = read_rel_table(&rel_table,
+                                  DLIMP_get_first_dyntag(DT_REL, dyn_nugget),
+                                  relnum, relent, elf_file,
+                                  dyn_module->wrong_endian);
     }
 
+    /*-----------------------------------------------------------------------*/
+    /* Resolve each referenced symbol once for all of this module's          */
+    /* relocations, through the loader's cache for this module.  If the      */
+    /* cache cannot be set up, look up every time.                           */
+    /*-----------------------------------------------------------------------*/
+    psymcache = DLSYM_get_symbol_cache(handle, dyn_module);
+
    /*------------------------------------------------------------------------*/
    /* Process the PLTGOT relocations                                         */
    /*------------------------------------------------------------------------*/
    if (plt_table)
-      process_pltgot_relocs(handle, plt_table, pltreltype, pltnum, dyn_module);
+      process_pltgot_relocs(handle, plt_table, pltreltype, pltnum, psymcache,
+                            dyn_module);
 
     /*-----------------------------------------------------------------------*/
     /* Process the GOT relocations                                           */
     /*-----------------------------------------------------------------------*/
     if (rel_table || rela_table)
         process_got_relocs(handle, rel_table, relnum, rela_table, relanum,
-                           dyn_module);
+                           psymcache, dyn_module);
 
     /*------------------------------------------------------------------------*/
     /* Free memory used for ELF relocation table copies.                      */
     /*------------------------------------------------------------------------*/
-    if (rela_table) DLIF_free(rela_table);
-    if (rel_table)  DLIF_free(rel_table);
-    if (plt_table)  DLIF_free(plt_table);
+    if (free_rela) DLIF_free(rela_table);
+    if (free_rel)  DLIF_free(rel_table);
+    if (free_plt)  DLIF_free(plt_table);
 }
 
 /*****************************************************************************/
@@ -2049,4 +2241,179 @@ void unit_arm_rel_mask_for_group(ARM_RELOC_TYPE r_type, int32_t* reloc_val)
 {
     rel_mask_for_group(r_type, reloc_val);
 }
+
+/*****************************************************************************/
+/* Reference for the unit test below: the plain serial walk that predates   */
+/* the per-segment planning pass.  Every segment takes, in table order, its */
+/* RELA entries and then its REL entries, each looked up without the        */
+/* symbol cache.                                                             */
+/*****************************************************************************/
+static void serial_got_relocs(struct Elf32_Rel* rel_table, uint32_t relnum,
+                              struct Elf32_Rela* rela_table, uint32_t relanum,
+                              DLIMP_Dynamic_Module* dyn_module)
+{
+    DLIMP_Loaded_Segment* seg =
+      (DLIMP_Loaded_Segment*)(dyn_module->loaded_module->loaded_segments.buf);
+    int seg_size = dyn_module->loaded_module->loaded_segments.size;
+    int32_t rid;
+    int s;
+
+    for (s=0; s<seg_size; s++)
+    {
+        Elf32_Addr seg_start_addr = seg[s].input_vaddr;
+        Elf32_Addr seg_end_addr   = seg_start_addr + seg[s].phdr.p_memsz;
+
+        if(!seg[s].phdr.p_filesz) continue;
+
+        for (rid = 0; rid < relanum; rid++)
+            if (rela_table[rid].r_offset >= seg_start_addr &&
+                rela_table[rid].r_offset < seg_end_addr)
+                relocate_rela_range(NULL, seg + s, rela_table, rid, rid + 1,
+                                    NULL, dyn_module);
+
+        for (rid = 0; rid < relnum; rid++)
+            if (rel_table[rid].r_offset >= seg_start_addr &&
+                rel_table[rid].r_offset < seg_end_addr)
+                relocate_rel_range(NULL, seg + s, rel_table, rid, rid + 1,
+                                   NULL, dyn_module);
+    }
+}
+
+/*****************************************************************************/
+/* Relocate a synthetic module of num_segs segments, each holding           */
+/* relocs_per_seg REL entries plus some RELA entries on the same fields,     */
+/* once with the serial reference walk and once through process_got_relocs */
+/* on DLREL_MAX_THREADS threads, whatever the CPU count and pass size, and  */
+/* return TRUE if both produce byte-identical segment contents.             */
+/*****************************************************************************/
+BOOL unit_arm_relocate_parallel_matches_serial(int32_t num_segs,
+                                               int32_t relocs_per_seg)
+{
+    static const ARM_RELOC_TYPE types[] =
+        { R_ARM_ABS32, R_ARM_REL32, R_ARM_PREL31, R_ARM_ABS32_NOI };
+    const int32_t num_syms = 64;
+    const uint32_t seg_bytes = relocs_per_seg * 4;
+    DLIMP_Dynamic_Module dyn_module;
+    DLIMP_Loaded_Module loaded_module;
+    DLSYM_Cache symcache;
+    struct Elf32_Sym* symtab;
+    struct Elf32_Rel* rel_table;
+    struct Elf32_Rela* rela_table;
+    uint8_t* image;
+    uint8_t* work;
+    uint8_t* result[2];
+    int32_t saved_forced_threads = DLREL_forced_threads;
+    int32_t relanum = 0;
+    int32_t i, j, run;
+    uint32_t seed = 1;
+    BOOL match;
+
+    memset(&dyn_module, 0, sizeof(dyn_module));
+    memset(&loaded_module, 0, sizeof(loaded_module));
+    AL_initialize(&loaded_module.loaded_segments,
+                  sizeof(DLIMP_Loaded_Segment), num_segs);
+    dyn_module.loaded_module = &loaded_module;
+    dyn_module.name = "unit_test";
+
+    symtab = DLIF_malloc(num_syms * sizeof(struct Elf32_Sym));
+    rel_table = DLIF_malloc(num_segs * relocs_per_seg *
+                            sizeof(struct Elf32_Rel));
+    rela_table = DLIF_malloc(num_segs * relocs_per_seg *
+                             sizeof(struct Elf32_Rela));
+    image = DLIF_malloc(num_segs * seg_bytes);
+    work = DLIF_malloc(num_segs * seg_bytes);
+    result[0] = DLIF_malloc(num_segs * seg_bytes);
+    result[1] = DLIF_malloc(num_segs * seg_bytes);
+
+    /*-----------------------------------------------------------------------*/
+    /* Local, defined symbols resolve without a global lookup.               */
+    /*-----------------------------------------------------------------------*/
+    memset(symtab, 0, num_syms * sizeof(struct Elf32_Sym));
+    for (i = 0; i < num_syms; i++)
+    {
+        symtab[i].st_info = ELF32_ST_INFO(STB_LOCAL, STT_OBJECT);
+        symtab[i].st_shndx = 1;
+        symtab[i].st_value = 0x20000000 + i * 0x100;
+    }
+    dyn_module.symtab = symtab;
+    dyn_module.symnum = num_syms;
+
+    for (i = 0; i < num_segs * (int32_t)seg_bytes; i++)
+    {
+        seed = seed * 1103515245 + 12345;
+        image[i] = seed >> 16;
+    }
+
+    for (i = 0; i < num_segs; i++)
+    {
+        DLIMP_Loaded_Segment seg;
+
+        memset(&seg, 0, sizeof(seg));
+        seg.input_vaddr = seg.phdr.p_vaddr = 0x10000000 + i * 0x100000;
+        seg.phdr.p_filesz = seg.phdr.p_memsz = seg_bytes;
+        AL_append(&loaded_module.loaded_segments, &seg);
+
+        for (j = 0; j < relocs_per_seg; j++)
+        {
+            struct Elf32_Rel* rel = &rel_table[i * relocs_per_seg + j];
+
+            rel->r_offset = seg.input_vaddr + j * 4;
+            rel->r_info = ELF32_R_INFO((i + j) % num_syms,
+                                       types[j % (sizeof(types) /
+                                                  sizeof(types[0]))]);
+            if (j % 3 == 0)
+            {
+                rela_table[relanum].r_offset = rel->r_offset;
+                rela_table[relanum].r_info =
+                                      ELF32_R_INFO(j % num_syms, R_ARM_ABS32);
+                rela_table[relanum].r_addend = i * j;
+                relanum++;
+            }
+        }
+    }
+
+    /*-----------------------------------------------------------------------*/
+    /* Run 0 is the serial reference, run 1 uses the thread pool.  Both      */
+    /* relocate the same host buffer, since PC-relative results depend on    */
+    /* its address.                                                          */
+    /*-----------------------------------------------------------------------*/
+    for (run = 0; run < 2; run++)
+    {
+        DLIMP_Loaded_Segment* seg =
+                   (DLIMP_Loaded_Segment*)loaded_module.loaded_segments.buf;
+
+        memcpy(work, image, num_segs * seg_bytes);
+        for (i = 0; i < num_segs; i++)
+            seg[i].reloc_offset = (int32_t)(work + i * seg_bytes) -
+                                  (int32_t)seg[i].phdr.p_vaddr;
+
+        if (run == 0)
+            serial_got_relocs(rel_table, num_segs * relocs_per_seg,
+                              rela_table, relanum, &dyn_module);
+        else
+        {
+            DLREL_forced_threads = DLREL_MAX_THREADS;
+            DLSYM_cache_init(&symcache, &dyn_module);
+            process_got_relocs(NULL, rel_table, num_segs * relocs_per_seg,
+                               rela_table, relanum, &symcache, &dyn_module);
+            DLSYM_cache_destroy(&symcache);
+            DLREL_forced_threads = saved_forced_threads;
+        }
+        memcpy(result[run], work, num_segs * seg_bytes);
+    }
+
+    match = !memcmp(result[0], result[1], num_segs * seg_bytes) &&
+            memcmp(result[0], image, num_segs * seg_bytes);
+
+    AL_destroy(&loaded_module.loaded_segments);
+    DLIF_free(symtab);
+    DLIF_free(rel_table);
+    DLIF_free(rela_table);
+    DLIF_free(image);
+    DLIF_free(work);
+    DLIF_free(result[0]);
+    DLIF_free(result[1]);
+
+    return match;
+}
 #endif
@@ -615,19 +615,28 @@ static void rel_change_endian(C60_RELOC_TYPE r_type, uint8_t *address)
 /*****************************************************************************/
 /* READ_REL_TABLE()                                                          */
 /*                                                                           */
-/*    Read in an Elf32_Rel type relocation table.  This function allocates   */
-/*    host memory for the table.                                             */
+/*    Read in an Elf32_Rel type relocation table.  If the file is mapped and */
+/*    no endian conversion is needed, the table is used in place;            */
+/*    otherwise this function allocates host memory for the table.           */
+/*    Returns TRUE if the table must be freed by the caller.                 */
 /*                                                                           */
 /*****************************************************************************/
-static void read_rel_table(struct Elf32_Rel **rel_table,
+static BOOL read_rel_table(struct Elf32_Rel **rel_table,
                            int32_t table_offset,
                            uint32_t relnum, uint32_t relent,
                            LOADER_FILE_DESC *fd, BOOL wrong_endian)
 {
+   if (!wrong_endian && (table_offset & 3) == 0)
+   {
+      *rel_table = (struct Elf32_Rel *)DLIF_fview(fd, table_offset,
+                                                  relnum * relent);
+      if (*rel_table) return FALSE;
+   }
+
    *rel_table = (struct Elf32_Rel *)DLIF_malloc(relnum * relent);
    if (NULL == *rel_table) {
        DLIF_error(DLET_MEMORY, "Failed to Allocate read_rel_table\n");
-       return;
+       return FALSE;
    }
    DLIF_fseek(fd, table_offset, LOADER_SEEK_SET);
    DLIF_fread(*rel_table, relnum, relent, fd);
@@ -638,117 +647,189 @@ static void read_rel_table(struct Elf32_Rel **rel_table,
       for (i = 0; i < relnum; i++)
          DLIMP_change_rel_endian(*rel_table + i);
    }
+
+   return TRUE;
 }
 
 /*****************************************************************************/
-/* PROCESS_REL_TABLE()                                                       */
+/* LOOKUP_SYMBOL()                                                           */
 /*                                                                           */
-/*    Process table of Elf32_Rel type relocations.                           */
+/*    Resolve a relocation's symbol, through the symbol resolution cache of  */
+/*    the current relocation pass if there is one.                           */
 /*                                                                           */
 /*****************************************************************************/
-static void process_rel_table(DLOAD_HANDLE handle, DLIMP_Loaded_Segment* seg,
-                              struct Elf32_Rel *rel_table,
-                              uint32_t relnum,
-                              int32_t *start_relidx,
-                              uint32_t ti_static_base,
-                              DLIMP_Dynamic_Module* dyn_module)
+static BOOL lookup_symbol(DLOAD_HANDLE handle, DLSYM_Cache *symcache,
+                          int32_t r_symid, DLIMP_Dynamic_Module *dyn_module,
+                          Elf32_Addr *r_symval)
+{
+   if (symcache)
+      return DLSYM_cached_lookup(handle, symcache, r_symid, r_symval);
+
+   return DLSYM_canonical_lookup(handle, r_symid, dyn_module, r_symval);
+}
+
+/*****************************************************************************/
+/* FIND_RELOC_RANGE()                                                        */
+/*                                                                           */
+/*    Find the first run of entries in an Elf32_Rel or Elf32_Rela table that */
+/*    fall within the given segment, searching from start_relidx (or from    */
+/*    the start of the table if that is out of range).  The run is returned  */
+/*    in [*first, *last).  Returns TRUE if a run was found.                  */
+/*                                                                           */
+/*****************************************************************************/
+static BOOL find_reloc_range(DLIMP_Loaded_Segment *seg,
+                             void *reloc_table, size_t entsize,
+                             uint32_t relnum,
+                             int32_t start_relidx,
+                             int32_t *first, int32_t *last)
 {
    Elf32_Addr seg_start_addr = seg->input_vaddr;
    Elf32_Addr seg_end_addr   = seg_start_addr + seg->phdr.p_memsz;
    BOOL found = FALSE;
-   int32_t relidx = *start_relidx;
+   int32_t relidx = start_relidx;
 
-   /*------------------------------------------------------------------------*/
-   /* If the given start reloc index is out of range, then start from the    */
-   /* beginning of the given table.                                          */
-   /*------------------------------------------------------------------------*/
    if (relidx >= relnum) relidx = 0;
 
-   /*------------------------------------------------------------------------*/
-   /* Spin through Elf32_Rel type relocation table.                          */
-   /*------------------------------------------------------------------------*/
+   *first = relidx;
    for ( ; relidx < relnum; relidx++)
    {
       /*---------------------------------------------------------------------*/
-      /* If the relocation offset falls within the segment, process it.      */
+      /* Both Elf32_Rel and Elf32_Rela start with r_offset.                  */
       /*---------------------------------------------------------------------*/
-      if (rel_table[relidx].r_offset >= seg_start_addr &&
-          rel_table[relidx].r_offset < seg_end_addr)
+      Elf32_Addr r_offset = ((struct Elf32_Rel *)
+                          ((uint8_t *)reloc_table + relidx * entsize))->r_offset;
+
+      if (r_offset >= seg_start_addr && r_offset < seg_end_addr)
       {
-         Elf32_Addr     r_symval = 0;
-         C60_RELOC_TYPE r_type  =
-                       (C60_RELOC_TYPE)ELF32_R_TYPE(rel_table[relidx].r_info);
-         int32_t        r_symid = ELF32_R_SYM(rel_table[relidx].r_info);
+         if (!found) *first = relidx;
+         found = TRUE;
+      }
 
-         uint8_t *reloc_address = NULL;
-         uint32_t pc     = 0;
-         uint32_t addend = 0;
+      else if (found)
+         break;
+   }
 
-         BOOL     change_endian = FALSE;
+   if (!found) *first = relidx;
+   *last = relidx;
+   return found;
+}
 
-         found = TRUE;
+/*****************************************************************************/
+/* RELOCATE_REL_RANGE()                                                      */
+/*                                                                           */
+/*    Process entries [first, last) of a table of Elf32_Rel type             */
+/*    relocations, all of which fall within the given segment.               */
+/*                                                                           */
+/*****************************************************************************/
+static void relocate_rel_range(DLOAD_HANDLE handle, DLIMP_Loaded_Segment* seg,
+                               struct Elf32_Rel *rel_table,
+                               int32_t first, int32_t last,
+                               uint32_t ti_static_base,
+                               DLSYM_Cache *symcache,
+                               DLIMP_Dynamic_Module* dyn_module)
+{
+   int32_t relidx;
 
-         /*------------------------------------------------------------------*/
-         /* If symbol definition is not found, don't do the relocation.      */
-         /* An error is generated by the lookup function.                    */
-         /*------------------------------------------------------------------*/
-         if (!DLSYM_canonical_lookup(handle, r_symid, dyn_module, &r_symval))
-            continue;
+   for (relidx = first; relidx < last; relidx++)
+   {
+      Elf32_Addr     r_symval = 0;
+      C60_RELOC_TYPE r_type  =
+                    (C60_RELOC_TYPE)ELF32_R_TYPE(rel_table[relidx].r_info);
+      int32_t        r_symid = ELF32_R_SYM(rel_table[relidx].r_info);
 
-         /*------------------------------------------------------------------*/
-         /* Addend value is stored in the relocation field.                  */
-         /* We'll need to unpack it from the data for the segment that is    */
-         /* currently being relocated.                                       */
-         /*------------------------------------------------------------------*/
-         reloc_address =
-                       (((uint8_t *)(seg->phdr.p_vaddr) + seg->reloc_offset) +
-                        rel_table[relidx].r_offset - seg->input_vaddr);
-         pc = (uint32_t)reloc_address;
+      uint8_t *reloc_address = NULL;
+      uint32_t pc     = 0;
+      uint32_t addend = 0;
 
-         change_endian = rel_swap_endian(dyn_module, r_type);
-         if (change_endian)
-            rel_change_endian(r_type, reloc_address);
+      BOOL     change_endian = FALSE;
 
-         rel_unpack_addend(
-                        (C60_RELOC_TYPE)ELF32_R_TYPE(rel_table[relidx].r_info),
-                                                       reloc_address, &addend);
+      /*---------------------------------------------------------------------*/
+      /* If symbol definition is not found, don't do the relocation.         */
+      /* An error is generated by the lookup function.                       */
+      /*---------------------------------------------------------------------*/
+      if (!lookup_symbol(handle, symcache, r_symid, dyn_module, &r_symval))
+         continue;
 
-         /*------------------------------------------------------------------*/
-         /* Perform actual relocation.  This is a really wide function       */
-         /* interface and could do with some encapsulation.                  */
-         /*------------------------------------------------------------------*/
-         reloc_do(r_type,
-                  reloc_address,
-                  addend,
-                  r_symval,
-                  pc,
-                  dyn_module->wrong_endian,
-                  ti_static_base,
-                  dyn_module->dsbt_index);
+      /*---------------------------------------------------------------------*/
+      /* Addend value is stored in the relocation field.                     */
+      /* We'll need to unpack it from the data for the segment that is       */
+      /* currently being relocated.                                          */
+      /*---------------------------------------------------------------------*/
+      reloc_address =
+                    (((uint8_t *)(seg->phdr.p_vaddr) + seg->reloc_offset) +
+                     rel_table[relidx].r_offset - seg->input_vaddr);
+      pc = (uint32_t)reloc_address;
 
-      }
+      change_endian = rel_swap_endian(dyn_module, r_type);
+      if (change_endian)
+         rel_change_endian(r_type, reloc_address);
 
-      else if (found)
-         break;
+      rel_unpack_addend(
+                     (C60_RELOC_TYPE)ELF32_R_TYPE(rel_table[relidx].r_info),
+                                                    reloc_address, &addend);
+
+      /*---------------------------------------------------------------------*/
+      /* Perform actual relocation.  This is a really wide function          */
+      /* interface and could do with some encapsulation.                     */
+      /*---------------------------------------------------------------------*/
+      reloc_do(r_type,
+               reloc_address,
+               addend,
+               r_symval,
+               pc,
+               dyn_module->wrong_endian,
+               ti_static_base,
+               dyn_module->dsbt_index);
    }
 }
 
+/*****************************************************************************/
+/* PROCESS_REL_TABLE()                                                       */
+/*                                                                           */
+/*    Process table of Elf32_Rel type relocations.                           */
+/*                                                                           */
+/*****************************************************************************/
+static void process_rel_table(DLOAD_HANDLE handle, DLIMP_Loaded_Segment* seg,
+                              struct Elf32_Rel *rel_table,
+                              uint32_t relnum,
+                              int32_t *start_relidx,
+                              uint32_t ti_static_base,
+                              DLSYM_Cache *symcache,
+                              DLIMP_Dynamic_Module* dyn_module)
+{
+   int32_t first, last;
+
+   if (find_reloc_range(seg, rel_table, sizeof(struct Elf32_Rel), relnum,
+                        *start_relidx, &first, &last))
+      relocate_rel_range(handle, seg, rel_table, first, last,
+                         ti_static_base, symcache, dyn_module);
+}
+
 /*****************************************************************************/
 /* READ_RELA_TABLE()                                                         */
 /*                                                                           */
-/*    Read in an Elf32_Rela type relocation table.  This function allocates  */
-/*    host memory for the table.                                             */
+/*    Read in an Elf32_Rela type relocation table.  If the file is mapped    */
+/*    and no endian conversion is needed, the table is used in place;        */
+/*    otherwise this function allocates host memory for the table.           */
+/*    Returns TRUE if the table must be freed by the caller.                 */
 /*                                                                           */
 /*****************************************************************************/
-static void read_rela_table(struct Elf32_Rela **rela_table,
+static BOOL read_rela_table(struct Elf32_Rela **rela_table,
                             int32_t table_offset,
                             uint32_t relanum, uint32_t relaent,
                             LOADER_FILE_DESC *fd, BOOL wrong_endian)
 {
+   if (!wrong_endian && (table_offset & 3) == 0)
+   {
+      *rela_table = (struct Elf32_Rela *)DLIF_fview(fd, table_offset,
+                                                    relanum * relaent);
+      if (*rela_table) return FALSE;
+   }
+
    *rela_table = (struct Elf32_Rela *)DLIF_malloc(relanum * relaent);
    if (NULL == *rela_table) {
        DLIF_error(DLET_MEMORY, "Failed to Allocate read_rela_table\n");
-       return;
+       return FALSE;
    }
    DLIF_fseek(fd, table_offset, LOADER_SEEK_SET);
    DLIF_fread(*rela_table, relanum, relaent, fd);
@@ -759,6 +840,54 @@ static void read_rela_table(struct Elf32_Rela **rela_table,
       for (i = 0; i < relanum; i++)
          DLIMP_change_rela_endian(*rela_table + i);
    }
+
+   return TRUE;
+}
+
+/*****************************************************************************/
+/* RELOCATE_RELA_RANGE()                                                     */
+/*                                                                           */
+/*    Process entries [first, last) of a table of Elf32_Rela type            */
+/*    relocations, all of which fall within the given segment.               */
+/*                                                                           */
+/*****************************************************************************/
+static void relocate_rela_range(DLOAD_HANDLE handle,
+                                DLIMP_Loaded_Segment *seg,
+                                struct Elf32_Rela *rela_table,
+                                int32_t first, int32_t last,
+                                uint32_t ti_static_base,
+                                DLSYM_Cache *symcache,
+                                DLIMP_Dynamic_Module *dyn_module)
+{
+    int32_t relidx;
+
+    for (relidx = first; relidx < last; relidx++)
+    {
+        Elf32_Addr     r_symval;
+        C60_RELOC_TYPE r_type  =
+                  (C60_RELOC_TYPE)ELF32_R_TYPE(rela_table[relidx].r_info);
+        int32_t        r_symid = ELF32_R_SYM(rela_table[relidx].r_info);
+
+        /*-------------------------------------------------------------------*/
+        /* If symbol definition is not found, don't do the relocation.       */
+        /* An error is generated by the lookup function.                     */
+        /*-------------------------------------------------------------------*/
+        if (!lookup_symbol(handle, symcache, r_symid, dyn_module, &r_symval))
+            continue;
+
+        /*-------------------------------------------------------------------*/
+        /* Perform actual relocation.  This is a really wide function        */
+        /* interface and could do with some encapsulation.                   */
+        /*-------------------------------------------------------------------*/
+        reloc_do(r_type,
+                 (uint8_t*)(seg->phdr.p_vaddr) + seg->reloc_offset,
+                 rela_table[relidx].r_addend,
+                 r_symval,
+                 rela_table[relidx].r_offset - seg->input_vaddr,
+                 dyn_module->wrong_endian,
+                 ti_static_base,
+                 dyn_module->dsbt_index);
+    }
 }
 
 /*****************************************************************************/
@@ -772,61 +901,59 @@ static void process_rela_table(DLOAD_HANDLE handle, DLIMP_Loaded_Segment *seg,
                                uint32_t relanum,
                                int32_t *start_relidx,
                                uint32_t ti_static_base,
+                               DLSYM_Cache *symcache,
                                DLIMP_Dynamic_Module *dyn_module)
 {
-    Elf32_Addr seg_start_addr = seg->input_vaddr;
-    Elf32_Addr seg_end_addr   = seg_start_addr + seg->phdr.p_memsz;
-    BOOL       found          = FALSE;
-    int32_t    relidx         = *start_relidx;
-
-    /*-----------------------------------------------------------------------*/
-    /* If the given start reloc index is out of range, then start from       */
-    /* the beginning of the given table.                                     */
-    /*-----------------------------------------------------------------------*/
-    if (relidx > relanum) relidx = 0;
-
-    /*-----------------------------------------------------------------------*/
-    /* Spin through RELA relocation table.                                   */
-    /*-----------------------------------------------------------------------*/
-    for ( ; relidx < relanum; relidx++)
-    {
-        /*-------------------------------------------------------------------*/
-        /* If the relocation offset falls within the segment, process it.    */
-        /*-------------------------------------------------------------------*/
-        if (rela_table[relidx].r_offset >= seg_start_addr &&
-            rela_table[relidx].r_offset < seg_end_addr)
-        {
-            Elf32_Addr     r_symval;
-            C60_RELOC_TYPE r_type  =
-                      (C60_RELOC_TYPE)ELF32_R_TYPE(rela_table[relidx].r_info);
-            int32_t        r_symid = ELF32_R_SYM(rela_table[relidx].r_info);
-
-            found = TRUE;
-
-            /*---------------------------------------------------------------*/
-            /* If symbol definition is not found, don't do the relocation.   */
-            /* An error is generated by the lookup function.                 */
-            /*---------------------------------------------------------------*/
-            if (!DLSYM_canonical_lookup(handle, r_symid, dyn_module, &r_symval))
-                continue;
-
-            /*---------------------------------------------------------------*/
-            /* Perform actual relocation.  This is a really wide function    */
-            /* interface and could do with some encapsulation.               */
-            /*---------------------------------------------------------------*/
-            reloc_do(r_type,
-                     (uint8_t*)(seg->phdr.p_vaddr) + seg->reloc_offset,
-                     rela_table[relidx].r_addend,
-                     r_symval,
-                     rela_table[relidx].r_offset - seg->input_vaddr,
-                     dyn_module->wrong_endian,
-                     ti_static_base,
-                     dyn_module->dsbt_index);
-        }
+    int32_t first, last;
 
-        else if (found)
-            break;
-    }
+    if (find_reloc_range(seg, rela_table, sizeof(struct Elf32_Rela), relanum,
+                         *start_relidx, &first, &last))
+        relocate_rela_range(handle, seg, rela_table, first, last,
+                            ti_static_base, symcache, dyn_module);
+}
+
+/*****************************************************************************/
+/* RELOC_TASK, RELOC_PASS                                                    */
+/*                                                                           */
+/*    GOT relocations of one segment, processed as a unit by a relocation    */
+/*    thread.  Segments occupy disjoint host memory, so different segments   */
+/*    can be relocated concurrently; within a segment the serial order       */
+/*    (Elf32_Rela entries, then Elf32_Rel entries) is preserved.             */
+/*                                                                           */
+/*****************************************************************************/
+typedef struct
+{
+   DLIMP_Loaded_Segment *seg;
+   int32_t               rela_first;
+   int32_t               rela_last;
+   int32_t               rel_first;
+   int32_t               rel_last;
+} Reloc_Task;
+
+typedef struct
+{
+   DLOAD_HANDLE          handle;
+   DLIMP_Dynamic_Module *dyn_module;
+   DLSYM_Cache          *symcache;
+   uint32_t              ti_static_base;
+   struct Elf32_Rel     *rel_table;
+   struct Elf32_Rela    *rela_table;
+   Reloc_Task           *tasks;
+} Reloc_Pass;
+
+static void run_reloc_task(void *arg, int32_t t)
+{
+   Reloc_Pass *pass = (Reloc_Pass *)arg;
+   Reloc_Task *task = &pass->tasks[t];
+
+   relocate_rela_range(pass->handle, task->seg, pass->rela_table,
+                       task->rela_first, task->rela_last,
+                       pass->ti_static_base, pass->symcache,
+                       pass->dyn_module);
+   relocate_rel_range(pass->handle, task->seg, pass->rel_table,
+                      task->rel_first, task->rel_last,
+                      pass->ti_static_base, pass->symcache,
+                      pass->dyn_module);
 }
 
 /*****************************************************************************/
@@ -840,6 +967,7 @@ static void process_rela_table(DLOAD_HANDLE handle, DLIMP_Loaded_Segment *seg,
 static void process_got_relocs(DLOAD_HANDLE handle,
                                struct Elf32_Rel* rel_table, uint32_t relnum,
                                struct Elf32_Rela* rela_table, uint32_t relanum,
+                               DLSYM_Cache *symcache,
                                DLIMP_Dynamic_Module* dyn_module)
 {
    DLIMP_Loaded_Segment *seg =
@@ -848,35 +976,78 @@ static void process_got_relocs(DLOAD_HANDLE handle,
    int32_t  rel_relidx = 0;
    int32_t  rela_relidx = 0;
    uint32_t seg_idx = 0;
-   uint32_t ti_static_base = 0;
+   Reloc_Pass pass;
+   int32_t  num_tasks = 0;
+   uint32_t num_relocs = 0;
+
+   pass.handle         = handle;
+   pass.dyn_module     = dyn_module;
+   pass.symcache       = symcache;
+   pass.ti_static_base = 0;
+   pass.rel_table      = rel_table;
+   pass.rela_table     = rela_table;
 
    /*------------------------------------------------------------------------*/
    /* Get the value of the static base (__TI_STATIC_BASE) which will be      */
    /* passed into the relocation table processing functions.                 */
    /*------------------------------------------------------------------------*/
    if (!DLSYM_lookup_local_symtab("__TI_STATIC_BASE", dyn_module->symtab,
-                             dyn_module->symnum, &ti_static_base))
+                             dyn_module->symnum, &pass.ti_static_base))
       DLIF_error(DLET_RELOC, "Could not resolve value of __TI_STATIC_BASE\n");
 
+   pass.tasks = DLIF_malloc(num_segs * sizeof(Reloc_Task));
+
    /*------------------------------------------------------------------------*/
-   /* Process relocations segment by segment.                                */
+   /* Split the relocations by segment, then relocate the segments on the    */
+   /* relocation threads.                                                    */
    /*------------------------------------------------------------------------*/
    for (seg_idx = 0; seg_idx < num_segs; seg_idx++)
    {
+      Reloc_Task task;
+
       /*---------------------------------------------------------------------*/
       /* Relocations should not occur in uninitialized segments.             */
       /*---------------------------------------------------------------------*/
       if (!seg[seg_idx].phdr.p_filesz) continue;
 
+      task.seg = seg + seg_idx;
+      task.rela_first = task.rela_last = 0;
+      task.rel_first = task.rel_last = 0;
+
       if (rela_table)
-         process_rela_table(handle, (seg + seg_idx),
-                            rela_table, relanum, &rela_relidx,
-                            ti_static_base, dyn_module);
+         find_reloc_range(seg + seg_idx, rela_table,
+                          sizeof(struct Elf32_Rela), relanum, rela_relidx,
+                          &task.rela_first, &task.rela_last);
 
       if (rel_table)
-         process_rel_table(handle, (seg + seg_idx),
-                            rel_table, relnum, &rel_relidx,
-                            ti_static_base, dyn_module);
+         find_reloc_range(seg + seg_idx, rel_table,
+                          sizeof(struct Elf32_Rel), relnum, rel_relidx,
+                          &task.rel_first, &task.rel_last);
+
+      if (task.rela_first == task.rela_last &&
+          task.rel_first == task.rel_last)
+         continue;
+
+      /*---------------------------------------------------------------------*/
+      /* Without memory for the task list, relocate the segment right away.  */
+      /*---------------------------------------------------------------------*/
+      if (pass.tasks == NULL)
+      {
+         pass.tasks = &task;
+         run_reloc_task(&pass, 0);
+         pass.tasks = NULL;
+         continue;
+      }
+
+      pass.tasks[num_tasks++] = task;
+      num_relocs += (task.rela_last - task.rela_first) +
+                    (task.rel_last - task.rel_first);
+   }
+
+   if (pass.tasks)
+   {
+      DLREL_run_tasks(num_tasks, num_relocs, run_reloc_task, &pass);
+      DLIF_free(pass.tasks);
    }
 }
 
@@ -891,6 +1062,7 @@ static void process_got_relocs(DLOAD_HANDLE handle,
 static void process_pltgot_relocs(DLOAD_HANDLE handle, void* plt_reloc_table,
                                   int reltype,
                                   uint32_t pltnum,
+                                  DLSYM_Cache *symcache,
                                   DLIMP_Dynamic_Module* dyn_module)
 {
    Elf32_Addr r_offset = (reltype == DT_REL) ?
@@ -935,12 +1107,12 @@ static void process_pltgot_relocs(DLOAD_HANDLE handle, void* plt_reloc_table,
             process_rel_table(handle, (seg + seg_idx),
                               (struct Elf32_Rel *)plt_reloc_table,
                               pltnum, &plt_relidx,
-                              ti_static_base, dyn_module);
+                              ti_static_base, symcache, dyn_module);
          else
             process_rela_table(handle, (seg + seg_idx),
                                (struct Elf32_Rela *)plt_reloc_table,
                                pltnum, &plt_relidx,
-                               ti_static_base, dyn_module);
+                               ti_static_base, symcache, dyn_module);
 
          break;
       }
@@ -958,6 +1130,10 @@ void DLREL_relocate_c60(DLOAD_HANDLE handle, LOADER_FILE_DESC *fd,
    struct Elf32_Rela *rela_table = NULL;
    struct Elf32_Rel  *rel_table  = NULL;
    void              *plt_table  = NULL;
+   BOOL               free_rela  = FALSE;
+   BOOL               free_rel   = FALSE;
+   BOOL               free_plt   = FALSE;
+   DLSYM_Cache       *psymcache  = NULL;
 
    /*------------------------------------------------------------------------*/
    /* Read the size of the relocation table (DT_RELASZ) and the size per     */
@@ -1004,18 +1180,22 @@ void DLREL_relocate_c60(DLOAD_HANDLE handle, LOADER_FILE_DESC *fd,
       {
          pltnum = pltrelsz/relent;
          relsz -= pltrelsz;
-         read_rel_table(((struct Elf32_Rel**) &plt_table),
-                        DLIMP_get_first_dyntag(DT_JMPREL, dyn_nugget),
-                        pltnum, relent, fd, dyn_module->wrong_endian);
+         free_plt = read_rel_table(((struct Elf32_Rel**) &plt_table),
+                                   DLIMP_get_first_dyntag(DT_JMPREL,
+                                                          dyn_nugget),
+                                   pltnum, relent, fd,
+                                   dyn_module->wrong_endian);
       }
 
       else if (pltreltyp == DT_RELA)
       {
          pltnum = pltrelsz/relaent;
          relasz -= pltrelsz;
-         read_rela_table(((struct Elf32_Rela**) &plt_table),
-                         DLIMP_get_first_dyntag(DT_JMPREL, dyn_nugget),
-                         pltnum, relaent, fd, dyn_module->wrong_endian);
+         free_plt = read_rela_table(((struct Elf32_Rela**) &plt_table),
+                                    DLIMP_get_first_dyntag(DT_JMPREL,
+                                                           dyn_nugget),
+                                    pltnum, relaent, fd,
+                                    dyn_module->wrong_endian);
       }
 
       else
@@ -1032,8 +1212,10 @@ void DLREL_relocate_c60(DLOAD_HANDLE handle, LOADER_FILE_DESC *fd,
    if (relasz != INT_MAX)
    {
       relanum = relasz/relaent;
-      read_rela_table(&rela_table, DLIMP_get_first_dyntag(DT_RELA, dyn_nugget),
-                      relanum, relaent, fd, dyn_module->wrong_endian);
+      free_rela = read_rela_table(&rela_table,
+                                  DLIMP_get_first_dyntag(DT_RELA, dyn_nugget),
+                                  relanum, relaent, fd,
+                                  dyn_module->wrong_endian);
    }
 
    /*------------------------------------------------------------------------*/
@@ -1042,28 +1224,38 @@ void DLREL_relocate_c60(DLOAD_HANDLE handle, LOADER_FILE_DESC *fd,
    if (relsz != INT_MAX)
    {
       relnum = relsz/relent;
-      read_rel_table(&rel_table, DLIMP_get_first_dyntag(DT_REL, dyn_nugget),
-                     relnum, relent, fd, dyn_module->wrong_endian);
+      free_rel = read_rel_table(&rel_table,
+                                DLIMP_get_first_dyntag(DT_REL, dyn_nugget),
+                                relnum, relent, fd, dyn_module->wrong_endian);
    }
 
+   /*------------------------------------------------------------------------*/
+   /* Resolve each referenced symbol once for all of this module's           */
+   /* relocations, through the loader's cache for this module.  If the       */
+   /* cache cannot be set up, look up every time.                            */
+   /*------------------------------------------------------------------------*/
+   psymcache = DLSYM_get_symbol_cache(handle, dyn_module);
+
    /*------------------------------------------------------------------------*/
    /* Process the PLTGOT relocations                                         */
    /*------------------------------------------------------------------------*/
    if (plt_table)
-      process_pltgot_relocs(handle, plt_table, pltreltyp, pltnum, dyn_module);
+      process_pltgot_relocs(handle, plt_table, pltreltyp, pltnum, psymcache,
+                            dyn_module);
 
    /*------------------------------------------------------------------------*/
    /* Process the GOT relocations                                            */
    /*------------------------------------------------------------------------*/
    if (rel_table || rela_table)
-      process_got_relocs(handle, rel_table, relnum, rela_table, relanum, dyn_module);
+      process_got_relocs(handle, rel_table, relnum, rela_table, relanum,
+                         psymcache, dyn_module);
 
    /*-------------------------------------------------------------------------*/
    /* Free memory used for ELF relocation table copies.                       */
    /*-------------------------------------------------------------------------*/
-   if (rela_table) DLIF_free(rela_table);
-   if (rel_table)  DLIF_free(rel_table);
-   if (plt_table)  DLIF_free(plt_table);
+   if (free_rela) DLIF_free(rela_table);
+   if (free_rel)  DLIF_free(rel_table);
+   if (free_plt)  DLIF_free(plt_table);
 }
 
 /*****************************************************************************/
@@ -47,6 +47,8 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <pthread.h>
+#include <unistd.h>
 
 #include "ArrayList.h"
 #include "Queue.h"
@@ -92,6 +94,17 @@ int DLREL_relocations;
 time_t DLREL_total_reloc_time;
 #endif
 
+/*---------------------------------------------------------------------------*/
+/* Upper bound on the number of threads used to process relocations.         */
+/*---------------------------------------------------------------------------*/
+int32_t DLREL_max_threads = DLREL_MAX_THREADS;
+
+/*---------------------------------------------------------------------------*/
+/* When non-zero, the number of threads to use regardless of the CPU count  */
+/* and the pass size.  Only meant for the unit tests.                       */
+/*---------------------------------------------------------------------------*/
+int32_t DLREL_forced_threads = 0;
+
 
 /*---------------------------------------------------------------------------*/
 /* Dependency Graph Queue - FIFO queue of dynamic modules that are loaded    */
@@ -149,6 +162,8 @@ DLOAD_HANDLE  DLOAD_create(void * client_handle)
 
         /* Store client token, so it can be handed back during DLIF calls */
         pLoaderObject->client_handle = client_handle;
+
+        pLoaderObject->DLSYM_symbol_caches = NULL;
     }
 
     return((DLOAD_HANDLE)pLoaderObject);
@@ -174,6 +189,8 @@ void  DLOAD_destroy(DLOAD_HANDLE handle)
 
     AL_destroy(&(pLoaderObject->DLIMP_module_dependency_list));
 
+    DLSYM_flush_symbol_caches(handle);
+
     /* Free the instance object */
     DLIF_free (pLoaderObject);
 }
@@ -386,6 +403,8 @@ static void initialize_loaded_module(DLOAD_HANDLE handle,
     loaded_module->gsymtab = NULL;
     loaded_module->gstrtab = NULL;
     loaded_module->gsymnum = loaded_module->gstrsz = 0;
+    loaded_module->gsymhash = NULL;
+    loaded_module->gsymhash_nbucket = 0;
 
     /*-----------------------------------------------------------------------*/
     /* Initialize the Array_List of dependencies.                            */
@@ -976,6 +995,8 @@ static void delete_DLIMP_Loaded_Module(DLOAD_HANDLE handle,
     loaded_module->gsymnum = 0;
     if (loaded_module->gstrtab) DLIF_free(loaded_module->gstrtab);
     loaded_module->gstrsz = 0;
+    if (loaded_module->gsymhash) DLIF_free(loaded_module->gsymhash);
+    loaded_module->gsymhash_nbucket = 0;
     AL_destroy(&(loaded_module->loaded_segments));
     AL_destroy(&(loaded_module->dependencies));
 
@@ -1017,6 +1038,7 @@ static DLIMP_Dynamic_Module *new_DLIMP_Dynamic_Module(LOADER_FILE_DESC *fd)
     dyn_module->dyntab = NULL;
     dyn_module->symtab = NULL;
     dyn_module->symnum = 0;
+    dyn_module->hashtab = NULL;
     dyn_module->gsymtab_offset = 0;
     dyn_module->gstrtab_offset = 0;
     dyn_module->c_args = NULL;
@@ -1088,6 +1110,7 @@ static void delete_DLIMP_Dynamic_Module(DLOAD_HANDLE handle,
     if (dyn_module->name)     DLIF_free(dyn_module->name);
     if (dyn_module->strtab)   DLIF_free(dyn_module->strtab);
     if (dyn_module->symtab)   DLIF_free(dyn_module->symtab);
+    if (dyn_module->hashtab)  DLIF_free(dyn_module->hashtab);
     if (dyn_module->phdr)     DLIF_free(dyn_module->phdr);
     if (dyn_module->dyntab)   DLIF_free(dyn_module->dyntab);
 
@@ -1753,6 +1776,27 @@ static BOOL process_dynamic_table(LOADER_FILE_DESC *fd,
 #if LOADER_DEBUG
         if (debugging_on) DLIF_trace("symnum=%d\n", hash_nchain);
 #endif
+
+        /*-------------------------------------------------------------------*/
+        /* Keep the whole hash table; DLSYM_copy_globals() reuses its bucket */
+        /* assignment to index the module's global symbols. The table is an  */
+        /* optimization only, so the load goes on without it.                */
+        /*-------------------------------------------------------------------*/
+        dyn_module->hashtab =
+              DLIF_malloc((2 + hash_nbucket + hash_nchain) * sizeof(Elf32_Word));
+        if (dyn_module->hashtab)
+        {
+            int j;
+            dyn_module->hashtab[0] = hash_nbucket;
+            dyn_module->hashtab[1] = hash_nchain;
+            DLIF_fread(&(dyn_module->hashtab[2]), sizeof(Elf32_Word),
+                       hash_nbucket + hash_nchain, fd);
+            if (dyn_module->wrong_endian)
+            {
+                for (j = 2; j < 2 + hash_nbucket + hash_nchain; j++)
+                    DLIMP_change_endian32((int32_t*)(&(dyn_module->hashtab[j])));
+            }
+        }
     }
     else
     {
@@ -2152,6 +2196,75 @@ static int32_t dload_static_executable(DLOAD_HANDLE handle,
     return local_file_handle;
 }
 
+/*****************************************************************************/
+/* DLREL_run_tasks()                                                         */
+/*                                                                           */
+/*    Call task_fxn(arg, task) once for every task in [0, num_tasks).  The   */
+/*    tasks must be independent of each other; they are handed out to a     */
+/*    small pool of threads, the calling thread included, and all of them   */
+/*    have completed when this function returns.                             */
+/*                                                                           */
+/*****************************************************************************/
+typedef struct
+{
+    void    (*task_fxn)(void *arg, int32_t task);
+    void     *arg;
+    int32_t   num_tasks;
+    int32_t   next_task;
+} DLREL_Task_Pool;
+
+static void *run_task_worker(void *p)
+{
+    DLREL_Task_Pool *pool = (DLREL_Task_Pool *)p;
+    int32_t task;
+
+    while ((task = __sync_fetch_and_add(&pool->next_task, 1)) <
+           pool->num_tasks)
+        pool->task_fxn(pool->arg, task);
+
+    return NULL;
+}
+
+void DLREL_run_tasks(int32_t num_tasks, uint32_t num_relocs,
+                     void (*task_fxn)(void *arg, int32_t task), void *arg)
+{
+    pthread_t       threads[DLREL_MAX_THREADS];
+    DLREL_Task_Pool pool;
+    int32_t         num_threads = DLREL_max_threads;
+    int32_t         started = 0;
+    long            num_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    int32_t         i;
+
+    if (DLREL_forced_threads > 0)
+        num_threads = DLREL_forced_threads;
+    else
+    {
+        if (num_cpus > 0 && num_threads > num_cpus) num_threads = num_cpus;
+        if (num_relocs < DLREL_MIN_PARALLEL_RELOCS) num_threads = 1;
+    }
+    if (num_threads > DLREL_MAX_THREADS) num_threads = DLREL_MAX_THREADS;
+    if (num_threads > num_tasks) num_threads = num_tasks;
+
+    pool.task_fxn  = task_fxn;
+    pool.arg       = arg;
+    pool.num_tasks = num_tasks;
+    pool.next_task = 0;
+
+    /*-----------------------------------------------------------------------*/
+    /* If a helper thread cannot be started, the remaining threads simply    */
+    /* pick up its share of the tasks.                                       */
+    /*-----------------------------------------------------------------------*/
+    for (i = 1; i < num_threads; i++)
+        if (pthread_create(&threads[started], NULL, run_task_worker,
+                           &pool) == 0)
+            started++;
+
+    run_task_worker(&pool);
+
+    for (i = 0; i < started; i++)
+        pthread_join(threads[i], NULL);
+}
+
 /*****************************************************************************/
 /* process_dynamic_module_relocations()                                      */
 /*                                                                           */
@@ -2467,6 +2580,13 @@ static int32_t relocate_dependency_graph_modules(DLOAD_HANDLE handle,
         detach_loaded_module(dyn_mod_ptr);
         delete_DLIMP_Dynamic_Module(handle, &dyn_mod_ptr);
     }
+
+    /*-----------------------------------------------------------------------*/
+    /* All modules of this load are relocated; their symbol resolution       */
+    /* caches are no longer needed.                                          */
+    /*-----------------------------------------------------------------------*/
+    DLSYM_flush_symbol_caches(handle);
+
     return local_file_handle;
 }
 
@@ -3010,6 +3130,12 @@ BOOL DLOAD_unload(DLOAD_HANDLE handle, uint32_t file_handle)
                 /*-----------------------------------------------------------*/
                 execute_module_termination(handle, loaded_module);
 
+                /*-----------------------------------------------------------*/
+                /* Cached symbol values may resolve to this module (or to    */
+                /* its dependents), so drop them.                            */
+                /*-----------------------------------------------------------*/
+                DLSYM_flush_symbol_caches(handle);
+
                 /*-----------------------------------------------------------*/
                 /* Unload dependent modules via the client. Client needs to  */
                 /* know when a dependent gets unloaded so that it can update */
@@ -462,6 +462,7 @@ DLoad4430_delete (DLoad4430_Handle * handlePtr)
             /* Clear the ProcMgr handle in the local array. */
             GT_assert (curTrace,(handle->procId < MultiProc_MAXPROCESSORS));
             DLOAD_destroy(handle->loaderHandle);
+            DLIF_flushMapTable(handle);
             DLoad_state.dLoadHandles [handle->procId] = NULL;
             handle->loaderHandle = NULL;
             Memory_free (NULL, handle, sizeof (DLoad4430_Object));
@@ -606,7 +607,7 @@ DLoad4430_load (DLoad4430_Handle handle,
             if (handlePtr->DLL_debug)
                 DLDBG_add_host_record(handlePtr, imagePath);
 
-            //DLIF_mapTable(handlePtr);
+            DLIF_mapTable(handlePtr);
 
             /*----------------------------------------------------------------*/
             /* Now, we are ready to start loading the specified file onto the */
@@ -615,9 +616,9 @@ DLoad4430_load (DLoad4430_Handle handle,
             prog_handle = DLOAD_load(handlePtr->loaderHandle,
                                      fp, prog_argc, (char**)(prog_argv.buf));
 
-            //DLIF_unMapTable(handlePtr);
+            DLIF_unMapTable(handlePtr);
 
-            fclose(fp);
+            DLIF_fclose(fp);
 
             /*----------------------------------------------------------------*/
             /* If the load was successful, then we'll need to write the debug */
@@ -769,14 +770,14 @@ DLoad4430_unload (DLoad4430_Handle handle, UInt32 fileId)
     }
     else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        //DLIF_mapTable(dloadHandle);
+        DLIF_mapTable(dloadHandle);
 
         unloaded = DLOAD_unload(dloadHandle->loaderHandle, fileId);
         if (!unloaded) {
             status = DLOAD_E_FAIL;
         }
 
-        //DLIF_unMapTable(dloadHandle);
+        DLIF_unMapTable(dloadHandle);
 
         if (dloadHandle->DLL_debug)
             DLDBG_rm_target_record(dloadHandle, fileId);
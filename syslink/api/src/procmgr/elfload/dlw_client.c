@@ -56,6 +56,7 @@
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <unistd.h>
+#include <pthread.h>
 #include <Std.h>
 #include <UsrUtilsDrv.h>
 #include <Memory.h>
@@ -86,13 +87,89 @@ int memLeakTestInfoNum;
 
 /*****************************************************************************/
 /* Client Provided File I/O                                                  */
+/*                                                                           */
+/*    Object files are mapped into the host address space the first time the */
+/*    core loader touches them.  Reads are then served from the file mapping */
+/*    without going through stdio, and DLIF_fview() hands out read-only      */
+/*    pointers into it.  If a file cannot be mapped, the stdio functions are */
+/*    used instead.                                                          */
+/*****************************************************************************/
+#define MAX_FILE_VIEWS          8
+
+struct file_view {
+    LOADER_FILE_DESC *stream;
+    const uint8_t    *base;
+    size_t            size;
+    size_t            pos;
+};
+
+static struct file_view file_views[MAX_FILE_VIEWS];
+static pthread_mutex_t  file_views_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*****************************************************************************/
+/* GET_FILE_VIEW() - Return the mapping of the given file, mapping the file  */
+/*      on first use.  Returns NULL if the file cannot be mapped.            */
 /*****************************************************************************/
+static struct file_view *get_file_view(LOADER_FILE_DESC *stream)
+{
+    struct file_view *view = NULL;
+    struct file_view *free_view = NULL;
+    struct stat st;
+    void *base;
+    int i;
+
+    pthread_mutex_lock(&file_views_lock);
+    for (i = 0; i < MAX_FILE_VIEWS; i++) {
+        if (file_views[i].stream == stream) {
+            view = &file_views[i];
+            break;
+        }
+        if (free_view == NULL && file_views[i].stream == NULL)
+            free_view = &file_views[i];
+    }
+
+    if (view == NULL && free_view != NULL &&
+        fstat(fileno(stream), &st) == 0 && st.st_size > 0) {
+        base = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE,
+                    fileno(stream), 0);
+        if (base != MAP_FAILED) {
+            /* The loader reads the whole image front to back. */
+            madvise(base, st.st_size, MADV_WILLNEED);
+            free_view->stream = stream;
+            free_view->base = base;
+            free_view->size = st.st_size;
+            free_view->pos = ftell(stream);
+            view = free_view;
+        }
+    }
+    pthread_mutex_unlock(&file_views_lock);
+
+    return view;
+}
+
 /*****************************************************************************/
 /* DLIF_FSEEK() - Seek to a position in specified file.                      */
 /*****************************************************************************/
 int DLIF_fseek(LOADER_FILE_DESC *stream, int32_t offset, int origin)
 {
-    return fseek(stream, offset, origin);
+    struct file_view *view = get_file_view(stream);
+    size_t pos;
+
+    if (view == NULL)
+        return fseek(stream, offset, origin);
+
+    if (origin == SEEK_CUR)
+        pos = view->pos + offset;
+    else if (origin == SEEK_END)
+        pos = view->size + offset;
+    else
+        pos = offset;
+
+    if ((int32_t)pos < 0)
+        return -1;
+
+    view->pos = pos;
+    return 0;
 }
 
 /*****************************************************************************/
@@ -100,7 +177,12 @@ int DLIF_fseek(LOADER_FILE_DESC *stream, int32_t offset, int origin)
 /*****************************************************************************/
 int32_t DLIF_ftell(LOADER_FILE_DESC *stream)
 {
-    return ftell(stream);
+    struct file_view *view = get_file_view(stream);
+
+    if (view == NULL)
+        return ftell(stream);
+
+    return view->pos;
 }
 
 /*****************************************************************************/
@@ -110,7 +192,39 @@ int32_t DLIF_ftell(LOADER_FILE_DESC *stream)
 size_t DLIF_fread(void *ptr, size_t size, size_t nmemb,
                   LOADER_FILE_DESC *stream)
 {
-    return fread(ptr, size, nmemb, stream);
+    struct file_view *view = get_file_view(stream);
+    size_t avail;
+
+    if (view == NULL)
+        return fread(ptr, size, nmemb, stream);
+
+    if (size == 0 || view->pos >= view->size)
+        return 0;
+
+    /* Like fread(), only whole members are returned. */
+    avail = (view->size - view->pos) / size;
+    if (nmemb > avail)
+        nmemb = avail;
+
+    memcpy(ptr, view->base + view->pos, size * nmemb);
+    view->pos += size * nmemb;
+
+    return nmemb;
+}
+
+/*****************************************************************************/
+/* DLIF_FVIEW() - Return a read-only pointer to "size" bytes of the file     */
+/*      starting at "offset", or NULL if the file is not mapped.             */
+/*****************************************************************************/
+const void *DLIF_fview(LOADER_FILE_DESC *stream, int32_t offset, size_t size)
+{
+    struct file_view *view = get_file_view(stream);
+
+    if (view == NULL || offset < 0 || (size_t)offset > view->size ||
+        size > view->size - offset)
+        return NULL;
+
+    return view->base + offset;
 }
 
 /*****************************************************************************/
@@ -120,6 +234,19 @@ size_t DLIF_fread(void *ptr, size_t size, size_t nmemb,
 /*****************************************************************************/
 int32_t DLIF_fclose(LOADER_FILE_DESC *fd)
 {
+    int i;
+
+    pthread_mutex_lock(&file_views_lock);
+    for (i = 0; i < MAX_FILE_VIEWS; i++) {
+        if (file_views[i].stream == fd) {
+            munmap((void *)file_views[i].base, file_views[i].size);
+            file_views[i].stream = NULL;
+            file_views[i].base = NULL;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&file_views_lock);
+
     return fclose(fd);
 }
 
@@ -277,23 +404,28 @@ static struct  mem_entry memory_regions[] = {
 };
 
 /* Helper function used by DLIF module. */
-unsigned long translate_addr(void * client_handle, unsigned long target_addr)
+static int find_region(unsigned long target_addr)
 {
     int i = 0;
     int num_entries = sizeof(memory_regions)/sizeof(struct mem_entry);
-    unsigned long seg_offset;
 
     for(i=0; i< num_entries; i++){
         if (target_addr >= memory_regions[i].ducati_virt_addr && target_addr <
             (memory_regions[i].ducati_virt_addr + memory_regions[i].size)) {
-            break;
-        }
-        else {
-            continue;
+            return i;
         }
     }
 
-    if(i == num_entries)
+    return -1;
+}
+
+/* Helper function used by DLIF module. */
+unsigned long translate_addr(void * client_handle, unsigned long target_addr)
+{
+    int i = find_region(target_addr);
+    unsigned long seg_offset;
+
+    if(i < 0)
         return 0;
     else {
         seg_offset = target_addr - memory_regions[i].ducati_virt_addr;
@@ -301,6 +433,184 @@ unsigned long translate_addr(void * client_handle, unsigned long target_addr)
     }
 }
 
+/*****************************************************************************/
+/* Host mappings of target memory.                                           */
+/*                                                                           */
+/*    Segments are accessed through host mappings of the physical windows in */
+/*    memory_regions[].  Instead of mapping each segment on its own, a       */
+/*    mapping covers the whole region (small regions) or the aligned         */
+/*    granules around the segment (large regions), so that adjacent segments */
+/*    share one mapping.  Mappings are cached per client handle, keyed by    */
+/*    physical range, and are only released by DLIF_flushMapTable() when the */
+/*    DLoad4430 object is deleted, so reloading an image reuses them.        */
+/*****************************************************************************/
+#define MAP_GRANULE_SIZE        0x100000
+#define MAP_WHOLE_REGION_SIZE   0x400000
+#define MAP_INIT_WINDOWS        16
+
+static void *map_target(DLoad4430_Object *clientObj,
+                        unsigned long target_addr, unsigned long size)
+{
+    DLoad4430_MapWindow *window;
+    DLoad4430_MapWindow *windows;
+    Memory_MapInfo mapinfo;
+    unsigned long phys, reg_start, reg_end, win_start, win_end;
+    int i = find_region(target_addr);
+    int status;
+
+    if (i < 0) {
+        DLIF_error(DLET_MEMORY, "The target address is out of range\n");
+        return NULL;
+    }
+
+    phys = memory_regions[i].mpu_phys_addr +
+           (target_addr - memory_regions[i].ducati_virt_addr);
+
+    /*-----------------------------------------------------------------------*/
+    /* Reuse a cached window if one covers the requested range.              */
+    /*-----------------------------------------------------------------------*/
+    for (window = clientObj->mapWindows;
+         window < clientObj->mapWindows + clientObj->numMapWindows; window++) {
+        if (phys >= window->physAddr &&
+            phys + size <= window->physAddr + window->size)
+            return (void *)(window->virtAddr + (phys - window->physAddr));
+    }
+
+    /*-----------------------------------------------------------------------*/
+    /* Otherwise map the window around the segment, clipped to its region.   */
+    /*-----------------------------------------------------------------------*/
+    reg_start = memory_regions[i].mpu_phys_addr;
+    reg_end = reg_start + memory_regions[i].size;
+    if (memory_regions[i].size <= MAP_WHOLE_REGION_SIZE) {
+        win_start = reg_start;
+        win_end = reg_end;
+    }
+    else {
+        win_start = phys & ~(MAP_GRANULE_SIZE - 1);
+        win_end = (phys + size + MAP_GRANULE_SIZE - 1) &
+                  ~(MAP_GRANULE_SIZE - 1);
+        if (win_start < reg_start)
+            win_start = reg_start;
+        if (win_end > reg_end)
+            win_end = reg_end;
+    }
+    if (win_end < phys + size)
+        win_end = phys + size;
+
+    if (clientObj->numMapWindows == clientObj->maxMapWindows) {
+        windows = DLIF_malloc((clientObj->maxMapWindows + MAP_INIT_WINDOWS) *
+                              sizeof(DLoad4430_MapWindow));
+        if (windows == NULL) {
+            DLIF_error(DLET_MEMORY, "Failed to grow the mapping cache\n");
+            return NULL;
+        }
+        if (clientObj->mapWindows) {
+            memcpy(windows, clientObj->mapWindows,
+                   clientObj->numMapWindows * sizeof(DLoad4430_MapWindow));
+            DLIF_free(clientObj->mapWindows);
+        }
+        clientObj->mapWindows = windows;
+        clientObj->maxMapWindows += MAP_INIT_WINDOWS;
+    }
+
+    /* Mappings outlive a single load, so hold the driver open for them. */
+    if (!clientObj->mapDrvOpen) {
+        UsrUtilsDrv_setup ();
+        clientObj->mapDrvOpen = TRUE;
+    }
+
+    mapinfo.src = win_start;
+    mapinfo.size = win_end - win_start;
+    mapinfo.isCached = FALSE;
+    status = Memory_map (&mapinfo);
+    if (status < 0 || mapinfo.dst == (UInt32)(-1)) {
+        DLIF_error(DLET_MEMORY,
+                   "Memory_map failed for Physical Address 0x%x Exiting\n",
+                   (UInt32)mapinfo.src);
+        return NULL;
+    }
+
+#if LOADER_DEBUG
+    if (debugging_on) {
+        DLIF_trace("=============================================\n");
+        DLIF_trace("mapinfo.mpu_virt_addr is 0x%x\n",
+                   (unsigned int)mapinfo.dst);
+        DLIF_trace("mapinfo.mpu_phys_addr is 0x%x\n",
+                   (unsigned int)mapinfo.src);
+        DLIF_trace("mapinfo.size is 0x%x\n",
+                   (unsigned int)mapinfo.size);
+    }
+#endif
+
+    window = &clientObj->mapWindows[clientObj->numMapWindows++];
+    window->physAddr = mapinfo.src;
+    window->size = mapinfo.size;
+    window->virtAddr = mapinfo.dst;
+
+    return (void *)(window->virtAddr + (phys - window->physAddr));
+}
+
+/*****************************************************************************/
+/* DLIF_MAPTABLE() - Open the driver used to map target memory for the      */
+/*      duration of a load or unload.                                        */
+/*****************************************************************************/
+void DLIF_mapTable(void* client_handle)
+{
+    DLoad4430_Object *clientObj = (DLoad4430_Object *)client_handle;
+
+    if (clientObj->mapRefCount++ == 0 && !clientObj->mapDrvOpen) {
+        UsrUtilsDrv_setup ();
+        clientObj->mapDrvOpen = TRUE;
+    }
+}
+
+/*****************************************************************************/
+/* DLIF_UNMAPTABLE() - Close the driver opened by DLIF_mapTable(), unless    */
+/*      cached mappings still need it.                                       */
+/*****************************************************************************/
+void DLIF_unMapTable(void* client_handle)
+{
+    DLoad4430_Object *clientObj = (DLoad4430_Object *)client_handle;
+
+    if (clientObj->mapRefCount == 0)
+        return;
+
+    if (--clientObj->mapRefCount == 0 && clientObj->numMapWindows == 0 &&
+        clientObj->mapDrvOpen) {
+        UsrUtilsDrv_destroy ();
+        clientObj->mapDrvOpen = FALSE;
+    }
+}
+
+/*****************************************************************************/
+/* DLIF_FLUSHMAPTABLE() - Unmap all cached windows of target memory.         */
+/*****************************************************************************/
+void DLIF_flushMapTable(void* client_handle)
+{
+    DLoad4430_Object *clientObj = (DLoad4430_Object *)client_handle;
+    Memory_UnmapInfo unmapinfo;
+    UInt32 i;
+
+    for (i = 0; i < clientObj->numMapWindows; i++) {
+        unmapinfo.addr = clientObj->mapWindows[i].virtAddr;
+        unmapinfo.size = clientObj->mapWindows[i].size;
+        if (Memory_unmap (&unmapinfo) < 0)
+            DLIF_error(DLET_MEMORY, "Memory_unmap failed\n");
+    }
+
+    if (clientObj->mapWindows)
+        DLIF_free(clientObj->mapWindows);
+    clientObj->mapWindows = NULL;
+    clientObj->numMapWindows = 0;
+    clientObj->maxMapWindows = 0;
+
+    if (clientObj->mapDrvOpen) {
+        UsrUtilsDrv_destroy ();
+        clientObj->mapDrvOpen = FALSE;
+    }
+    clientObj->mapRefCount = 0;
+}
+
 /*****************************************************************************/
 /* DLIF_INITMEM() - Initialize the target memory.                            */
 /*****************************************************************************/
@@ -378,10 +688,8 @@ BOOL DLIF_allocate(void * client_handle, struct DLOAD_MEMORY_REQUEST *targ_req)
 /*****************************************************************************/
 BOOL DLIF_release(void* client_handle, struct DLOAD_MEMORY_SEGMENT* ptr)
 {
-    void *physAddr;
-    Memory_MapInfo mapinfo;
-    Memory_UnmapInfo unmapinfo;
-    int status;
+    DLoad4430_Object *clientObj = (DLoad4430_Object *)client_handle;
+    void *hostAddr;
 
 #if LOADER_DEBUG
     if (debugging_on)
@@ -394,36 +702,12 @@ BOOL DLIF_release(void* client_handle, struct DLOAD_MEMORY_SEGMENT* ptr)
     /* as available (will also merge with adjacent free packets).            */
     /*-----------------------------------------------------------------------*/
     if (!(ptr->flags & DLOAD_SF_relocatable)) {
-        physAddr = (void *)translate_addr(client_handle,
-                                          (unsigned long)(ptr->target_address));
-
-        if (physAddr == NULL) {
-            DLIF_error(DLET_MEMORY, "The target address is out of range\n");
+        hostAddr = map_target(clientObj, (unsigned long)(ptr->target_address),
+                              ptr->memsz_in_bytes);
+        if (hostAddr == NULL)
             return FALSE;
-        }
 
-        UsrUtilsDrv_setup ();
-        mapinfo.src = (unsigned long)physAddr;
-        mapinfo.size =  ptr->memsz_in_bytes;
-        status = Memory_map (&mapinfo);
-        if (status < 0) {
-            DLIF_error(DLET_MEMORY,
-                       "Memory_map failed for Physical Address 0x%x Exiting\n",
-                       (UInt32)mapinfo.src);
-        }
-        else {
-            unmapinfo.addr = mapinfo.dst;
-            unmapinfo.size = mapinfo.size;
-            memset ((void *)mapinfo.dst, 0, ptr->memsz_in_bytes);
-            status = Memory_unmap (&unmapinfo);
-            if (status < 0) {
-                DLIF_error (DLET_MEMORY, "Memory_unmap failed\n");
-            }
-        }
-        UsrUtilsDrv_destroy ();
-        if (status < 0) {
-            return FALSE;
-        }
+        memset (hostAddr, 0, ptr->memsz_in_bytes);
     }
     else {
         DLTMM_free(client_handle, ptr->target_address);
@@ -442,62 +726,39 @@ BOOL DLIF_copy(void* client_handle, struct DLOAD_MEMORY_REQUEST* targ_req)
     struct DLOAD_MEMORY_SEGMENT* obj_desc = targ_req->segment;
     LOADER_FILE_DESC* f = targ_req->fp;
     DLoad4430_Object *clientObj = (DLoad4430_Object *)client_handle;
-    void *dstAddr = NULL;
-    Memory_MapInfo mapinfo;
-    int status;
+    const void *src;
 
-    dstAddr = (void *)translate_addr(client_handle,
-                                     (unsigned long)(obj_desc->target_address));
-    if (dstAddr == NULL) {
-        DLIF_error(DLET_MEMORY, "The target address is out of range\n");
+    targ_req->host_address = map_target(clientObj,
+                                     (unsigned long)(obj_desc->target_address),
+                                     obj_desc->memsz_in_bytes);
+    if (targ_req->host_address == NULL)
         return FALSE;
-    }
-
-    UsrUtilsDrv_setup ();
-    mapinfo.src = (unsigned long)dstAddr;
-    mapinfo.size =  targ_req->segment->memsz_in_bytes;
-    status = Memory_map(&mapinfo);
-    UsrUtilsDrv_destroy ();
-    if (status < 0) {
-        DLIF_error(DLET_MEMORY,
-                   "Memory_map failed for Physical Address 0x%x Exiting\n",
-                   (UInt32)mapinfo.src);
-        return FALSE;
-    } else {
-        targ_req->host_address  = (void *)mapinfo.dst;
-    }
-#if LOADER_DEBUG
-    if (debugging_on) {
-        DLIF_trace("=============================================\n");
-        DLIF_trace("mapinfo.mpu_virt_addr is 0x%x\n",
-                   (unsigned int)mapinfo.dst);
-        DLIF_trace("mapinfo.ducati_virt_addr is 0x%x\n",
-                   (unsigned int)obj_desc->target_address);
-        DLIF_trace("mapinfo.mpu_phys_addr is 0x%x\n",
-                   (unsigned int)mapinfo.src);
-        DLIF_trace("mapinfo.size is 0x%x\n",
-                   (unsigned int)mapinfo.size);
-    }
-#endif
-    if((unsigned long)targ_req->host_address == (unsigned long)(-1)) {
-        DLIF_error(DLET_MEMORY,
-                   "Failed to do memory mapping for address [0x%x]\n",targ_req->host_address);
-        return FALSE;
-    }
 
     /*-------------------------------------------------------------------*/
     /* As required by API, copy the described segment into memory from   */
-    /* file.  We're the client, not the loader, so we can use fseek() and*/
-    /* fread().                                                          */
+    /* file.  The initialized part is copied straight from the file      */
+    /* mapping; only the uninitialized (bss) tail is zeroed.             */
     /*-------------------------------------------------------------------*/
     /* ??? I don't think we want to do this if we are allocating target  */
     /*   memory for the run only placement of this segment.  If it is the*/
     /*   load placement or both load and run placement, then we can do   */
     /*   the copy.                                                       */
     /*-------------------------------------------------------------------*/
-    memset(targ_req->host_address, 0, obj_desc->memsz_in_bytes);
-    fseek(f,targ_req->offset,SEEK_SET);
-    fread(targ_req->host_address,obj_desc->objsz_in_bytes,1,f);
+    src = DLIF_fview(f, targ_req->offset, obj_desc->objsz_in_bytes);
+    if (src != NULL) {
+        memcpy(targ_req->host_address, src, obj_desc->objsz_in_bytes);
+    }
+    else {
+        DLIF_fseek(f, targ_req->offset, SEEK_SET);
+        if (DLIF_fread(targ_req->host_address, obj_desc->objsz_in_bytes, 1,
+                       f) != 1 && obj_desc->objsz_in_bytes != 0) {
+            DLIF_error(DLET_FILE, "Failed to read segment from file\n");
+            return FALSE;
+        }
+    }
+    if (obj_desc->memsz_in_bytes > obj_desc->objsz_in_bytes)
+        memset((uint8_t *)targ_req->host_address + obj_desc->objsz_in_bytes,
+               0, obj_desc->memsz_in_bytes - obj_desc->objsz_in_bytes);
 
     /*-------------------------------------------------------------------*/
     /* Once we have target address for this allocation, add debug        */
@@ -548,20 +809,11 @@ BOOL DLIF_read(void* client_handle, void *ptr, size_t size, size_t nmemb,
 /*****************************************************************************/
 BOOL DLIF_write(void* client_handle, struct DLOAD_MEMORY_REQUEST* req)
 {
-    int status;
-    Memory_UnmapInfo unmapinfo;
-
     /*-----------------------------------------------------------------------*/
     /* Nothing to do since we are relocating directly into target memory.    */
+    /* The host mapping stays in the client's mapping cache.                 */
     /*-----------------------------------------------------------------------*/
-    if (req->host_address) {
-        unmapinfo.addr = (UInt32)req->host_address;
-        unmapinfo.size = req->segment->memsz_in_bytes;
-        status = Memory_unmap (&unmapinfo);
-        if (status < 0)
-                return FALSE;
-    }
-    else
+    if (!req->host_address)
         return FALSE;
 
     return TRUE;
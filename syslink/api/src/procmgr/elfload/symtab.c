@@ -61,6 +61,105 @@ TYPE_QUEUE_IMPLEMENTATION(int32_t, Int32)
 /*---------------------------------------------------------------------------*/
 int32_t DLIMP_application_handle = 0;
 
+/*---------------------------------------------------------------------------*/
+/* Terminates a chain in a loaded module's global symbol hash (gsymhash).    */
+/*---------------------------------------------------------------------------*/
+#define DLSYM_HASH_END ((Elf32_Word)-1)
+
+/*****************************************************************************/
+/* DLSYM_ELF_HASH() - The ELF symbol hash function, as used by DT_HASH.      */
+/*****************************************************************************/
+static Elf32_Word DLSYM_elf_hash(const char *name)
+{
+    Elf32_Word h = 0, g;
+
+    while (*name)
+    {
+        h = (h << 4) + (uint8_t)*name++;
+        g = h & 0xf0000000;
+        if (g) h ^= g >> 24;
+        h &= ~g;
+    }
+
+    return h;
+}
+
+/*****************************************************************************/
+/* DLSYM_BUILD_GLOBAL_HASH() - Index the loaded module's global symbol table */
+/*      by name hash. When the object file has a DT_HASH table, its bucket   */
+/*      assignment is reused instead of hashing every symbol name.           */
+/*****************************************************************************/
+static void DLSYM_build_global_hash(DLIMP_Dynamic_Module *dyn_module,
+                                    Elf32_Word global_index)
+{
+    DLIMP_Loaded_Module *module  = dyn_module->loaded_module;
+    struct Elf32_Sym    *gsymtab = module->gsymtab;
+    Elf32_Word          *hashtab = dyn_module->hashtab;
+    Elf32_Word          *bucket, *chain;
+    Elf32_Word           nbucket, i, b, sym_idx, steps;
+    BOOL                 use_dt_hash;
+
+    if (module->gsymhash) DLIF_free(module->gsymhash);
+    module->gsymhash = NULL;
+    module->gsymhash_nbucket = 0;
+
+    if (!gsymtab || module->gsymnum == 0) return;
+
+    use_dt_hash = (hashtab && hashtab[0] > 0 &&
+                   hashtab[1] == dyn_module->symnum);
+    nbucket = use_dt_hash ? hashtab[0] : module->gsymnum / 2 + 1;
+
+    module->gsymhash = DLIF_malloc((nbucket + module->gsymnum) *
+                                   sizeof(Elf32_Word));
+    if (!module->gsymhash) return;
+
+    bucket = module->gsymhash;
+    chain  = bucket + nbucket;
+    for (b = 0; b < nbucket; b++) bucket[b] = DLSYM_HASH_END;
+
+    /*-----------------------------------------------------------------------*/
+    /* chain[] first records the bucket of each global symbol.               */
+    /*-----------------------------------------------------------------------*/
+    for (i = 0; i < module->gsymnum; i++) chain[i] = DLSYM_HASH_END;
+
+    if (use_dt_hash)
+    {
+        for (b = 0; b < nbucket; b++)
+        {
+            for (sym_idx = hashtab[2 + b], steps = 0;
+                 sym_idx != STN_UNDEF && sym_idx < dyn_module->symnum &&
+                 steps < dyn_module->symnum;
+                 sym_idx = hashtab[2 + nbucket + sym_idx], steps++)
+                if (sym_idx >= global_index)
+                    chain[sym_idx - global_index] = b;
+        }
+
+        /*-------------------------------------------------------------------*/
+        /* Lookups hash the name, so make sure the producer used the ELF     */
+        /* hash function before trusting its buckets.                        */
+        /*-------------------------------------------------------------------*/
+        if (chain[0] != DLSYM_elf_hash((char *)gsymtab[0].st_name) % nbucket)
+            for (i = 0; i < module->gsymnum; i++) chain[i] = DLSYM_HASH_END;
+    }
+
+    for (i = 0; i < module->gsymnum; i++)
+        if (chain[i] == DLSYM_HASH_END)
+            chain[i] = DLSYM_elf_hash((char *)gsymtab[i].st_name) % nbucket;
+
+    /*-----------------------------------------------------------------------*/
+    /* Link the chains. Going backwards leaves each chain in symbol table    */
+    /* order, so the first match is the one a linear search would find.      */
+    /*-----------------------------------------------------------------------*/
+    for (i = module->gsymnum; i-- > 0; )
+    {
+        b = chain[i];
+        chain[i] = bucket[b];
+        bucket[b] = i;
+    }
+
+    module->gsymhash_nbucket = nbucket;
+}
+
 /*****************************************************************************/
 /* DLSYM_COPY_GLOBALS() - Copy global symbols from the dynamic module's      */
 /*      symbol table to the loader's global symbol table.                    */
@@ -134,6 +233,11 @@ void DLSYM_copy_globals(DLIMP_Dynamic_Module *dyn_module)
                                  dyn_module->symtab[i + global_index].st_name);
 #endif
    }
+
+    /*-----------------------------------------------------------------------*/
+    /* Index the global symbols for DLSYM_lookup_loaded_module().            */
+    /*-----------------------------------------------------------------------*/
+    DLSYM_build_global_hash(dyn_module, global_index);
 }
 
 /*****************************************************************************/
@@ -184,10 +288,7 @@ static BOOL breadth_first_lookup(DLOAD_HANDLE phandle,
         /* Search the symbol table of the current file handle's Module.      */
         /* If the symbol was found, then we're finished.                     */
         /*-------------------------------------------------------------------*/
-        if (DLSYM_lookup_global_symtab(sym_name,
-                                       mod_node->value->gsymtab,
-                                       mod_node->value->gsymnum,
-                                       sym_value))
+        if (DLSYM_lookup_loaded_module(sym_name, mod_node->value, sym_value))
             return TRUE;
 
         /*-------------------------------------------------------------------*/
@@ -246,10 +347,7 @@ BOOL DLSYM_global_lookup(DLOAD_HANDLE handle,
             /*---------------------------------------------------------------*/
             /* Return true if we find the symbol.                            */
             /*---------------------------------------------------------------*/
-            if (DLSYM_lookup_global_symtab(sym_name,
-                                           node->value->gsymtab,
-                                           node->value->gsymnum,
-                                           sym_value))
+            if (DLSYM_lookup_loaded_module(sym_name, node->value, sym_value))
                 return TRUE;
         }
     }
@@ -322,6 +420,44 @@ BOOL DLSYM_lookup_global_symtab(const char *sym_name, struct Elf32_Sym *symtab,
     return DLSYM_lookup_symtab(sym_name, symtab, symnum, sym_value, FALSE);
 }
 
+/*****************************************************************************/
+/* DLSYM_lookup_loaded_module() - Lookup the symbol name in the global       */
+/*                               symbol table of a loaded module, using its  */
+/*                               hash index when it has one. Symbol must     */
+/*                               have global binding. Return the value in    */
+/*                               sym_value and return TRUE if the lookup     */
+/*                               succeeds.                                   */
+/*****************************************************************************/
+BOOL DLSYM_lookup_loaded_module(const char          *sym_name,
+                                DLIMP_Loaded_Module *module,
+                                Elf32_Addr          *sym_value)
+{
+    struct Elf32_Sym *gsymtab = module->gsymtab;
+    Elf32_Word       *chain;
+    Elf32_Word        sym_idx;
+
+    if (!module->gsymhash)
+        return DLSYM_lookup_global_symtab(sym_name, gsymtab, module->gsymnum,
+                                          sym_value);
+
+    chain = module->gsymhash + module->gsymhash_nbucket;
+    for (sym_idx = module->gsymhash[DLSYM_elf_hash(sym_name) %
+                                    module->gsymhash_nbucket];
+         sym_idx != DLSYM_HASH_END;
+         sym_idx = chain[sym_idx])
+    {
+        if ((gsymtab[sym_idx].st_shndx != SHN_UNDEF) &&
+            (ELF32_ST_BIND(gsymtab[sym_idx].st_info) != STB_LOCAL) &&
+            !strcmp(sym_name, (char*)(gsymtab[sym_idx].st_name)))
+        {
+            if (sym_value) *sym_value = gsymtab[sym_idx].st_value;
+            return TRUE;
+        }
+    }
+    if (sym_value) *sym_value = 0;
+    return FALSE;
+}
+
 /*****************************************************************************/
 /* DLSYM_lookup_local_symtab() - Lookup the symbol name in the given symbol  */
 /*                               table. Symbol must have local binding.      */
@@ -398,3 +534,184 @@ BOOL DLSYM_canonical_lookup(DLOAD_HANDLE handle,
     }
 }
 
+/*****************************************************************************/
+/* DLSYM_CACHE_INIT() - Set up an empty symbol resolution cache for the      */
+/*                      symbol table of the given module.  Returns FALSE if  */
+/*                      host memory for the cache cannot be allocated.       */
+/*****************************************************************************/
+BOOL DLSYM_cache_init(DLSYM_Cache *cache, DLIMP_Dynamic_Module *dyn_module)
+{
+    cache->dyn_module = dyn_module;
+    cache->file_handle = dyn_module->loaded_module ?
+                         dyn_module->loaded_module->file_handle : 0;
+    cache->symnum = dyn_module->symnum;
+    cache->state = NULL;
+    cache->value = NULL;
+    cache->lookups = 0;
+    cache->misses = 0;
+    cache->next = NULL;
+
+    if (cache->symnum)
+    {
+        cache->state = DLIF_malloc(cache->symnum * sizeof(uint8_t));
+        cache->value = DLIF_malloc(cache->symnum * sizeof(Elf32_Addr));
+        if (!cache->state || !cache->value)
+        {
+            if (cache->state) DLIF_free(cache->state);
+            if (cache->value) DLIF_free(cache->value);
+            cache->state = NULL;
+            cache->value = NULL;
+            return FALSE;
+        }
+        memset(cache->state, DLSYM_CACHE_EMPTY,
+               cache->symnum * sizeof(uint8_t));
+    }
+
+    pthread_mutex_init(&cache->lock, NULL);
+    return TRUE;
+}
+
+/*****************************************************************************/
+/* DLSYM_CACHE_DESTROY() - Free a symbol resolution cache.                   */
+/*****************************************************************************/
+void DLSYM_cache_destroy(DLSYM_Cache *cache)
+{
+    pthread_mutex_destroy(&cache->lock);
+    if (cache->state) DLIF_free(cache->state);
+    if (cache->value) DLIF_free(cache->value);
+    cache->state = NULL;
+    cache->value = NULL;
+}
+
+/*****************************************************************************/
+/* DLSYM_CACHED_LOOKUP() - Same as DLSYM_canonical_lookup(), but the result  */
+/*                         for each symbol index is only computed once.  A   */
+/*                         failed lookup is reported once and remembered.    */
+/*****************************************************************************/
+BOOL DLSYM_cached_lookup(DLOAD_HANDLE handle, DLSYM_Cache *cache,
+                         int32_t sym_index, Elf32_Addr *sym_value)
+{
+    uint8_t state;
+    Elf32_Addr value = 0;
+
+    if (sym_index < 0 || sym_index >= cache->symnum)
+        return DLSYM_canonical_lookup(handle, sym_index, cache->dyn_module,
+                                      sym_value);
+
+#if LOADER_DEBUG
+    __sync_fetch_and_add(&cache->lookups, 1);
+#endif
+
+    state = cache->state[sym_index];
+    if (state == DLSYM_CACHE_EMPTY)
+    {
+        pthread_mutex_lock(&cache->lock);
+        state = cache->state[sym_index];
+        if (state == DLSYM_CACHE_EMPTY)
+        {
+#if LOADER_DEBUG
+            cache->misses++;
+#endif
+            state = DLSYM_canonical_lookup(handle, sym_index,
+                                           cache->dyn_module, &value) ?
+                    DLSYM_CACHE_RESOLVED : DLSYM_CACHE_FAILED;
+            cache->value[sym_index] = value;
+            /* Publish the value before the state that guards it. */
+            __sync_synchronize();
+            cache->state[sym_index] = state;
+        }
+        pthread_mutex_unlock(&cache->lock);
+    }
+    else
+    {
+        /* Pairs with the barrier on the publishing side. */
+        __sync_synchronize();
+    }
+
+    if (state != DLSYM_CACHE_RESOLVED) return FALSE;
+
+    if (sym_value) *sym_value = cache->value[sym_index];
+    return TRUE;
+}
+
+/*****************************************************************************/
+/* DLSYM_GET_SYMBOL_CACHE() - Return the symbol resolution cache that the    */
+/*      loader object keeps for the given module, creating it on first use.  */
+/*      Caches are keyed by the module's file handle, so the relocation      */
+/*      passes of a module (PLT and GOT) share their symbol lookups.         */
+/*      Returns NULL if host memory for the cache cannot be allocated.       */
+/*****************************************************************************/
+DLSYM_Cache *DLSYM_get_symbol_cache(DLOAD_HANDLE handle,
+                                    DLIMP_Dynamic_Module *dyn_module)
+{
+    LOADER_OBJECT *pHandle = (LOADER_OBJECT *)handle;
+    DLSYM_Cache *cache;
+    int32_t file_handle = dyn_module->loaded_module ?
+                          dyn_module->loaded_module->file_handle : 0;
+
+    for (cache = pHandle->DLSYM_symbol_caches; cache; cache = cache->next)
+    {
+        if (cache->file_handle == file_handle &&
+            cache->symnum == dyn_module->symnum)
+        {
+            cache->dyn_module = dyn_module;
+            return cache;
+        }
+    }
+
+    cache = DLIF_malloc(sizeof(DLSYM_Cache));
+    if (!cache) return NULL;
+
+    if (!DLSYM_cache_init(cache, dyn_module))
+    {
+        DLIF_free(cache);
+        return NULL;
+    }
+
+    cache->next = pHandle->DLSYM_symbol_caches;
+    pHandle->DLSYM_symbol_caches = cache;
+    return cache;
+}
+
+/*****************************************************************************/
+/* DLSYM_FLUSH_SYMBOL_CACHES() - Discard all symbol resolution caches of the */
+/*      loader object.  Called when a load completes and when a module is    */
+/*      unloaded, since cached values may refer to the unloaded module.      */
+/*****************************************************************************/
+void DLSYM_flush_symbol_caches(DLOAD_HANDLE handle)
+{
+    LOADER_OBJECT *pHandle = (LOADER_OBJECT *)handle;
+    DLSYM_Cache *cache = pHandle->DLSYM_symbol_caches;
+#if LOADER_DEBUG
+    uint32_t total_lookups = 0;
+    uint32_t total_misses = 0;
+#endif
+
+    while (cache)
+    {
+        DLSYM_Cache *next = cache->next;
+
+#if LOADER_DEBUG
+        if (debugging_on)
+            DLIF_trace("Symbol cache for file handle %d: %d symbols, "
+                       "%d lookups, %d resolved\n", cache->file_handle,
+                       cache->symnum, cache->lookups, cache->misses);
+        total_lookups += cache->lookups;
+        total_misses += cache->misses;
+#endif
+
+        DLSYM_cache_destroy(cache);
+        DLIF_free(cache);
+        cache = next;
+    }
+
+#if LOADER_DEBUG
+    if (debugging_on && total_lookups)
+        DLIF_trace("Symbol cache: %d lookups, %d resolved, %d%% hit rate\n",
+                   total_lookups, total_misses,
+                   (int)(((total_lookups - total_misses) * 100ULL) /
+                         total_lookups));
+#endif
+
+    pHandle->DLSYM_symbol_caches = NULL;
+}
@@ -43,6 +43,7 @@
 /* Standard headers */
 #include <host_os.h>
 #include <pthread.h>
+#include <unistd.h>
 
 /* OSAL, Utility and IPC headers */
 #include <Std.h>
@@ -76,6 +77,9 @@ extern "C" {
 #define RCMCLIENT_HEAPID_ARRAY_BLOCKSIZE 256   /*!< Default heap block size */
 #define MAX_NAME_LEN                      32   /*!< Max RCM client name len */
 #define WAIT_NONE                        0x0   /*!< 0 wait time for msg Que */
+#define RCMCLIENT_COMPLETION_LEN          64   /*!< Reply slots, power of 2 */
+#define RCMCLIENT_RECV_TIMEOUT        100000   /*!< Shutdown poll, usec     */
+#define RCMCLIENT_RECV_BACKOFF         10000   /*!< Delay after a get error */
 
 /* =============================================================================
  * Structures & Enums
@@ -83,16 +87,23 @@ extern "C" {
  */
 
 /*!
- *  @brief  RCM recipient used for managing messages from server
- *          (mailman algorithm)
+ *  @brief  RCM recipient waiting on a completion slot for its reply
  */
 typedef struct Recipient_tag {
-    List_Elem            elem;       /*!< Pointer to list of messages       */
+    List_Elem            elem;       /*!< Link in the slot's waiter list    */
     UInt16               msgId;      /*!< Msg ID received from server       */
     RcmClient_Message  * msg;        /*!< Ptr to msg received from server   */
     OsalSemaphore_Handle event;      /*!< Semaphore to unblock client task  */
 } Recipient;
 
+/*!
+ *  @brief  Completion slot, selected by the low bits of the msgId
+ */
+typedef struct RcmClient_Completion_tag {
+    List_Object          waiters;    /*!< Recipients blocked on this slot   */
+    List_Object          mail;       /*!< Replies not yet collected         */
+} RcmClient_Completion;
+
 /*!
  *  @brief RCM Client instance object structure
  */
@@ -105,10 +116,17 @@ typedef struct RcmClient_Object_tag {
     MessageQ_QueueId     serverMsgQ;  /*!< Server message queue id          */
     Bool                 cbNotify;    /*!< Callback notification            */
     UInt16               msgId;       /*!< Last used message id             */
-    OsalSemaphore_Handle mbxLock;     /*!< Mailbox lock                     */
-    OsalSemaphore_Handle queueLock;   /*!< Message queue lock               */
-    List_Handle          recipients;  /*!< List of waiting recipients       */
-    List_Handle          newMail;     /*!< List of undelivered messages     */
+    IGateProvider_Handle replyGate;   /*!< Completion table gate            */
+    RcmClient_Completion completion [RCMCLIENT_COMPLETION_LEN];
+                                      /*!< Reply slots indexed by msgId     */
+    pthread_t            recvThread;  /*!< Reply routing thread             */
+    Bool                 shutdown;    /*!< Signal receive thread to exit    */
+    List_Object          msgCache;    /*!< Free messages, guarded by gate   */
+    UInt                 cacheLength; /*!< Max # of messages in msgCache    */
+    UInt                 cacheCount;  /*!< # of messages in msgCache        */
+    UInt32               cacheMsgSize;/*!< MessageQ size of cached messages */
+    UInt32               cacheHits;   /*!< Allocs served from msgCache      */
+    UInt32               cacheMisses; /*!< Allocs sent to MessageQ_alloc    */
 } RcmClient_Object;
 
 /*!
@@ -154,6 +172,11 @@ static Int _RcmClient_getReturnMsg (RcmClient_Object      * obj,
                                     const UInt16            msgId,
                                     RcmClient_Message    ** returnMsg);
 
+/*!
+ *  @brief      Route return messages from the server to their recipients
+ */
+static Void _RcmClient_recvThrFxn (IArg arg);
+
 /*!
  *  @brief      Initialize RCM client module
  */
@@ -186,7 +209,9 @@ RcmClient_ModuleObject RcmClient_module_obj =
     .defaultCfg.defaultHeapBlockSize         = RCMCLIENT_HEAPID_ARRAY_BLOCKSIZE,
     .setupRefCount                           = 0,
     .defaultInst_params.heapId               = RCMCLIENT_DEFAULT_HEAPID,
-    .defaultInst_params.callbackNotification = false
+    .defaultInst_params.callbackNotification = false,
+    .defaultInst_params.cacheLength          = 0,
+    .defaultInst_params.cacheDataSize        = 0
 };
 
 /*
@@ -367,11 +392,12 @@ Int _RcmClient_Instance_init (RcmClient_Object        * obj,
                               String                    server,
                               const RcmClient_Params  * params)
 {
-    MessageQ_Params mqParams;
-    Int             rval;
-    UInt16          procId;
-    List_Params     listP;
-    Int             status = RcmClient_S_SUCCESS;
+    MessageQ_Params     mqParams;
+    RcmClient_Packet  * packet;
+    Int                 rval;
+    UInt16              procId;
+    UInt                i;
+    Int                 status = RcmClient_S_SUCCESS;
 
     GT_0trace (curTrace, GT_ENTER, "_RcmClient_Instance_init");
 
@@ -382,10 +408,22 @@ Int _RcmClient_Instance_init (RcmClient_Object        * obj,
     obj->serverMsgQ  = MessageQ_INVALIDMESSAGEQ;
     obj->msgQue      = NULL;
     obj->errorMsgQue = NULL;
-    obj->mbxLock     = NULL;
-    obj->queueLock   = NULL;
-    obj->recipients  = NULL;
-    obj->newMail     = NULL;
+    obj->replyGate   = NULL;
+    obj->recvThread  = 0;
+    obj->shutdown    = FALSE;
+    obj->cacheLength = 0;
+    obj->cacheCount  = 0;
+    obj->cacheHits   = 0;
+    obj->cacheMisses = 0;
+
+    /* Construct the message cache, guarded by the instance gate */
+    List_construct (&(obj->msgCache), NULL);
+
+    /* Construct the completion table, guarded by replyGate */
+    for (i = 0; i < RCMCLIENT_COMPLETION_LEN; i++) {
+        List_construct (&(obj->completion [i].waiters), NULL);
+        List_construct (&(obj->completion [i].mail), NULL);
+    }
 
     /* Create a gate instance */
     obj->gate = (IGateProvider_Handle) GateMutex_create ();
@@ -450,11 +488,12 @@ Int _RcmClient_Instance_init (RcmClient_Object        * obj,
     /* Create callback server */
     if (obj->cbNotify == true) {
         /* TODO Create callback server thread */
-        /* Make sure to free resources acquired by thread */
+        /* Make sure to free resources acquired by thread. Until then the
+         * instance is set up as a synchronous one below.
+         */
         GT_0trace (curTrace,
                    GT_4CLASS,
                    "RcmClient asynchronous transfers not supported \n");
-        goto leave;
     }
 
     /* Register the heapId used for message allocation */
@@ -480,60 +519,52 @@ Int _RcmClient_Instance_init (RcmClient_Object        * obj,
         obj->heapId = RcmClient_module->heapIdAry[procId];
     }
 
-    /* Create the mailbox lock */
-    obj->mbxLock = OsalSemaphore_create (OsalSemaphore_Type_Counting, 1);
-    GT_assert (curTrace, (obj->mbxLock != NULL));
-    if (obj->mbxLock ==  NULL) {
+    /* Create the completion table gate */
+    obj->replyGate = (IGateProvider_Handle) GateMutex_create ();
+    GT_assert (curTrace, (obj->replyGate != NULL));
+    if (obj->replyGate == NULL) {
         status = RcmClient_E_FAIL;
         GT_setFailureReason (curTrace,
                              GT_4CLASS,
                              "_RcmClient_Instance_init",
                              status,
-                             "Unable to create mbx lock");
+                             "Unable to create reply gate");
         goto leave;
     }
 
-    /* Create the message queue lock */
-    obj->queueLock = OsalSemaphore_create (OsalSemaphore_Type_Counting, 1);
-    GT_assert (curTrace, (obj->queueLock != NULL));
-    if (obj->queueLock ==  NULL) {
+    /* Create the thread which routes return messages to their recipients */
+    rval = pthread_create (&(obj->recvThread), NULL,
+                           (Void *)&_RcmClient_recvThrFxn, (Void *)obj);
+    if (rval != 0) {
+        obj->recvThread = 0;
         status = RcmClient_E_FAIL;
         GT_setFailureReason (curTrace,
                              GT_4CLASS,
                              "_RcmClient_Instance_init",
                              status,
-                             "Unable to create queue lock");
+                             "Unable to create receive thread");
         goto leave;
     }
 
-    /* Create the return message recipient list */
-    List_Params_init (&listP);
-    listP.gateHandle = obj->gate;
-    obj->recipients = List_create (&listP);
-    GT_assert (curTrace, (obj->recipients != NULL));
-    if (obj->recipients == NULL) {
-        status = RcmClient_E_LISTCREATEFAILED;
-        GT_setFailureReason (curTrace,
-                             GT_4CLASS,
-                             "_RcmClient_Instance_init",
-                             status,
-                             "Unable to create recipients list");
-        goto leave;
-    }
-
-    /* Create list of undelivered messages (new mail) */
-    List_Params_init (&listP);
-    listP.gateHandle = obj->gate;
-    obj->newMail = List_create (&listP);
-    if (obj->newMail == NULL) {
-        status = RcmClient_E_LISTCREATEFAILED;
-        GT_setFailureReason (curTrace,
-                             GT_4CLASS,
-                             "_RcmClient_Instance_init",
-                             status,
-                             "Could not create new mail list object");
-        goto leave;
+    /* Pre-allocate the message cache */
+    obj->cacheMsgSize = sizeof(RcmClient_Packet) - sizeof(UInt32)
+                + (params->cacheDataSize < sizeof(UInt32) ? sizeof(UInt32) :
+                    params->cacheDataSize);
+    for (i = 0; i < params->cacheLength; i++) {
+        packet = (RcmClient_Packet *)MessageQ_alloc (obj->heapId,
+                                                     obj->cacheMsgSize);
+        if (packet == NULL) {
+            /* Not fatal, the cache is filled again by RcmClient_free */
+            GT_1trace (curTrace,
+                       GT_2CLASS,
+                       "_RcmClient_Instance_init: message cache holds %d "
+                       "messages", obj->cacheCount);
+            break;
+        }
+        List_put (&(obj->msgCache), (List_Elem *)&(packet->msgqHeader));
+        obj->cacheCount++;
     }
+    obj->cacheLength = params->cacheLength;
 
 leave:
     GT_1trace (curTrace, GT_LEAVE, "_RcmClient_Instance_init", status);
@@ -608,33 +639,51 @@ leave:
  */
 Int _RcmClient_Instance_finalize (RcmClient_Object * obj)
 {
-    Int status = RcmClient_S_SUCCESS;
+    List_Elem * elem;
+    UInt        i;
+    Int         rval;
+    Int         status = RcmClient_S_SUCCESS;
 
     GT_1trace (curTrace, GT_ENTER, "RcmClient_instance_finalize", obj);
 
-    if (obj->newMail != NULL) {
-        while (!(List_empty(obj->newMail))) {
-            List_remove(obj->newMail, List_get(obj->newMail));
+    /* Block until the receive thread exits. The thread polls the shutdown
+     * flag every RCMCLIENT_RECV_TIMEOUT, so it is joined even if the unblock
+     * fails; the instance must not be freed while the thread still runs.
+     */
+    if (obj->recvThread != 0) {
+        obj->shutdown = TRUE;
+        rval = MessageQ_unblock (obj->msgQue);
+        if (rval < 0) {
+            status = RcmClient_E_FAIL;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmClient_Instance_finalize",
+                                 rval,
+                                 "MessageQ_unblock failed!");
         }
-        List_delete (&obj->newMail);
+        pthread_join (obj->recvThread, NULL);
+        obj->recvThread = 0;
     }
 
-    if (obj->recipients != NULL) {
-        while (!(List_empty(obj->recipients))) {
-            List_remove(obj->recipients, List_get(obj->recipients));
+    /* Return any replies that were never collected */
+    for (i = 0; i < RCMCLIENT_COMPLETION_LEN; i++) {
+        while ((elem = List_get (&(obj->completion [i].mail))) != NULL) {
+            MessageQ_free ((MessageQ_Msg)_getPacketAddrElem (elem));
         }
-        List_delete (&obj->recipients);
+        List_destruct (&(obj->completion [i].mail));
+        List_destruct (&(obj->completion [i].waiters));
     }
 
-    if (obj->queueLock != NULL) {
-        OsalSemaphore_delete (&(obj->queueLock));
-        obj->queueLock = NULL;
+    if (obj->replyGate != NULL) {
+        GateMutex_delete ((GateMutex_Handle *)&(obj->replyGate));
     }
 
-    if (obj->mbxLock != NULL) {
-        OsalSemaphore_delete (&(obj->mbxLock));
-        obj->mbxLock = NULL;
+    /* Free the cached messages */
+    while ((elem = List_get (&(obj->msgCache))) != NULL) {
+        MessageQ_free ((MessageQ_Msg)_getPacketAddrElem (elem));
     }
+    List_destruct (&(obj->msgCache));
+    obj->cacheCount = 0;
 
     if (obj->serverMsgQ != MessageQ_INVALIDMESSAGEQ) {
         MessageQ_close ((MessageQ_QueueId *)(&obj->serverMsgQ));
@@ -696,6 +745,9 @@ Int RcmClient_Params_init (RcmClient_Params * params)
         params->heapId = RcmClient_module->defaultInst_params.heapId;
         params->callbackNotification = \
                     RcmClient_module->defaultInst_params.callbackNotification;
+        params->cacheLength = RcmClient_module->defaultInst_params.cacheLength;
+        params->cacheDataSize = \
+                    RcmClient_module->defaultInst_params.cacheDataSize;
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
@@ -935,7 +987,9 @@ Int RcmClient_alloc (RcmClient_Handle       handle,
                      RcmClient_Message   ** message)
 {
     Int                 totalSize;
-    RcmClient_Packet  * packet;
+    RcmClient_Packet  * packet      = NULL;
+    List_Elem         * elem;
+    IArg                key;
     Int                 status      = RcmClient_S_SUCCESS;
 
     GT_3trace (curTrace, GT_ENTER, "RcmClient_alloc", handle, dataSize,
@@ -976,8 +1030,32 @@ Int RcmClient_alloc (RcmClient_Handle       handle,
     /* We deduct sizeof(UInt32) as "data[1]" is the start of the payload */
     totalSize = sizeof(RcmClient_Packet) - sizeof(UInt32) + dataSize;
 
+    /* Small messages come from the cache, and are allocated at the cached
+     * size on a miss so that RcmClient_free can recycle them
+     */
+    if ((handle->cacheLength > 0) && (totalSize <= handle->cacheMsgSize)) {
+        key = IGateProvider_enter (handle->gate);
+        elem = List_get (&(handle->msgCache));
+        if (elem != NULL) {
+            handle->cacheCount--;
+            handle->cacheHits++;
+        }
+        else {
+            handle->cacheMisses++;
+        }
+        IGateProvider_leave (handle->gate, key);
+
+        if (elem != NULL) {
+            packet = _getPacketAddrElem (elem);
+        }
+        totalSize = handle->cacheMsgSize;
+    }
+
     /* Allocate the message */
-    packet = (RcmClient_Packet *)MessageQ_alloc (handle->heapId, totalSize);
+    if (packet == NULL) {
+        packet = (RcmClient_Packet *)MessageQ_alloc (handle->heapId,
+                                                     totalSize);
+    }
     if (NULL == packet) {
         *message = NULL;
         status = RcmClient_E_MSGALLOCFAILED;
@@ -1625,6 +1703,8 @@ Int RcmClient_free (RcmClient_Handle handle, RcmClient_Message * msg)
 {
     Int          rval;
     MessageQ_Msg msgqMsg;
+    IArg         key;
+    Bool         cached = FALSE;
     Int          status = RcmClient_S_SUCCESS;
 
     GT_2trace (curTrace, GT_ENTER, "RcmClient_free", handle, msg);
@@ -1658,6 +1738,23 @@ Int RcmClient_free (RcmClient_Handle handle, RcmClient_Message * msg)
     }
 
     msgqMsg = (MessageQ_Msg)_RcmClient_getPacketAddr (msg);
+
+    /* Keep messages of the cached size for the next RcmClient_alloc */
+    if ((handle->cacheLength > 0)
+        && (MessageQ_getMsgSize (msgqMsg) == handle->cacheMsgSize)
+        && (msgqMsg->heapId == handle->heapId)) {
+        key = IGateProvider_enter (handle->gate);
+        if (handle->cacheCount < handle->cacheLength) {
+            List_put (&(handle->msgCache), (List_Elem *)msgqMsg);
+            handle->cacheCount++;
+            cached = TRUE;
+        }
+        IGateProvider_leave (handle->gate, key);
+    }
+    if (cached) {
+        goto leave;
+    }
+
     rval = MessageQ_free (msgqMsg);
     if (rval < 0) {
         GT_setFailureReason (curTrace,
@@ -1676,6 +1773,54 @@ leave:
 }
 
 
+/*!
+ *  @brief      Get the message cache statistics
+ *
+ *  @param      handle      Instance handle
+ *  @param      stats       Location to receive the statistics
+ *
+ *  @sa         RcmClient_alloc, RcmClient_free
+ */
+Int RcmClient_getCacheStats (RcmClient_Handle       handle,
+                             RcmClient_CacheStats * stats)
+{
+    IArg    key;
+    Int     status = RcmClient_S_SUCCESS;
+
+    GT_2trace (curTrace, GT_ENTER, "RcmClient_getCacheStats", handle, stats);
+
+    if (RcmClient_module->setupRefCount == 0) {
+        status = RcmClient_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmClient_getCacheStats",
+                             status,
+                             "Module is in an invalid state!");
+        goto leave;
+    }
+    if ((handle == NULL) || (stats == NULL)) {
+        status = RcmClient_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmClient_getCacheStats",
+                             status,
+                             "Invalid argument passed!");
+        goto leave;
+    }
+
+    key = IGateProvider_enter (handle->gate);
+    stats->hits   = handle->cacheHits;
+    stats->misses = handle->cacheMisses;
+    stats->count  = handle->cacheCount;
+    IGateProvider_leave (handle->gate, key);
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "RcmClient_getCacheStats", status);
+
+    return status;
+}
+
+
 /*!
  *  @brief      Get symbol index for given name of the function
  *
@@ -2120,18 +2265,13 @@ leave:
 
 
 /*!
- *  @brief      A thread safe algorithm for message delivery
- *              This function is called to pickup a specified return message
- *              from the server. messages are taken from the queue and either
- *              delivered to the mailbox if not the specified message or
- *              returned to the caller. The calling thread might play the role
- *              of mailman or simply wait on a list of recipients.
- *
- *              This algorithm guarantees that a waiting recipient is released
- *              as soon as his message arrives. All new mail is placed in the
- *              mailbox until the recipient arrives to collect it. The messages
- *              can arrive in any order and will be processed as they arrive.
- *              message delivery is never stalled waiting on absent recipient.
+ *  @brief      Pick up a specific return message from the server.
+ *              Replies are routed by the receive thread into the completion
+ *              slot selected by their msgId. If the reply has already
+ *              arrived it is taken from the slot's mail list, otherwise the
+ *              caller queues itself on the slot and sleeps until the receive
+ *              thread hands it the message. Only the owner of a reply is
+ *              ever woken for it.
  *
  *  @param      handle     Instance handle
  *  @param      msgId      Message expected from the RCM server
@@ -2142,15 +2282,13 @@ Int _RcmClient_getReturnMsg (RcmClient_Object     * handle,
                              const UInt16           msgId,
                              RcmClient_Message   ** returnMsg)
 {
-    List_Elem         * elem;
-    Recipient         * recipient;
-    RcmClient_Packet  * packet;
-    Bool                messageDelivered;
-    MessageQ_Msg        msgqMsg             = NULL;
-    Bool                messageFound        = FALSE;
-    Int                 queueLockAcquired   = 0;
-    Int                 rval;
-    Int                 status              = RcmClient_S_SUCCESS;
+    List_Elem            * elem;
+    RcmClient_Packet     * packet;
+    RcmClient_Completion * slot;
+    Recipient              self;
+    IArg                   key;
+    Int                    rval;
+    Int                    status              = RcmClient_S_SUCCESS;
 
     GT_3trace (curTrace, GT_ENTER, "_RcmClient_getReturnMsg", handle, msgId,
                 returnMsg);
@@ -2176,354 +2314,186 @@ Int _RcmClient_getReturnMsg (RcmClient_Object     * handle,
 
     *returnMsg = NULL;
 
-    /* Keep trying until message found */
-    while (!messageFound) {
+    if (handle->recvThread == 0) {
+        status = RcmClient_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmClient_getReturnMsg",
+                             status,
+                             "No receive thread for return messages");
+        goto leave;
+    }
 
-        /* Acquire the mailbox lock */
-        rval = OsalSemaphore_pend (handle->mbxLock, OSALSEMAPHORE_WAIT_FOREVER);
-        if (rval < 0) {
+    slot = &(handle->completion [msgId & (RCMCLIENT_COMPLETION_LEN - 1)]);
+
+    key = IGateProvider_enter (handle->replyGate);
+
+    /* Check if the reply has already been delivered */
+    elem = NULL;
+    while ((elem = List_next ((List_Handle)&(slot->mail), elem)) != NULL) {
+        packet = _getPacketAddrElem (elem);
+        if (msgId == packet->msgId) {
+            List_remove ((List_Handle)&(slot->mail), elem);
+            *returnMsg = &packet->message;
+            break;
+        }
+    }
+
+    if (*returnMsg != NULL) {
+        IGateProvider_leave (handle->replyGate, key);
+        goto leave;
+    }
+
+    /* Construct recipient on local stack and wait on the slot */
+    self.msgId = msgId;
+    self.msg = NULL;
+    self.event = OsalSemaphore_create (OsalSemaphore_Type_Counting, 0);
+    if (self.event ==  NULL) {
+        IGateProvider_leave (handle->replyGate, key);
+        status = RcmClient_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmClient_getReturnMsg",
+                             status,
+                             "Thread event construct fails");
+        goto leave;
+    }
+    List_put ((List_Handle)&(slot->waiters), &(self.elem));
+
+    IGateProvider_leave (handle->replyGate, key);
+
+    /* The receive thread unlinks us before posting the event */
+    rval = OsalSemaphore_pend (self.event, OSALSEMAPHORE_WAIT_FOREVER);
+    if (rval < 0) {
+        key = IGateProvider_enter (handle->replyGate);
+        if (self.msg == NULL) {
+            List_remove ((List_Handle)&(slot->waiters), &(self.elem));
+        }
+        IGateProvider_leave (handle->replyGate, key);
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmClient_getReturnMsg",
+                             rval,
+                             "Thread event pend fails");
+        status = RcmClient_E_FAIL;
+    }
+
+    if (self.msg != NULL) {
+        *returnMsg = self.msg;
+    }
+    else if (status >= 0) {
+        /* Woken without a message, the instance is shutting down */
+        status = RcmClient_E_LOSTMSG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmClient_getReturnMsg",
+                             status,
+                             "Receive thread terminated");
+    }
+
+#ifdef HAVE_ANDROID_OS
+    /* Android bionic Semdelete code returns -1 if count == 0 */
+    OsalSemaphore_post (self.event);
+#endif /* ifdef HAVE_ANDROID_OS */
+    rval = OsalSemaphore_delete (&(self.event));
+    if (rval < 0) {
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmClient_getReturnMsg",
+                             rval,
+                             "Thread event delete failed");
+        status = RcmClient_E_FAIL;
+    }
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "_RcmClient_getReturnMsg", status);
+
+    return status;
+}
+
+
+/*!
+ *  @brief      Receive thread, routes each return message to the recipient
+ *              waiting on its completion slot or parks it in the slot's
+ *              mail list until the recipient arrives.
+ *
+ *  @param      arg        Instance handle
+ */
+static
+Void _RcmClient_recvThrFxn (IArg arg)
+{
+    RcmClient_Object     * obj      = (RcmClient_Object *)arg;
+    RcmClient_Completion * slot;
+    RcmClient_Packet     * packet;
+    Recipient            * recipient;
+    List_Elem            * elem;
+    MessageQ_Msg           msgqMsg;
+    IArg                   key;
+    UInt                   i;
+    Int                    rval;
+
+    GT_1trace (curTrace, GT_ENTER, "_RcmClient_recvThrFxn", arg);
+
+    while (!obj->shutdown) {
+        msgqMsg = NULL;
+        rval = MessageQ_get (obj->msgQue, &msgqMsg, RCMCLIENT_RECV_TIMEOUT);
+        if (    (rval < 0)
+            &&  (rval != MessageQ_E_UNBLOCKED)
+            &&  (rval != MessageQ_E_TIMEOUT)) {
             GT_setFailureReason (curTrace,
                                  GT_4CLASS,
-                                 "_RcmClient_getReturnMsg",
+                                 "_RcmClient_recvThrFxn",
                                  rval,
-                                 "handle->mbxLock pend failed");
-            status = RcmClient_E_FAIL;
-            goto leave;
+                                 "MessageQ get failed");
+            /* Back off instead of spinning on a persistent error */
+            usleep (RCMCLIENT_RECV_BACKOFF);
         }
+        if (msgqMsg == NULL) {
+            continue;
+        }
+
+        packet = _getPacketAddrMsgqMsg (msgqMsg);
+        slot = &(obj->completion [packet->msgId &
+                                  (RCMCLIENT_COMPLETION_LEN - 1)]);
+
+        key = IGateProvider_enter (obj->replyGate);
 
-        /* Search new mail list for message */
+        /* Hand the message to its recipient if already waiting */
+        recipient = NULL;
         elem = NULL;
-        while ((elem = List_next (handle->newMail, elem)) != NULL) {
-            packet = _getPacketAddrElem (elem);
-            if (msgId == packet->msgId) {
-                List_remove (handle->newMail, elem);
-                *returnMsg = &packet->message;
-                messageFound = TRUE;
+        while ((elem = List_next ((List_Handle)&(slot->waiters), elem))
+                != NULL) {
+            if (((Recipient *)elem)->msgId == packet->msgId) {
+                recipient = (Recipient *)elem;
                 break;
             }
         }
 
-        if (messageFound) {
-            /* Release the mailbox lock */
-            rval = OsalSemaphore_post (handle->mbxLock);
-            if (rval < 0) {
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmClient_getReturnMsg",
-                                     rval,
-                                     "handle->mbxLock post failed");
-                status = RcmClient_E_FAIL;
-                goto leave;
-            }
+        if (recipient != NULL) {
+            List_remove ((List_Handle)&(slot->waiters), &(recipient->elem));
+            recipient->msg = &packet->message;
+            OsalSemaphore_post (recipient->event);
         }
         else {
-            /* Attempt the message queue lock */
-            queueLockAcquired = OsalSemaphore_pend (handle->queueLock,
-                                        OSALSEMAPHORE_WAIT_NONE);
-            if ((queueLockAcquired < 0) &&
-                (queueLockAcquired != OSALSEMAPHORE_E_WAITNONE)) {
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmClient_getReturnMsg",
-                                     status,
-                                     "handle->queueLock failed");
-                status = RcmClient_E_FAIL;
-                goto leave;
-            }
-
-            if (! (queueLockAcquired < 0)) {
-                /*
-                 * MailMan role
-                 */
-
-                /* Deliver new mail until message found */
-                while (!messageFound) {
-                    /* Get message from queue if available (non-blocking) */
-                    if (NULL == msgqMsg) {
-                        rval = MessageQ_get (handle->msgQue, &msgqMsg,
-                                                WAIT_NONE);
-                        if ((rval != MessageQ_E_TIMEOUT) && (rval < 0)) {
-                            GT_setFailureReason (curTrace,
-                                                 GT_4CLASS,
-                                                 "_RcmClient_getReturnMsg",
-                                                 rval,
-                                                 "handle->MessageQ get failed");
-                            status = RcmClient_E_LOSTMSG;
-                            goto leave;
-                        }
-                    }
-
-                    while (NULL != msgqMsg) {
-                        /* Check if message found */
-                        packet = _getPacketAddrMsgqMsg (msgqMsg);
-                        messageFound = (msgId == packet->msgId);
-                        if (messageFound) {
-                            *returnMsg = &packet->message;
-
-                            /* Search wait list for new mailman */
-                            elem = NULL;
-                            while ((elem =
-                                List_next (handle->recipients, elem)) != NULL) {
-                                recipient = (Recipient *)elem;
-                                if (NULL == recipient->msg) {
-                                    rval = OsalSemaphore_post(recipient->event);
-                                    if (rval < 0) {
-                                        GT_setFailureReason (curTrace,
-                                                             GT_4CLASS,
-                                                             "RcmClient_"
-                                                             "getReturnMsg",
-                                                             rval,
-                                                             "recipient->event "
-                                                             "post failed");
-                                        status = RcmClient_E_FAIL;
-                                        goto leave;
-                                    }
-                                    break;
-                                }
-                            }
-
-                            /* Release the message queue lock */
-                            rval = OsalSemaphore_post (handle->queueLock);
-                            if (rval < 0) {
-                                GT_setFailureReason (curTrace,
-                                                     GT_4CLASS,
-                                                     "_RcmClient_getReturnMsg",
-                                                     rval,
-                                                     "handle->queueLock post "
-                                                     "failed");
-                                status = RcmClient_E_FAIL;
-                                goto leave;
-                            }
-
-                            /* Release the mailbox lock */
-                            rval = OsalSemaphore_post (handle->mbxLock);
-                            if (rval < 0) {
-                                GT_setFailureReason (curTrace,
-                                                     GT_4CLASS,
-                                                     "_RcmClient_getReturnMsg",
-                                                     rval,
-                                                     "handle->mbxLock post "
-                                                     "failed");
-                                status = RcmClient_E_FAIL;
-                                goto leave;
-                            }
-                            break;
-                        }
-                        else {
-                            /*
-                             * Deliver message to mailbox
-                             */
-
-                            /* Search recipient list for message owner */
-                            elem = NULL;
-                            messageDelivered = FALSE;
-                            while ((elem =
-                                List_next (handle->recipients, elem)) != NULL) {
-                                recipient = (Recipient *)elem;
-                                if (recipient->msgId == packet->msgId) {
-                                    recipient->msg = &packet->message;
-                                    rval = OsalSemaphore_post(recipient->event);
-                                    if (rval < 0) {
-                                        GT_setFailureReason (curTrace,
-                                                             GT_4CLASS,
-                                                             "RcmClient_"
-                                                             "getReturnMsg",
-                                                             rval,
-                                                             "recipient->event "
-                                                             "post failed");
-                                        status = RcmClient_E_FAIL;
-                                        goto leave;
-                                    }
-                                    messageDelivered = TRUE;
-                                    break;
-                                }
-                            }
-
-                            /* Add undelivered message to new mail list */
-                            if (!messageDelivered) {
-                                /* Use the elem in the MessageQ hdr */
-                                elem = (List_Elem *)&packet->msgqHeader;
-                                List_put (handle->newMail, elem);
-                            }
-                        }
-
-                        /* Get next message from queue if available */
-                        rval = MessageQ_get (handle->msgQue, &msgqMsg,
-                                                WAIT_NONE);
-                        if ((rval != MessageQ_E_TIMEOUT) && (rval < 0)) {
-                            GT_setFailureReason (curTrace,
-                                                 GT_4CLASS,
-                                                 "_RcmClient_getReturnMsg",
-                                                 rval,
-                                                 "handle->MessageQ get failed");
-                            status = RcmClient_E_LOSTMSG;
-                            goto leave;
-                        }
-                    }
-
-                    if (!messageFound) {
-                        /*
-                         * Message queue empty
-                         */
-
-                        /* Release the mailbox lock */
-                        rval = OsalSemaphore_post (handle->mbxLock);
-                        if (rval < 0) {
-                            GT_setFailureReason (curTrace,
-                                                 GT_4CLASS,
-                                                 "_RcmClient_getReturnMsg",
-                                                 rval,
-                                                 "uhandle->mbxLock post failed");
-                            status = RcmClient_E_FAIL;
-                            goto leave;
-                        }
-
-                        /* Get next message, this blocks the thread */
-                        rval = MessageQ_get (handle->msgQue, &msgqMsg,
-                                                MessageQ_FOREVER);
-                        if (rval < 0) {
-                            GT_setFailureReason (curTrace,
-                                                 GT_4CLASS,
-                                                 "_RcmClient_getReturnMsg",
-                                                 rval,
-                                                 "handle->MessageQ get failed");
-                            status = RcmClient_E_LOSTMSG;
-                            goto leave;
-                        }
-
-                        if (msgqMsg == NULL) {
-                            GT_setFailureReason (curTrace,
-                                                 GT_4CLASS,
-                                                 "_RcmClient_getReturnMsg",
-                                                 rval,
-                                                 "Message received is NULL");
-                            status = RcmClient_E_LOSTMSG;
-                            goto leave;
-                        }
-
-                        /* Acquire the mailbox lock */
-                        rval = OsalSemaphore_pend (handle->mbxLock,
-                                                   OSALSEMAPHORE_WAIT_FOREVER);
-                        if (rval < 0) {
-                            GT_setFailureReason (curTrace,
-                                                GT_4CLASS,
-                                                "_RcmClient_getReturnMsg",
-                                                rval,
-                                                "handle->queueLock fails");
-                            status = RcmClient_E_FAIL;
-                        }
-                    }
-                }
-            }
-            else {
-                /* Construct recipient on local stack */
-                Recipient self;
-                self.msgId = msgId;
-                self.msg = NULL;
-                self.event = OsalSemaphore_create (OsalSemaphore_Type_Counting,
-                                    0);
-                if (self.event ==  NULL) {
-                    GT_setFailureReason (curTrace,
-                                         GT_4CLASS,
-                                         "_RcmClient_getReturnMsg",
-                                         RcmClient_E_FAIL,
-                                         "Thread event construct fails");
-                    status = RcmClient_E_FAIL;
-                    goto leave;
-                }
-
-                /* Add recipient to wait list */
-                elem = &self.elem;
-                List_put (handle->recipients, elem);
-
-                /* Release the mailbox lock */
-                rval = OsalSemaphore_post (handle->mbxLock);
-                if (rval < 0) {
-                    GT_setFailureReason (curTrace,
-                                         GT_4CLASS,
-                                         "_RcmClient_getReturnMsg",
-                                         rval,
-                                         "handle->mbxLock post fails");
-                    status = RcmClient_E_FAIL;
-                    goto leave;
-                }
-
-                /* Wait on event */
-                rval = OsalSemaphore_pend (self.event,
-                                            OSALSEMAPHORE_WAIT_FOREVER);
-                if (rval < 0) {
-                    GT_setFailureReason (curTrace,
-                                         GT_4CLASS,
-                                         "_RcmClient_getReturnMsg",
-                                         rval,
-                                         "Thread event pend fails");
-                    status = RcmClient_E_FAIL;
-                    goto leave;
-                }
-
-                /* Acquire the mailbox lock */
-                rval = OsalSemaphore_pend (handle->mbxLock,
-                                            OSALSEMAPHORE_WAIT_FOREVER);
-                if (rval < 0) {
-                    GT_setFailureReason (curTrace,
-                                         GT_4CLASS,
-                                         "_RcmClient_getReturnMsg",
-                                         rval,
-                                         "handle->mbxLock pend fails");
-                    status = RcmClient_E_FAIL;
-                    goto leave;
-                }
-
-                if (NULL != self.msg) {
-                    /* Pickup message */
-                    *returnMsg = self.msg;
-                    messageFound = TRUE;
-                }
-
-                /* Remove recipient from wait list */
-                List_remove (handle->recipients, elem);
-#ifdef HAVE_ANDROID_OS
-                /* Android bionic Semdelete code returns -1 if count == 0 */
-                rval = OsalSemaphore_post (self.event);
-                if (rval < 0) {
-                    GT_setFailureReason (curTrace,
-                                         GT_4CLASS,
-                                         "_RcmClient_getReturnMsg",
-                                         rval,
-                                         "self.event post fails");
-                    status = RcmClient_E_FAIL;
-                    goto leave;
-                }
-#endif /* ifdef HAVE_ANDROID_OS */
-                rval = OsalSemaphore_delete (&(self.event));
-                if (rval < 0){
-                    GT_setFailureReason (curTrace,
-                                         GT_4CLASS,
-                                         "_RcmClient_getReturnMsg",
-                                         rval,
-                                         "Thread event delete failed");
-                    status = RcmClient_E_FAIL;
-                    goto leave;
-                }
-
-                /* Release the mailbox lock */
-                rval = OsalSemaphore_post (handle->mbxLock);
-                if (rval < 0){
-                    GT_setFailureReason (curTrace,
-                                         GT_4CLASS,
-                                         "_RcmClient_getReturnMsg",
-                                         rval,
-                                         "handle->mbxLock post fails");
-                    status = RcmClient_E_FAIL;
-                }
-            }
+            /* Use the elem in the MessageQ hdr */
+            List_put ((List_Handle)&(slot->mail),
+                      (List_Elem *)&packet->msgqHeader);
         }
-    } /* while (!messageFound) */
 
-leave:
-    GT_1trace (curTrace, GT_LEAVE, "_RcmClient_getReturnMsg", status);
+        IGateProvider_leave (obj->replyGate, key);
+    }
 
-    return status;
+    /* Release any recipients still waiting, they get no message */
+    key = IGateProvider_enter (obj->replyGate);
+    for (i = 0; i < RCMCLIENT_COMPLETION_LEN; i++) {
+        while ((elem = List_get ((List_Handle)&(obj->completion [i].waiters)))
+                != NULL) {
+            OsalSemaphore_post (((Recipient *)elem)->event);
+        }
+    }
+    IGateProvider_leave (obj->replyGate, key);
+
+    GT_0trace (curTrace, GT_LEAVE, "_RcmClient_recvThrFxn");
 }
 
 
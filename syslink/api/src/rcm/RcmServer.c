@@ -47,6 +47,7 @@
 #include <host_os.h>
 #include <pthread.h>
 #include <sched.h>
+#include <time.h>
 
 /* Utility and IPC headers */
 #include <Std.h>
@@ -74,6 +75,9 @@ extern "C" {
  */
 #define RCMSERVER_MAX_TABLES        8
 #define RCMSERVER_POOL_MAP_LEN      4
+#define RCMSERVER_SYMHASH_LEN       128         /* Power of two */
+#define RCMSERVER_DYNPOOL_LEN(i)    (4 << (i))  /* Dynamic pool table i */
+#define RCMSERVER_DYNPOOL_KEYMAX    0xFF        /* Dynamic pool key range */
 #define WAIT_FOREVER                0xFFFFFFFF
 #define WAIT_NONE                   0x0
 #define MAX_NAME_LEN                32
@@ -98,6 +102,9 @@ typedef struct RcmServer_FxnTabElem_tag {
     String                      name;
     RcmServer_MsgFxn            addr;
     UInt16                      key;
+    UInt32                      hash;       /* Hash of name */
+    UInt32                      fxnBase;    /* fxnIdx without the key bits */
+    struct RcmServer_FxnTabElem_tag * hashNext; /* Next on hash chain */
 } RcmServer_FxnTabElem;
 
 /* Array of RcmServer_FxnTabElems */
@@ -106,7 +113,18 @@ typedef struct RcmServer_FxnTabElemAry_tag {
     RcmServer_FxnTabElem *      elem;
 } RcmServer_FxnTabElemAry;
 
-/* RcmServer worker thread pool object */
+/* RcmServer worker thread pool object
+ *
+ * Each worker owns its ready queue. Messages are dispatched to one worker
+ * (an idle one if possible) and a worker whose queue is empty steals from
+ * the tail of a sibling's queue before going to sleep.
+ *
+ * A pool with maxCount above count scales itself: a worker is added when
+ * no worker is idle and the chosen ready queue has not made progress for
+ * growLatency ms, and workers above count which have been idle for
+ * idleTimeout ms are retired. Retired worker objects stay in workerAry
+ * (so lock-free readers never see them freed) and are reused on growth.
+ */
 typedef struct RcmServer_ThreadPool_tag {
     String                      name;       /* Pool name */
     Int                         count;      /* Thread count (at create time) */
@@ -114,10 +132,19 @@ typedef struct RcmServer_ThreadPool_tag {
     Int                         osPriority; /* OS-specific thread priority */
     SizeT                       stackSize;  /* Thread stack size */
     String                      stackSeg;   /* Thread stack placement */
-    OsalSemaphore_Handle        sem;        /* Message semaphore (counting) */
     List_Object                 threadList; /* List of worker threads */
-    List_Object                 readyQueue; /* Queue of messages */
-    IGateProvider_Handle        readyQueueGate; /* message queue list gate */
+    struct RcmServer_WorkerThread_tag ** workerAry; /* Workers by index */
+    Int                         maxWorkers; /* Length of workerAry */
+    Int                         numWorkers; /* Entries used in workerAry */
+    Int                         numActive;  /* Workers not retired */
+    UInt                        nextWorker; /* Round-robin dispatch cursor */
+    Int                         maxCount;   /* Upper thread count bound */
+    UInt32                      growLatency; /* Queue stall (ms) to grow */
+    UInt32                      idleTimeout; /* Idle time (ms) to shrink */
+    IGateProvider_Handle        scaleGate;  /* Serializes grow and shrink */
+    UInt16                      key;        /* Dynamic pool id key */
+    Bool                        inUse;      /* Dynamic pool entry in use */
+    struct RcmServer_Object_tag * server;   /* Server instance */
 } RcmServer_ThreadPool;
 
 /* RCM Server instance object structure */
@@ -129,6 +156,9 @@ typedef struct RcmServer_Object_tag {
     RcmServer_FxnTabElemAry  fxnTabStatic; /* Static function table */
     RcmServer_FxnTabElem *   fxnTab [RCMSERVER_MAX_TABLES];
                                            /* Function table base pointers */
+    RcmServer_FxnTabElem *   symHash [RCMSERVER_SYMHASH_LEN];
+                                           /* Name index into fxnTab */
+    IGateProvider_Handle     fxnTabGate;   /* Function table gate */
     UInt16                   key;          /* Function index key */
     UInt16                   jobId;        /* Job id tracker */
     Bool                     shutdown;     /* Signal shutdown by application */
@@ -136,16 +166,31 @@ typedef struct RcmServer_Object_tag {
     RcmServer_ThreadPool *   poolMap [RCMSERVER_POOL_MAP_LEN];
     List_Handle              jobList;      /* List of job stream queues */
     IGateProvider_Handle     jobListGate;  /* Job stream queue gate */
+    IGateProvider_Handle     poolGate;     /* Dynamic pool table gate */
+    UInt16                   poolKey;      /* Dynamic pool id key */
 } RcmServer_Object;
 
 /* RCM Worker Thread object structure */
-typedef struct {
+typedef struct RcmServer_WorkerThread_tag {
     List_Elem                   elem;
     UInt16                      jobId;      /* Current job stream id */
     pthread_t                   thread;     /* Server thread object */
     Bool                        terminate;  /* Thread terminate flag */
     RcmServer_ThreadPool *      pool;       /* Worker pool */
     RcmServer_Object *          server;     /* Server instance */
+    Int                         index;      /* Position in pool->workerAry */
+    OsalSemaphore_Handle        sem;        /* Run semaphore (counting) */
+    List_Object                 readyQueue; /* Queue of messages */
+    IGateProvider_Handle        readyQueueGate; /* message queue list gate */
+    UInt                        depth;      /* Messages on readyQueue */
+    Bool                        idle;       /* Waiting on sem */
+    Bool                        retired;    /* Removed by pool shrinking */
+    UInt32                      progress;   /* Time (ms) queue last moved */
+    UInt32                      idleSince;  /* Time (ms) worker went idle */
+    UInt32                      processed;  /* Messages executed */
+    UInt32                      steals;     /* Messages taken from siblings */
+    UInt32                      idleMs;     /* Time spent waiting on sem */
+    UInt32                      idleUs;     /* Sub-millisecond idle remainder */
 } RcmServer_WorkerThread;
 
 /* RCM Job Stream object structure */
@@ -191,6 +236,14 @@ static Int _RcmServer_getFxnAddr (RcmServer_Object    * obj,
 
 static UInt16 _RcmServer_getNextKey (RcmServer_Object * obj);
 
+static UInt32 _RcmServer_hashName (String name);
+
+static Void _RcmServer_symHashInsert (RcmServer_Object       * obj,
+                                      RcmServer_FxnTabElem   * slot);
+
+static Void _RcmServer_symHashRemove (RcmServer_Object       * obj,
+                                      RcmServer_FxnTabElem   * slot);
+
 static Int _RcmServer_getSymIdx (RcmServer_Object * obj,
                                  String             name,
                                  UInt32           * index);
@@ -199,6 +252,33 @@ static Int _RcmServer_getPool (RcmServer_Object       * obj,
                                RcmClient_Packet       * packet,
                                RcmServer_ThreadPool  ** poolP);
 
+static Int _RcmServer_lookupPool (RcmServer_Object       * obj,
+                                  UInt16                   poolId,
+                                  RcmServer_ThreadPool  ** poolP);
+
+static Int _RcmServer_enqueue (RcmServer_ThreadPool   * pool,
+                               RcmServer_WorkerThread * self,
+                               RcmClient_Packet       * packet);
+
+static Int _RcmServer_submit (RcmServer_Object       * obj,
+                              RcmClient_Packet       * packet,
+                              RcmServer_WorkerThread * self);
+
+static Int _RcmServer_initPool (RcmServer_Object               * obj,
+                                RcmServer_ThreadPool           * pool,
+                                const RcmServer_ThreadPoolDesc * desc);
+
+static Int _RcmServer_finalizePool (RcmServer_ThreadPool * pool);
+
+static Int _RcmServer_addWorker (RcmServer_ThreadPool     * pool,
+                                 RcmServer_WorkerThread  ** workerP);
+
+static Void _RcmServer_reapIdle (RcmServer_ThreadPool * pool);
+
+static UInt32 _RcmServer_nowMs (Void);
+
+static RcmClient_Packet * _RcmServer_takeMsg (RcmServer_WorkerThread * obj);
+
 static Void _RcmServer_process (RcmServer_Object  * obj,
                                 RcmClient_Packet  * packet);
 
@@ -359,6 +439,9 @@ RcmServer_Params_init (RcmServer_Params * params)
         params->defaultPool.osPriority = RCMSERVER_INVALID_OS_PRIORITY;
         params->defaultPool.stackSize = 0;  /* use system default */
         params->defaultPool.stackSeg = "";
+        params->defaultPool.maxCount = 0;      /* fixed size pool */
+        params->defaultPool.growLatency = 0;
+        params->defaultPool.idleTimeout = 0;
 
         /* Worker pools */
         params->workerPools.length = 0;
@@ -482,15 +565,10 @@ _RcmServer_Instance_init (RcmServer_Object        * obj,
 {
     List_Params                 listP;
     MessageQ_Params             mqParams;
-    pthread_attr_t              threadP;
-    struct sched_param          schedParam;
     Int                         i;
-    Int                         j;
     SizeT                       size;
     Char                      * cp;
     RcmServer_ThreadPool      * poolAry;
-    RcmServer_WorkerThread    * worker;
-    List_Handle                 listH;
     Int                         status      = RcmServer_S_SUCCESS;
 
     GT_3trace (curTrace, GT_ENTER, "_RcmServer_Instance_init", obj, name,
@@ -512,6 +590,15 @@ _RcmServer_Instance_init (RcmServer_Object        * obj,
     for (i = 0; i < RcmServer_module->defaultCfg.maxTables; i++) {
         obj->fxnTab [i] = NULL;
     }
+    for (i = 0; i < RCMSERVER_SYMHASH_LEN; i++) {
+        obj->symHash [i] = NULL;
+    }
+    obj->fxnTabGate = NULL;
+    for (i = 0; i < RCMSERVER_POOL_MAP_LEN; i++) {
+        obj->poolMap [i] = NULL;
+    }
+    obj->poolGate = NULL;
+    obj->poolKey = 0;
 
     /* Initialize the worker pool map */
     for (i = 0; i < RcmServer_module->defaultCfg.poolMapLen; i++) {
@@ -531,6 +618,32 @@ _RcmServer_Instance_init (RcmServer_Object        * obj,
         goto leave;
     }
 
+    /* Create the function table gate */
+    obj->fxnTabGate = (IGateProvider_Handle) GateMutex_create ();
+    GT_assert (curTrace, (obj->fxnTabGate != NULL));
+    if (obj->fxnTabGate == NULL) {
+        status = RcmServer_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmServer_Instance_init",
+                             status,
+                             "Unable to create mutex!");
+        goto leave;
+    }
+
+    /* Create the dynamic pool table gate */
+    obj->poolGate = (IGateProvider_Handle) GateMutex_create ();
+    GT_assert (curTrace, (obj->poolGate != NULL));
+    if (obj->poolGate == NULL) {
+        status = RcmServer_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmServer_Instance_init",
+                             status,
+                             "Unable to create mutex!");
+        goto leave;
+    }
+
     /* Create list for job objects */
     List_Params_init (&listP);
     obj->jobListGate = (IGateProvider_Handle) GateMutex_create ();
@@ -601,6 +714,8 @@ _RcmServer_Instance_init (RcmServer_Object        * obj,
             cp += (String_len (params->fxns.elem [i].name) + 1);
             obj->fxnTabStatic.elem [i].addr = params->fxns.elem [i].addr;
             obj->fxnTabStatic.elem [i].key = 0;
+            obj->fxnTabStatic.elem [i].fxnBase = 0x80000000 | i;
+            _RcmServer_symHashInsert (obj, &(obj->fxnTabStatic.elem [i]));
         }
 
         /* Hook up the static function table */
@@ -671,38 +786,8 @@ _RcmServer_Instance_init (RcmServer_Object        * obj,
         *cp++ = '\0';
     }
 
-    poolAry [0].count      = params->defaultPool.count;
-    poolAry [0].priority   = params->defaultPool.priority;
-    poolAry [0].osPriority = params->defaultPool.osPriority;
-    poolAry [0].stackSize  = params->defaultPool.stackSize;
-    poolAry [0].stackSeg   = NULL;   /* TODO */
-    poolAry [0].sem        = NULL;
-
-    /* ThreadList is static, no gate protection required */
-    List_construct (&(poolAry [0].threadList), NULL);
-
-    poolAry [0].readyQueueGate = (IGateProvider_Handle) GateMutex_create ();
-    GT_assert (curTrace, (poolAry [0].readyQueueGate != NULL));
-    if (poolAry [0].readyQueueGate == NULL) {
-        status = RcmServer_E_FAIL;
-        GT_setFailureReason (curTrace,
-                             GT_4CLASS,
-                             "_RcmServer_Instance_init",
-                             status,
-                             "Unable to create mutex!");
-        goto leave;
-    }
-    listP.gateHandle = poolAry [0].readyQueueGate;
-    List_construct (&(poolAry [0].readyQueue), &listP);
-
-    poolAry [0].sem = OsalSemaphore_create (OsalSemaphore_Type_Counting, 0);
-    if (poolAry [0].sem ==  NULL) {
-        status = RcmServer_E_FAIL;
-        GT_setFailureReason (curTrace,
-                             GT_4CLASS,
-                             "_RcmServer_Instance_init",
-                             status,
-                             "Unable to create semaphore for default pool!");
+    status = _RcmServer_initPool (obj, &(poolAry [0]), &params->defaultPool);
+    if (status < 0) {
         goto leave;
     }
 
@@ -717,99 +802,13 @@ _RcmServer_Instance_init (RcmServer_Object        * obj,
             poolAry [i+1].name = NULL;
         }
 
-        poolAry [i+1].count      = params->workerPools.elem [i].count;
-        poolAry [i+1].priority   = params->workerPools.elem [i].priority;
-        poolAry [i+1].osPriority = params->workerPools.elem [i].osPriority;
-        poolAry [i+1].stackSize  = params->workerPools.elem [i].stackSize;
-        poolAry [i+1].stackSeg   = NULL;  /* TODO */
-
-        /* ThreadList is static, no gate protection required */
-        List_construct (&(poolAry [i+1].threadList), NULL);
-
-        poolAry [i+1].readyQueueGate =
-                    (IGateProvider_Handle) GateMutex_create ();
-        GT_assert (curTrace, (poolAry [i+1].readyQueueGate != NULL));
-        if (poolAry [0].readyQueueGate == NULL) {
-            status = RcmServer_E_FAIL;
-            GT_setFailureReason (curTrace,
-                             GT_4CLASS,
-                             "_RcmServer_Instance_init",
-                             status,
-                             "Unable to create mutex!");
-            goto leave;
-        }
-        listP.gateHandle = poolAry [i+1].readyQueueGate;
-        List_construct (&(poolAry [i+1].readyQueue), &listP);
-
-        /* Create the run synchronizer */
-        poolAry [i+1].sem  = OsalSemaphore_create (OsalSemaphore_Type_Counting,
-                                                    0);
-        if (poolAry [i+1].sem == NULL) {
-            status = RcmServer_E_FAIL;
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "_RcmServer_Instance_init",
-                                 status,
-                                 "Unable to create sync for RCM pool threads!");
+        status = _RcmServer_initPool (obj, &(poolAry [i+1]),
+                                      &(params->workerPools.elem [i]));
+        if (status < 0) {
             goto leave;
         }
     }
 
-    /* Create the worker threads in each static pool */
-    for (i = 0; i < obj->poolMap0Len; i++) {
-        for (j = 0; j < poolAry [i].count; j++) {
-            /* Allocate worker thread object */
-            size = sizeof (RcmServer_WorkerThread);
-            worker = Memory_calloc (RcmServer_Module_heap(), size,
-                                        sizeof (Ptr));
-            if (worker == NULL) {
-                status = RcmServer_E_NOMEMORY;
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmServer_Instance_init",
-                                     status,
-                                     "Memory allocation failed for worker "
-                                     "thread!");
-                goto leave;
-            }
-
-            /* Initialize worker thread object */
-            worker->jobId     = RcmClient_DISCRETEJOBID;
-            worker->thread    = 0;
-            worker->terminate = FALSE;
-            worker->pool      = &(poolAry [i]);
-            worker->server    = obj;
-
-            /* add worker thread to worker pool */
-            listH = &(poolAry [i].threadList);
-            List_putHead (listH, &(worker->elem));
-
-            /* Create worker thread */
-            pthread_attr_init (&threadP);
-            pthread_attr_getschedparam (&threadP, &schedParam);
-            if (poolAry [i].priority > 0) {
-                schedParam.sched_priority += 1;
-            }
-            else if (poolAry [i].priority < 0) {
-                schedParam.sched_priority -= 1;
-            }
-            pthread_attr_setschedparam (&threadP, &schedParam);
-
-            status = pthread_create (&(worker->thread), &threadP,
-                                     (Void *) &_RcmServer_workerThrFxn,
-                                     (Void *) worker);
-            if (status < 0) {
-                status = RcmServer_E_FAIL;
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmServer_Instance_init",
-                                     status,
-                                     "Could not create worker thread!");
-                goto leave;
-            }
-        }
-    }
-
     /* Create the semaphore used to release the server thread */
     obj->run = OsalSemaphore_create (OsalSemaphore_Type_Binary, 0);
     if (obj->run == NULL) {
@@ -917,9 +916,7 @@ _RcmServer_Instance_finalize (RcmServer_Object * obj)
     UInt                        tabCount;
     RcmServer_FxnTabElem      * fdp;
     RcmServer_ThreadPool      * poolAry;
-    RcmServer_WorkerThread    * worker;
     List_Elem                 * elem;
-    List_Handle                 listH;
     List_Handle                 msgQueH;
     RcmClient_Packet          * packet;
     MessageQ_Msg                msgqMsg;
@@ -1002,113 +999,9 @@ _RcmServer_Instance_finalize (RcmServer_Object * obj)
     poolAry = obj->poolMap [0];
 
     /* Free all the static pool resources */
-    for (i = 0; i < obj->poolMap0Len; i++) {
-
-        /* Free all the worker thread objects */
-        listH = &(poolAry [i].threadList);
-
-        /* Mark each worker thread for termination */
-        elem = NULL;
-        while ((elem = List_next (listH, elem)) != NULL) {
-            worker = (RcmServer_WorkerThread *)elem;
-            worker->terminate = TRUE;
-        }
-
-        /* Unblock each worker thread so it can terminate */
-        elem = NULL;
-        while ((elem = List_next (listH, elem)) != NULL) {
-            status = OsalSemaphore_post (poolAry [i].sem);
-            if (status != OSALSEMAPHORE_SUCCESS) {
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmServer_Instance_finalize",
-                                     status,
-                                     "Sem post failed for worker pool!");
-                status = RcmServer_E_FAIL;
-                goto leave;
-            }
-        }
-
-        /* Wait for each worker thread to terminate */
-        elem = NULL;
-        while ((elem = List_get (listH)) != NULL) {
-            worker = (RcmServer_WorkerThread *)elem;
-            status = pthread_join (worker->thread, NULL);
-            if (status < 0) {
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmServer_Instance_finalize",
-                                     status,
-                                     "Server thread did not exit properly!");
-                status = RcmServer_E_FAIL;
-                goto leave;
-            }
-
-            /* Not required for unix Thread_delete(&worker->thread); */
-
-            /* Free the worker thread object */
-            Memory_free (RcmServer_Module_heap(), worker,
-                            sizeof (RcmServer_WorkerThread));
-        }
-
-        /* Free up pool resources */
-#ifdef HAVE_ANDROID_OS
-        /* Android bionic Semdelete code returns -1 if count == 0 */
-        rval = OsalSemaphore_post (poolAry [i].sem);
-        if (rval < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "_RcmServer_Instance_finalize",
-                                 rval,
-                                 "Sem post failed for worker pool cleanup!");
-            status = RcmServer_E_FAIL;
-            goto leave;
-        }
-#endif /* ifdef HAVE_ANDROID_OS */
-        status = OsalSemaphore_delete (&(poolAry [i].sem));
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "_RcmServer_Instance_finalize",
-                                 status,
-                                 "Unable to delete RCM worker pool sync!");
-            status = RcmServer_E_FAIL;
-            goto leave;
-        }
-        List_destruct (&(poolAry [i].threadList));
-
-        /* Return any remaining messages on the readyQueue */
-        msgQueH = &(poolAry [i].readyQueue);
-
-        while ((elem = List_get (msgQueH)) != NULL) {
-            packet = (RcmClient_Packet *)elem;
-            GT_2trace (curTrace,
-                       GT_3CLASS,
-                       "_RcmServer_Instance_finalize: Returning unprocessed "
-                       "message, msgId = 0x%x, packet = 0x%x",
-                       packet->msgId, packet);
-            _RcmServer_setStatusCode (packet, RcmServer_Status_Unprocessed);
-            msgqMsg = &packet->msgqHeader;
-            rval = MessageQ_put (MessageQ_getReplyQueue (msgqMsg), msgqMsg);
-            if (rval < 0) {
-                GT_2trace (curTrace,
-                           GT_4CLASS,
-                           "_RcmServer_Instance_finalize: Unable to return "
-                           "msg 0x%x from pool 0x%x back to Client",
-                           rval, packet->message.poolId);
-            }
-        }
-
-        List_destruct (&(poolAry [i].readyQueue));
-        status = GateMutex_delete (
-                    (GateMutex_Handle *)&(poolAry [i].readyQueueGate));
+    for (i = 0; (poolAry != NULL) && (i < obj->poolMap0Len); i++) {
+        status = _RcmServer_finalizePool (&(poolAry [i]));
         if (status < 0) {
-            GT_setFailureReason (curTrace,
-                             GT_4CLASS,
-                             "_RcmServer_Instance_finalize",
-                             status,
-                             "Unable to delete mutex");
-            status = RcmClient_E_FAIL;
             goto leave;
         }
     }
@@ -1127,15 +1020,43 @@ _RcmServer_Instance_finalize (RcmServer_Object * obj)
         obj->poolMap [0] = NULL;
     }
 
-    /* TODO: free up all dynamic worker pools */
-#if 0
     /* Free all dynamic worker pools */
-    for (p = 1; p < RcmServer_POOL_MAP_LEN; p++) {
-        if ((poolAry = obj->poolMap [p]) == NULL) {
+    for (i = 1; i < RCMSERVER_POOL_MAP_LEN; i++) {
+        if ((poolAry = obj->poolMap [i]) == NULL) {
             continue;
         }
+        for (j = 0; j < RCMSERVER_DYNPOOL_LEN (i); j++) {
+            if (!poolAry [j].inUse) {
+                continue;
+            }
+            status = _RcmServer_finalizePool (&(poolAry [j]));
+            if (status < 0) {
+                goto leave;
+            }
+            if (poolAry [j].name != NULL) {
+                Memory_free (RcmServer_Module_heap(), poolAry [j].name,
+                             String_len (poolAry [j].name) + 1);
+            }
+            poolAry [j].inUse = FALSE;
+        }
+        Memory_free (RcmServer_Module_heap(), poolAry,
+                     RCMSERVER_DYNPOOL_LEN (i) * sizeof (RcmServer_ThreadPool));
+        obj->poolMap [i] = NULL;
+    }
+
+    /* Destruct the dynamic pool table gate */
+    if (obj->poolGate != NULL) {
+        status = GateMutex_delete ((GateMutex_Handle *)&(obj->poolGate));
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_Instance_finalize",
+                                 status,
+                                 "Unable to delete mutex");
+            status = RcmClient_E_FAIL;
+            goto leave;
+        }
     }
-#endif
 
     /* Free up the dynamic function tables and any leftover name strings */
     for (i = 1; i < RCMSERVER_MAX_TABLES; i++) {
@@ -1154,6 +1075,9 @@ _RcmServer_Instance_finalize (RcmServer_Object * obj)
             obj->fxnTab [i] = NULL;
         }
     }
+    for (i = 0; i < RCMSERVER_SYMHASH_LEN; i++) {
+        obj->symHash [i] = NULL;
+    }
 
     if (obj->serverThread != 0) {
         status = pthread_join (obj->serverThread, NULL);
@@ -1201,6 +1125,20 @@ _RcmServer_Instance_finalize (RcmServer_Object * obj)
                     obj->fxnTabStatic.length * sizeof (RcmServer_FxnTabElem));
     }
 
+    /* Destruct the function table gate */
+    if (obj->fxnTabGate != NULL) {
+        status = GateMutex_delete ((GateMutex_Handle *)&(obj->fxnTabGate));
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_Instance_finalize",
+                                 status,
+                                 "Unable to delete mutex");
+            status = RcmClient_E_FAIL;
+            goto leave;
+        }
+    }
+
     /* Destruct the instance gate */
     status = GateMutex_delete ((GateMutex_Handle *)&(obj->gate));
     if (status < 0) {
@@ -1236,6 +1174,7 @@ RcmServer_addSymbol (RcmServer_Handle   handle,
     SizeT                   tabSize;
     UInt32                  fxnIdx      = 0xFFFFFFFF;
     RcmServer_FxnTabElem  * slot        = NULL;
+    IArg                    key;
     Int                     status      = RcmServer_S_SUCCESS;
 
     GT_4trace (curTrace, GT_ENTER, "RcmServer_addSymbol", handle, funcName, addr,
@@ -1288,7 +1227,7 @@ RcmServer_addSymbol (RcmServer_Handle   handle,
     }
 
     /* Protect the symbol table while changing it */
-    /* TODO: key = IGateProvider_enter (handle->gate); */
+    key = IGateProvider_enter (handle->fxnTabGate);
 
     /* Look for an empty slot to use */
     for (i = 1; i < RcmServer_module->defaultCfg.maxTables; i++) {
@@ -1322,6 +1261,7 @@ RcmServer_addSymbol (RcmServer_Handle   handle,
                 ((handle->fxnTab [i]) + j)->addr = 0;
                 ((handle->fxnTab [i]) + j)->name = NULL;
                 ((handle->fxnTab [i]) + j)->key = 0;
+                ((handle->fxnTab [i]) + j)->hashNext = NULL;
             }
 
             /* Use first slot in new table */
@@ -1354,7 +1294,9 @@ RcmServer_addSymbol (RcmServer_Handle   handle,
 
         String_cpy (slot->name, funcName);
         slot->key = _RcmServer_getNextKey (handle);
-        fxnIdx = ((slot->key << _RCM_KeyShift) | (i << 12) | j);
+        slot->fxnBase = ((i << 12) | j);
+        fxnIdx = ((slot->key << _RCM_KeyShift) | slot->fxnBase);
+        _RcmServer_symHashInsert (handle, slot);
     }
     /* Error, no more room to add new symbol */
     else {
@@ -1367,7 +1309,7 @@ RcmServer_addSymbol (RcmServer_Handle   handle,
     }
 
 leave_gate:
-    /* TODO: IGateProvider_leave (handle->gate, key); */
+    IGateProvider_leave (handle->fxnTabGate, key);
 leave:
     /* On success, return new function index */
     if (status >= 0) {
@@ -1390,6 +1332,7 @@ RcmServer_removeSymbol (RcmServer_Handle handle, String name)
     UInt                    tabIdx;
     UInt                    tabOff;
     RcmServer_FxnTabElem  * slot;
+    IArg                    key;
     Int                     status = RcmServer_S_SUCCESS;
 
     GT_2trace (curTrace, GT_ENTER, "RcmServer_removeSymbol", handle, name);
@@ -1423,7 +1366,7 @@ RcmServer_removeSymbol (RcmServer_Handle handle, String name)
     }
 
     /* Protect the symbol table while changing it */
-    /* TODO: key = IGateProvider_enter (handle->gate); */
+    key = IGateProvider_enter (handle->fxnTabGate);
 
     /* Find the symbol in the table */
     status = _RcmServer_getSymIdx (handle, name, &fxnIdx);
@@ -1453,6 +1396,7 @@ RcmServer_removeSymbol (RcmServer_Handle handle, String name)
     slot = (handle->fxnTab [tabIdx]) + tabOff;
 
     /* clear the table index */
+    _RcmServer_symHashRemove (handle, slot);
     slot->addr = 0;
     if (slot->name != NULL) {
         Memory_free (RcmServer_Module_heap(), slot->name,
@@ -1462,7 +1406,7 @@ RcmServer_removeSymbol (RcmServer_Handle handle, String name)
     slot->key = 0;
 
 leave_gate:
-    /* TODO: IGateProvider_leave (handle->gate, key); */
+    IGateProvider_leave (handle->fxnTabGate, key);
 leave:
     GT_1trace (curTrace, GT_LEAVE, "RcmServer_removeSymbol", status);
 
@@ -1471,49 +1415,344 @@ leave:
 
 
 /*
- *  ======== RcmServer_start ========
+ *  ======== RcmServer_createPool ========
  */
 Int
-RcmServer_start (RcmServer_Handle handle)
+RcmServer_createPool (RcmServer_Handle              handle,
+                      RcmServer_ThreadPoolDesc    * desc,
+                      UInt16                      * poolId)
 {
-    Int status = RcmServer_S_SUCCESS;
+    RcmServer_ThreadPool  * pool    = NULL;
+    IArg                    key;
+    SizeT                   size;
+    Int                     i;
+    Int                     j       = 0;
+    Int                     status  = RcmServer_S_SUCCESS;
 
-    GT_1trace (curTrace, GT_ENTER, "RcmServer_start", handle);
+    GT_3trace (curTrace, GT_ENTER, "RcmServer_createPool", handle, desc,
+               poolId);
 
     if (RcmServer_module->setupRefCount == 0) {
         status = RcmServer_E_INVALIDSTATE;
         GT_setFailureReason (curTrace,
                              GT_4CLASS,
-                             "RcmServer_start",
+                             "RcmServer_createPool",
                              status,
                              "Module is in an invalid state!");
+        goto leave;
     }
-    else if (handle == NULL) {
+    if ((handle == NULL) || (desc == NULL) || (poolId == NULL)) {
         status = RcmServer_E_INVALIDARG;
         GT_setFailureReason (curTrace,
                              GT_4CLASS,
-                             "RcmServer_start",
+                             "RcmServer_createPool",
                              status,
-                             "Invalid handle passed!");
+                             "Invalid argument passed!");
+        goto leave;
     }
-    else {
-        /* Signal the run synchronizer, unblocks the server thread */
-        status = OsalSemaphore_post (handle->run);
-#ifdef HAVE_ANDROID_OS
-        /* Signal once more for Android */
-        status = OsalSemaphore_post (handle->run);
-#endif /* ifdef HAVE_ANDROID_OS */
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "RcmServer_start",
-                                 status,
-                                 "Semaphore post for RcmServer_start failed!");
-            status = RcmServer_E_FAIL;
+
+    key = IGateProvider_enter (handle->poolGate);
+
+    /* Look for an unused entry, allocating tables as needed */
+    for (i = 1; (pool == NULL) && (i < RCMSERVER_POOL_MAP_LEN); i++) {
+        if (handle->poolMap [i] == NULL) {
+            size = RCMSERVER_DYNPOOL_LEN (i) * sizeof (RcmServer_ThreadPool);
+            handle->poolMap [i] = (RcmServer_ThreadPool *) Memory_calloc (
+                                RcmServer_Module_heap(), size, sizeof (Ptr));
+            if (handle->poolMap [i] == NULL) {
+                status = RcmServer_E_NOMEMORY;
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "RcmServer_createPool",
+                                     status,
+                                     "Memory allocation failed for pool "
+                                     "table!");
+                goto leave_gate;
+            }
+        }
+        for (j = 0; j < RCMSERVER_DYNPOOL_LEN (i); j++) {
+            if (!(handle->poolMap [i]) [j].inUse) {
+                pool = &(handle->poolMap [i]) [j];
+                break;
+            }
         }
     }
 
-    GT_1trace (curTrace, GT_LEAVE, "RcmServer_start", status);
+    if (pool == NULL) {
+        status = RcmServer_E_NOMEMORY;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_createPool",
+                             status,
+                             "Exceeded max allowed worker pools!");
+        goto leave_gate;
+    }
+    i--;    /* table index of the entry found */
+
+    /* Copy the pool name */
+    pool->name = NULL;
+    if (desc->name != NULL) {
+        pool->name = (String) Memory_alloc (RcmServer_Module_heap(),
+                                            String_len (desc->name) + 1,
+                                            sizeof (Char *));
+        if (pool->name == NULL) {
+            status = RcmServer_E_NOMEMORY;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "RcmServer_createPool",
+                                 status,
+                                 "Memory allocation failed for pool name!");
+            goto leave_gate;
+        }
+        String_cpy (pool->name, desc->name);
+    }
+
+    status = _RcmServer_initPool (handle, pool, desc);
+    if (status < 0) {
+        _RcmServer_finalizePool (pool);
+        if (pool->name != NULL) {
+            Memory_free (RcmServer_Module_heap(), pool->name,
+                         String_len (pool->name) + 1);
+            pool->name = NULL;
+        }
+        goto leave_gate;
+    }
+
+    /* Keys run 1 - 255, a zero key never matches a lookup */
+    handle->poolKey = (handle->poolKey % RCMSERVER_DYNPOOL_KEYMAX) + 1;
+    pool->key = handle->poolKey;
+    pool->inUse = TRUE;
+
+    *poolId = (pool->key << 7) | (i << 5) | j;
+
+leave_gate:
+    IGateProvider_leave (handle->poolGate, key);
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "RcmServer_createPool", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== RcmServer_deletePool ========
+ */
+Int
+RcmServer_deletePool (RcmServer_Handle handle, UInt16 poolId)
+{
+    RcmServer_ThreadPool  * pool;
+    IArg                    key;
+    Int                     status  = RcmServer_S_SUCCESS;
+
+    GT_2trace (curTrace, GT_ENTER, "RcmServer_deletePool", handle, poolId);
+
+    if (RcmServer_module->setupRefCount == 0) {
+        status = RcmServer_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_deletePool",
+                             status,
+                             "Module is in an invalid state!");
+        goto leave;
+    }
+    if (handle == NULL) {
+        status = RcmServer_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_deletePool",
+                             status,
+                             "Invalid handle passed!");
+        goto leave;
+    }
+
+    /* Static pools have bit-15 set, cannot remove these pools */
+    if (poolId & 0x8000) {
+        status = RcmServer_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_deletePool",
+                             status,
+                             "Cannot delete static pool!");
+        goto leave;
+    }
+
+    /* Unlink the pool; clearing the key stops new messages but keeps the
+     * entry reserved until its workers are gone
+     */
+    key = IGateProvider_enter (handle->poolGate);
+    status = _RcmServer_lookupPool (handle, poolId, &pool);
+    if (status >= 0) {
+        pool->key = 0;
+    }
+    IGateProvider_leave (handle->poolGate, key);
+
+    if (status < 0) {
+        status = RcmServer_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_deletePool",
+                             status,
+                             "Pool id not found!");
+        goto leave;
+    }
+
+    /* Workers finish their current message, queued ones are returned */
+    status = _RcmServer_finalizePool (pool);
+
+    key = IGateProvider_enter (handle->poolGate);
+    if (pool->name != NULL) {
+        Memory_free (RcmServer_Module_heap(), pool->name,
+                     String_len (pool->name) + 1);
+        pool->name = NULL;
+    }
+    pool->inUse = FALSE;
+    IGateProvider_leave (handle->poolGate, key);
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "RcmServer_deletePool", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== RcmServer_getPoolStats ========
+ */
+Int
+RcmServer_getPoolStats (RcmServer_Handle        handle,
+                        UInt16                  poolId,
+                        RcmServer_PoolStats   * stats)
+{
+    RcmServer_ThreadPool      * pool;
+    RcmServer_WorkerThread    * worker;
+    IArg                        key;
+    IArg                        scaleKey;
+    IArg                        workerKey;
+    Int                         i;
+    Int                         status = RcmServer_S_SUCCESS;
+
+    GT_3trace (curTrace, GT_ENTER, "RcmServer_getPoolStats", handle, poolId,
+               stats);
+
+    if (RcmServer_module->setupRefCount == 0) {
+        status = RcmServer_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_getPoolStats",
+                             status,
+                             "Module is in an invalid state!");
+        goto leave;
+    }
+    if (handle == NULL) {
+        status = RcmServer_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_getPoolStats",
+                             status,
+                             "Invalid handle passed!");
+        goto leave;
+    }
+    if (stats == NULL) {
+        status = RcmServer_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_getPoolStats",
+                             status,
+                             "Stats pointer passed is NULL!");
+        goto leave;
+    }
+
+    key = IGateProvider_enter (handle->poolGate);
+
+    if (_RcmServer_lookupPool (handle, poolId, &pool) < 0) {
+        IGateProvider_leave (handle->poolGate, key);
+        status = RcmServer_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_getPoolStats",
+                             status,
+                             "Pool id not found!");
+        goto leave;
+    }
+
+    /* The scale gate keeps the worker set fixed; depth, idle time and the
+     * retired flag are read under each worker's queue gate. The message
+     * counters are bumped by the workers without a lock.
+     */
+    scaleKey = IGateProvider_enter (pool->scaleGate);
+
+    stats->numWorkers = pool->numActive;
+    stats->queueDepth = 0;
+    stats->processed  = 0;
+    stats->steals     = 0;
+    stats->idleTime   = 0;
+
+    for (i = 0; i < pool->numWorkers; i++) {
+        worker = pool->workerAry [i];
+        workerKey = IGateProvider_enter (worker->readyQueueGate);
+        if (!worker->retired) {
+            stats->queueDepth += worker->depth;
+        }
+        stats->idleTime   += worker->idleMs;
+        IGateProvider_leave (worker->readyQueueGate, workerKey);
+        stats->processed  += worker->processed;
+        stats->steals     += worker->steals;
+    }
+
+    IGateProvider_leave (pool->scaleGate, scaleKey);
+    IGateProvider_leave (handle->poolGate, key);
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "RcmServer_getPoolStats", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== RcmServer_start ========
+ */
+Int
+RcmServer_start (RcmServer_Handle handle)
+{
+    Int status = RcmServer_S_SUCCESS;
+
+    GT_1trace (curTrace, GT_ENTER, "RcmServer_start", handle);
+
+    if (RcmServer_module->setupRefCount == 0) {
+        status = RcmServer_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_start",
+                             status,
+                             "Module is in an invalid state!");
+    }
+    else if (handle == NULL) {
+        status = RcmServer_E_INVALIDARG;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "RcmServer_start",
+                             status,
+                             "Invalid handle passed!");
+    }
+    else {
+        /* Signal the run synchronizer, unblocks the server thread */
+        status = OsalSemaphore_post (handle->run);
+#ifdef HAVE_ANDROID_OS
+        /* Signal once more for Android */
+        status = OsalSemaphore_post (handle->run);
+#endif /* ifdef HAVE_ANDROID_OS */
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "RcmServer_start",
+                                 status,
+                                 "Semaphore post for RcmServer_start failed!");
+            status = RcmServer_E_FAIL;
+        }
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "RcmServer_start", status);
 
     return status;
 }
@@ -1663,18 +1902,8 @@ _RcmServer_dispatch (RcmServer_Object * obj, RcmClient_Packet * packet)
     jobId = packet->message.jobId;
 
     if (jobId == RcmClient_DISCRETEJOBID) {
-        listH = &pool->readyQueue;
-        List_put (listH, (List_Elem *)packet);
-
-        /* Dispatch a new worker thread */
-        status = OsalSemaphore_post (pool->sem);
-        if (status < 0) {
-            GT_setFailureReason (curTrace,
-                                 GT_4CLASS,
-                                 "_RcmServer_dispatch",
-                                 status,
-                                 "Could not post pool semaphore!");
-        }
+        /* Dispatch to a worker thread */
+        status = _RcmServer_submit (obj, packet, NULL);
     }
     /* Must be a job stream message */
     else {
@@ -1700,18 +1929,10 @@ _RcmServer_dispatch (RcmServer_Object * obj, RcmClient_Packet * packet)
         }
         /* If job object is empty, place message directly on ready queue */
         else if (job->empty) {
-            job->empty = FALSE;
-            listH = &pool->readyQueue;
-            List_put (listH, (List_Elem *)packet);
-
-            /* Dispatch a new worker thread */
-            status = OsalSemaphore_post (pool->sem);
-            if (status < 0) {
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmServer_dispatch",
-                                     RcmServer_E_INVALIDSTATE,
-                                     "Could not post pool semaphore!");
+            /* Dispatch to a worker thread */
+            status = _RcmServer_submit (obj, packet, NULL);
+            if (status >= 0) {
+                job->empty = FALSE;
             }
         }
         /* Place message on job queue */
@@ -1861,35 +2082,28 @@ _RcmServer_getFxnAddr (RcmServer_Object   * obj,
 static Int
 _RcmServer_getSymIdx (RcmServer_Object * obj, String name, UInt32 * index)
 {
-    UInt                    i;
-    UInt                    j;
-    UInt                    len;
+    UInt32                  hash;
     RcmServer_FxnTabElem  * slot;
     UInt32                  fxnIdx = 0xFFFFFFFF;
     Int                     status = RcmServer_S_SUCCESS;
 
     GT_3trace (curTrace, GT_ENTER, "_RcmServer_getSymIdx", obj, name, index);
 
-    /* Search tables for given function name */
-    for (i = 0; i < RCMSERVER_MAX_TABLES; i++) {
-        if (obj->fxnTab [i] != NULL) {
-            len = (i == 0) ? obj->fxnTabStatic.length : (1 << (i + 4));
-            for (j = 0; j < len; j++) {
-                slot = (obj->fxnTab [i]) + j;
-                if ((((obj->fxnTab [i]) + j)->name != NULL) &&
-                    (String_cmp (((obj->fxnTab [i]) + j)->name, name) == 0) ) {
-                    if (i == 0) {
-                        fxnIdx = 0x80000000 | j;
-                    }
-                    else {
-                        fxnIdx = ((slot->key << _RCM_KeyShift) | (i << 12) | j);
-                    }
-                    break;
-                }
+    /* Walk the hash chain for the given function name */
+    hash = _RcmServer_hashName (name);
+    for (slot = obj->symHash [hash & (RCMSERVER_SYMHASH_LEN - 1)];
+         slot != NULL; slot = slot->hashNext) {
+        if ((slot->hash == hash) && (String_cmp (slot->name, name) == 0)) {
+            /* Static symbols have bit-31 set and carry no key; the key of
+             * a dynamic slot is read now so a re-added symbol gets its
+             * current key.
+             */
+            if (slot->fxnBase & 0x80000000) {
+                fxnIdx = slot->fxnBase;
+            }
+            else {
+                fxnIdx = ((slot->key << _RCM_KeyShift) | slot->fxnBase);
             }
-        }
-
-        if (fxnIdx != 0xFFFFFFFF) {
             break;
         }
     }
@@ -1944,6 +2158,71 @@ _RcmServer_getNextKey (RcmServer_Object * obj)
 }
 
 
+/*
+ *  ======== _RcmServer_hashName ========
+ *
+ *  FNV-1a hash of a symbol name.
+ */
+static UInt32
+_RcmServer_hashName (String name)
+{
+    UInt32  hash = 2166136261u;
+
+    while (*name != '\0') {
+        hash ^= (UInt8)(*name++);
+        hash *= 16777619u;
+    }
+
+    return hash;
+}
+
+
+/*
+ *  ======== _RcmServer_symHashInsert ========
+ *
+ *  Must have table gate before calling this function. The slot is appended
+ *  to its chain so that, for duplicate names, the first symbol added keeps
+ *  winning lookups as it did with the linear table scan.
+ */
+static Void
+_RcmServer_symHashInsert (RcmServer_Object     * obj,
+                          RcmServer_FxnTabElem * slot)
+{
+    RcmServer_FxnTabElem ** link;
+
+    slot->hash = _RcmServer_hashName (slot->name);
+    slot->hashNext = NULL;
+
+    link = &(obj->symHash [slot->hash & (RCMSERVER_SYMHASH_LEN - 1)]);
+    while (*link != NULL) {
+        link = &((*link)->hashNext);
+    }
+    *link = slot;
+}
+
+
+/*
+ *  ======== _RcmServer_symHashRemove ========
+ *
+ *  Must have table gate before calling this function.
+ */
+static Void
+_RcmServer_symHashRemove (RcmServer_Object     * obj,
+                          RcmServer_FxnTabElem * slot)
+{
+    RcmServer_FxnTabElem ** link;
+
+    link = &(obj->symHash [slot->hash & (RCMSERVER_SYMHASH_LEN - 1)]);
+    while ((*link != NULL) && (*link != slot)) {
+        link = &((*link)->hashNext);
+    }
+    if (*link != NULL) {
+        *link = slot->hashNext;
+    }
+    slot->hashNext = NULL;
+}
+
+
 /*
  *  ======== _RcmServer_getPool ========
  */
@@ -1952,13 +2231,31 @@ _RcmServer_getPool (RcmServer_Object      * obj,
                     RcmClient_Packet      * packet,
                     RcmServer_ThreadPool ** poolP)
 {
-    UInt16  poolId;
-    UInt16  offset;
-    Int     status = RcmServer_S_SUCCESS;
+    Int     status;
 
     GT_3trace (curTrace, GT_ENTER, "_RcmServer_getPool", obj, packet, poolP);
 
-    poolId = packet->message.poolId;
+    status = _RcmServer_lookupPool (obj, packet->message.poolId, poolP);
+
+    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_getPool", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== _RcmServer_lookupPool ========
+ */
+static Int
+_RcmServer_lookupPool (RcmServer_Object      * obj,
+                       UInt16                  poolId,
+                       RcmServer_ThreadPool ** poolP)
+{
+    UInt16  index;
+    UInt16  offset;
+    Int     status = RcmServer_S_SUCCESS;
+
+    GT_3trace (curTrace, GT_ENTER, "_RcmServer_lookupPool", obj, poolId, poolP);
 
     /* Static pools have bit-15 set */
     if (poolId & 0x8000) {
@@ -1971,18 +2268,33 @@ _RcmServer_getPool (RcmServer_Object      * obj,
             status = RcmServer_E_PoolIdNotFound;
             GT_setFailureReason (curTrace,
                                  GT_4CLASS,
-                                 "_RcmServer_getPool",
+                                 "_RcmServer_lookupPool",
                                  status,
                                  "Pool id not found1");
         }
     }
-    /* Must be a dynamic pool */
+    /* Must be a dynamic pool, key 14:7, table index 6:5, offset 4:0 */
     else {
-        /* TODO */
-        status = RcmServer_E_FAIL;
+        index = (poolId >> 5) & 0x3;
+        offset = (poolId & 0x001F);
+        if ((index > 0) && (obj->poolMap [index] != NULL)
+            && (offset < RCMSERVER_DYNPOOL_LEN (index))
+            && ((obj->poolMap [index]) [offset].inUse)
+            && ((obj->poolMap [index]) [offset].key == ((poolId >> 7) & 0xFF))) {
+            *poolP = &(obj->poolMap [index]) [offset];
+        }
+        else {
+            *poolP = NULL;
+            status = RcmServer_E_PoolIdNotFound;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_lookupPool",
+                                 status,
+                                 "Dynamic pool id not found");
+        }
     }
 
-    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_getPool", status);
+    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_lookupPool", status);
 
     return status;
 }
@@ -2002,6 +2314,7 @@ _RcmServer_process (RcmServer_Object * obj, RcmClient_Packet * packet)
     UInt16              messageType;
     UInt16              jobId;
     Int                 rval;
+    IArg                gateKey;
     Int                 status      = RcmServer_S_SUCCESS;
 
     GT_2trace (curTrace, GT_ENTER, "_RcmServer_process", obj, packet);
@@ -2122,7 +2435,9 @@ _RcmServer_process (RcmServer_Object * obj, RcmClient_Packet * packet)
 
     case RcmClient_Desc_SYM_IDX:
         name = (String)rcmMsg->data;
+        gateKey = IGateProvider_enter (obj->fxnTabGate);
         rval = _RcmServer_getSymIdx(obj, name, &fxnIdx);
+        IGateProvider_leave (obj->fxnTabGate, gateKey);
 
         if (rval < 0) {
             _RcmServer_setStatusCode (
@@ -2439,6 +2754,676 @@ _RcmServer_setStatusCode (RcmClient_Packet * packet, UInt16 code)
 }
 
 
+/*
+ *  ======== _RcmServer_enqueue ========
+ *
+ *  Place a message on a worker's ready queue. When self is given the
+ *  message goes on that worker's own queue and no semaphore is posted; the
+ *  worker picks it up on its next pass. Otherwise an idle worker is
+ *  preferred, starting from the pool's round-robin cursor, and a scaling
+ *  pool may add a worker for the message.
+ */
+static Int
+_RcmServer_enqueue (RcmServer_ThreadPool   * pool,
+                    RcmServer_WorkerThread * self,
+                    RcmClient_Packet       * packet)
+{
+    RcmServer_WorkerThread    * worker;
+    RcmServer_WorkerThread    * cand;
+    Bool                        scaling;
+    IArg                        key;
+    UInt32                      now     = 0;
+    UInt                        start;
+    Int                         i;
+    Int                         status  = RcmServer_S_SUCCESS;
+
+    GT_3trace (curTrace, GT_ENTER, "_RcmServer_enqueue", pool, self, packet);
+
+    scaling = (pool->maxCount > pool->count);
+    if (scaling) {
+        now = _RcmServer_nowMs ();
+    }
+
+select:
+    if (self != NULL) {
+        worker = self;
+    }
+    else {
+        worker = NULL;
+        start = pool->nextWorker++;
+        for (i = 0; i < pool->numWorkers; i++) {
+            cand = pool->workerAry [(start + i) % pool->numWorkers];
+            if (cand->retired) {
+                continue;
+            }
+            if (worker == NULL) {
+                worker = cand;
+            }
+            if (cand->idle) {
+                worker = cand;
+                break;
+            }
+        }
+
+        /* Grow the pool if nothing can take the message promptly */
+        if (scaling && ((worker == NULL) || ((!worker->idle)
+            && (worker->depth > 0)
+            && ((now - worker->progress) >= pool->growLatency)))) {
+            key = IGateProvider_enter (pool->scaleGate);
+            if (pool->numActive < pool->maxCount) {
+                if (_RcmServer_addWorker (pool, &cand) >= 0) {
+                    worker = cand;
+                }
+            }
+            IGateProvider_leave (pool->scaleGate, key);
+        }
+
+        if (worker == NULL) {
+            status = RcmServer_E_FAIL;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_enqueue",
+                                 status,
+                                 "Pool has no worker threads!");
+            goto leave;
+        }
+    }
+
+    key = IGateProvider_enter (worker->readyQueueGate);
+    if (worker->retired) {
+        /* Lost a race with _RcmServer_reapIdle, pick again */
+        IGateProvider_leave (worker->readyQueueGate, key);
+        goto select;
+    }
+    List_put ((List_Handle)&(worker->readyQueue), (List_Elem *)packet);
+    if ((worker->depth++ == 0) && scaling) {
+        worker->progress = now;
+    }
+    IGateProvider_leave (worker->readyQueueGate, key);
+
+    if (self == NULL) {
+        status = OsalSemaphore_post (worker->sem);
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_enqueue",
+                                 status,
+                                 "Could not post worker semaphore!");
+            /* The message is queued; a sibling will steal it */
+            status = RcmServer_S_SUCCESS;
+        }
+    }
+
+    /* Retire workers above the minimum that have been idle too long */
+    if (scaling && (pool->idleTimeout > 0)
+        && (pool->numActive > pool->count)) {
+        key = IGateProvider_enter (pool->scaleGate);
+        _RcmServer_reapIdle (pool);
+        IGateProvider_leave (pool->scaleGate, key);
+    }
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_enqueue", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== _RcmServer_submit ========
+ *
+ *  Look up the target pool of a message and queue it there. Dynamic pools
+ *  are looked up and used under the pool table gate so they cannot be
+ *  deleted in between.
+ */
+static Int
+_RcmServer_submit (RcmServer_Object       * obj,
+                   RcmClient_Packet       * packet,
+                   RcmServer_WorkerThread * self)
+{
+    RcmServer_ThreadPool  * pool;
+    Bool                    dynamic;
+    IArg                    key     = NULL;
+    Int                     status;
+
+    GT_3trace (curTrace, GT_ENTER, "_RcmServer_submit", obj, packet, self);
+
+    dynamic = ((packet->message.poolId & 0x8000) == 0);
+    if (dynamic) {
+        key = IGateProvider_enter (obj->poolGate);
+    }
+
+    status = _RcmServer_getPool (obj, packet, &pool);
+    if (status >= 0) {
+        status = _RcmServer_enqueue (pool,
+                    ((self != NULL) && (self->pool == pool)) ? self : NULL,
+                    packet);
+    }
+
+    if (dynamic) {
+        IGateProvider_leave (obj->poolGate, key);
+    }
+
+    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_submit", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== _RcmServer_reapIdle ========
+ *
+ *  Must have the pool's scale gate before calling this function. A worker
+ *  is only retired with an empty queue, under its queue gate, so enqueue
+ *  can detect the race and pick another worker.
+ */
+static Void
+_RcmServer_reapIdle (RcmServer_ThreadPool * pool)
+{
+    RcmServer_WorkerThread    * worker;
+    Bool                        retire;
+    IArg                        key;
+    UInt32                      now;
+    Int                         i;
+
+    now = _RcmServer_nowMs ();
+
+    for (i = 0; (i < pool->numWorkers) && (pool->numActive > pool->count);
+         i++) {
+        worker = pool->workerAry [i];
+        if (worker->retired || !worker->idle
+            || ((now - worker->idleSince) < pool->idleTimeout)) {
+            continue;
+        }
+
+        retire = FALSE;
+        key = IGateProvider_enter (worker->readyQueueGate);
+        if ((worker->depth == 0) && worker->idle) {
+            worker->retired = TRUE;
+            pool->numActive--;
+            retire = TRUE;
+        }
+        IGateProvider_leave (worker->readyQueueGate, key);
+
+        /* Wake the worker so its thread exits */
+        if (retire) {
+            OsalSemaphore_post (worker->sem);
+        }
+    }
+}
+
+
+/*
+ *  ======== _RcmServer_nowMs ========
+ */
+static UInt32
+_RcmServer_nowMs (Void)
+{
+    struct timespec now;
+
+    clock_gettime (CLOCK_MONOTONIC, &now);
+
+    return ((now.tv_sec * 1000) + (now.tv_nsec / 1000000));
+}
+
+
+/*
+ *  ======== _RcmServer_initPool ========
+ *
+ *  Initialize a worker pool from its descriptor and start its minimum
+ *  number of worker threads. The pool name is set up by the caller.
+ */
+static Int
+_RcmServer_initPool (RcmServer_Object               * obj,
+                     RcmServer_ThreadPool           * pool,
+                     const RcmServer_ThreadPoolDesc * desc)
+{
+    Int                         i;
+    SizeT                       size;
+    Int                         status  = RcmServer_S_SUCCESS;
+
+    GT_3trace (curTrace, GT_ENTER, "_RcmServer_initPool", obj, pool, desc);
+
+    pool->count       = desc->count;
+    pool->priority    = desc->priority;
+    pool->osPriority  = desc->osPriority;
+    pool->stackSize   = desc->stackSize;
+    pool->stackSeg    = NULL;   /* TODO */
+    pool->maxCount    = (desc->maxCount > desc->count) ? desc->maxCount
+                                                       : desc->count;
+    pool->growLatency = desc->growLatency;
+    pool->idleTimeout = desc->idleTimeout;
+    pool->workerAry   = NULL;
+    pool->maxWorkers  = 0;
+    pool->numWorkers  = 0;
+    pool->numActive   = 0;
+    pool->nextWorker  = 0;
+    pool->server      = obj;
+
+    /* ThreadList is only changed under the scale gate */
+    List_construct (&(pool->threadList), NULL);
+
+    pool->scaleGate = (IGateProvider_Handle) GateMutex_create ();
+    GT_assert (curTrace, (pool->scaleGate != NULL));
+    if (pool->scaleGate == NULL) {
+        status = RcmServer_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmServer_initPool",
+                             status,
+                             "Unable to create mutex!");
+        goto leave;
+    }
+
+    if (pool->maxCount == 0) {
+        goto leave;
+    }
+
+    /* Allocate the worker index used for dispatch and stealing */
+    size = pool->maxCount * sizeof (RcmServer_WorkerThread *);
+    pool->workerAry = (RcmServer_WorkerThread **) Memory_calloc (
+                                RcmServer_Module_heap(), size, sizeof (Ptr));
+    if (pool->workerAry == NULL) {
+        status = RcmServer_E_NOMEMORY;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmServer_initPool",
+                             status,
+                             "Memory allocation failed for worker array!");
+        goto leave;
+    }
+    pool->maxWorkers = pool->maxCount;
+
+    /* Create the minimum number of worker threads */
+    for (i = 0; i < pool->count; i++) {
+        status = _RcmServer_addWorker (pool, NULL);
+        if (status < 0) {
+            goto leave;
+        }
+    }
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_initPool", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== _RcmServer_finalizePool ========
+ *
+ *  Terminate all worker threads of a pool, return any messages still on
+ *  their ready queues to the clients and free the worker objects.
+ */
+static Int
+_RcmServer_finalizePool (RcmServer_ThreadPool * pool)
+{
+    RcmServer_WorkerThread    * worker;
+    List_Elem                 * elem;
+    List_Handle                 listH;
+    List_Handle                 msgQueH;
+    RcmClient_Packet          * packet;
+    MessageQ_Msg                msgqMsg;
+    Int                         rval;
+    Int                         status  = RcmServer_S_SUCCESS;
+
+    GT_1trace (curTrace, GT_ENTER, "_RcmServer_finalizePool", pool);
+
+    /* Nothing was set up if the scale gate is missing */
+    if (pool->scaleGate == NULL) {
+        goto leave;
+    }
+
+    /* Free all the worker thread objects */
+    listH = &(pool->threadList);
+
+    /* Mark each worker thread for termination */
+    elem = NULL;
+    while ((elem = List_next (listH, elem)) != NULL) {
+        worker = (RcmServer_WorkerThread *)elem;
+        worker->terminate = TRUE;
+    }
+
+    /* Unblock each worker thread so it can terminate */
+    elem = NULL;
+    while ((elem = List_next (listH, elem)) != NULL) {
+        worker = (RcmServer_WorkerThread *)elem;
+        status = OsalSemaphore_post (worker->sem);
+        if (status != OSALSEMAPHORE_SUCCESS) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_finalizePool",
+                                 status,
+                                 "Sem post failed for worker pool!");
+            status = RcmServer_E_FAIL;
+            goto leave;
+        }
+    }
+
+    /* Wait for each worker thread to terminate */
+    elem = NULL;
+    while ((elem = List_get (listH)) != NULL) {
+        worker = (RcmServer_WorkerThread *)elem;
+        if (worker->thread != 0) {
+            status = pthread_join (worker->thread, NULL);
+            if (status < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "_RcmServer_finalizePool",
+                                     status,
+                                     "Server thread did not exit properly!");
+                status = RcmServer_E_FAIL;
+                goto leave;
+            }
+        }
+
+        /* Not required for unix Thread_delete(&worker->thread); */
+
+        /* Return any remaining messages on the readyQueue */
+        msgQueH = &(worker->readyQueue);
+
+        while ((elem = List_get (msgQueH)) != NULL) {
+            packet = (RcmClient_Packet *)elem;
+            GT_2trace (curTrace,
+                       GT_3CLASS,
+                       "_RcmServer_finalizePool: Returning unprocessed "
+                       "message, msgId = 0x%x, packet = 0x%x",
+                       packet->msgId, packet);
+            _RcmServer_setStatusCode (packet, RcmServer_Status_Unprocessed);
+            msgqMsg = &packet->msgqHeader;
+            rval = MessageQ_put (MessageQ_getReplyQueue (msgqMsg), msgqMsg);
+            if (rval < 0) {
+                GT_2trace (curTrace,
+                           GT_4CLASS,
+                           "_RcmServer_finalizePool: Unable to return "
+                           "msg 0x%x from pool 0x%x back to Client",
+                           rval, packet->message.poolId);
+            }
+        }
+        List_destruct (&(worker->readyQueue));
+
+        /* Free up worker resources */
+#ifdef HAVE_ANDROID_OS
+        /* Android bionic Semdelete code returns -1 if count == 0 */
+        rval = OsalSemaphore_post (worker->sem);
+        if (rval < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_finalizePool",
+                                 rval,
+                                 "Sem post failed for worker pool cleanup!");
+            status = RcmServer_E_FAIL;
+            goto leave;
+        }
+#endif /* ifdef HAVE_ANDROID_OS */
+        status = OsalSemaphore_delete (&(worker->sem));
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_finalizePool",
+                                 status,
+                                 "Unable to delete RCM worker pool sync!");
+            status = RcmServer_E_FAIL;
+            goto leave;
+        }
+
+        status = GateMutex_delete (
+                    (GateMutex_Handle *)&(worker->readyQueueGate));
+        if (status < 0) {
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_finalizePool",
+                                 status,
+                                 "Unable to delete mutex");
+            status = RcmClient_E_FAIL;
+            goto leave;
+        }
+
+        /* Free the worker thread object */
+        Memory_free (RcmServer_Module_heap(), worker,
+                        sizeof (RcmServer_WorkerThread));
+    }
+    List_destruct (listH);
+
+    /* Free the worker index */
+    if (pool->workerAry != NULL) {
+        Memory_free (RcmServer_Module_heap(), pool->workerAry,
+                     pool->maxWorkers * sizeof (RcmServer_WorkerThread *));
+        pool->workerAry = NULL;
+    }
+    pool->maxWorkers = 0;
+    pool->numWorkers = 0;
+    pool->numActive = 0;
+
+    status = GateMutex_delete ((GateMutex_Handle *)&(pool->scaleGate));
+    if (status < 0) {
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmServer_finalizePool",
+                             status,
+                             "Unable to delete mutex");
+        status = RcmClient_E_FAIL;
+        goto leave;
+    }
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_finalizePool", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== _RcmServer_addWorker ========
+ *
+ *  Start one more worker thread in the pool, reusing a retired worker
+ *  object when there is one. Must have the pool's scale gate, or be the
+ *  only thread using the pool, before calling this function.
+ */
+static Int
+_RcmServer_addWorker (RcmServer_ThreadPool     * pool,
+                      RcmServer_WorkerThread  ** workerP)
+{
+    RcmServer_WorkerThread    * worker  = NULL;
+    pthread_attr_t              threadP;
+    struct sched_param          schedParam;
+    Int                         i;
+    Int                         status  = RcmServer_S_SUCCESS;
+
+    GT_2trace (curTrace, GT_ENTER, "_RcmServer_addWorker", pool, workerP);
+
+    /* Reuse a retired worker object first */
+    for (i = 0; i < pool->numWorkers; i++) {
+        if (pool->workerAry [i]->retired) {
+            worker = pool->workerAry [i];
+            break;
+        }
+    }
+
+    if (worker != NULL) {
+        /* The retired thread has exited or is about to */
+        if (worker->thread != 0) {
+            pthread_join (worker->thread, NULL);
+            worker->thread = 0;
+        }
+    }
+    else {
+        if (pool->numWorkers >= pool->maxWorkers) {
+            status = RcmServer_E_FAIL;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_addWorker",
+                                 status,
+                                 "Pool is at its maximum thread count!");
+            goto leave;
+        }
+
+        /* Allocate worker thread object */
+        worker = Memory_calloc (RcmServer_Module_heap(),
+                                sizeof (RcmServer_WorkerThread),
+                                sizeof (Ptr));
+        if (worker == NULL) {
+            status = RcmServer_E_NOMEMORY;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_addWorker",
+                                 status,
+                                 "Memory allocation failed for worker "
+                                 "thread!");
+            goto leave;
+        }
+
+        /* Initialize worker thread object */
+        worker->jobId     = RcmClient_DISCRETEJOBID;
+        worker->thread    = 0;
+        worker->pool      = pool;
+        worker->server    = pool->server;
+        worker->index     = pool->numWorkers;
+        worker->depth     = 0;
+
+        /* Ready queue is guarded by its own gate, see _RcmServer_enqueue */
+        List_construct (&(worker->readyQueue), NULL);
+
+        worker->readyQueueGate = (IGateProvider_Handle) GateMutex_create ();
+        GT_assert (curTrace, (worker->readyQueueGate != NULL));
+        if (worker->readyQueueGate == NULL) {
+            Memory_free (RcmServer_Module_heap(), worker,
+                         sizeof (RcmServer_WorkerThread));
+            status = RcmServer_E_FAIL;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_addWorker",
+                                 status,
+                                 "Unable to create mutex!");
+            goto leave;
+        }
+
+        /* Create the run synchronizer */
+        worker->sem = OsalSemaphore_create (OsalSemaphore_Type_Counting, 0);
+        if (worker->sem == NULL) {
+            GateMutex_delete ((GateMutex_Handle *)&(worker->readyQueueGate));
+            Memory_free (RcmServer_Module_heap(), worker,
+                         sizeof (RcmServer_WorkerThread));
+            status = RcmServer_E_FAIL;
+            GT_setFailureReason (curTrace,
+                                 GT_4CLASS,
+                                 "_RcmServer_addWorker",
+                                 status,
+                                 "Unable to create sync for RCM pool threads!");
+            goto leave;
+        }
+
+        /* Add worker thread to worker pool, publish the index slot before
+         * the count so lock-free readers never see an empty slot
+         */
+        List_putHead (&(pool->threadList), &(worker->elem));
+        pool->workerAry [pool->numWorkers] = worker;
+        __sync_synchronize ();
+        pool->numWorkers++;
+    }
+
+    worker->terminate = FALSE;
+    worker->idle      = FALSE;
+    worker->retired   = FALSE;
+    worker->progress  = _RcmServer_nowMs ();
+    worker->idleSince = worker->progress;
+
+    /* Create worker thread */
+    pthread_attr_init (&threadP);
+    pthread_attr_getschedparam (&threadP, &schedParam);
+    if (pool->priority > 0) {
+        schedParam.sched_priority += 1;
+    }
+    else if (pool->priority < 0) {
+        schedParam.sched_priority -= 1;
+    }
+    pthread_attr_setschedparam (&threadP, &schedParam);
+
+    status = pthread_create (&(worker->thread), &threadP,
+                             (Void *) &_RcmServer_workerThrFxn,
+                             (Void *) worker);
+    if (status != 0) {
+        /* Leave the object retired so it can be reused */
+        worker->thread = 0;
+        worker->retired = TRUE;
+        status = RcmServer_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_RcmServer_addWorker",
+                             status,
+                             "Could not create worker thread!");
+        goto leave;
+    }
+    pool->numActive++;
+
+    if (workerP != NULL) {
+        *workerP = worker;
+    }
+
+leave:
+    GT_1trace (curTrace, GT_LEAVE, "_RcmServer_addWorker", status);
+
+    return status;
+}
+
+
+/*
+ *  ======== _RcmServer_takeMsg ========
+ *
+ *  Take the oldest message from the worker's own queue. If that queue is
+ *  empty, steal the newest message from the first sibling which has one.
+ *  Job stream order is not affected: a job stream never has more than one
+ *  message on the ready queues at a time.
+ */
+static RcmClient_Packet *
+_RcmServer_takeMsg (RcmServer_WorkerThread * obj)
+{
+    RcmServer_ThreadPool      * pool    = obj->pool;
+    RcmServer_WorkerThread    * victim;
+    List_Handle                 listH;
+    List_Elem                 * elem    = NULL;
+    IArg                        key;
+    Int                         i;
+
+    key = IGateProvider_enter (obj->readyQueueGate);
+    elem = List_get ((List_Handle)&(obj->readyQueue));
+    if (elem != NULL) {
+        obj->depth--;
+        if (pool->maxCount > pool->count) {
+            obj->progress = _RcmServer_nowMs ();
+        }
+    }
+    IGateProvider_leave (obj->readyQueueGate, key);
+
+    for (i = 1; (elem == NULL) && (i < pool->numWorkers); i++) {
+        victim = pool->workerAry [(obj->index + i) % pool->numWorkers];
+
+        /* Unlocked peek, the depth is re-checked under the gate. Retired
+         * workers always have an empty queue.
+         */
+        if (victim->depth == 0) {
+            continue;
+        }
+
+        key = IGateProvider_enter (victim->readyQueueGate);
+        if (victim->depth > 0) {
+            /* The list object is the sentinel, its prev is the tail */
+            listH = (List_Handle)&(victim->readyQueue);
+            elem = List_prev (listH, &(victim->readyQueue.elem));
+            List_remove (listH, elem);
+            victim->depth--;
+            if (pool->maxCount > pool->count) {
+                victim->progress = _RcmServer_nowMs ();
+            }
+            obj->steals++;
+        }
+        IGateProvider_leave (victim->readyQueueGate, key);
+    }
+
+    return ((RcmClient_Packet *)elem);
+}
+
+
 /*
  *  ======== _RcmServer_workerThrFxn ========
  */
@@ -2448,12 +3433,12 @@ _RcmServer_workerThrFxn (IArg arg)
     RcmClient_Packet          * packet;
     List_Elem                 * elem;
     List_Handle                 listH;
-    List_Handle                 readyQueueH;
     UInt16                      jobId;
     IArg                        key;
-    RcmServer_ThreadPool      * pool;
     RcmServer_JobStream       * job;
     RcmServer_WorkerThread    * obj;
+    struct timespec             idleStart;
+    struct timespec             idleEnd;
     Bool                        running;
     Int                         rval;
     Int                         rval1;
@@ -2461,32 +3446,14 @@ _RcmServer_workerThrFxn (IArg arg)
     GT_1trace (curTrace, GT_ENTER, "_RcmServer_workerThrFxn", arg);
 
     obj = (RcmServer_WorkerThread *)arg;
-    readyQueueH = &obj->pool->readyQueue;
     packet = NULL;
     running = TRUE;
+    rval = RcmServer_S_SUCCESS;
 
     /* Main processing loop */
     while (running) {
-        GT_1trace (curTrace,
-                   GT_1CLASS,
-                   "_RcmServer_workerThrFxn waiting for job, thread = 0x%x",
-                   (IArg)(obj->thread));
-
-        /* If no current message, wait until signaled to run */
-        if (packet == NULL) {
-            rval = OsalSemaphore_pend (obj->pool->sem,
-                                        OSALSEMAPHORE_WAIT_FOREVER);
-            if (rval < 0) {
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "_RcmServer_workerThrFxn",
-                                     rval,
-                                     "Semaphore pend failed!");
-            }
-        }
-
-        /* Check if thread should terminate */
-        if (obj->terminate) {
+        /* Check if thread should terminate or was retired by the pool */
+        if (obj->terminate || obj->retired) {
             running = FALSE;
             GT_1trace (curTrace,
                        GT_1CLASS,
@@ -2495,13 +3462,41 @@ _RcmServer_workerThrFxn (IArg arg)
             continue;
         }
 
-        /* Get next message from ready queue */
-        packet = (RcmClient_Packet *)List_get (readyQueueH);
+        /* Get next message from own ready queue, else steal one */
+        packet = _RcmServer_takeMsg (obj);
+
+        /* If no message, wait until signaled to run */
         if (packet == NULL) {
             GT_1trace (curTrace,
-                       GT_2CLASS,
-                       "_RcmServer_workerThrFxn: Ready queue is empty "
-                       " worker thread = 0x%x", (IArg) obj->thread);
+                       GT_1CLASS,
+                       "_RcmServer_workerThrFxn waiting for job, thread = 0x%x",
+                       (IArg)(obj->thread));
+
+            clock_gettime (CLOCK_MONOTONIC, &idleStart);
+            obj->idleSince = (idleStart.tv_sec * 1000)
+                           + (idleStart.tv_nsec / 1000000);
+            obj->idle = TRUE;
+            rval = OsalSemaphore_pend (obj->sem, OSALSEMAPHORE_WAIT_FOREVER);
+            clock_gettime (CLOCK_MONOTONIC, &idleEnd);
+            obj->idle = FALSE;
+
+            if (rval < 0) {
+                GT_setFailureReason (curTrace,
+                                     GT_4CLASS,
+                                     "_RcmServer_workerThrFxn",
+                                     rval,
+                                     "Semaphore pend failed!");
+            }
+
+            /* Account idle time, carrying the sub-millisecond part. The
+             * queue gate makes the update atomic for getPoolStats.
+             */
+            key = IGateProvider_enter (obj->readyQueueGate);
+            obj->idleUs += ((idleEnd.tv_sec - idleStart.tv_sec) * 1000000)
+                         + ((idleEnd.tv_nsec - idleStart.tv_nsec) / 1000);
+            obj->idleMs += obj->idleUs / 1000;
+            obj->idleUs %= 1000;
+            IGateProvider_leave (obj->readyQueueGate, key);
             continue;
         }
 
@@ -2516,14 +3511,15 @@ _RcmServer_workerThrFxn (IArg arg)
 
         /* Process the message */
         _RcmServer_process(obj->server, packet);
+        obj->processed++;
         packet = NULL;
 
         /* If this worker thread just finished processing a job message,
          * queue up the next message for this job id. As an optimization,
-         * if the message is addressed to this worker's pool, then don't
-         * signal the semaphore, just get the next message from the queue
-         * and processes it. This keeps the current thread running instead
-         * of switching to another thread.
+         * if the message is addressed to this worker's pool, then it goes
+         * on this worker's own queue without signaling any semaphore, and
+         * is picked up on the next pass through the loop. This keeps the
+         * current thread running instead of switching to another thread.
          */
         if (jobId != RcmClient_DISCRETEJOBID) {
 
@@ -2556,9 +3552,9 @@ _RcmServer_workerThrFxn (IArg arg)
                     break;
                 }
                 else {
-                    /* Get target pool id */
+                    /* Queue it in the target pool's ready queue */
                     packet = (RcmClient_Packet *)elem;
-                    rval = _RcmServer_getPool (obj->server, packet, &pool);
+                    rval = _RcmServer_submit (obj->server, packet, obj);
                     /* If error, return the message to the client */
                     if (rval < 0) {
                         switch (rval) {
@@ -2586,21 +3582,7 @@ _RcmServer_workerThrFxn (IArg arg)
                                                  "back to the client!");
                         }
                     }
-                    /* Packet is valid, queue it in the corresponding pool's
-                     * ready queue */
-                    else {
-                        listH = &pool->readyQueue;
-                        List_put (listH, elem);
-                        packet = NULL;
-                        rval = OsalSemaphore_post (pool->sem);
-                        if (rval < 0) {
-                            GT_setFailureReason (curTrace,
-                                                 GT_4CLASS,
-                                                 "_RcmServer_workerThrFxn",
-                                                 rval,
-                                                 "Pool Ssemaphore post failed");
-                        }
-                    }
+                    packet = NULL;
 
                     /* Loop around and wait to be run again */
                 }
@@ -42,33 +42,189 @@
 /* Standard headers */
 #include <Std.h>
 
+/* OSAL & Utils headers */
+#include <Trace.h>
+#include <Cache.h>
+
+/* OS-specific headers */
+#include <pthread.h>
+
 #if defined (__cplusplus)
 extern "C" {
 #endif /* defined (__cplusplus) */
 
 
+/* =============================================================================
+ *  Macros and types
+ * =============================================================================
+ */
+/*!
+ *  @brief  Value of Cache_ModuleObject.procId when no processor is registered
+ */
+#define CACHE_NOPROC            0xFFFFu
+
+/*!
+ *  @brief  Cache module state
+ */
+typedef struct Cache_ModuleObject_tag {
+    Cache_OpFxn         wbInvFxn;
+    /*!< Writes back and invalidates a range */
+    Cache_OpFxn         invFxn;
+    /*!< Invalidates a range */
+    volatile UInt16     procId;
+    /*!< Processor whose MMU driver carries out the operations */
+    UInt32              refCount [Cache_MAXPROCS];
+    /*!< Number of registrations per processor */
+    pthread_mutex_t     lock;
+    /*!< Serializes Cache_register and Cache_unregister */
+} Cache_ModuleObject;
+
+
+/* =============================================================================
+ *  Globals
+ * =============================================================================
+ */
+static Cache_ModuleObject Cache_state =
+{
+    .wbInvFxn = NULL,
+    .invFxn   = NULL,
+    .procId   = CACHE_NOPROC,
+    .lock     = PTHREAD_MUTEX_INITIALIZER
+};
+
+
+/* =============================================================================
+ *  APIs
+ * =============================================================================
+ */
 /*
  *  ======== Cache_inv ========
  */
-Void Cache_inv(Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait)
+Int Cache_inv(Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait)
 {
-    /* TODO : Define this */
+    UInt16 procId = Cache_state.procId;
+    Int    status = Cache_S_SUCCESS;
+
+    if (byteCnt == 0) {
+        return status;
+    }
+
+    if (procId == CACHE_NOPROC) {
+        status = Cache_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Cache_inv",
+                             status,
+                             "No cache maintenance registered!");
+    }
+    else if (Cache_state.invFxn (blockPtr, byteCnt, procId) < 0) {
+        status = Cache_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Cache_inv",
+                             status,
+                             "Cache invalidate failed!");
+    }
+
+    return status;
 }
 
 /*
  *  ======== Cache_wb ========
+ *  The MMU driver only offers a combined write back and invalidate, which
+ *  also covers a plain write back.
  */
-Void Cache_wb(Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait)
+Int Cache_wb(Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait)
 {
-        /* TODO : Define this */
+    return Cache_wbInv (blockPtr, byteCnt, type, wait);
 }
 
 /*
  *  ======== Cache_wbInv ========
  */
-Void Cache_wbInv(Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait)
+Int Cache_wbInv(Ptr blockPtr, UInt32 byteCnt, Bits16 type, Bool wait)
+{
+    UInt16 procId = Cache_state.procId;
+    Int    status = Cache_S_SUCCESS;
+
+    if (byteCnt == 0) {
+        return status;
+    }
+
+    if (procId == CACHE_NOPROC) {
+        status = Cache_E_INVALIDSTATE;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Cache_wbInv",
+                             status,
+                             "No cache maintenance registered!");
+    }
+    else if (Cache_state.wbInvFxn (blockPtr, byteCnt, procId) < 0) {
+        status = Cache_E_FAIL;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "Cache_wbInv",
+                             status,
+                             "Cache write back failed!");
+    }
+
+    return status;
+}
+
+/*
+ *  ======== Cache_register ========
+ *  Any registered processor will do, since the operations act on the MPU
+ *  virtual address; the first one stays in use until it is unregistered.
+ */
+Void Cache_register(UInt16 procId, Cache_OpFxn wbInvFxn, Cache_OpFxn invFxn)
+{
+    GT_assert (curTrace, (procId < Cache_MAXPROCS));
+
+    if (procId < Cache_MAXPROCS) {
+        pthread_mutex_lock (&Cache_state.lock);
+        Cache_state.refCount [procId]++;
+        if (Cache_state.procId == CACHE_NOPROC) {
+            Cache_state.wbInvFxn = wbInvFxn;
+            Cache_state.invFxn   = invFxn;
+            Cache_state.procId   = procId;
+        }
+        pthread_mutex_unlock (&Cache_state.lock);
+    }
+}
+
+/*
+ *  ======== Cache_unregister ========
+ */
+Void Cache_unregister(UInt16 procId)
+{
+    UInt16 i;
+
+    if (procId < Cache_MAXPROCS) {
+        pthread_mutex_lock (&Cache_state.lock);
+        if (Cache_state.refCount [procId] > 0) {
+            Cache_state.refCount [procId]--;
+        }
+        if (   (Cache_state.procId == procId)
+            && (Cache_state.refCount [procId] == 0)) {
+            /* Switch to another registered processor, if any. */
+            Cache_state.procId = CACHE_NOPROC;
+            for (i = 0; i < Cache_MAXPROCS; i++) {
+                if (Cache_state.refCount [i] > 0) {
+                    Cache_state.procId = i;
+                    break;
+                }
+            }
+        }
+        pthread_mutex_unlock (&Cache_state.lock);
+    }
+}
+
+/*
+ *  ======== Cache_isEnabled ========
+ */
+Bool Cache_isEnabled(Void)
 {
-        /* TODO : Define this */
+    return (Cache_state.procId != CACHE_NOPROC);
 }
 
 
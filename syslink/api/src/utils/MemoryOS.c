@@ -50,13 +50,14 @@
 /* Linux OS-specific headers */
 #include <unistd.h>
 #include <stdlib.h>
+#include <stddef.h>
 #include <string.h>
 #include <assert.h>
+#include <sched.h>
 
 /* OSAL and kernel utils */
 #include <MemoryOS.h>
 #include <Trace.h>
-#include <List.h>
 #include <Gate.h>
 #include <GateMutex.h>
 #include <Bitops.h>
@@ -81,11 +82,9 @@ extern "C" {
  * =============================================================================
  */
 /*!
- *  @brief  Structure for containing
+ *  @brief  Structure for containing a mapping
  */
 typedef struct MemoryOS_MapTableInfo {
-    List_Elem next;
-    /*!< Pointer to next entry */
     UInt32    actualAddress;
     /*!< Actual address */
     UInt32    mappedAddress;
@@ -94,16 +93,43 @@ typedef struct MemoryOS_MapTableInfo {
     /*!< Size of the region mapped */
 } MemoryOS_MapTableInfo;
 
+/*!
+ *  @brief  Snapshot of all mappings, never modified once published.
+ *
+ *          entries is sorted by mapped address; mapped regions do not
+ *          overlap, so a binary search finds the one containing an address.
+ *          Actual regions may overlap (the same memory mapped twice), so
+ *          byActual is sorted by actual address and maxEnd [i] is the
+ *          highest end address of byActual [0..i], which bounds the
+ *          backward scan from the binary search position.
+ */
+typedef struct MemoryOS_MapTable {
+    UInt32                   count;
+    /*!< Number of mappings */
+    UInt32                   allocSize;
+    /*!< Size of this allocation */
+    MemoryOS_MapTableInfo ** byActual;
+    /*!< Entries sorted by actual address */
+    UInt32 *                 maxEnd;
+    /*!< Running maximum of actualAddress + size along byActual */
+    MemoryOS_MapTableInfo    entries [1];
+    /*!< Entries sorted by mapped address */
+} MemoryOS_MapTable;
+
 /*!
  *  @brief  Structure defining state object of system memory manager.
  */
 typedef struct MemoryOS_ModuleObject {
     Atomic      refCount;
     /*!< Reference count */
-    List_Object mapTable;
-    /*!< Head of map table */
+    MemoryOS_MapTable * volatile mapTable;
+    /*!< Current map table, NULL when there are no mappings */
+    volatile UInt32 readers [2];
+    /*!< Translations in progress, counted by epoch parity */
+    volatile UInt32 epoch;
+    /*!< Selects the readers counter new translations use */
     IGateProvider_Handle gateHandle;
-    /*!< Lock handle */
+    /*!< Lock handle, serializes updates of the map table */
 } MemoryOS_ModuleObject;
 
 
@@ -120,6 +146,226 @@ static
 MemoryOS_ModuleObject MemoryOS_state ;
 
 
+/* =============================================================================
+ * Internal functions
+ * =============================================================================
+ */
+/*!
+ *  @brief  Order map table entries by actual address.
+ */
+static int
+_MemoryOS_cmpActual (const void * a, const void * b)
+{
+    UInt32 aa = (*(MemoryOS_MapTableInfo * const *) a)->actualAddress;
+    UInt32 ba = (*(MemoryOS_MapTableInfo * const *) b)->actualAddress;
+
+    return (aa > ba) - (aa < ba);
+}
+
+
+/*!
+ *  @brief  Build a new map table from the current one, optionally adding
+ *          an entry and removing the entry at a given position.
+ *
+ *  @param  old         Current map table, may be NULL
+ *  @param  add         Entry to add, NULL if none
+ *  @param  removeIdx   Position in old->entries to drop, old->count if none
+ *  @param  newTable    Location to receive the new table, NULL when empty
+ *
+ *  @sa     _MemoryOS_publishTable
+ */
+static Int
+_MemoryOS_buildTable (MemoryOS_MapTable *     old,
+                      MemoryOS_MapTableInfo * add,
+                      UInt32                  removeIdx,
+                      MemoryOS_MapTable **    newTable)
+{
+    Int                 status   = MEMORYOS_SUCCESS;
+    UInt32              oldCount = (old != NULL) ? old->count : 0;
+    UInt32              count;
+    UInt32              size;
+    UInt32              i;
+    UInt32              j;
+    UInt32              end;
+    MemoryOS_MapTable * table;
+
+    count = oldCount + ((add != NULL) ? 1 : 0)
+            - ((removeIdx < oldCount) ? 1 : 0);
+    *newTable = NULL;
+    if (count == 0) {
+        return status;
+    }
+
+    size = offsetof (MemoryOS_MapTable, entries)
+           + count * (  sizeof (MemoryOS_MapTableInfo)
+                      + sizeof (MemoryOS_MapTableInfo *)
+                      + sizeof (UInt32));
+    table = MemoryOS_alloc (size, 0, 0);
+    if (table == NULL) {
+        /*! @retval MEMORYOS_E_MEMORY Failed to allocate the map table */
+        status = MEMORYOS_E_MEMORY;
+        GT_setFailureReason (curTrace,
+                             GT_4CLASS,
+                             "_MemoryOS_buildTable",
+                             status,
+                             "Failed to allocate memory!");
+        return status;
+    }
+    table->count     = count;
+    table->allocSize = size;
+    table->byActual  = (MemoryOS_MapTableInfo **) &table->entries [count];
+    table->maxEnd    = (UInt32 *) &table->byActual [count];
+
+    /* Merge the new entry into the old ones, skipping the removed one */
+    for (i = 0, j = 0; i < oldCount; i++) {
+        if (i == removeIdx) {
+            continue;
+        }
+        if (   (add != NULL)
+            && (add->mappedAddress < old->entries [i].mappedAddress)) {
+            table->entries [j++] = *add;
+            add = NULL;
+        }
+        table->entries [j++] = old->entries [i];
+    }
+    if (add != NULL) {
+        table->entries [j++] = *add;
+    }
+
+    for (i = 0; i < count; i++) {
+        table->byActual [i] = &table->entries [i];
+    }
+    qsort (table->byActual, count, sizeof (MemoryOS_MapTableInfo *),
+           _MemoryOS_cmpActual);
+    for (i = 0, end = 0; i < count; i++) {
+        if (table->byActual [i]->actualAddress + table->byActual [i]->size
+            > end) {
+            end = table->byActual [i]->actualAddress
+                  + table->byActual [i]->size;
+        }
+        table->maxEnd [i] = end;
+    }
+
+    *newTable = table;
+
+    return status;
+}
+
+
+/*!
+ *  @brief  Replace the map table and free the old one once no translation
+ *          can still be using it. Called with the module gate held.
+ *
+ *          Translations take no lock: they count themselves in the readers
+ *          counter selected by the epoch parity before loading the table.
+ *          Any translation that can see the old table was counted before
+ *          the new one was published, so after the epoch has been flipped
+ *          twice and each counter has drained once, the old table is
+ *          unreachable. Flipping keeps new translations from starving the
+ *          wait.
+ *
+ *  @param  table   New map table
+ *
+ *  @sa     _MemoryOS_buildTable, MemoryOS_translate
+ */
+static Void
+_MemoryOS_publishTable (MemoryOS_MapTable * table)
+{
+    MemoryOS_MapTable * old = MemoryOS_state.mapTable;
+    UInt32              idx;
+    UInt32              round;
+
+    __sync_synchronize ();
+    MemoryOS_state.mapTable = table;
+    __sync_synchronize ();
+
+    if (old != NULL) {
+        for (round = 0; round < 2; round++) {
+            idx = MemoryOS_state.epoch & 1;
+            __sync_fetch_and_add (&MemoryOS_state.epoch, 1);
+            while (MemoryOS_state.readers [idx] != 0) {
+                sched_yield ();
+            }
+        }
+        MemoryOS_free (old, old->allocSize, 0);
+    }
+}
+
+
+/*!
+ *  @brief  Find the entry whose mapped region contains addr.
+ *
+ *  @param  table   Map table
+ *  @param  addr    Mapped address
+ *
+ *  @sa     _MemoryOS_findActual
+ */
+static MemoryOS_MapTableInfo *
+_MemoryOS_findMapped (MemoryOS_MapTable * table, UInt32 addr)
+{
+    UInt32 lo = 0;
+    UInt32 hi = table->count;
+    UInt32 mid;
+
+    /* Find the first entry mapped above addr */
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (table->entries [mid].mappedAddress <= addr) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    if (   (lo > 0)
+        && (addr - table->entries [lo - 1].mappedAddress
+            < table->entries [lo - 1].size)) {
+        return &table->entries [lo - 1];
+    }
+
+    return NULL;
+}
+
+
+/*!
+ *  @brief  Find an entry whose actual region contains addr.
+ *
+ *  @param  table   Map table
+ *  @param  addr    Actual address
+ *
+ *  @sa     _MemoryOS_findMapped
+ */
+static MemoryOS_MapTableInfo *
+_MemoryOS_findActual (MemoryOS_MapTable * table, UInt32 addr)
+{
+    MemoryOS_MapTableInfo * info;
+    UInt32                  lo = 0;
+    UInt32                  hi = table->count;
+    UInt32                  mid;
+
+    while (lo < hi) {
+        mid = (lo + hi) / 2;
+        if (table->byActual [mid]->actualAddress <= addr) {
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+
+    /* Regions starting at or below addr, until none reaches past it */
+    while (lo > 0 && table->maxEnd [lo - 1] > addr) {
+        info = table->byActual [--lo];
+        if (addr - info->actualAddress < info->size) {
+            return info;
+        }
+    }
+
+    return NULL;
+}
+
+
 /* =============================================================================
  * APIs
  * =============================================================================
@@ -167,8 +413,8 @@ MemoryOS_setup (void)
         }
         else {
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            /* Construct the map table */
-            List_construct (&MemoryOS_state.mapTable, NULL);
+            /* Start with an empty map table */
+            MemoryOS_state.mapTable = NULL;
 
             status = OsalDrv_open ();
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
@@ -221,7 +467,11 @@ MemoryOS_destroy (void)
 #endif /* if !defined(SYSLINK_BUILD_OPTIMIZE) */
         if (   Atomic_dec_return (&MemoryOS_state.refCount)
             == MEMORYOS_MAKE_MAGICSTAMP(0)) {
-            List_destruct (&MemoryOS_state.mapTable);
+            if (MemoryOS_state.mapTable != NULL) {
+                MemoryOS_free (MemoryOS_state.mapTable,
+                               MemoryOS_state.mapTable->allocSize, 0);
+                MemoryOS_state.mapTable = NULL;
+            }
 
             /* Delete the gate handle */
             status = GateMutex_delete ((GateMutex_Handle *)&MemoryOS_state.gateHandle);
@@ -384,7 +634,8 @@ Int
 MemoryOS_map (Memory_MapInfo * mapInfo)
 {
     Int                     status   = MEMORYOS_SUCCESS;
-    MemoryOS_MapTableInfo * info     = NULL;
+    MemoryOS_MapTableInfo   info;
+    MemoryOS_MapTable *     table;
     IArg                    key;
 
     GT_1trace (curTrace, GT_ENTER, "MemoryOS_map", mapInfo);
@@ -427,7 +678,8 @@ MemoryOS_map (Memory_MapInfo * mapInfo)
 #endif /* #if !defined(SYSLINK_BUILD_OPTIMIZE) */
         key = IGateProvider_enter (MemoryOS_state.gateHandle);
 
-        mapInfo->dst = OsalDrv_map (mapInfo->src, mapInfo->size);
+        mapInfo->dst = OsalDrv_map (mapInfo->src, mapInfo->size,
+                                     mapInfo->isCached);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         if (mapInfo->dst == (UInt32)NULL) {
             status = MEMORYOS_E_MAP;
@@ -439,29 +691,17 @@ MemoryOS_map (Memory_MapInfo * mapInfo)
         }
         else {
 #endif /* #if !defined(SYSLINK_BUILD_OPTIMIZE) */
-            info = MemoryOS_alloc (sizeof (MemoryOS_MapTableInfo), 0, 0);
-#if !defined(SYSLINK_BUILD_OPTIMIZE)
-            if (info == NULL) {
-                status = MEMORYOS_E_MEMORY;
-                GT_setFailureReason (curTrace,
-                                     GT_4CLASS,
-                                     "MemoryOS_map",
-                                     status,
-                                     "Failed to allocate memory!");
+            /* Populate the info */
+            info.actualAddress = mapInfo->src;
+            info.mappedAddress = mapInfo->dst;
+            info.size          = mapInfo->size;
+            /* Publish a copy of the map table with the info added */
+            status = _MemoryOS_buildTable (MemoryOS_state.mapTable, &info,
+                                           ~0u, &table);
+            if (status >= 0) {
+                _MemoryOS_publishTable (table);
             }
-            else {
-#endif /* #if !defined(SYSLINK_BUILD_OPTIMIZE) */
-                /* Initialize the list element */
-                List_elemClear ((List_Elem *) info);
-                /* Populate the info */
-                info->actualAddress = mapInfo->src;
-                info->mappedAddress = mapInfo->dst;
-                info->size          = mapInfo->size;
-                /* Put the info into the list */
-                List_putHead ((List_Handle) &MemoryOS_state.mapTable,
-                              (List_Elem *) info);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
-            }
         }
 #endif /* #if !defined(SYSLINK_BUILD_OPTIMIZE) */
         IGateProvider_leave (MemoryOS_state.gateHandle, key);
@@ -486,9 +726,10 @@ MemoryOS_map (Memory_MapInfo * mapInfo)
 Int
 MemoryOS_unmap (Memory_UnmapInfo * unmapInfo)
 {
-    Int         status   = MEMORYOS_SUCCESS;
-    List_Elem * info     = NULL;
-    IArg        key;
+    Int                     status   = MEMORYOS_SUCCESS;
+    MemoryOS_MapTableInfo * info;
+    MemoryOS_MapTable *     table;
+    IArg                    key;
 
     GT_1trace (curTrace, GT_ENTER, "MemoryOS_unmap", unmapInfo);
 
@@ -531,14 +772,16 @@ MemoryOS_unmap (Memory_UnmapInfo * unmapInfo)
 #endif /* #if !defined(SYSLINK_BUILD_OPTIMIZE) */
         key = IGateProvider_enter (MemoryOS_state.gateHandle);
 
-        /* Delete the node in the map table */
-        List_traverse (info, (List_Handle) &MemoryOS_state.mapTable) {
-            if (   ((MemoryOS_MapTableInfo *) info)->mappedAddress
-                == unmapInfo->addr) {
-                List_remove ((List_Handle) &MemoryOS_state.mapTable,
-                             (List_Elem *) info);
-                MemoryOS_free (info, sizeof (MemoryOS_MapTableInfo), 0);
-                break;
+        /* Publish a copy of the map table without the node */
+        table = MemoryOS_state.mapTable;
+        if (table != NULL) {
+            info = _MemoryOS_findMapped (table, unmapInfo->addr);
+            if (info != NULL && info->mappedAddress == unmapInfo->addr) {
+                status = _MemoryOS_buildTable (table, NULL,
+                                               info - table->entries, &table);
+                if (status >= 0) {
+                    _MemoryOS_publishTable (table);
+                }
             }
         }
 
@@ -663,10 +906,8 @@ MemoryOS_translate (Ptr srcAddr, Memory_XltFlags flags)
 {
     Ptr                     buf    = NULL;
     MemoryOS_MapTableInfo * tinfo  = NULL;
-    List_Elem *             info   = NULL;
-    IArg                    key;
-    UInt32                  frmAddr;
-    UInt32                  toAddr;
+    MemoryOS_MapTable *     table;
+    UInt32                  idx;
 
     GT_2trace (curTrace, GT_ENTER, "MemoryOS_translate", srcAddr, flags);
 
@@ -684,23 +925,31 @@ MemoryOS_translate (Ptr srcAddr, Memory_XltFlags flags)
     }
     else {
 #endif /* #if !defined(SYSLINK_BUILD_OPTIMIZE) */
-        key = IGateProvider_enter (MemoryOS_state.gateHandle);
-
-        /* Traverse to the node in the map table */
-        List_traverse (info, (List_Handle) &MemoryOS_state.mapTable) {
-            tinfo = (MemoryOS_MapTableInfo *) info;
-            frmAddr = (flags == Memory_XltFlags_Virt2Phys) ?
-                                    tinfo->mappedAddress : tinfo->actualAddress;
-            toAddr = (flags == Memory_XltFlags_Virt2Phys) ?
-                                    tinfo->actualAddress : tinfo->mappedAddress;
-            if (   (((UInt32) srcAddr) >= frmAddr)
-                && (((UInt32) srcAddr) < (frmAddr + tinfo->size))) {
-                buf = (Ptr) (toAddr + ((UInt32)srcAddr - frmAddr));
-                break;
+        /* No lock: the table is kept alive while this translation is
+         * counted, see _MemoryOS_publishTable.
+         */
+        idx = MemoryOS_state.epoch & 1;
+        __sync_fetch_and_add (&MemoryOS_state.readers [idx], 1);
+
+        table = MemoryOS_state.mapTable;
+        if (table != NULL) {
+            if (flags == Memory_XltFlags_Virt2Phys) {
+                tinfo = _MemoryOS_findMapped (table, (UInt32) srcAddr);
+                if (tinfo != NULL) {
+                    buf = (Ptr) (  tinfo->actualAddress
+                                 + ((UInt32) srcAddr - tinfo->mappedAddress));
+                }
+            }
+            else {
+                tinfo = _MemoryOS_findActual (table, (UInt32) srcAddr);
+                if (tinfo != NULL) {
+                    buf = (Ptr) (  tinfo->mappedAddress
+                                 + ((UInt32) srcAddr - tinfo->actualAddress));
+                }
             }
         }
 
-        IGateProvider_leave (MemoryOS_state.gateHandle, key);
+        __sync_fetch_and_sub (&MemoryOS_state.readers [idx], 1);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
     }
 #endif /* #if !defined(SYSLINK_BUILD_OPTIMIZE) */
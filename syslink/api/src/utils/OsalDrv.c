@@ -85,6 +85,12 @@ extern "C" {
  */
 static Int32 OsalDrv_handle = -1;
 
+/*!
+ *  @brief  Driver handle opened without O_SYNC, through which the driver
+ *          creates cached mappings. Opened on the first cached map.
+ */
+static Int32 OsalDrv_cachedHandle = -1;
+
 /*!
  *  @brief  Reference count for the driver handle.
  */
@@ -181,6 +187,11 @@ OsalDrv_close (Void)
         else {
             OsalDrv_handle = 0;
         }
+
+        if (OsalDrv_cachedHandle >= 0) {
+            close (OsalDrv_cachedHandle);
+            OsalDrv_cachedHandle = -1;
+        }
     }
 
     GT_1trace (curTrace, GT_LEAVE, "OsalDrv_close", status);
@@ -193,17 +204,41 @@ OsalDrv_close (Void)
 /*!
  *  @brief  Function to map a memory region specific to the driver.
  *
+ *          The driver maps memory uncached for a handle opened with O_SYNC,
+ *          which is how the main handle is opened. Cached mappings go through
+ *          a second handle opened without it; if that cannot be opened the
+ *          region is mapped uncached.
+ *
  *  @sa     OsalDrv_close,OsalDrv_open
  */
 UInt32
-OsalDrv_map (UInt32 addr, UInt32 size)
+OsalDrv_map (UInt32 addr, UInt32 size, Bool isCached)
 {
     UInt32 pageSize = getpagesize ();
     UInt32 userAddr = (UInt32) NULL;
     UInt32 taddr;
     UInt32 tsize;
+    Int32  handle   = OsalDrv_handle;
+
+    GT_1trace (curTrace, GT_ENTER, "OsalDrv_map", isCached);
 
-    GT_0trace (curTrace, GT_ENTER, "OsalDrv_map");
+    if ((OsalDrv_refCount > 0) && (isCached == TRUE)) {
+        if (OsalDrv_cachedHandle < 0) {
+            OsalDrv_cachedHandle = open (OSALDRV_DRIVER_NAME, O_RDWR);
+            if (OsalDrv_cachedHandle >= 0) {
+                fcntl (OsalDrv_cachedHandle, F_SETFD, FD_CLOEXEC);
+            }
+        }
+        if (OsalDrv_cachedHandle >= 0) {
+            handle = OsalDrv_cachedHandle;
+        }
+        else {
+            GT_0trace (curTrace,
+                       GT_2CLASS,
+                       "    OsalDrv_map: cached handle unavailable, mapping "
+                       "uncached\n");
+        }
+    }
 
     if (OsalDrv_refCount > 0) {
         taddr = addr;
@@ -216,7 +251,7 @@ OsalDrv_map (UInt32 addr, UInt32 size)
                                   tsize,
                                   PROT_READ | PROT_WRITE,
                                   MAP_SHARED,
-                                  OsalDrv_handle,
+                                  handle,
                                   (off_t) taddr);
 #if !defined(SYSLINK_BUILD_OPTIMIZE)
         if (userAddr == (UInt32) MAP_FAILED) {
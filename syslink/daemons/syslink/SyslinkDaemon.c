@@ -207,6 +207,7 @@ static Void exceptionDumpRegisters (Void)
 
     traceinfo.src  = CONTEXTBUFFERADD;
     traceinfo.size = 0x80;
+    traceinfo.isCached = FALSE;
     status = Memory_map (&traceinfo);
     if (status!= MEMORYOS_SUCCESS) {
         Osal_printf ("Memory_map failed\n");
@@ -271,6 +272,7 @@ static Void exceptionDumpRegisters (Void)
                         "to 12KB\n");
         traceinfo.size = STACKBUFFERSZE;
     }
+    traceinfo.isCached = FALSE;
 
     status = Memory_map (&traceinfo);
     if (status!= MEMORYOS_SUCCESS) {
@@ -27,3 +27,17 @@ LOCAL_CFLAGS += -DSYSLINK_DIRECT_LOGD
 LOCAL_MODULE:= syslink_trace_daemon.out
 
 include $(BUILD_EXECUTABLE)
+
+# Decoder for binary captures, built for the development host
+include $(CLEAR_VARS)
+
+LOCAL_MODULE_TAGS:=optional
+
+LOCAL_SRC_FILES:= \
+	SyslinkTraceDecode.c
+
+LOCAL_CFLAGS += -Wall
+
+LOCAL_MODULE:= syslink_trace_decode
+
+include $(BUILD_HOST_EXECUTABLE)
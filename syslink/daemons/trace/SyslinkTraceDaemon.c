@@ -43,10 +43,16 @@
 /* OS-specific headers */
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdarg.h>
 #include <unistd.h>
 #include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/uio.h>
 #include <pthread.h>
 #include <semaphore.h>
 
@@ -55,6 +61,8 @@
 #include <UsrUtilsDrv.h>
 #include <Memory.h>
 
+#include "SyslinkTraceFormat.h"
+
 #if defined (__cplusplus)
 extern "C" {
 #endif /* defined (__cplusplus) */
@@ -69,49 +77,236 @@ extern "C" {
 
 #define TRACE_BUFFER_SIZE               0x10000
 
-#define TIMEOUT_USECS                   500000
+/* Poll interval bounds; the interval doubles each time a core's trace
+ * buffer is found empty and drops back to the minimum when it has data.
+ */
+#define TRACE_POLL_MIN_USECS            10000
+#define TRACE_POLL_MAX_USECS            2000000
+
+/* Per-core staging ring between a reader and the writer, power of 2 */
+#define TRACE_STAGE_SIZE                0x20000
+
+#define TRACE_NUM_CORES                 3
+
+/* Longest piece of text passed to one Osal_printf call, which formats into
+ * a 512 byte buffer
+ */
+#define TRACE_PRINT_CHUNK               256
 
 #ifdef HAVE_ANDROID_OS
 #undef LOG_TAG
 #define LOG_TAG "TRACED"
 #endif
 
-static FILE *log;
-/* Semaphore to allow only one thread to print at once */
-sem_t        semPrint;
-/* Scratch buffer with extra space for core names */
-Char         tempBuffer [TRACE_BUFFER_SIZE + 128];
-
-
 /* Thread (core) specific info */
 typedef struct traceBufferParams {
     Char      * coreName;
     UInt32      bufferAddress;
+    UInt32      coreId;         /* Index in traceCores, for binary mode */
+
+    /* Staging ring, single producer (reader) and single consumer (writer).
+     * Only the reader moves stageTail and only the writer moves stageHead.
+     */
+    Char        stage [TRACE_STAGE_SIZE];
+    volatile UInt32 stageHead;  /* Next byte the writer takes */
+    volatile UInt32 stageTail;  /* Next byte the reader fills */
+    UInt32      dropped;        /* Bytes lost to a full staging ring */
 } traceBufferParams;
 
+/* Output state, only used by the writer thread after startup */
+static Int          logFd       = -1;   /* -1 writes through Osal_printf */
+static Char         logPath [PATH_MAX];
+static off_t        logSize;            /* Bytes in the current log file */
+static off_t        logMaxSize;         /* Rotate at this size, 0 never */
+static Bool         binaryMode;         /* Capture raw binary records */
+static Bool         diagStderr;         /* Binary records go to stdout */
+
+/* Posted by a reader whenever it publishes new staged text */
+static sem_t        semWrite;
+
+static traceBufferParams traceCores [TRACE_NUM_CORES];
+
+
+/*
+ *  Print a diagnostic message. While binary records are written to stdout
+ *  the messages go to stderr instead, so they cannot corrupt the capture.
+ */
+static Void traceDiag (const Char * format, ...)
+{
+    va_list             args;
+    Char                buffer [TRACE_PRINT_CHUNK];
+
+    va_start (args, format);
+    if (diagStderr) {
+        vfprintf (stderr, format, args);
+    }
+    else {
+        vsnprintf (buffer, sizeof (buffer), format, args);
+        Osal_printf ("%s", buffer);
+    }
+    va_end (args);
+}
+
+
+/*
+ *  Append to the staging ring at the reader's private tail. Returns FALSE
+ *  without copying if the data does not fit.
+ */
+static Bool stagePut (traceBufferParams * params, UInt32 * tail,
+                      const Char * src, UInt32 len)
+{
+    UInt32 pos;
+    UInt32 part;
+
+    if (len > TRACE_STAGE_SIZE - (*tail - params->stageHead)) {
+        return FALSE;
+    }
+
+    pos = *tail & (TRACE_STAGE_SIZE - 1);
+    part = TRACE_STAGE_SIZE - pos;
+    if (part >= len) {
+        memcpy (&params->stage [pos], src, len);
+    }
+    else {
+        memcpy (&params->stage [pos], src, part);
+        memcpy (params->stage, src + part, len - part);
+    }
+    *tail += len;
+
+    return TRUE;
+}
+
+
+/*
+ *  Stage the new traces one line at a time, each with the core name in
+ *  front. Lines are published together at the end so the writer never
+ *  interleaves partial lines from different cores.
+ */
+static Void stageLines (traceBufferParams * params, Char * traceBuffer,
+                        UInt32 readPos, UInt32 writePos)
+{
+    UInt32              endPos;
+    UInt32              lineSize;
+    UInt32              i;
+    UInt32              tail;
+    UInt32              committed;
+    Bool                full;
+    Bool                ok;
+    Bool                newline;
+    Char                note [64];
+    Int                 len;
+    UInt32              coreNameSize = strlen(params->coreName);
+
+    committed = params->stageTail;
+    full = FALSE;
+
+    /* Note any traces lost since the last batch */
+    if (params->dropped > 0) {
+        len = snprintf (note, sizeof (note), "%s<%u bytes of traces "
+                        "dropped>\n", params->coreName, params->dropped);
+        if (stagePut (params, &committed, note, len)) {
+            params->dropped = 0;
+        }
+    }
+
+    while (readPos != writePos) {
+        tail = committed;
+        ok = !full && stagePut (params, &tail, params->coreName,
+                                coreNameSize);
+        lineSize = 0;
+        do {
+            /* Text runs to the write position or the buffer end */
+            endPos = (readPos < writePos) ? writePos :
+                                            (TRACE_BUFFER_SIZE - 8);
+            for (i = readPos; i < endPos && traceBuffer [i] != '\n'; i++);
+            if (i < endPos) {
+                i++;    /* Keep the newline */
+            }
+            ok = ok && stagePut (params, &tail, &traceBuffer [readPos],
+                                 i - readPos);
+            lineSize += i - readPos;
+            newline = (i > readPos) && (traceBuffer [i - 1] == '\n');
+            readPos = (i >= TRACE_BUFFER_SIZE - 8) ? 0 : i;
+        } while (!newline && readPos != writePos);
+
+        /* Pretty print truncated traces at the end of the buffer. */
+        if (!newline) {
+            ok = ok && stagePut (params, &tail, "\n", 1);
+        }
+
+        if (ok) {
+            committed = tail;
+        }
+        else {
+            /* Drop the rest of this batch to keep the order */
+            full = TRUE;
+            params->dropped += lineSize;
+        }
+    }
+
+    /* Make the staged text visible before publishing it */
+    __sync_synchronize ();
+    params->stageTail = committed;
+}
+
+
+/*
+ *  Stage the new traces as one binary record holding the raw buffer
+ *  contents, see SyslinkTraceFormat.h. The text is formatted offline.
+ */
+static Void stageRecord (traceBufferParams * params, Char * traceBuffer,
+                         UInt32 readPos, UInt32 writePos)
+{
+    traceRecordHeader   rec;
+    struct timeval      now;
+    UInt32              tail;
+    UInt32              first;
+    Bool                ok;
+
+    gettimeofday (&now, NULL);
+    first = (readPos < writePos) ? writePos - readPos :
+                                   (TRACE_BUFFER_SIZE - 8) - readPos;
+
+    rec.tag     = TRACE_RECORD_TAG;
+    rec.coreId  = params->coreId;
+    rec.sec     = now.tv_sec;
+    rec.usec    = now.tv_usec;
+    rec.length  = first + ((readPos < writePos) ? 0 : writePos);
+    rec.dropped = params->dropped;
+
+    tail = params->stageTail;
+    ok = stagePut (params, &tail, (Char *)&rec, sizeof (rec))
+        && stagePut (params, &tail, &traceBuffer [readPos], first)
+        && stagePut (params, &tail, traceBuffer, rec.length - first);
+    if (!ok) {
+        params->dropped += rec.length;
+        return;
+    }
+    params->dropped = 0;
+
+    /* Make the staged record visible before publishing it */
+    __sync_synchronize ();
+    params->stageTail = tail;
+}
 
 
 Void printRemoteTraces (Void *args)
 {
     Int                 status              = 0;
     Memory_MapInfo      traceinfo;
-    UInt32              numOfBytesInBuffer  = 0;
     volatile UInt32   * readPointer;
     volatile UInt32   * writePointer;
     UInt32              writePos;
     Char              * traceBuffer;
-    UInt32              numBytesToCopy;
-    UInt32              printStart;
-    UInt32              i;
+    UInt32              pollUsecs           = TRACE_POLL_MIN_USECS;
     traceBufferParams * params = (traceBufferParams*)args;
-    UInt32              coreNameSize = strlen(params->coreName);
-    Char                saveChar;
 
-    Osal_printf ("Creating trace thread for %s\n", params->coreName);
+    traceDiag ("Creating trace thread for %s\n", params->coreName);
 
     /* Get the user virtual address of the buffer */
     traceinfo.src  = params->bufferAddress;
     traceinfo.size = TRACE_BUFFER_SIZE;
+    traceinfo.isCached = FALSE;
     status = Memory_map (&traceinfo);
     readPointer = (volatile UInt32 *)traceinfo.dst;
     writePointer = (volatile UInt32 *)(traceinfo.dst + 0x4);
@@ -121,76 +316,218 @@ Void printRemoteTraces (Void *args)
     *readPointer = 0;
     *writePointer = 0;
     do {
-        do {
-            usleep (TIMEOUT_USECS);
-        } while (*readPointer == *writePointer);
-
-        sem_wait (&semPrint);    /* Acquire exclusive access to printing */
+        /* Back off while the core is quiet */
+        while (*readPointer == *writePointer) {
+            usleep (pollUsecs);
+            pollUsecs = (pollUsecs * 2 > TRACE_POLL_MAX_USECS) ?
+                            TRACE_POLL_MAX_USECS : pollUsecs * 2;
+        }
+        pollUsecs = TRACE_POLL_MIN_USECS;
 
-        /* Copy the trace buffer contents to the scratch buffer. */
-        memcpy (tempBuffer, params->coreName, coreNameSize);
-        numOfBytesInBuffer = coreNameSize;
         writePos = *writePointer;
-        if (*readPointer < writePos) {
-            numBytesToCopy = writePos - (*readPointer);
-            memcpy (&tempBuffer [numOfBytesInBuffer],
-                    &traceBuffer [*readPointer], numBytesToCopy);
-            numOfBytesInBuffer += numBytesToCopy;
+        if (binaryMode) {
+            stageRecord (params, traceBuffer, *readPointer, writePos);
         }
         else {
-            numBytesToCopy = ((TRACE_BUFFER_SIZE - 8) - (*readPointer));
-            memcpy (&tempBuffer [numOfBytesInBuffer],
-                    &traceBuffer [*readPointer], numBytesToCopy);
-            numOfBytesInBuffer += numBytesToCopy;
-            numBytesToCopy = writePos;
-            memcpy (&tempBuffer [numOfBytesInBuffer], traceBuffer,
-                    numBytesToCopy);
-            numOfBytesInBuffer += numBytesToCopy;
+            stageLines (params, traceBuffer, *readPointer, writePos);
         }
 
         /* Update the read position in shared memory. */
         *readPointer = writePos;
 
-        /* Print the traces one line at time. */
-        printStart = 0;
-        i = coreNameSize;
-        while ( i < numOfBytesInBuffer ) {
-            /* Search for a newline */
-            while (tempBuffer [i] != '\n' && i < numOfBytesInBuffer ) {
-                i++;
-            }
+        sem_post (&semWrite);
+
+    } while (1);
+
+    traceDiag ("Leaving %s thread function \n", params->coreName);
+
+    return;
+}
+
+
+/*
+ *  Start a binary capture file with the core name table.
+ */
+static Void writeFileHeader (Void)
+{
+    traceFileHeader     hdr;
+    Char                names [TRACE_NUM_CORES][TRACE_CORE_NAME_LEN];
+    struct iovec        iov [2];
+    ssize_t             written;
+    Int                 i;
+
+    hdr.tag      = TRACE_FILE_TAG;
+    hdr.version  = TRACE_FILE_VERSION;
+    hdr.numCores = TRACE_NUM_CORES;
+
+    memset (names, 0, sizeof (names));
+    for (i = 0; i < TRACE_NUM_CORES; i++) {
+        strncpy (names [i], traceCores [i].coreName, TRACE_CORE_NAME_LEN - 1);
+    }
+
+    iov [0].iov_base = &hdr;
+    iov [0].iov_len = sizeof (hdr);
+    iov [1].iov_base = names;
+    iov [1].iov_len = sizeof (names);
+    written = writev (logFd, iov, 2);
+    if (written > 0) {
+        logSize += written;
+    }
+}
 
-            /* Pretty print truncated traces at the end of the buffer. */
-            if (tempBuffer [i] != '\n') {
-                tempBuffer [i] = '\n';
-            }
 
-            /* Temporarily replace the char after newline with '\0', */
-            /* print trace, then prefix next trace with core name.   */
-            saveChar = tempBuffer [i + 1];
-            tempBuffer [i + 1] = 0;
-            if (log == NULL) {
-                Osal_printf ("%s", &tempBuffer [printStart]);
+/*
+ *  Start a new log file once the current one reaches logMaxSize. The
+ *  previous log is kept with a ".1" suffix. The new file is opened before
+ *  the current one is closed; if that fails, writing continues to the
+ *  current file and rotation is retried after another logMaxSize bytes.
+ */
+static Void rotateLog (Void)
+{
+    Char oldPath [PATH_MAX + 2];
+    Char newPath [PATH_MAX + 4];
+    Int  newFd;
+
+    snprintf (oldPath, sizeof (oldPath), "%s.1", logPath);
+    snprintf (newPath, sizeof (newPath), "%s.new", logPath);
+
+    newFd = open (newPath, O_WRONLY | O_CREAT | O_APPEND | O_TRUNC, 0644);
+    if (newFd < 0) {
+        traceDiag ("Failed to open file: %s (%s), not rotating\n",
+                   newPath, strerror (errno));
+        logSize = 0;
+        return;
+    }
+
+    if (rename (logPath, oldPath) < 0) {
+        traceDiag ("Failed to rotate %s (%s)\n", logPath, strerror (errno));
+        close (newFd);
+        unlink (newPath);
+        logSize = 0;
+        return;
+    }
+    if (rename (newPath, logPath) < 0) {
+        traceDiag ("Failed to rotate %s (%s)\n", logPath, strerror (errno));
+        /* Put the current file back under its name. */
+        rename (oldPath, logPath);
+        close (newFd);
+        unlink (newPath);
+        logSize = 0;
+        return;
+    }
+
+    close (logFd);
+    logFd = newFd;
+    logSize = 0;
+    if (binaryMode) {
+        writeFileHeader ();
+    }
+}
+
+
+/*
+ *  Print staged text with one Osal_printf per line, splitting lines that
+ *  are longer than TRACE_PRINT_CHUNK. Used when there is no log file.
+ */
+static Void printText (const Char * text, size_t len)
+{
+    const Char        * newline;
+    size_t              lineLen;
+
+    while (len > 0) {
+        newline = memchr (text, '\n', len);
+        lineLen = (newline != NULL) ? (size_t)(newline - text) + 1 : len;
+        if (lineLen > TRACE_PRINT_CHUNK) {
+            lineLen = TRACE_PRINT_CHUNK;
+        }
+        Osal_printf ("%.*s", (Int)lineLen, text);
+        text += lineLen;
+        len -= lineLen;
+    }
+}
+
+
+/*
+ *  Writer thread, drains the staging rings of all cores with one writev
+ *  per wakeup. A core that floods its ring only loses its own traces.
+ */
+Void writeTraces (Void *args)
+{
+    struct iovec        iov [TRACE_NUM_CORES * 2];
+    UInt32              tails [TRACE_NUM_CORES];
+    traceBufferParams * params;
+    UInt32              head;
+    UInt32              pos;
+    UInt32              len;
+    Int                 iovCnt;
+    Int                 first;
+    ssize_t             written;
+    Int                 i;
+
+    do {
+        sem_wait (&semWrite);
+
+        /* Collect up to two segments per core */
+        iovCnt = 0;
+        for (i = 0; i < TRACE_NUM_CORES; i++) {
+            params = &traceCores [i];
+            tails [i] = params->stageTail;
+            __sync_synchronize ();
+            head = params->stageHead;
+            len = tails [i] - head;
+            if (len == 0) {
+                continue;
             }
-            else {
-                fprintf (log,"%s", &tempBuffer [printStart]);
+            pos = head & (TRACE_STAGE_SIZE - 1);
+            if (pos + len > TRACE_STAGE_SIZE) {
+                iov [iovCnt].iov_base = &params->stage [pos];
+                iov [iovCnt].iov_len = TRACE_STAGE_SIZE - pos;
+                iovCnt++;
+                len -= TRACE_STAGE_SIZE - pos;
+                pos = 0;
             }
-            tempBuffer [i + 1] = saveChar;
-            i++;
-            printStart = i - coreNameSize;
-            memcpy (&tempBuffer [printStart], params->coreName, coreNameSize );
+            iov [iovCnt].iov_base = &params->stage [pos];
+            iov [iovCnt].iov_len = len;
+            iovCnt++;
         }
 
-        if (log != NULL ) {
-            fflush (log);
+        /* Write everything collected, resuming after short writes */
+        first = 0;
+        while (first < iovCnt) {
+            if (logFd < 0) {
+                printText ((Char *)iov [first].iov_base, iov [first].iov_len);
+                first++;
+                continue;
+            }
+            written = writev (logFd, &iov [first], iovCnt - first);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                break;
+            }
+            logSize += written;
+            while (first < iovCnt && (size_t)written >= iov [first].iov_len) {
+                written -= iov [first].iov_len;
+                first++;
+            }
+            if (first < iovCnt) {
+                iov [first].iov_base = (Char *)iov [first].iov_base + written;
+                iov [first].iov_len -= written;
+            }
         }
 
-        sem_post (&semPrint);    /* Release exclusive access to printing */
+        /* Release the ring space to the readers */
+        __sync_synchronize ();
+        for (i = 0; i < TRACE_NUM_CORES; i++) {
+            traceCores [i].stageHead = tails [i];
+        }
 
+        if (logMaxSize > 0 && logSize >= logMaxSize) {
+            rotateLog ();
+        }
     } while (1);
 
-    Osal_printf ("Leaving %s thread function \n", params->coreName);
-
     return;
 }
 
@@ -198,10 +535,14 @@ Void printRemoteTraces (Void *args)
 /** print usage and exit */
 static Void printUsageExit (Char * app)
 {
-    Osal_printf ("%s: [-h] [-l logfile] [-f]\n", app);
+    Osal_printf ("%s: [-h] [-l logfile] [-s size] [-b] [-f]\n", app);
     Osal_printf ("  -h   Show this help message.\n");
     Osal_printf ("  -l   Select log file to write. (\"stdout\" can be used for"
                  "terminal output.)\n");
+    Osal_printf ("  -s   Rotate the log file every size KB. (Keeps one old log"
+                 " as logfile.1)\n");
+    Osal_printf ("  -b   Capture binary records to the log file, decode them "
+                 "with syslink_trace_decode.\n");
     Osal_printf ("  -f   Run in foreground. (Do not fork daemon process.)\n");
 
     exit (EXIT_SUCCESS);
@@ -213,12 +554,14 @@ Int main (Int argc, Char * argv [])
     pthread_t           thread_sys; /* server thread object */
     pthread_t           thread_app; /* server thread object */
     pthread_t           thread_dsp; /* server thread object */
+    pthread_t           thread_log; /* writer thread object */
     Char              * log_file    = NULL;
     Bool                daemon      = TRUE;
     Int                 i;
-    traceBufferParams   args_sys;
-    traceBufferParams   args_app;
-    traceBufferParams   args_dsp;
+    struct stat         logStat;
+    traceBufferParams * args_sys    = &traceCores [0];
+    traceBufferParams * args_app    = &traceCores [1];
+    traceBufferParams * args_dsp    = &traceCores [2];
 
     /* parse cmd-line args */
     for (i = 1; i < argc; i++) {
@@ -228,6 +571,15 @@ Int main (Int argc, Char * argv [])
             }
             log_file = argv[i];
         }
+        else if (!strcmp ("-s", argv[i])) {
+            if (++i >= argc) {
+                printUsageExit (argv[0]);
+            }
+            logMaxSize = (off_t)strtoul (argv[i], NULL, 0) * 1024;
+        }
+        else if (!strcmp ("-b", argv[i])) {
+            binaryMode = TRUE;
+        }
         else if (!strcmp ("-f", argv[i])) {
             daemon = FALSE;
         }
@@ -236,16 +588,22 @@ Int main (Int argc, Char * argv [])
         }
     }
 
-    Osal_printf ("Spawning Ducati-Tesla Trace daemon...\n");
+    diagStderr = binaryMode && (log_file != NULL)
+                 && (strcmp (log_file, "stdout") == 0);
+
+    traceDiag ("Spawning Ducati-Tesla Trace daemon...\n");
 
     if (daemon) {
         pid_t child_pid;
         pid_t child_sid;
 
+        /* Nothing buffered may be flushed a second time by the child */
+        fflush (stdout);
+
         /* Fork off the parent process */
         child_pid = fork ();
         if (child_pid < 0) {
-            Osal_printf ("Spawning Trace daemon failed!\n");
+            traceDiag ("Spawning Trace daemon failed!\n");
             exit (EXIT_FAILURE);     /* Failure */
         }
 
@@ -257,67 +615,87 @@ Int main (Int argc, Char * argv [])
         /* Create a new SID for the child process */
         child_sid = setsid ();
         if (child_sid < 0) {
-            Osal_printf ("setsid failed!\n");
+            traceDiag ("setsid failed!\n");
             exit (EXIT_FAILURE);     /* Failure */
         }
     }
 
     if (log_file == NULL) {
-        log = NULL;
+        if (binaryMode) {
+            traceDiag ("Binary capture needs a log file (-l)\n");
+            exit (EXIT_FAILURE);     /* Failure */
+        }
+        logFd = -1;
     }
     else {
         if (strcmp (log_file, "stdout") == 0) {
             /* why do we need this?  It would be an issue when logging to file.. */
             /* Change file mode mask */
             umask (0);
-            log = stdout;
+            logFd = STDOUT_FILENO;
+            logMaxSize = 0;
         }
         else {
-            log = fopen (log_file, "a+");
-            if (log == NULL ) {
-                Osal_printf("Failed to open file: %s\n", log_file);
+            logFd = open (log_file, O_WRONLY | O_CREAT | O_APPEND, 0644);
+            if (logFd < 0) {
+                traceDiag ("Failed to open file: %s\n", log_file);
                 exit (EXIT_FAILURE);     /* Failure */
             }
+            /* Rotation needs the full path once we chdir below */
+            if (realpath (log_file, logPath) == NULL) {
+                logMaxSize = 0;
+            }
+            if (fstat (logFd, &logStat) == 0) {
+                logSize = logStat.st_size;
+            }
         }
     }
 
     /* Change the current working directory */
     if ((chdir("/")) < 0) {
-        Osal_printf ("chdir failed!\n");
+        traceDiag ("chdir failed!\n");
         exit (EXIT_FAILURE);     /* Failure */
     }
 
-    sem_init (&semPrint, 0, 1);
+    sem_init (&semWrite, 0, 0);
 
     UsrUtilsDrv_setup ();
 
-    args_sys.coreName = "[SYSM3]: ";
-    args_sys.bufferAddress = SYSM3_TRACE_BUFFER_PHYS_ADDR;
-    args_app.coreName = "[APPM3]: ";
-    args_app.bufferAddress = APPM3_TRACE_BUFFER_PHYS_ADDR;
-    args_dsp.coreName = "[DSP]: ";
-    args_dsp.bufferAddress = TESLA_TRACE_BUFFER_PHYS_ADDR;
+    args_sys->coreName = "[SYSM3]: ";
+    args_sys->bufferAddress = SYSM3_TRACE_BUFFER_PHYS_ADDR;
+    args_app->coreName = "[APPM3]: ";
+    args_app->bufferAddress = APPM3_TRACE_BUFFER_PHYS_ADDR;
+    args_dsp->coreName = "[DSP]: ";
+    args_dsp->bufferAddress = TESLA_TRACE_BUFFER_PHYS_ADDR;
+    for (i = 0; i < TRACE_NUM_CORES; i++) {
+        traceCores [i].coreId = i;
+    }
+
+    if (binaryMode) {
+        writeFileHeader ();
+    }
 
+    pthread_create (&thread_log, NULL, (Void *)&writeTraces, NULL);
     pthread_create (&thread_sys, NULL, (Void *)&printRemoteTraces,
-                    (Void*)&args_sys);
+                    (Void*)args_sys);
     pthread_create (&thread_app, NULL, (Void *)&printRemoteTraces,
-                    (Void*)&args_app);
+                    (Void*)args_app);
     pthread_create (&thread_dsp, NULL, (Void *)&printRemoteTraces,
-                    (Void*)&args_dsp);
+                    (Void*)args_dsp);
 
     pthread_join (thread_sys, NULL);
-    Osal_printf ("SysM3 trace thread exited\n");
+    traceDiag ("SysM3 trace thread exited\n");
     pthread_join (thread_app, NULL);
-    Osal_printf ("AppM3 trace thread exited\n");
+    traceDiag ("AppM3 trace thread exited\n");
     pthread_join (thread_dsp, NULL);
-    Osal_printf ("Tesla trace thread exited\n");
+    traceDiag ("Tesla trace thread exited\n");
 
     UsrUtilsDrv_destroy ();
 
-    sem_destroy (&semPrint);
+    sem_destroy (&semWrite);
 
-    if (log != NULL && log != stdout ) {
-        fclose(log);
+    if (logFd >= 0 && logFd != STDOUT_FILENO) {
+        close (logFd);
     }
 
     return 0;
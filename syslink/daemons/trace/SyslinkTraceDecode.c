@@ -0,0 +1,298 @@
+/*
+ *  Syslink-IPC for TI OMAP Processors
+ *
+ *  Copyright (c) 2008-2010, Texas Instruments Incorporated
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  *  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  *  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  *  Neither the name of Texas Instruments Incorporated nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*============================================================================
+ *  @file   SyslinkTraceDecode.c
+ *
+ *  @brief  Decoder for binary trace captures of the Syslink trace daemon
+ *
+ *          Rebuilds the core-prefixed text that the daemon prints in its
+ *          default mode from a file written with "-b". Uses only the C
+ *          library so it also builds on the host:
+ *
+ *              cc -o syslink_trace_decode SyslinkTraceDecode.c
+ *
+ *  ============================================================================
+ */
+
+
+/* OS-specific headers */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "SyslinkTraceFormat.h"
+
+#if defined (__cplusplus)
+extern "C" {
+#endif /* defined (__cplusplus) */
+
+
+/* Decoder state for one core */
+typedef struct traceCoreState {
+    char        name [TRACE_CORE_NAME_LEN];
+    char      * line;           /* Partial line carried between records */
+    size_t      lineLen;
+    size_t      lineMax;
+    uint32_t    sec;            /* Time of the record that began the line */
+    uint32_t    usec;
+} traceCoreState;
+
+static traceCoreState   cores [TRACE_MAX_CORES];
+static int              showTime    = 0;
+
+
+/* Print one finished line with its core name */
+static void printLine (traceCoreState * core, const char * text, size_t len)
+{
+    if (showTime) {
+        printf ("%u.%06u ", core->sec, core->usec);
+    }
+    fputs (core->name, stdout);
+    fwrite (text, 1, len, stdout);
+    if (len == 0 || text [len - 1] != '\n') {
+        putchar ('\n');
+    }
+}
+
+
+/* Print the partial line of a core, e.g. at end of input */
+static void flushLine (traceCoreState * core)
+{
+    if (core->lineLen > 0) {
+        printLine (core, core->line, core->lineLen);
+        core->lineLen = 0;
+    }
+}
+
+
+/* Append text to the partial line of a core */
+static int keepLine (traceCoreState * core, const char * text, size_t len)
+{
+    char * line;
+
+    if (core->lineLen + len > core->lineMax) {
+        line = realloc (core->line, core->lineLen + len);
+        if (line == NULL) {
+            return -1;
+        }
+        core->line = line;
+        core->lineMax = core->lineLen + len;
+    }
+    memcpy (&core->line [core->lineLen], text, len);
+    core->lineLen += len;
+
+    return 0;
+}
+
+
+/* Print the complete lines of a record, keep the rest for the next one */
+static int decodeRecord (traceCoreState * core, traceRecordHeader * rec,
+                         const char * text)
+{
+    const char * end = text + rec->length;
+    const char * nl;
+    char         note [48];
+    int          len;
+
+    if (rec->dropped > 0) {
+        flushLine (core);
+        core->sec = rec->sec;
+        core->usec = rec->usec;
+        len = snprintf (note, sizeof (note), "<%u bytes of traces dropped>\n",
+                        rec->dropped);
+        printLine (core, note, len);
+    }
+
+    while (text < end) {
+        if (core->lineLen == 0) {
+            core->sec = rec->sec;
+            core->usec = rec->usec;
+        }
+        nl = memchr (text, '\n', end - text);
+        if (nl == NULL) {
+            return keepLine (core, text, end - text);
+        }
+        nl++;
+        if (core->lineLen > 0) {
+            if (keepLine (core, text, nl - text) < 0) {
+                return -1;
+            }
+            flushLine (core);
+        }
+        else {
+            printLine (core, text, nl - text);
+        }
+        text = nl;
+    }
+
+    return 0;
+}
+
+
+static int decodeFile (FILE * in, const char * name)
+{
+    traceFileHeader     hdr;
+    traceRecordHeader   rec;
+    char              * text        = NULL;
+    size_t              textMax     = 0;
+    char              * buf;
+    uint32_t            tag;
+    uint32_t            i;
+    int                 status      = 0;
+
+    while (fread (&tag, sizeof (tag), 1, in) == 1) {
+        if (tag == TRACE_FILE_TAG) {
+            /* (Re)load the core name table */
+            hdr.tag = tag;
+            if (fread (&hdr.version, sizeof (hdr) - sizeof (tag), 1, in) != 1
+                || hdr.version != TRACE_FILE_VERSION
+                || hdr.numCores > TRACE_MAX_CORES) {
+                fprintf (stderr, "%s: bad file header\n", name);
+                status = -1;
+                break;
+            }
+            for (i = 0; i < hdr.numCores; i++) {
+                flushLine (&cores [i]);
+                if (fread (cores [i].name, TRACE_CORE_NAME_LEN, 1, in) != 1) {
+                    fprintf (stderr, "%s: truncated file header\n", name);
+                    status = -1;
+                    goto leave;
+                }
+                cores [i].name [TRACE_CORE_NAME_LEN - 1] = '\0';
+            }
+        }
+        else if (tag == TRACE_RECORD_TAG) {
+            rec.tag = tag;
+            if (fread (&rec.coreId, sizeof (rec) - sizeof (tag), 1, in) != 1
+                || rec.coreId >= TRACE_MAX_CORES) {
+                fprintf (stderr, "%s: bad record header\n", name);
+                status = -1;
+                break;
+            }
+            if (rec.length > textMax) {
+                buf = realloc (text, rec.length);
+                if (buf == NULL) {
+                    fprintf (stderr, "%s: out of memory\n", name);
+                    status = -1;
+                    break;
+                }
+                text = buf;
+                textMax = rec.length;
+            }
+            if (rec.length > 0 && fread (text, rec.length, 1, in) != 1) {
+                fprintf (stderr, "%s: truncated record\n", name);
+                status = -1;
+                break;
+            }
+            if (decodeRecord (&cores [rec.coreId], &rec, text) < 0) {
+                fprintf (stderr, "%s: out of memory\n", name);
+                status = -1;
+                break;
+            }
+        }
+        else {
+            fprintf (stderr, "%s: unknown block 0x%08x\n", name, tag);
+            status = -1;
+            break;
+        }
+    }
+
+leave:
+    free (text);
+
+    return status;
+}
+
+
+/** print usage and exit */
+static void printUsageExit (char * app)
+{
+    printf ("%s: [-h] [-t] [capture ...]\n", app);
+    printf ("  -h   Show this help message.\n");
+    printf ("  -t   Prefix each line with its capture time.\n");
+    printf ("Reads standard input when no capture file is given.\n");
+
+    exit (EXIT_SUCCESS);
+}
+
+
+int main (int argc, char * argv [])
+{
+    FILE  * in;
+    int     numFiles    = 0;
+    int     status      = 0;
+    int     i;
+
+    for (i = 1; i < argc; i++) {
+        if (!strcmp ("-t", argv[i])) {
+            showTime = 1;
+        }
+        else if (!strcmp ("-h", argv[i])) {
+            printUsageExit (argv[0]);
+        }
+    }
+
+    for (i = 1; i < argc; i++) {
+        if (argv[i][0] == '-') {
+            continue;
+        }
+        numFiles++;
+        in = fopen (argv[i], "rb");
+        if (in == NULL) {
+            fprintf (stderr, "Failed to open file: %s\n", argv[i]);
+            status = EXIT_FAILURE;
+            continue;
+        }
+        if (decodeFile (in, argv[i]) < 0) {
+            status = EXIT_FAILURE;
+        }
+        fclose (in);
+    }
+
+    if (numFiles == 0 && decodeFile (stdin, "stdin") < 0) {
+        status = EXIT_FAILURE;
+    }
+
+    for (i = 0; i < TRACE_MAX_CORES; i++) {
+        flushLine (&cores [i]);
+        free (cores [i].line);
+    }
+
+    return status;
+}
+
+
+#if defined (__cplusplus)
+}
+#endif /* defined (__cplusplus) */
@@ -0,0 +1,87 @@
+/*
+ *  Syslink-IPC for TI OMAP Processors
+ *
+ *  Copyright (c) 2008-2010, Texas Instruments Incorporated
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *  *  Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *
+ *  *  Redistributions in binary form must reproduce the above copyright
+ *     notice, this list of conditions and the following disclaimer in the
+ *     documentation and/or other materials provided with the distribution.
+ *
+ *  *  Neither the name of Texas Instruments Incorporated nor the names of
+ *     its contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+ *  AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO,
+ *  THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ *  PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ *  CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ *  EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ *  PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS;
+ *  OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY,
+ *  WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR
+ *  OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE,
+ *  EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ */
+/*============================================================================
+ *  @file   SyslinkTraceFormat.h
+ *
+ *  @brief  Layout of the binary trace capture file
+ *
+ *          A capture file is a sequence of blocks, each starting with a
+ *          32-bit tag. A file header is written whenever the daemon opens
+ *          or rotates the file, and is followed by trace records holding
+ *          the raw bytes taken from a core's trace buffer. All fields are
+ *          in the byte order of the capturing processor.
+ *
+ *  ============================================================================
+ */
+
+#ifndef SYSLINKTRACEFORMAT_H_0xB7A1
+#define SYSLINKTRACEFORMAT_H_0xB7A1
+
+#include <stdint.h>
+
+#if defined (__cplusplus)
+extern "C" {
+#endif /* defined (__cplusplus) */
+
+
+#define TRACE_FILE_TAG          0x46544C53  /* "SLTF" */
+#define TRACE_RECORD_TAG        0x52544C53  /* "SLTR" */
+#define TRACE_FILE_VERSION      1
+
+#define TRACE_MAX_CORES         8
+#define TRACE_CORE_NAME_LEN     16
+
+/* File header, followed by numCores names of TRACE_CORE_NAME_LEN chars */
+typedef struct traceFileHeader {
+    uint32_t    tag;            /* TRACE_FILE_TAG */
+    uint32_t    version;        /* TRACE_FILE_VERSION */
+    uint32_t    numCores;       /* Entries in the core name table */
+} traceFileHeader;
+
+/* Record header, followed by length bytes of raw trace text */
+typedef struct traceRecordHeader {
+    uint32_t    tag;            /* TRACE_RECORD_TAG */
+    uint32_t    coreId;         /* Index into the core name table */
+    uint32_t    sec;            /* Capture time (gettimeofday) */
+    uint32_t    usec;
+    uint32_t    length;         /* Bytes of trace text in the record */
+    uint32_t    dropped;        /* Bytes lost on this core before it */
+} traceRecordHeader;
+
+
+#if defined (__cplusplus)
+}
+#endif /* defined (__cplusplus) */
+
+#endif /* SYSLINKTRACEFORMAT_H_0xB7A1 */
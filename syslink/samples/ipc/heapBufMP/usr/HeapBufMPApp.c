@@ -32,6 +32,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <pthread.h>
 
 /* Standard headers */
 #include <Std.h>
@@ -87,6 +88,16 @@ extern "C" {
 #define HEAPBUF_SYSM3_IMAGE_PATH "./HeapBufMP_MPUSYS_Test_Core0.xem3"
 #define HEAPBUF_APPM3_IMAGE_PATH ""
 
+/*!
+ *  @brief  Magazine test: threads, blocks held per thread and round, block
+ *          size, magazine size and rounds per thread
+ */
+#define HEAPBUFMPAPP_MAG_THREADS    2
+#define HEAPBUFMPAPP_MAG_BLOCKS     12
+#define HEAPBUFMPAPP_MAG_BLOCKSIZE  128
+#define HEAPBUFMPAPP_MAG_SIZE       8
+#define HEAPBUFMPAPP_MAG_ROUNDS     100
+
 ProcMgr_Handle       HeapBufMPApp_Prochandle   = NULL;
 UInt32               curAddr   = 0;
 
@@ -160,6 +171,118 @@ HeapBufMPApp_startup (Void)
 }
 
 
+/*
+ *  Allocates and frees more blocks than fit in one magazine, so that the
+ *  thread's magazine is refilled and drained in batches.
+ */
+static Void *
+HeapBufMPApp_magazineThreadFxn (Void * arg)
+{
+    HeapBufMP_Handle    handle = (HeapBufMP_Handle) arg;
+    Ptr                 blocks [HEAPBUFMPAPP_MAG_BLOCKS];
+    Int                 round;
+    Int                 i;
+    Int                 n;
+
+    for (round = 0; round < HEAPBUFMPAPP_MAG_ROUNDS; round++) {
+        for (n = 0; n < HEAPBUFMPAPP_MAG_BLOCKS; n++) {
+            blocks [n] = HeapBufMP_alloc (handle,
+                                          HEAPBUFMPAPP_MAG_BLOCKSIZE,
+                                          0);
+            if (blocks [n] == NULL) {
+                break;
+            }
+            Memory_set (blocks [n], round, HEAPBUFMPAPP_MAG_BLOCKSIZE);
+        }
+        for (i = 0; i < n; i++) {
+            HeapBufMP_free (handle, blocks [i], HEAPBUFMPAPP_MAG_BLOCKSIZE);
+        }
+    }
+
+    /* The magazine is drained to the heap when the thread exits. */
+    return NULL;
+}
+
+
+/*
+ *  Creates a HeapBufMP with per-thread magazines, exercises it from several
+ *  threads and checks that all blocks are back in the heap once the threads
+ *  have exited.
+ */
+static Int
+HeapBufMPApp_testMagazines (Void)
+{
+    Int                 status      = 0;
+    HeapBufMP_Params    params;
+    HeapBufMP_Handle    handle      = NULL;
+    IHeap_Handle        regionHeap;
+    Ptr                 sharedAddr  = NULL;
+    SizeT               sharedSize;
+    Memory_Stats        stats;
+    pthread_t           threads [HEAPBUFMPAPP_MAG_THREADS];
+    Int                 numThreads;
+
+    Osal_printf ("\nTesting HeapBufMP magazines\n");
+
+    HeapBufMP_Params_init (&params);
+    params.blockSize    = HEAPBUFMPAPP_MAG_BLOCKSIZE;
+    params.numBlocks    = HEAPBUFMPAPP_MAG_THREADS * HEAPBUFMPAPP_MAG_BLOCKS;
+    params.align        = 128;
+    params.magazineSize = HEAPBUFMPAPP_MAG_SIZE;
+    sharedSize = HeapBufMP_sharedMemReq (&params);
+
+    regionHeap = SharedRegion_getHeap (APP_SHAREDREGION_ENTRY_ID);
+    if (regionHeap != NULL) {
+        sharedAddr = Memory_alloc (regionHeap, sharedSize, 0);
+    }
+    if (sharedAddr == NULL) {
+        Osal_printf ("Magazine test: shared memory allocation failed\n");
+        return -1;
+    }
+
+    params.sharedAddr = sharedAddr;
+    handle = HeapBufMP_create (&params);
+    if (handle == NULL) {
+        Osal_printf ("Magazine test: HeapBufMP_create failed\n");
+        status = -1;
+    }
+    else {
+        for (numThreads = 0;
+             numThreads < HEAPBUFMPAPP_MAG_THREADS;
+             numThreads++) {
+            if (pthread_create (&threads [numThreads], NULL,
+                                HeapBufMPApp_magazineThreadFxn,
+                                handle) != 0) {
+                Osal_printf ("Magazine test: pthread_create failed\n");
+                status = -1;
+                break;
+            }
+        }
+        while (numThreads > 0) {
+            pthread_join (threads [--numThreads], NULL);
+        }
+
+        Memory_getStats ((IHeap_Handle) handle, &stats);
+        Osal_printf ("Magazine heap stats: 0x%x bytes free, "
+                     "0x%x bytes total\n",
+                     stats.totalFreeSize, stats.totalSize);
+        if (stats.totalFreeSize != stats.totalSize) {
+            Osal_printf ("ERROR: Blocks were not returned to the heap\n");
+            status = -1;
+        }
+
+        if (HeapBufMP_delete (&handle) != HeapBufMP_S_SUCCESS) {
+            Osal_printf ("ERROR: HeapBufMP_delete failed\n");
+            status = -1;
+        }
+    }
+
+    Memory_free (regionHeap, sharedAddr, sharedSize);
+
+    return status;
+}
+
+
 /*
  *  Function to execute the HeapBufMPApp sample application
  */
@@ -351,6 +474,14 @@ HeapBufMPApp_execute (Void)
                       sizeof (ListMP_Node));
     }
 
+    /* -------------------------------------------------------------------------
+     * Per-thread magazines
+     * -------------------------------------------------------------------------
+     */
+    if (HeapBufMPApp_testMagazines () < 0) {
+        Osal_printf ("ERROR: HeapBufMP magazine test failed\n");
+    }
+
     /* -------------------------------------------------------------------------
      * Cleanup
      * -------------------------------------------------------------------------
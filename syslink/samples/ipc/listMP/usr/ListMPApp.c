@@ -29,6 +29,7 @@
 #include <unistd.h>
 #include <errno.h>
 #include <string.h>
+#include <sys/time.h>
 
 /* Standard headers */
 #include <Std.h>
@@ -122,6 +123,12 @@ extern "C" {
 #define LOCAL_LIST_OFFSET       (LOCAL_LIST - SHAREDMEM)
 #define REMOTE_LIST_OFFSET      (REMOTE_LIST - SHAREDMEM)
 
+/* Number of nodes on the list walked by the traversal benchmark */
+#define LISTMPAPP_BENCH_NODES   64u
+
+/* Number of complete walks timed in each mode */
+#define LISTMPAPP_BENCH_WALKS   100u
+
 /* Base Image to be loaded */
 #define LISTMP_SYSM3_IMAGE_PATH "./ListMP_MPUSYS_Test_Core0.xem3"
 /** ============================================================================
@@ -194,6 +201,100 @@ ListMPApp_startup (UInt32 sharedAddr)
 }
 
 
+/* Walks the list from head to tail LISTMPAPP_BENCH_WALKS times and returns
+ * the elapsed time in microseconds. *count gets the nodes seen per walk.
+ */
+static UInt32
+ListMPApp_walk (ListMP_Handle handle, UInt * count)
+{
+    struct timeval  start;
+    struct timeval  end;
+    ListMP_Elem *   elem;
+    UInt            i;
+
+    gettimeofday (&start, NULL);
+    for (i = 0; i < LISTMPAPP_BENCH_WALKS; i++) {
+        *count = 0;
+        for (elem = ListMP_next (handle, NULL);
+             elem != NULL;
+             elem = ListMP_next (handle, elem)) {
+            (*count)++;
+        }
+    }
+    gettimeofday (&end, NULL);
+
+    return ((end.tv_sec - start.tv_sec) * 1000000)
+           + (end.tv_usec - start.tv_usec);
+}
+
+/* Compares ListMP_next traversal through the driver with direct access on a
+ * private list in the heap of the application SharedRegion.
+ */
+static Void
+ListMPApp_traverseBench (Ptr heapHandle)
+{
+    ListMP_Params   params;
+    ListMP_Handle   handle;
+    ListMP_Node *   node;
+    Ptr             sharedAddr;
+    SizeT           sharedSize;
+    UInt32          ioctlUsecs;
+    UInt32          directUsecs;
+    UInt            ioctlCount;
+    UInt            directCount;
+    UInt            i;
+
+    ListMP_Params_init (&params);
+    params.regionId = APP_SHAREDREGION_ENTRY_ID;
+    sharedSize = ListMP_sharedMemReq (&params);
+    sharedAddr = Memory_alloc ((IHeap_Handle) heapHandle, sharedSize, 0);
+    if (sharedAddr == NULL) {
+        Osal_printf ("Traversal benchmark: no memory for the list\n");
+        return;
+    }
+
+    params.sharedAddr = sharedAddr;
+    handle = ListMP_create (&params);
+    if (handle == NULL) {
+        Osal_printf ("Traversal benchmark: ListMP_create failed\n");
+        Memory_free ((IHeap_Handle) heapHandle, sharedAddr, sharedSize);
+        return;
+    }
+
+    for (i = 0; i < LISTMPAPP_BENCH_NODES; i++) {
+        node = (ListMP_Node *) Memory_alloc ((IHeap_Handle) heapHandle,
+                                             sizeof (ListMP_Node),
+                                             0);
+        if (node == NULL) {
+            break;
+        }
+        node->id = i;
+        ListMP_putTail (handle, &(node->elem));
+    }
+
+    ListMP_setDirectAccess (handle, FALSE);
+    ioctlUsecs = ListMPApp_walk (handle, &ioctlCount);
+    if (ListMP_setDirectAccess (handle, TRUE) == ListMP_S_SUCCESS) {
+        directUsecs = ListMPApp_walk (handle, &directCount);
+        Osal_printf ("Traversal benchmark: %u walks of %u nodes:"
+                     " ioctl %u usec, direct %u usec%s\n",
+                     LISTMPAPP_BENCH_WALKS, ioctlCount, ioctlUsecs,
+                     directUsecs,
+                     (directCount == ioctlCount) ? "" : " (COUNT MISMATCH)");
+    }
+    else {
+        Osal_printf ("Traversal benchmark: %u walks of %u nodes:"
+                     " ioctl %u usec, direct access not available\n",
+                     LISTMPAPP_BENCH_WALKS, ioctlCount, ioctlUsecs);
+    }
+
+    while ((node = (ListMP_Node *) ListMP_getHead (handle)) != NULL) {
+        Memory_free ((IHeap_Handle) heapHandle, node, sizeof (ListMP_Node));
+    }
+    ListMP_delete (&handle);
+    Memory_free ((IHeap_Handle) heapHandle, sharedAddr, sharedSize);
+}
+
 Int
 ListMPApp_execute (UInt32 sharedAddr)
 {
@@ -363,6 +464,8 @@ ListMPApp_execute (UInt32 sharedAddr)
                       node,
                       sizeof (ListMP_Node));
     }
+
+    ListMPApp_traverseBench (ListMPApp_heapHandle);
 func_clean:
     /* -------------------------------------------------------------------------
      * Cleanup
@@ -51,6 +51,9 @@
 /* Application header */
 #include "MessageQApp_config.h"
 
+/* Linux headers */
+#include <sys/time.h>
+
 
 #if defined (__cplusplus)
 extern "C" {
@@ -91,6 +94,11 @@ extern "C" {
  */
 #define  MESSAGEQAPP_NUM_TRANSFERS  10
 
+/*!
+ *  @brief  Number of messages sent per MessageQ_putMany in the batched test.
+ */
+#define  MESSAGEQAPP_BATCH_SIZE     8
+
 
 /** ============================================================================
  *  Globals
@@ -338,8 +346,14 @@ MessageQApp_execute (Int testNo)
 {
     Int32                    status     = 0;
     MessageQ_Msg             msg        = NULL;
+    MessageQ_Msg             msgs [MESSAGEQAPP_BATCH_SIZE];
     MessageQ_Params          msgParams;
     UInt16                   i;
+    UInt                     j;
+    UInt                     numMsgs;
+    UInt                     received;
+    struct timeval           start;
+    struct timeval           end;
     Char                   * msgQName;
 
     Osal_printf ("Entered MessageQApp_execute\n");
@@ -443,6 +457,80 @@ MessageQApp_execute (Int testNo)
         }
     }
 
+    if (status >= 0) {
+        Osal_printf ("\nExchanging messages in batches of %d\n",
+                     MESSAGEQAPP_BATCH_SIZE);
+        gettimeofday (&start, NULL);
+        for (i = 0; i < MESSAGEQAPP_NUM_TRANSFERS && status >= 0; i++) {
+            for (j = 0; j < MESSAGEQAPP_BATCH_SIZE; j++) {
+                msgs [j] = MessageQ_alloc (HEAPID, MSGSIZE);
+                if (msgs [j] == NULL) {
+                    Osal_printf ("Error in MessageQ_alloc\n");
+                    status = MessageQ_E_MEMORY;
+                    break;
+                }
+                MessageQ_setMsgId (msgs [j], (j % 16));
+                MessageQ_setReplyQueue (MessageQApp_messageQ, msgs [j]);
+            }
+            if (status < 0) {
+                while (j > 0) {
+                    MessageQ_free (msgs [--j]);
+                }
+                break;
+            }
+
+            status = MessageQ_putMany (MessageQApp_queueId, msgs,
+                                       MESSAGEQAPP_BATCH_SIZE, &numMsgs);
+            if (status < 0) {
+                Osal_printf ("Error in MessageQ_putMany [0x%x], %d put\n",
+                             status, numMsgs);
+                for (j = numMsgs; j < MESSAGEQAPP_BATCH_SIZE; j++) {
+                    MessageQ_free (msgs [j]);
+                }
+                break;
+            }
+
+            /* Replies may trickle in, so collect until the batch is back. */
+            received = 0;
+            while (received < MESSAGEQAPP_BATCH_SIZE) {
+                status = MessageQ_getMany (MessageQApp_messageQ,
+                                           &msgs [received],
+                                           MESSAGEQAPP_BATCH_SIZE - received,
+                                           &numMsgs,
+                                           MessageQ_FOREVER);
+                if (status < 0) {
+                    Osal_printf ("Error in MessageQ_getMany [0x%x]\n",
+                                 status);
+                    break;
+                }
+                received += numMsgs;
+            }
+
+            for (j = 0; j < received; j++) {
+                if (MessageQ_getMsgId (msgs [j]) != ((j % 16) + 1)) {
+                    Osal_printf ("Data integrity failure!\n"
+                                 "    Expected %d\n"
+                                 "    Received %d\n",
+                                 ((j % 16) + 1),
+                                 MessageQ_getMsgId (msgs [j]));
+                    status = MessageQ_E_FAIL;
+                }
+                MessageQ_free (msgs [j]);
+            }
+        }
+        gettimeofday (&end, NULL);
+
+        if (status >= 0) {
+            Osal_printf ("Exchanged %d messages in batches, %d usec per "
+                         "message\n",
+                         MESSAGEQAPP_NUM_TRANSFERS * MESSAGEQAPP_BATCH_SIZE,
+                         (((end.tv_sec - start.tv_sec) * 1000000)
+                          + (end.tv_usec - start.tv_usec))
+                         / (MESSAGEQAPP_NUM_TRANSFERS
+                            * MESSAGEQAPP_BATCH_SIZE));
+        }
+    }
+
     /* Keep the Ducati application running. */
 #if !defined (SYSLINK_USE_DAEMON)
     /* Send die message */
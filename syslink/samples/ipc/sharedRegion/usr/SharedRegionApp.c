@@ -32,6 +32,7 @@
 #include <string.h>
 #include <fcntl.h>
 #include <errno.h>
+#include <sys/time.h>
 
  /* Standard headers */
 #include <Std.h>
@@ -41,6 +42,7 @@
 #include <OsalPrint.h>
 #include <Memory.h>
 #include <String.h>
+#include <Cache.h>
 
 /* Module level headers */
 //#include <ti/ipc/Ipc.h>
@@ -96,6 +98,27 @@ extern "C" {
 #define SHAREDMEM               0xA0000000
 #define SHAREDMEMSIZE           0x54000
 
+/*!
+ *  @brief  Number of address translation round trips timed
+ */
+#define SHAREDREGIONAPP_XLT_LOOPS   100000u
+
+/*!
+ *  @brief  Size of the buffer used for the memcpy throughput comparison
+ */
+#define SHAREDREGIONAPP_COPY_SIZE   0x10000u
+
+/*!
+ *  @brief  Number of copies timed in each direction
+ */
+#define SHAREDREGIONAPP_COPY_LOOPS  100u
+
+/*!
+ *  @brief  Region mapped cached through cachedRegionMask, compared against
+ *          the uncached region SHAREDREGION_ID
+ */
+#define SHAREDREGIONAPP_CACHED_ID   (SHAREDREGION_ID + NUM_SHAREDREGIONS - 1)
+
 /*
 #define SHAREDMEM_PHY           0x83f00000
 #define SHAREDMEMSIZE           0xF000
@@ -105,6 +128,9 @@ ProcMgr_Handle sharedRegionApp_procMgrHandle = NULL;
 
 UInt32 sharedRegionApp_shAddrBase;
 
+/* Cached mapping of region SHAREDREGIONAPP_CACHED_ID, dst is 0 if unmapped */
+Memory_MapInfo sharedRegionApp_cachedMap;
+
 UInt32 curAddr;
 
 void * ProcMgrApp_startup ();
@@ -133,6 +159,8 @@ sharedRegionApp_startup (Void)
     Osal_printf ("Entered sharedRegionApp_startup\n");
 
     Ipc_getConfig (&config);
+    config.sharedRegionConfig.cachedRegionMask =
+                                            (1u << SHAREDREGIONAPP_CACHED_ID);
     status = Ipc_setup (&config);
     if (status < 0) {
         Osal_printf ("Error in Ipc_setup [0x%x]\n", status);
@@ -216,6 +244,23 @@ sharedRegionApp_startup (Void)
         sprintf(tmpStr,"AppSharedRegion%d" ,i);
         entry.name = tmpStr;
 
+        if ((SHAREDREGION_ID + i) == SHAREDREGIONAPP_CACHED_ID) {
+            /* This region is only accessed through the cached mapping. */
+            sharedRegionApp_cachedMap.src = (UInt32) Memory_translate (
+                                                entry.base,
+                                                Memory_XltFlags_Virt2Phys);
+            sharedRegionApp_cachedMap.size     = SHAREDREGION_SIZE;
+            sharedRegionApp_cachedMap.isCached = TRUE;
+            if (    (sharedRegionApp_cachedMap.src == 0)
+                ||  (Memory_map (&sharedRegionApp_cachedMap) < 0)) {
+                Osal_printf ("Cached mapping of region %d failed\n",
+                             SHAREDREGIONAPP_CACHED_ID);
+                sharedRegionApp_cachedMap.dst = 0;
+                continue;
+            }
+            entry.base = (Ptr) sharedRegionApp_cachedMap.dst;
+        }
+
         status = SharedRegion_setEntry ((SHAREDREGION_ID + i), &entry);
 
         if (status < 0) {
@@ -238,6 +283,140 @@ sharedRegionApp_startup (Void)
     return 0;
 }
 
+/* Times getId/getSRPtr/getPtr round trips, the translations done by every
+ * MessageQ and ListMP call, spreading the addresses over the given region.
+ * The lock-free snapshot and the locked table scan are timed separately.
+ */
+static Void
+sharedRegionApp_timeXlt (Ptr base, Bool lockFree)
+{
+    struct timeval      start;
+    struct timeval      end;
+    SharedRegion_SRPtr  srPtr;
+    UInt32              addr;
+    UInt32              i;
+    UInt16              id;
+
+    _SharedRegion_setLockFree (lockFree);
+
+    gettimeofday (&start, NULL);
+    for (i = 0; i < SHAREDREGIONAPP_XLT_LOOPS; i++) {
+        addr  = (UInt32) base + ((i * 64) % SHAREDMEMSIZE);
+        id    = SharedRegion_getId ((Ptr) addr);
+        srPtr = SharedRegion_getSRPtr ((Ptr) addr, id);
+        if ((UInt32) SharedRegion_getPtr (srPtr) != addr) {
+            Osal_printf ("Address translation mismatch at [0x%x]\n", addr);
+            break;
+        }
+    }
+    gettimeofday (&end, NULL);
+    Osal_printf ("%u %s address translation round trips took %u usec\n",
+                 i,
+                 (lockFree == TRUE) ? "lock-free" : "locked",
+                 ((end.tv_sec - start.tv_sec) * 1000000)
+                 + (end.tv_usec - start.tv_usec));
+
+    _SharedRegion_setLockFree (TRUE);
+}
+
+/* Times copies between a local buffer and shared memory through the given
+ * mapping and prints the throughput in MB/s. Cache maintenance is included
+ * in the timing for the cached mapping.
+ */
+static Int
+sharedRegionApp_timeCopy (Ptr shared, Ptr local, Bool isCached)
+{
+    Int             status = 0;
+    struct timeval  start;
+    struct timeval  end;
+    UInt32          usec;
+    UInt32          i;
+
+    gettimeofday (&start, NULL);
+    for (i = 0; (i < SHAREDREGIONAPP_COPY_LOOPS) && (status >= 0); i++) {
+        memcpy (shared, local, SHAREDREGIONAPP_COPY_SIZE);
+        if (isCached == TRUE) {
+            status = Cache_wb (shared, SHAREDREGIONAPP_COPY_SIZE,
+                               Cache_Type_ALL, TRUE);
+        }
+    }
+    gettimeofday (&end, NULL);
+    if (status < 0) {
+        Osal_printf ("Cache_wb failed [0x%x]\n", status);
+        return status;
+    }
+    usec = ((end.tv_sec - start.tv_sec) * 1000000)
+           + (end.tv_usec - start.tv_usec);
+    Osal_printf ("    %s local->shared: %u MB/s\n",
+                 (isCached == TRUE) ? "cached  " : "uncached",
+                 (usec == 0) ? 0 : ((SHAREDREGIONAPP_COPY_SIZE
+                                     * SHAREDREGIONAPP_COPY_LOOPS) / usec));
+
+    gettimeofday (&start, NULL);
+    for (i = 0; (i < SHAREDREGIONAPP_COPY_LOOPS) && (status >= 0); i++) {
+        if (isCached == TRUE) {
+            status = Cache_inv (shared, SHAREDREGIONAPP_COPY_SIZE,
+                                Cache_Type_ALL, TRUE);
+        }
+        memcpy (local, shared, SHAREDREGIONAPP_COPY_SIZE);
+    }
+    gettimeofday (&end, NULL);
+    if (status < 0) {
+        Osal_printf ("Cache_inv failed [0x%x]\n", status);
+        return status;
+    }
+    usec = ((end.tv_sec - start.tv_sec) * 1000000)
+           + (end.tv_usec - start.tv_usec);
+    Osal_printf ("    %s shared->local: %u MB/s\n",
+                 (isCached == TRUE) ? "cached  " : "uncached",
+                 (usec == 0) ? 0 : ((SHAREDREGIONAPP_COPY_SIZE
+                                     * SHAREDREGIONAPP_COPY_LOOPS) / usec));
+
+    return status;
+}
+
+/* Compares memcpy throughput through the uncached region SHAREDREGION_ID and
+ * the region SHAREDREGIONAPP_CACHED_ID, which cachedRegionMask maps cached.
+ * Each region is only accessed through its own mapping.
+ */
+static Void
+sharedRegionApp_copyBench (Void)
+{
+    SharedRegion_Entry  uncached;
+    SharedRegion_Entry  cached;
+    Ptr                 local;
+
+    SharedRegion_getEntry (SHAREDREGION_ID, &uncached);
+    SharedRegion_getEntry (SHAREDREGIONAPP_CACHED_ID, &cached);
+    if (    (uncached.isValid != TRUE)
+        ||  (cached.isValid != TRUE)
+        ||  (_SharedRegion_isCached (SHAREDREGIONAPP_CACHED_ID) != TRUE)) {
+        Osal_printf ("Region %d is not mapped cached, skipping copy "
+                     "benchmark\n",
+                     SHAREDREGIONAPP_CACHED_ID);
+        return;
+    }
+
+    local = Memory_alloc (NULL, SHAREDREGIONAPP_COPY_SIZE, 0);
+    if (local == NULL) {
+        Osal_printf ("Copy benchmark setup failed\n");
+        return;
+    }
+
+    Osal_printf ("memcpy throughput, %u byte buffer, region %d uncached, "
+                 "region %d cached:\n",
+                 SHAREDREGIONAPP_COPY_SIZE,
+                 SHAREDREGION_ID,
+                 SHAREDREGIONAPP_CACHED_ID);
+    Memory_set (local, 0x5A, SHAREDREGIONAPP_COPY_SIZE);
+
+    if (sharedRegionApp_timeCopy (uncached.base, local, FALSE) >= 0) {
+        sharedRegionApp_timeCopy (cached.base, local, TRUE);
+    }
+
+    Memory_free (NULL, local, SHAREDREGIONAPP_COPY_SIZE);
+}
+
 Int
 sharedRegionApp_execute (Void)
 {
@@ -289,6 +468,11 @@ sharedRegionApp_execute (Void)
     Osal_printf ("User virtual pointer  =  [0x%x]\n", usrVirtAddress);
 
 
+    sharedRegionApp_timeXlt (info_set.base, FALSE);
+    sharedRegionApp_timeXlt (info_set.base, TRUE);
+
+    usrVirtAddress = (UInt32) info_set.base + 0x6000;
+
     Osal_printf ("Passing an address which is not in any of the SharedRegion\n"
         "areas registered -- this should fail!\n");
     usrVirtAddress += 0x200000;
@@ -298,6 +482,8 @@ sharedRegionApp_execute (Void)
     usrVirtAddress = (UInt32)SharedRegion_getPtr(srPtr);
     Osal_printf ("User virtual pointer  =  [0x%x]\n", usrVirtAddress);
 
+    sharedRegionApp_copyBench ();
+
     return (0);
 }
 
@@ -306,6 +492,7 @@ sharedRegionApp_shutdown (Void)
 {
     Int32 status = 0;
     ProcMgr_StopParams  stopParams;
+    Memory_UnmapInfo    unmapInfo;
 
     stopParams.proc_id = MultiProc_getId ("SysM3");
     status = ProcMgr_stop (sharedRegionApp_procMgrHandle, &stopParams);
@@ -322,6 +509,16 @@ sharedRegionApp_shutdown (Void)
     }
     Osal_printf ("ProcMgr_detach status: [0x%x]\n", status);
 
+    if (sharedRegionApp_cachedMap.dst != 0) {
+        /* Cache maintenance needs the ProcMgr handle, so unmap first. */
+        SharedRegion_clearEntry (SHAREDREGIONAPP_CACHED_ID);
+        unmapInfo.addr     = sharedRegionApp_cachedMap.dst;
+        unmapInfo.size     = sharedRegionApp_cachedMap.size;
+        unmapInfo.isCached = TRUE;
+        Memory_unmap (&unmapInfo);
+        sharedRegionApp_cachedMap.dst = 0;
+    }
+
     status = ProcMgr_close (&sharedRegionApp_procMgrHandle);
     Osal_printf ("ProcMgr_close status: [0x%x]\n", status);
 
@@ -26,6 +26,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdint.h>
+#include <string.h>
 
 #include <pthread.h>
 #include <semaphore.h>
@@ -49,6 +50,7 @@
 
 /* TILER headers */
 #include <tilermgr.h>
+#include <memmgr.h>
 
 #if defined (__cplusplus)
 extern "C" {
@@ -60,6 +62,20 @@ extern "C" {
  */
 
 #define RCMSERVER_NAME              "MEMALLOCMGRSERVER"
+#define MEMMGR_TEST_WIDTH           64
+#define MEMMGR_TEST_HEIGHT          64
+
+/* Marshalled MemMgr_Alloc packet for a single buffer, as sent by Ducati */
+typedef struct {
+    UInt    numBuffers;
+    UInt    pixelFormat;
+    UInt    width;
+    UInt    height;
+    UInt    length;
+    UInt    stride;
+    Ptr     ptr;
+    UInt  * reserved;
+} MemMgr_AllocArgs;
 
 RcmServer_Handle rcmServerHandle;
 Int              status;
@@ -96,6 +112,60 @@ static Void mmuFaultHandler (Void)
     sem_post (&semMemMgrWait);
 }
 
+/*
+ *  ======== MemMgrTest2D ========
+ *     Allocate two 2D TILER blocks back to back, check that both resolve
+ *     through SysLinkMemUtils_DAtoVA and free them again.
+ */
+static Int MemMgrTest2D (Void)
+{
+    Int               status    = 0;
+    MemMgr_AllocArgs  args [2];
+    UInt32            da [2]    = {0, 0};
+    Ptr               ua;
+    Int               i;
+
+    for (i = 0; i < 2; i++) {
+        memset (&args [i], 0, sizeof (MemMgr_AllocArgs));
+        args [i].numBuffers = 1;
+        args [i].pixelFormat = PIXEL_FMT_8BIT;
+        args [i].width = MEMMGR_TEST_WIDTH;
+        args [i].height = MEMMGR_TEST_HEIGHT;
+
+        da [i] = SysLinkMemUtils_alloc (sizeof (MemMgr_AllocArgs),
+                                        (UInt32 *)&args [i]);
+        if (!da [i]) {
+            Osal_printf ("2D alloc %d failed\n", i);
+            status = -1;
+            break;
+        }
+        Osal_printf ("2D alloc %d: da 0x%x ptr 0x%x stride %d\n", i, da [i],
+                        args [i].ptr, args [i].stride);
+    }
+
+    for (i = 0; i < 2 && status == 0; i++) {
+        ua = SysLinkMemUtils_DAtoVA ((Ptr)da [i]);
+        if (ua != args [i].ptr) {
+            Osal_printf ("DAtoVA of block %d returned 0x%x, expected 0x%x\n",
+                            i, ua, args [i].ptr);
+            status = -1;
+        }
+    }
+
+    for (i = 0; i < 2; i++) {
+        if (da [i] && SysLinkMemUtils_free (sizeof (Ptr),
+                                            (UInt32 *)&da [i]) != 0) {
+            Osal_printf ("2D free %d failed\n", i);
+            status = -1;
+        }
+    }
+
+    Osal_printf ("2D back to back allocation test %s\n",
+                    status == 0 ? "passed" : "failed");
+
+    return status;
+}
+
 struct MemMgr_funcInfo {
     RcmServer_MsgFxn fxnPtr;
     String           name;
@@ -213,6 +283,11 @@ Int main (Int argc, Char * argv [])
     pthread_create (&mmuFaultHandle, NULL,
                         (Void *)&mmuFaultHandler, NULL);
 
+    /* Optional self test before serving Ducati requests */
+    if (argc > 1 && !strcmp (argv [1], "-t")) {
+        MemMgrTest2D ();
+    }
+
     MemMgrThreadFxn (RCMSERVER_NAME);
 
     status = Ipc_destroy ();
@@ -47,6 +47,7 @@
 #include <stdlib.h>
 #include <unistd.h>
 #include <stdarg.h>
+#include <sys/time.h>
 
 /* OSAL & Utils headers */
 #include <Std.h>
@@ -102,6 +103,8 @@ Int main(Int argc, char * argv[])
     ProcMgr_Params          params;
     UInt16                  procId;
     UInt32                  optind;
+    struct timeval          loadStart;
+    struct timeval          loadEnd;
 
     Osal_printf ("Entered Ducati load main\n");
 
@@ -193,14 +196,19 @@ Int main(Int argc, char * argv[])
         }
 
         Osal_printf("Loading Image %s ..... \n", imagePath);
+        gettimeofday (&loadStart, NULL);
         status  = ProcMgr_load (ProcMgrApp_handle, imagePath, argc, &imagePath,
                                 &entryPoint, &fileId, uProcId);
+        gettimeofday (&loadEnd, NULL);
         if (status != PROCMGR_SUCCESS) {
             fprintf(stdout,"ProcMgr_load failed for image %s and "
                         "status = 0x%x\n",imagePath, status);
             exit(1);
         }
         Osal_printf ("Completed Loading Image ..... %s\n",imagePath);
+        Osal_printf ("Load time: %d us\n",
+                     (Int)((loadEnd.tv_sec - loadStart.tv_sec) * 1000000 +
+                           (loadEnd.tv_usec - loadStart.tv_usec)));
         fprintf(stdout, "entryPoint is 0x%x\n",entryPoint);
 
         startParams = malloc(sizeof(ProcMgr_StartParams));
@@ -354,6 +354,116 @@ exit:
 }
 
 
+/*
+ *  ======== TestDynamicPool ========
+ *     Create a worker pool on the local server, run fxnDouble on it through
+ *     a local client, report its statistics and delete it again.
+ */
+Int TestDynamicPool (RcmServer_ThreadPoolDesc * poolTemplate)
+{
+    RcmServer_ThreadPoolDesc    poolDesc;
+    RcmServer_PoolStats         poolStats;
+    RcmClient_Params            poolClientParams;
+    RcmClient_Handle            poolClient          = NULL;
+    RcmClient_Message         * rcmMsg              = NULL;
+    RcmClient_Message         * returnMsg           = NULL;
+    RCM_Remote_FxnArgs        * fxnDoubleArgs;
+    UInt16                      poolId;
+    UInt                        fxnIdx;
+    Int                         loop;
+    Int                         status              = 0;
+    Int                         tmpStatus;
+
+    Osal_printf ("\nTestDynamicPool: Testing dynamic worker pools\n");
+
+    poolDesc = *poolTemplate;
+    poolDesc.name        = "DynPool";
+    poolDesc.count       = 1;
+    poolDesc.maxCount    = 2;
+    poolDesc.growLatency = 10;
+    poolDesc.idleTimeout = 100;
+
+    status = RcmServer_createPool (rcmServerHandle, &poolDesc, &poolId);
+    if (status < 0) {
+        Osal_printf ("TestDynamicPool: Error in RcmServer_createPool\n");
+        goto exit;
+    }
+    Osal_printf ("TestDynamicPool: Created pool, poolId = 0x%x\n", poolId);
+
+    RcmClient_Params_init (&poolClientParams);
+    poolClientParams.heapId = RCM_MSGQ_HEAPID;
+    status = RcmClient_create (RCMSERVER_NAME, &poolClientParams,
+                               &poolClient);
+    if (status < 0) {
+        Osal_printf ("TestDynamicPool: Error in local RcmClient_create\n");
+        goto delete_pool;
+    }
+
+    status = RcmClient_getSymbolIndex (poolClient, "fxnDouble", &fxnIdx);
+    if (status < 0) {
+        Osal_printf ("TestDynamicPool: Error getting fxnDouble index\n");
+        goto delete_client;
+    }
+
+    for (loop = 1; loop <= LOOP_COUNT; loop++) {
+        status = RcmClient_alloc (poolClient, sizeof(RCM_Remote_FxnArgs),
+                                  &rcmMsg);
+        if (status < 0) {
+            Osal_printf ("TestDynamicPool: Error allocating RCM message\n");
+            goto delete_client;
+        }
+        rcmMsg->poolId = poolId;
+        rcmMsg->fxnIdx = fxnIdx;
+        fxnDoubleArgs = (RCM_Remote_FxnArgs *)(&rcmMsg->data);
+        fxnDoubleArgs->a = loop;
+
+        status = RcmClient_exec (poolClient, rcmMsg, &returnMsg);
+        if (status < 0) {
+            Osal_printf ("TestDynamicPool: RcmClient_exec error.\n");
+            goto delete_client;
+        }
+        Osal_printf ("TestDynamicPool: exec (fxnDouble(%d)), result = %d\n",
+                     loop, returnMsg->result);
+        RcmClient_free (poolClient, returnMsg);
+    }
+
+    status = RcmServer_getPoolStats (rcmServerHandle, poolId, &poolStats);
+    if (status < 0) {
+        Osal_printf ("TestDynamicPool: Error in RcmServer_getPoolStats\n");
+        goto delete_client;
+    }
+    Osal_printf ("TestDynamicPool: pool: workers %d, queued %d, "
+                 "processed %d, steals %d, idle %d ms\n",
+                 poolStats.numWorkers, poolStats.queueDepth,
+                 poolStats.processed, poolStats.steals,
+                 poolStats.idleTime);
+
+delete_client:
+    RcmClient_delete (&poolClient);
+
+delete_pool:
+    tmpStatus = RcmServer_deletePool (rcmServerHandle, poolId);
+    if (tmpStatus < 0) {
+        Osal_printf ("TestDynamicPool: Error in RcmServer_deletePool\n");
+        if (status >= 0) {
+            status = tmpStatus;
+        }
+    }
+
+    /* A deleted pool id must no longer be accepted */
+    if (RcmServer_getPoolStats (rcmServerHandle, poolId, &poolStats) >= 0) {
+        Osal_printf ("TestDynamicPool: Deleted pool still reports stats\n");
+        if (status >= 0) {
+            status = -1;
+        }
+    }
+
+exit:
+    Osal_printf ("TestDynamicPool: Leaving TestDynamicPool()\n");
+    return status;
+}
+
+
 /*
  *  ======== ipcSetup ========
  */
@@ -649,6 +759,11 @@ Void RcmServerThreadFxn (Void *arg)
     RcmServer_start (rcmServerHandle);
     Osal_printf ("RcmServerThreadFxn: RCM Server start passed \n");
 
+    status = TestDynamicPool (&rcmServerParams.defaultPool);
+    if (status < 0) {
+        Osal_printf ("RcmServerThreadFxn: Error in TestDynamicPool \n");
+    }
+
     sem_wait (&serverThreadSync);
 
     sem_post (&serverThreadWait);
@@ -752,6 +867,7 @@ Int RcmTestCleanup (Int testCase)
     RcmClient_Message  * returnMsg          = NULL;
     UInt                 rcmMsgSize;
     RCM_Remote_FxnArgs * fxnExitArgs;
+    RcmServer_PoolStats  poolStats;
 #if !defined(SYSLINK_USE_DAEMON)
     ProcMgr_StopParams   stopParams;
 #endif
@@ -799,6 +915,16 @@ Int RcmTestCleanup (Int testCase)
     Osal_printf ("RcmTestCleanup: Clean up RCM client module \n");
     RcmClient_exit ();
 
+    /* Report the default worker pool statistics */
+    if (RcmServer_getPoolStats (rcmServerHandle, RcmClient_DEFAULTPOOLID,
+                                &poolStats) >= 0) {
+        Osal_printf ("RcmTestCleanup: default pool: workers %d, queued %d, "
+                     "processed %d, steals %d, idle %d ms\n",
+                     poolStats.numWorkers, poolStats.queueDepth,
+                     poolStats.processed, poolStats.steals,
+                     poolStats.idleTime);
+    }
+
     /* Delete the rcm server */
     Osal_printf ("RcmTestCleanup: Delete RCM server instance \n");
     status = RcmServer_delete (&rcmServerHandle);
@@ -588,6 +588,8 @@ Int CreateRcmClient(Int testCase)
     Osal_printf ("CreateRcmClient: Creating RcmClient instance \n");
     rcmClientParams.callbackNotification = 0; /* disable asynchronous exec */
     rcmClientParams.heapId = RCM_MSGQ_HEAPID;
+    rcmClientParams.cacheLength = 4;     /* recycle the test messages */
+    rcmClientParams.cacheDataSize = sizeof(RCM_Remote_FxnArgs);
 
     while ((rcmClientHandle == NULL) && (count++ < MAX_CREATE_ATTEMPTS)) {
         status = RcmClient_create (remoteServerName, &rcmClientParams,
@@ -629,6 +631,7 @@ Int RcmClientCleanup (Int testCase)
     RcmClient_Message  * returnMsg          = NULL;
     UInt                 rcmMsgSize;
     RCM_Remote_FxnArgs * fxnExitArgs;
+    RcmClient_CacheStats cacheStats;
 #if !defined(SYSLINK_USE_DAEMON)
     ProcMgr_StopParams   stopParams;
 #endif
@@ -664,6 +667,12 @@ Int RcmClientCleanup (Int testCase)
     Osal_printf ("RcmClientCleanup: Calling RcmClient_free \n");
     RcmClient_free (rcmClientHandle, returnMsg);
 
+    status = RcmClient_getCacheStats (rcmClientHandle, &cacheStats);
+    if (status >= 0) {
+        Osal_printf ("RcmClientCleanup: message cache hits %d misses %d\n",
+                        cacheStats.hits, cacheStats.misses);
+    }
+
     /* Delete the rcm client */
     Osal_printf ("RcmClientCleanup: Delete RCM client instance \n");
     status = RcmClient_delete (&rcmClientHandle);
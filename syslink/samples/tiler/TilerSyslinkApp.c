@@ -25,6 +25,7 @@
  /* OS-specific headers */
 #include <stdio.h>
 #include <stdlib.h>
+#include <malloc.h>
 #include <unistd.h>
 #include <sys/mman.h>
 #include <sys/ioctl.h>
@@ -102,6 +103,9 @@ extern "C" {
 #define DUCATI_DMM_POOL_0_SIZE          0x10000000
 
 #define ROUND_DOWN_TO2POW(x, N)         ((x) & ~((N)-1))
+
+#define MAP_BENCH_MAX_BUFFERS           16
+#define MAP_BENCH_BUF_SIZE              0x10000
 #define ROUND_UP_TO2POW(x, N)           ROUND_DOWN_TO2POW((x) + (N) - 1, N)
 
 /* =============================================================================
@@ -902,6 +906,113 @@ Int SyslinkMapUnMapTest (UInt numTrials)
     return 0;
 }
 
+/*!
+ *  @brief   Function to measure the map/unmap rate of SysLinkMemUtils
+ *
+ *           One buffer stays mapped for the whole run, as buffers do in the
+ *           MemMgr server, and each trial maps numBuffers buffers with one
+ *           SysLinkMemUtils_map call and unmaps them again.
+ *
+ *  @param   numTrials   Number of map/unmap rounds
+ *  @param   numBuffers  Number of buffers mapped per round
+ *
+ *  @sa
+ */
+Int SyslinkMapUnMapBenchmark (UInt numTrials, UInt numBuffers)
+{
+    Int                             status              = 0;
+    Ptr                             bufPtrs [MAP_BENCH_MAX_BUFFERS + 1];
+    SyslinkMemUtils_MpuAddrToMap    mpuAddrList [MAP_BENCH_MAX_BUFFERS + 1];
+    UInt32                          mappedAddr [MAP_BENCH_MAX_BUFFERS + 1];
+    UInt32                          residentAddr        = 0;
+    struct timespec                 start;
+    struct timespec                 end;
+    UInt32                          usecs;
+    UInt32                          rate;
+    Ipc_Config                      config;
+    UInt                            i;
+    UInt                            j;
+
+    if (numBuffers == 0 || numBuffers > MAP_BENCH_MAX_BUFFERS) {
+        Osal_printf ("Number of buffers must be 1..%d\n",
+                     MAP_BENCH_MAX_BUFFERS);
+        return -1;
+    }
+
+    Ipc_getConfig (&config);
+    status = Ipc_setup (&config);
+    if (status < 0) {
+        Osal_printf ("Error in Ipc_setup [0x%x]\n", status);
+        return -1;
+    }
+
+    /* Entry numBuffers is the resident buffer */
+    for (i = 0; i <= numBuffers; i++) {
+        bufPtrs [i] = memalign (MAP_BENCH_BUF_SIZE, MAP_BENCH_BUF_SIZE);
+        if (bufPtrs [i] == NULL) {
+            Osal_printf ("Error: memalign returned null.\n");
+            numBuffers = i;
+            status = -1;
+            goto exit;
+        }
+        mpuAddrList [i].mpuAddr = (UInt32)bufPtrs [i];
+        mpuAddrList [i].size = MAP_BENCH_BUF_SIZE;
+    }
+
+    status = SysLinkMemUtils_map (&mpuAddrList [numBuffers], 1, &residentAddr,
+                                  ProcMgr_MapType_Virt, PROC_SYSM3);
+    if (status < 0) {
+        Osal_printf ("SysLinkMemUtils_map failed with status [0x%x].\n",
+                     status);
+        residentAddr = 0;
+        goto exit;
+    }
+
+    clock_gettime (CLOCK_MONOTONIC, &start);
+    for (i = 0; i < numTrials; i++) {
+        status = SysLinkMemUtils_map (mpuAddrList, numBuffers, mappedAddr,
+                                      ProcMgr_MapType_Virt, PROC_SYSM3);
+        if (status < 0) {
+            Osal_printf ("SysLinkMemUtils_map failed with status [0x%x].\n",
+                         status);
+            goto exit;
+        }
+
+        for (j = 0; j < numBuffers; j++) {
+            status = SysLinkMemUtils_unmap (mappedAddr [j], PROC_SYSM3);
+            if (status < 0) {
+                Osal_printf ("SysLinkMemUtils_unmap failed with status "
+                             "[0x%x].\n", status);
+                goto exit;
+            }
+        }
+    }
+    clock_gettime (CLOCK_MONOTONIC, &end);
+
+    usecs = (end.tv_sec - start.tv_sec) * 1000000
+            + (end.tv_nsec - start.tv_nsec) / 1000;
+    rate = usecs ? (UInt32)((unsigned long long)numTrials * numBuffers
+                            * 1000000 / usecs) : 0;
+    Osal_printf ("%d rounds of %d buffers in %d us: %d us per round, "
+                 "%d maps/s\n", numTrials, numBuffers, usecs,
+                 usecs / (numTrials ? numTrials : 1), rate);
+
+exit:
+    if (residentAddr != 0) {
+        SysLinkMemUtils_unmap (residentAddr, PROC_SYSM3);
+    }
+    for (i = 0; i <= numBuffers; i++) {
+        free (bufPtrs [i]);
+    }
+
+    Ipc_destroy ();
+
+    if (status >= 0) {
+        Osal_printf ("Map/UnMap benchmark passed!\n");
+    }
+    return status;
+}
+
 #if defined (__cplusplus)
 }
 #endif /* defined (__cplusplus) */
@@ -65,6 +65,12 @@ Int SyslinkVirtToPhysPagesTest(void);
  */
 Int SyslinkMapUnMapTest(UInt);
 
+/*!
+ *  @brief  Function to measure the rate of mapping and unmapping buffers to
+ *          Ducati virtual space
+ */
+Int SyslinkMapUnMapBenchmark(UInt, UInt);
+
 #if defined (__cplusplus)
 }
 #endif /* defined (__cplusplus) */
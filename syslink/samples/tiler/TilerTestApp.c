@@ -83,6 +83,7 @@ Int main (Int argc, Char * argv [])
     Int     subTestNo   = -1;
     Int     procId      = -1;
     UInt    numTrials   = 1;
+    UInt    numBuffers  = 1;
     Int     i;
     Bool    validArgs   = TRUE;
 
@@ -94,7 +95,7 @@ Int main (Int argc, Char * argv [])
     }
 
     testNo = atoi (argv[1]);
-    if (testNo < 1 || testNo > 5) {
+    if (testNo < 1 || testNo > 6) {
         validArgs = FALSE;
         goto exit;
     }
@@ -134,6 +135,17 @@ Int main (Int argc, Char * argv [])
         else
             numTrials = 1;
         break;
+
+    case 6:
+        if(argc > 2)
+            numTrials = atoi (argv[2]);
+        else
+            numTrials = 1000;
+        if(argc > 3)
+            numBuffers = atoi (argv[3]);
+        else
+            numBuffers = 1;
+        break;
     }
 
     /* Run SyslinkVirtToPhysTest test */
@@ -174,6 +186,13 @@ Int main (Int argc, Char * argv [])
             Osal_printf ("Error in SyslinkMapUnMapTest test \n");
     }
 
+    if(testNo == 6) {
+        Osal_printf ("SyslinkMapUnMapBenchmark invoked.\n");
+        status = SyslinkMapUnMapBenchmark (numTrials, numBuffers);
+        if (status < 0)
+            Osal_printf ("Error in SyslinkMapUnMapBenchmark test \n");
+    }
+
     if(status < 0)
         Osal_printf("Exiting with status 0x%x\n", status);
 
@@ -201,6 +220,8 @@ exit:
                         "\n\t\tSyslink Use Malloc Buffer on AppM3\n");
         Osal_printf ("\t./syslink_tilertest.out 5 [# trials]: "
                         "\n\t\tSyslink Map/UnMap test\n");
+        Osal_printf ("\t./syslink_tilertest.out 6 [# trials] [# buffers]: "
+                        "\n\t\tSyslink Map/UnMap rate\n");
         Osal_printf ("\t[# trials] is optional, defaults to 1\n");
     }
 
@@ -10,7 +10,8 @@ LOCAL_SRC_FILES:= \
 	utilsApp.c \
 	GateTest.c \
 	MemoryTest.c \
-	ListTest.c
+	ListTest.c \
+	AtomicTest.c
 
 LOCAL_C_INCLUDES += \
 	$(LOCAL_PATH)/../inc \
@@ -0,0 +1,157 @@
+/*
+ *  Copyright 2001-2010 Texas Instruments - http://www.ti.com/
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License.
+ */
+
+/*============================================================================
+ *  @file   AtomicTest.c
+ *
+ *  @brief  Contention benchmark for Atomic_Ops
+ *  ============================================================================
+ */
+
+#include <Std.h>
+#include <OsalPrint.h>
+#include <Atomic_Ops.h>
+
+#include <pthread.h>
+#include <time.h>
+
+#define ATOMIC_MAX_THREADS      32
+
+/* Module state pattern used by the refCount checks, see MemoryOS.c */
+#define ATOMIC_MODULEID         (UInt16) 0x97D2
+#define ATOMIC_REF_BASE         (ATOMIC_MODULEID << 16u)
+
+#if defined (__cplusplus)
+extern "C" {
+#endif /* defined (__cplusplus) */
+
+typedef struct AtomicTest_Args {
+    Atomic *            refCount;
+    UInt                numIters;
+    Bool                useLock;
+    UInt                errors;
+} AtomicTest_Args;
+
+/* Serializes every operation, as Atomic_Ops.h used to */
+static pthread_mutex_t AtomicTest_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/*
+ * Each iteration does what a module API call does: check the module is set
+ * up, then take and drop a reference.
+ */
+static Void * AtomicTest_thread(Void * arg)
+{
+    AtomicTest_Args * args = (AtomicTest_Args *) arg;
+    Bool              notSetup;
+    UInt              i;
+
+    for (i = 0; i < args->numIters; i++) {
+        if (args->useLock) {
+            pthread_mutex_lock(&AtomicTest_lock);
+            notSetup = Atomic_cmpmask_and_lt(args->refCount, ATOMIC_REF_BASE,
+                                             ATOMIC_REF_BASE + 1u);
+            pthread_mutex_unlock(&AtomicTest_lock);
+            pthread_mutex_lock(&AtomicTest_lock);
+            Atomic_inc_return(args->refCount);
+            pthread_mutex_unlock(&AtomicTest_lock);
+            pthread_mutex_lock(&AtomicTest_lock);
+            Atomic_dec_return(args->refCount);
+            pthread_mutex_unlock(&AtomicTest_lock);
+        }
+        else {
+            notSetup = Atomic_cmpmask_and_lt(args->refCount, ATOMIC_REF_BASE,
+                                             ATOMIC_REF_BASE + 1u);
+            Atomic_inc_return(args->refCount);
+            Atomic_dec_return(args->refCount);
+        }
+        if (notSetup) {
+            args->errors++;
+        }
+    }
+
+    return NULL;
+}
+
+/*
+ * Runs numThreads threads doing numIters refCount checks each, and returns
+ * the elapsed time in microseconds.
+ */
+static UInt32 AtomicTest_run(UInt numThreads, UInt numIters, Bool useLock,
+                             UInt * errors)
+{
+    pthread_t           threads[ATOMIC_MAX_THREADS];
+    AtomicTest_Args     args[ATOMIC_MAX_THREADS];
+    Atomic              refCount = 0;
+    struct timespec     start;
+    struct timespec     end;
+    UInt                i;
+
+    Atomic_cmpmask_and_set(&refCount, ATOMIC_REF_BASE, ATOMIC_REF_BASE);
+    Atomic_set(&refCount, ATOMIC_REF_BASE + 1u);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < numThreads; i++) {
+        args[i].refCount = &refCount;
+        args[i].numIters = numIters;
+        args[i].useLock  = useLock;
+        args[i].errors   = 0;
+        pthread_create(&threads[i], NULL, AtomicTest_thread, &args[i]);
+    }
+    for (i = 0; i < numThreads; i++) {
+        pthread_join(threads[i], NULL);
+        *errors += args[i].errors;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (Atomic_read(&refCount) != ATOMIC_REF_BASE + 1u) {
+        (*errors)++;
+    }
+
+    return (end.tv_sec - start.tv_sec) * 1000000
+           + (end.tv_nsec - start.tv_nsec) / 1000;
+}
+
+/*
+ * Times refCount checks from 1 up to maxThreads threads, with the atomic
+ * operations alone and with every operation under one global mutex.
+ */
+Void AtomicTest(UInt maxThreads, UInt numIters)
+{
+    UInt32  atomicUsecs;
+    UInt32  lockUsecs;
+    UInt    errors = 0;
+    UInt    n;
+
+    if (maxThreads == 0 || maxThreads > ATOMIC_MAX_THREADS)
+        maxThreads = ATOMIC_MAX_THREADS;
+
+    for (n = 1; n <= maxThreads; n *= 2) {
+        atomicUsecs = AtomicTest_run(n, numIters, FALSE, &errors);
+        lockUsecs   = AtomicTest_run(n, numIters, TRUE, &errors);
+        Osal_printf("AtomicTest: %d threads x %d checks: atomic %d us, "
+                    "global mutex %d us\n", n, numIters, atomicUsecs,
+                    lockUsecs);
+    }
+
+    if (errors == 0)
+        Osal_printf("AtomicTest: PASSED!\n");
+    else
+        Osal_printf("AtomicTest: FAILED! %d errors\n", errors);
+}
+
+#if defined (__cplusplus)
+}
+#endif /* defined (__cplusplus) */
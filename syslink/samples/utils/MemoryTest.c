@@ -26,8 +26,16 @@
 
 #include <Memory.h>
 
+#include <stdlib.h>
+#include <time.h>
+
 #define BUF_SIZE    1024
 
+/* Physical window mapped by MemoryTranslateTest: Ducati base image */
+#define XLT_PHYS_BASE       0x9CF00000
+#define XLT_REGION_SIZE     0x1000
+#define XLT_MAX_REGIONS     1024
+
 #if defined (__cplusplus)
 extern "C" {
 #endif /* defined (__cplusplus) */
@@ -60,6 +68,87 @@ Void MemoryTest(Void)
         Osal_printf("MemoryTest: FAILED!\n");
 }
 
+/*
+ * Maps numRegions pages and times numLookups random translations in each
+ * direction.
+ */
+Void MemoryTranslateTest(UInt numRegions, UInt numLookups)
+{
+    Memory_MapInfo      mapInfo;
+    Memory_UnmapInfo    unmapInfo;
+    UInt32 *            virt;
+    struct timespec     start;
+    struct timespec     end;
+    UInt32              usecs;
+    UInt32              phys;
+    UInt                errors = 0;
+    UInt                i;
+    UInt                r;
+
+    if (numRegions == 0 || numRegions > XLT_MAX_REGIONS)
+        numRegions = XLT_MAX_REGIONS;
+
+    virt = (UInt32 *) Memory_alloc(NULL, numRegions * sizeof(UInt32), 0);
+    if (virt == NULL) {
+        Osal_printf("MemoryTranslateTest: FAILED to allocate!\n");
+        return;
+    }
+
+    for (i = 0; i < numRegions; i++) {
+        mapInfo.src  = XLT_PHYS_BASE + i * XLT_REGION_SIZE;
+        mapInfo.size = XLT_REGION_SIZE;
+        mapInfo.isCached = FALSE;
+        if (Memory_map(&mapInfo) < 0) {
+            Osal_printf("MemoryTranslateTest: Memory_map failed at %d\n", i);
+            numRegions = i;
+            errors++;
+            break;
+        }
+        virt[i] = mapInfo.dst;
+    }
+
+    srand(1);
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < numLookups && numRegions > 0; i++) {
+        r = rand() % numRegions;
+        phys = (UInt32) Memory_translate((Ptr)(virt[r] + (i & 0xFFF)),
+                                         Memory_XltFlags_Virt2Phys);
+        if (phys != XLT_PHYS_BASE + r * XLT_REGION_SIZE + (i & 0xFFF))
+            errors++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    usecs = (end.tv_sec - start.tv_sec) * 1000000
+            + (end.tv_nsec - start.tv_nsec) / 1000;
+    Osal_printf("MemoryTranslateTest: %d Virt2Phys over %d regions in %d us\n",
+                numLookups, numRegions, usecs);
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < numLookups && numRegions > 0; i++) {
+        r = rand() % numRegions;
+        if ((UInt32) Memory_translate(
+                        (Ptr)(XLT_PHYS_BASE + r * XLT_REGION_SIZE + 4),
+                        Memory_XltFlags_Phys2Virt) != virt[r] + 4)
+            errors++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    usecs = (end.tv_sec - start.tv_sec) * 1000000
+            + (end.tv_nsec - start.tv_nsec) / 1000;
+    Osal_printf("MemoryTranslateTest: %d Phys2Virt over %d regions in %d us\n",
+                numLookups, numRegions, usecs);
+
+    for (i = 0; i < numRegions; i++) {
+        unmapInfo.addr = virt[i];
+        unmapInfo.size = XLT_REGION_SIZE;
+        Memory_unmap(&unmapInfo);
+    }
+    Memory_free(NULL, virt, numRegions * sizeof(UInt32));
+
+    if (errors == 0)
+        Osal_printf("MemoryTranslateTest: PASSED!\n");
+    else
+        Osal_printf("MemoryTranslateTest: FAILED! %d errors\n", errors);
+}
+
 #if defined (__cplusplus)
 }
 #endif /* defined (__cplusplus) */
@@ -3,6 +3,9 @@
 
 #include <UsrUtilsDrv.h>
 
+#include <stdlib.h>
+#include <string.h>
+
 #if defined (__cplusplus)
 extern "C" {
 #endif /* defined (__cplusplus) */
@@ -12,14 +15,28 @@ extern "C" {
 Void MemoryTest(Void);
 Void GateTest(Void);
 Void ListTest(Void);
+Void MemoryTranslateTest(UInt numRegions, UInt numLookups);
+Void AtomicTest(UInt maxThreads, UInt numIters);
 
 Int main (Int argc, Char * argv [])
 {
     UsrUtilsDrv_setup();
 
-    MemoryTest();
-    GateTest();
-    ListTest();
+    /* utilsApp.out xlt [# regions] [# lookups] */
+    if (argc > 1 && strcmp(argv[1], "xlt") == 0) {
+        MemoryTranslateTest(argc > 2 ? atoi(argv[2]) : 256,
+                            argc > 3 ? atoi(argv[3]) : 1000000);
+    }
+    /* utilsApp.out atomic [max # threads] [# checks per thread] */
+    else if (argc > 1 && strcmp(argv[1], "atomic") == 0) {
+        AtomicTest(argc > 2 ? atoi(argv[2]) : 8,
+                   argc > 3 ? atoi(argv[3]) : 1000000);
+    }
+    else {
+        MemoryTest();
+        GateTest();
+        ListTest();
+    }
 
     UsrUtilsDrv_destroy();
 